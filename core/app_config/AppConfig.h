@@ -409,6 +409,7 @@ public:
     friend class InputFileUnittest;
     friend class InputContainerStdioUnittest;
     friend class BatcherUnittest;
+    friend class CheckpointManagerUnittest;
 #endif
 };
 
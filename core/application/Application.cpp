@@ -21,6 +21,7 @@
 #include <thread>
 
 #include "app_config/AppConfig.h"
+#include "batch/TimeoutFlushManager.h"
 #include "checkpoint/CheckPointManager.h"
 #include "common/CrashBackTraceUtil.h"
 #include "common/Flags.h"
@@ -237,6 +238,7 @@ void Application::Start() {
         LogtailPlugin::GetInstance()->LoadPluginBase();
     }
 
+    TimeoutFlushManager::GetInstance()->Init();
     LogProcess::GetInstance()->Start();
 
     time_t curTime = 0, lastProfilingCheckTime = 0, lastConfigCheckTime = 0, lastUpdateMetricTime = 0,
@@ -322,6 +324,7 @@ void Application::Exit() {
 #endif
 
     PipelineManager::GetInstance()->StopAllPipelines();
+    TimeoutFlushManager::GetInstance()->Stop();
 
     PluginRegistry::GetInstance()->UnloadPlugins();
 
@@ -149,8 +149,10 @@ private:
     }
 
     void UpdateExactlyOnceLogPosition() {
-        uint32_t offset = mBatch.mEvents.front().Cast<LogEvent>().GetPosition().first;
-        auto lastEventPosition = mBatch.mEvents.back().Cast<LogEvent>().GetPosition();
+        // use const access to avoid copying shared events
+        const auto& events = mBatch.mEvents;
+        uint32_t offset = events.front().Cast<LogEvent>().GetPosition().first;
+        auto lastEventPosition = events.back().Cast<LogEvent>().GetPosition();
         mBatch.mExactlyOnceCheckpoint->data.set_read_offset(offset);
         mBatch.mExactlyOnceCheckpoint->data.set_read_length(lastEventPosition.first + lastEventPosition.second
                                                             - offset);
@@ -18,6 +18,7 @@
 
 #include <json/json.h>
 
+#include <array>
 #include <cstdint>
 #include <map>
 #include <mutex>
@@ -102,9 +103,10 @@ public:
 
     // when group level batch is disabled, there should be only 1 element in BatchedEventsList
     void Add(PipelineEventGroup&& g, std::vector<BatchedEventsList>& res) {
-        std::lock_guard<std::mutex> lock(mMux);
         size_t key = g.GetTagsHash();
-        EventBatchItem<T>& item = mEventQueueMap[key];
+        EventQueueShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mMux);
+        EventBatchItem<T>& item = shard.mEventQueueMap[key];
 
         size_t eventsSize = g.GetEvents().size();
         for (size_t i = 0; i < eventsSize; ++i) {
@@ -113,6 +115,7 @@ public:
                 if (!mGroupQueue) {
                     item.Flush(res);
                 } else {
+                    std::lock_guard<std::mutex> groupLock(mGroupQueueMux);
                     if (!mGroupQueue->IsEmpty() && mGroupFlushStrategy->NeedFlushByTime(mGroupQueue->GetStatus())) {
                         mGroupQueue->Flush(res);
                     }
@@ -150,25 +153,28 @@ public:
     // key != 0: event level queue
     // key = 0: group level queue
     void FlushQueue(size_t key, BatchedEventsList& res) {
-        std::lock_guard<std::mutex> lock(mMux);
         if (key == 0) {
             if (!mGroupQueue) {
                 return;
             }
+            std::lock_guard<std::mutex> groupLock(mGroupQueueMux);
             return mGroupQueue->Flush(res);
         }
 
-        auto iter = mEventQueueMap.find(key);
-        if (iter == mEventQueueMap.end()) {
+        EventQueueShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mMux);
+        auto iter = shard.mEventQueueMap.find(key);
+        if (iter == shard.mEventQueueMap.end()) {
             return;
         }
 
         if (!mGroupQueue) {
             iter->second.Flush(res);
-            mEventQueueMap.erase(iter);
+            shard.mEventQueueMap.erase(iter);
             return;
         }
 
+        std::lock_guard<std::mutex> groupLock(mGroupQueueMux);
         if (!mGroupQueue->IsEmpty() && mGroupFlushStrategy->NeedFlushByTime(mGroupQueue->GetStatus())) {
             mGroupQueue->Flush(res);
         }
@@ -177,38 +183,66 @@ public:
                 mFlusher->GetContext().GetConfigName(), 0, 0, mGroupFlushStrategy->GetTimeoutSecs(), mFlusher);
         }
         iter->second.Flush(mGroupQueue.value());
-        mEventQueueMap.erase(iter);
+        shard.mEventQueueMap.erase(iter);
         if (mGroupFlushStrategy->NeedFlushBySize(mGroupQueue->GetStatus())) {
             mGroupQueue->Flush(res);
         }
     }
 
     void FlushAll(std::vector<BatchedEventsList>& res) {
-        std::lock_guard<std::mutex> lock(mMux);
-        for (auto& item : mEventQueueMap) {
-            if (!mGroupQueue) {
-                item.second.Flush(res);
-            } else {
-                if (!mGroupQueue->IsEmpty() && mGroupFlushStrategy->NeedFlushByTime(mGroupQueue->GetStatus())) {
-                    mGroupQueue->Flush(res);
-                }
-                item.second.Flush(mGroupQueue.value());
-                if (mGroupFlushStrategy->NeedFlushBySize(mGroupQueue->GetStatus())) {
-                    mGroupQueue->Flush(res);
+        for (auto& shard : mShards) {
+            std::lock_guard<std::mutex> lock(shard.mMux);
+            for (auto& item : shard.mEventQueueMap) {
+                if (!mGroupQueue) {
+                    item.second.Flush(res);
+                } else {
+                    std::lock_guard<std::mutex> groupLock(mGroupQueueMux);
+                    if (!mGroupQueue->IsEmpty() && mGroupFlushStrategy->NeedFlushByTime(mGroupQueue->GetStatus())) {
+                        mGroupQueue->Flush(res);
+                    }
+                    item.second.Flush(mGroupQueue.value());
+                    if (mGroupFlushStrategy->NeedFlushBySize(mGroupQueue->GetStatus())) {
+                        mGroupQueue->Flush(res);
+                    }
                 }
             }
+            shard.mEventQueueMap.clear();
         }
         if (mGroupQueue) {
+            std::lock_guard<std::mutex> groupLock(mGroupQueueMux);
             mGroupQueue->Flush(res);
         }
-        mEventQueueMap.clear();
     }
 
 private:
-    std::mutex mMux;
-    std::map<size_t, EventBatchItem<T>> mEventQueueMap;
+    // Event queues are sharded by the tags hash, so that groups with different tags, which are usually sent by
+    // different processing threads, can be batched in parallel.
+    static constexpr size_t kShardCnt = 16;
+
+    struct EventQueueShard {
+        std::mutex mMux;
+        std::map<size_t, EventBatchItem<T>> mEventQueueMap;
+    };
+
+    EventQueueShard& GetShard(size_t key) { return mShards[key % kShardCnt]; }
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    size_t GetEventQueueCnt() {
+        size_t cnt = 0;
+        for (auto& shard : mShards) {
+            cnt += shard.mEventQueueMap.size();
+        }
+        return cnt;
+    }
+
+    EventBatchItem<T>& GetEventQueue(size_t key) { return GetShard(key).mEventQueueMap[key]; }
+#endif
+
+    std::array<EventQueueShard, kShardCnt> mShards;
     EventFlushStrategy<T> mEventFlushStrategy;
 
+    // should always be locked after the shard lock, if both are needed
+    std::mutex mGroupQueueMux;
     std::optional<GroupBatchItem> mGroupQueue;
     std::optional<GroupFlushStrategy> mGroupFlushStrategy;
 
@@ -14,39 +14,213 @@
 
 #include "batch/TimeoutFlushManager.h"
 
+#include <chrono>
+
+#include "logger/Logger.h"
+
 using namespace std;
 
 namespace logtail {
 
+static uint64_t GetSteadyTimeInMs() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TimeoutFlushManager::TimeoutFlushManager() : mCurrentTick(GetSteadyTimeInMs()) {
+}
+
+void TimeoutFlushManager::Init() {
+    {
+        lock_guard<mutex> lock(mMux);
+        if (mIsThreadRunning) {
+            return;
+        }
+        mIsThreadRunning = true;
+    }
+    mThreadRes = async(launch::async, &TimeoutFlushManager::Run, this);
+}
+
+void TimeoutFlushManager::Stop() {
+    {
+        lock_guard<mutex> lock(mMux);
+        if (!mIsThreadRunning) {
+            return;
+        }
+        mIsThreadRunning = false;
+    }
+    mCV.notify_one();
+    future_status s = mThreadRes.wait_for(chrono::seconds(1));
+    if (s == future_status::ready) {
+        LOG_INFO(sLogger, ("timeout flush", "stopped successfully"));
+    } else {
+        LOG_WARNING(sLogger, ("timeout flush", "forced to stopped"));
+    }
+}
+
 void TimeoutFlushManager::UpdateRecord(
     const string& config, size_t index, size_t key, uint32_t timeoutSecs, Flusher* f) {
     lock_guard<mutex> lock(mMux);
+    uint64_t curTime = GetSteadyTimeInMs();
+    if (mRecordCnt == 0) {
+        // nothing to expire before now, skip the idle ticks at once
+        mCurrentTick = curTime;
+    }
     auto& item = mTimeoutRecords[config];
     auto it = item.find({index, key});
     if (it == item.end()) {
-        item.try_emplace({index, key}, f, key, timeoutSecs);
+        it = item.try_emplace({index, key}, f, key, timeoutSecs, curTime).first;
+        it->second.mRecords = &item;
+        it->second.mIndex = index;
+        ++mRecordCnt;
     } else {
-        it->second.Update();
+        it->second.Update(curTime);
+    }
+    AddToWheel(it->second);
+    if (it->second.mExpireTime < mNextFlushTime) {
+        // the flush thread is sleeping for a later slot
+        mNextFlushTime = it->second.mExpireTime;
+        mCV.notify_one();
     }
 }
 
 void TimeoutFlushManager::FlushTimeoutBatch() {
-    lock_guard<mutex> lock(mMux);
-    for (auto& item : mTimeoutRecords) {
-        for (auto it = item.second.begin(); it != item.second.end();) {
-            if (time(nullptr) - it->second.mUpdateTime >= it->second.mTimeoutSecs) {
-                it->second.mFlusher->Flush(it->second.mKey);
-                it = item.second.erase(it);
-            } else {
-                ++it;
+    FlushTimeoutBatch(GetSteadyTimeInMs());
+}
+
+void TimeoutFlushManager::FlushTimeoutBatch(uint64_t curTime) {
+    lock_guard<mutex> flushLock(mFlushMux);
+    vector<pair<Flusher*, size_t>> expired;
+    {
+        lock_guard<mutex> lock(mMux);
+        while (mCurrentTick <= curTime) {
+            if (mRecordCnt == 0) {
+                mCurrentTick = curTime + 1;
+                break;
             }
+            size_t index = mCurrentTick & (kNearSlotCnt - 1);
+            if (index == 0) {
+                Cascade();
+            }
+            auto& slot = mNearSlots[index];
+            for (TimeoutRecord* record : slot) {
+                expired.emplace_back(record->mFlusher, record->mKey);
+                record->mRecords->erase({record->mIndex, record->mKey});
+            }
+            mRecordCnt -= slot.size();
+            slot.clear();
+            ++mCurrentTick;
         }
     }
+    // flushers may update records again, so mMux should not be held here
+    for (const auto& item : expired) {
+        item.first->Flush(item.second);
+    }
 }
 
 void TimeoutFlushManager::ClearRecords(const string& config) {
+    lock_guard<mutex> flushLock(mFlushMux);
     lock_guard<mutex> lock(mMux);
-    mTimeoutRecords.erase(config);
+    auto it = mTimeoutRecords.find(config);
+    if (it == mTimeoutRecords.end()) {
+        return;
+    }
+    for (auto& item : it->second) {
+        RemoveFromWheel(item.second);
+    }
+    mRecordCnt -= it->second.size();
+    mTimeoutRecords.erase(it);
+}
+
+bool TimeoutFlushManager::Run() {
+    LOG_INFO(sLogger, ("timeout flush", "started"));
+    while (true) {
+        {
+            unique_lock<mutex> lock(mMux);
+            if (!mIsThreadRunning) {
+                break;
+            }
+            mNextFlushTime = GetNextFlushTime();
+            uint64_t flushTime = mNextFlushTime;
+            auto pred = [this, flushTime]() { return !mIsThreadRunning || mNextFlushTime != flushTime; };
+            if (flushTime == kNoFlushTime) {
+                mCV.wait(lock, pred);
+            } else {
+                mCV.wait_until(lock, chrono::steady_clock::time_point(chrono::milliseconds(flushTime)), pred);
+            }
+            if (!mIsThreadRunning) {
+                break;
+            }
+        }
+        FlushTimeoutBatch();
+    }
+    return true;
+}
+
+void TimeoutFlushManager::AddToWheel(TimeoutRecord& record) {
+    auto& slot = GetSlot(record.mExpireTime);
+    if (record.mSlot == nullptr) {
+        record.mSlotIter = slot.insert(slot.end(), &record);
+    } else {
+        // iterators remain valid after splice
+        slot.splice(slot.end(), *record.mSlot, record.mSlotIter);
+    }
+    record.mSlot = &slot;
+}
+
+void TimeoutFlushManager::RemoveFromWheel(TimeoutRecord& record) {
+    record.mSlot->erase(record.mSlotIter);
+    record.mSlot = nullptr;
+}
+
+// called at the beginning of every level 0 round, when all records in the current slot of level 1 expire in this round
+// and are moved to level 0, and so on for upper levels
+void TimeoutFlushManager::Cascade() {
+    for (size_t level = 0; level < kFarLevelCnt; ++level) {
+        size_t index = (mCurrentTick >> (kNearLevelBits + kFarLevelBits * level)) & (kFarSlotCnt - 1);
+        auto& slot = mFarSlots[level][index];
+        while (!slot.empty()) {
+            AddToWheel(*slot.front());
+        }
+        if (index != 0) {
+            break;
+        }
+    }
+}
+
+uint64_t TimeoutFlushManager::GetNextFlushTime() const {
+    if (mRecordCnt == 0) {
+        return kNoFlushTime;
+    }
+    size_t nearRecordCnt = 0;
+    for (const auto& slot : mNearSlots) {
+        nearRecordCnt += slot.size();
+    }
+    for (uint64_t tick = mCurrentTick; tick < mCurrentTick + kNearSlotCnt; ++tick) {
+        size_t index = tick & (kNearSlotCnt - 1);
+        if (!mNearSlots[index].empty() || (index == 0 && nearRecordCnt < mRecordCnt)) {
+            return tick;
+        }
+    }
+    // unreachable
+    return mCurrentTick + kNearSlotCnt;
+}
+
+list<TimeoutRecord*>& TimeoutFlushManager::GetSlot(uint64_t expireTime) {
+    if (expireTime < mCurrentTick) {
+        expireTime = mCurrentTick;
+    }
+    uint64_t delta = expireTime - mCurrentTick;
+    if (delta < kNearSlotCnt) {
+        return mNearSlots[expireTime & (kNearSlotCnt - 1)];
+    }
+    if (delta >= kMaxTimeoutMs) {
+        expireTime = mCurrentTick + kMaxTimeoutMs - 1;
+    }
+    size_t level = 0;
+    while (delta >= (kNearSlotCnt << (kFarLevelBits * (level + 1))) && level + 1 < kFarLevelCnt) {
+        ++level;
+    }
+    return mFarSlots[level][(expireTime >> (kNearLevelBits + kFarLevelBits * level)) & (kFarSlotCnt - 1)];
 }
 
 } // namespace logtail
@@ -16,11 +16,15 @@
 
 #pragma once
 
+#include <array>
+#include <condition_variable>
 #include <cstdint>
-#include <ctime>
+#include <future>
+#include <list>
 #include <map>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "plugin/interface/Flusher.h"
@@ -30,15 +34,35 @@ namespace logtail {
 struct TimeoutRecord {
     Flusher* mFlusher = nullptr;
     size_t mKey;
-    time_t mUpdateTime = 0;
     uint32_t mTimeoutSecs = 0;
+    // in milliseconds, read from a steady clock
+    uint64_t mUpdateTime = 0;
+    uint64_t mExpireTime = 0;
 
-    TimeoutRecord(Flusher* flusher, size_t key, uint32_t timeoutSecs)
-        : mFlusher(flusher), mKey(key), mUpdateTime(time(nullptr)), mTimeoutSecs(timeoutSecs) {}
+    TimeoutRecord(Flusher* flusher, size_t key, uint32_t timeoutSecs, uint64_t curTime)
+        : mFlusher(flusher), mKey(key), mTimeoutSecs(timeoutSecs) {
+        Update(curTime);
+    }
+
+    void Update(uint64_t curTime) {
+        mUpdateTime = curTime;
+        mExpireTime = curTime + mTimeoutSecs * 1000ULL;
+    }
+
+private:
+    // position of the record in the timing wheel
+    std::list<TimeoutRecord*>* mSlot = nullptr;
+    std::list<TimeoutRecord*>::iterator mSlotIter;
+    // used to remove the record from mTimeoutRecords once expired
+    std::map<std::pair<size_t, size_t>, TimeoutRecord>* mRecords = nullptr;
+    size_t mIndex = 0;
 
-    void Update() { mUpdateTime = time(nullptr); }
+    friend class TimeoutFlushManager;
 };
 
+// Timeout records are kept in a hierarchical timing wheel with millisecond resolution, and expired batches are flushed
+// by a dedicated thread, which sleeps until the next slot to expire. Adding, updating and expiring a record all take
+// O(1) time, and a batch is flushed right after its timeout, irrespective of how busy the processing threads are.
 class TimeoutFlushManager {
 public:
     TimeoutFlushManager(const TimeoutFlushManager&) = delete;
@@ -49,16 +73,51 @@ public:
         return &instance;
     }
 
+    void Init();
+    void Stop();
+
     void UpdateRecord(const std::string& config, size_t index, size_t key, uint32_t timeoutSecs, Flusher* f);
     void FlushTimeoutBatch();
+    // no batch of the config is being or will be flushed by the manager after return
     void ClearRecords(const std::string& config);
 
 private:
-    TimeoutFlushManager() = default;
+    // level 0 covers the next 256 ms, and every upper level is 64 times as long as the level below, so that the wheel
+    // covers about 18 hours altogether. Records expiring later than that are kept in the last slot until cascaded.
+    static constexpr size_t kNearLevelBits = 8;
+    static constexpr size_t kFarLevelBits = 6;
+    static constexpr size_t kFarLevelCnt = 3;
+    static constexpr uint64_t kNearSlotCnt = 1ULL << kNearLevelBits;
+    static constexpr uint64_t kFarSlotCnt = 1ULL << kFarLevelBits;
+    static constexpr uint64_t kMaxTimeoutMs = kNearSlotCnt << (kFarLevelBits * kFarLevelCnt);
+    static constexpr uint64_t kNoFlushTime = UINT64_MAX;
+
+    TimeoutFlushManager();
     ~TimeoutFlushManager() = default;
 
+    bool Run();
+    void FlushTimeoutBatch(uint64_t curTime);
+    void AddToWheel(TimeoutRecord& record);
+    void RemoveFromWheel(TimeoutRecord& record);
+    void Cascade();
+    uint64_t GetNextFlushTime() const;
+    std::list<TimeoutRecord*>& GetSlot(uint64_t expireTime);
+
     std::mutex mMux;
     std::map<std::string, std::map<std::pair<size_t, size_t>, TimeoutRecord>> mTimeoutRecords;
+    std::array<std::list<TimeoutRecord*>, kNearSlotCnt> mNearSlots;
+    std::array<std::array<std::list<TimeoutRecord*>, kFarSlotCnt>, kFarLevelCnt> mFarSlots;
+    size_t mRecordCnt = 0;
+    // all slots before the tick have been expired
+    uint64_t mCurrentTick = 0;
+    uint64_t mNextFlushTime = kNoFlushTime;
+
+    // should always be locked before mMux, which guarantees that no flusher is in use after ClearRecords returns
+    std::mutex mFlushMux;
+
+    std::future<bool> mThreadRes;
+    bool mIsThreadRunning = false;
+    std::condition_variable mCV;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class TimeoutFlushManagerUnittest;
@@ -0,0 +1,351 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checkpoint/CheckPointLogStore.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(_MSC_VER)
+#include <io.h>
+#endif
+
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "common/xxhash/xxhash.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(checkpoint_log_min_compact_size,
+                  "the log is not compacted if its size is below this value",
+                  1024 * 1024);
+
+using namespace std;
+
+namespace logtail {
+
+static const char kMagic[4] = {'L', 'T', 'C', 'P'};
+static const uint32_t kFormatVersion = 1;
+static const size_t kHeaderSize = sizeof(kMagic) + 4 + 4;
+static const size_t kRecordHeaderSize = 4 + 4;
+
+static void AppendUint32(string& buf, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint32_t ReadUint32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+CheckPointLogStore::~CheckPointLogStore() {
+    CloseFile();
+}
+
+void CheckPointLogStore::SetFilePath(const string& filePath) {
+    if (filePath == mFilePath) {
+        return;
+    }
+    CloseFile();
+    mFilePath = filePath;
+    mRecords.clear();
+    mNeedCompact = true;
+    mFileSize = 0;
+    mLiveSize = 0;
+}
+
+bool CheckPointLogStore::Exists() const {
+    return CheckExistance(mFilePath);
+}
+
+bool CheckPointLogStore::Load(unordered_map<string, string>& records, int32_t& version) {
+    mRecords.clear();
+    mNeedCompact = true;
+    mFileSize = 0;
+    mLiveSize = 0;
+
+    ifstream fin(mFilePath, ios::binary);
+    if (!fin) {
+        return false;
+    }
+    string data((istreambuf_iterator<char>(fin)), istreambuf_iterator<char>());
+    if (data.size() < kHeaderSize || data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0
+        || ReadUint32(data.data() + sizeof(kMagic)) != kFormatVersion) {
+        LOG_ERROR(sLogger, ("invalid checkpoint log header, ignore the file", mFilePath));
+        return false;
+    }
+    version = static_cast<int32_t>(ReadUint32(data.data() + sizeof(kMagic) + 4));
+
+    size_t pos = kHeaderSize;
+    bool isBroken = false;
+    while (pos < data.size()) {
+        if (data.size() - pos < kRecordHeaderSize) {
+            isBroken = true;
+            break;
+        }
+        uint32_t size = ReadUint32(data.data() + pos);
+        uint32_t checksum = ReadUint32(data.data() + pos + 4);
+        const char* payload = data.data() + pos + kRecordHeaderSize;
+        if (data.size() - pos - kRecordHeaderSize < size || size < 5 || XXH32(payload, size, 0) != checksum) {
+            isBroken = true;
+            break;
+        }
+        uint8_t op = static_cast<uint8_t>(payload[0]);
+        uint32_t keySize = ReadUint32(payload + 1);
+        if (keySize > size - 5 || (op != PUT_RECORD && op != DELETE_RECORD)) {
+            isBroken = true;
+            break;
+        }
+        string key(payload + 5, keySize);
+        size_t recordSize = kRecordHeaderSize + size;
+        auto it = mRecords.find(key);
+        if (it != mRecords.end()) {
+            mLiveSize -= it->second.mSize;
+        }
+        if (op == PUT_RECORD) {
+            string value(payload + 5 + keySize, size - 5 - keySize);
+            mRecords[key].mSize = recordSize;
+            mLiveSize += recordSize;
+            records[key] = std::move(value);
+        } else {
+            if (it != mRecords.end()) {
+                mRecords.erase(it);
+            }
+            records.erase(key);
+        }
+        pos += recordSize;
+    }
+    mFileSize = pos;
+    if (isBroken) {
+        LOG_WARNING(sLogger,
+                    ("checkpoint log is broken, the tail is discarded", mFilePath)("valid size", pos)("file size",
+                                                                                               data.size()));
+    } else {
+        mNeedCompact = false;
+    }
+    mLoadedVersion = version;
+    return true;
+}
+
+bool CheckPointLogStore::NeedCompact(int32_t version) const {
+    return mNeedCompact || version != mLoadedVersion || !Exists()
+        || mFileSize > 2 * mLiveSize + static_cast<size_t>(INT32_FLAG(checkpoint_log_min_compact_size));
+}
+
+bool CheckPointLogStore::BeginDump(int32_t version) {
+    CloseFile();
+    ++mDumpSeq;
+    mDumpFailed = false;
+    mIsIncremental = false;
+    mCompacting = NeedCompact(version);
+    if (mCompacting) {
+        mFile = fopen((mFilePath + ".tmp").c_str(), "wb");
+        mFileSize = 0;
+        mLiveSize = 0;
+    } else {
+        mFile = fopen(mFilePath.c_str(), "ab");
+    }
+    if (mFile == nullptr) {
+        LOG_ERROR(sLogger, ("open checkpoint log failed", mFilePath)("errno", errno));
+        mDumpFailed = true;
+        return false;
+    }
+    if (mCompacting && !WriteHeader(version)) {
+        mDumpFailed = true;
+        return false;
+    }
+    mLoadedVersion = version;
+    return true;
+}
+
+bool CheckPointLogStore::BeginIncrementalDump(int32_t version) {
+    if (NeedCompact(version)) {
+        return false;
+    }
+    CloseFile();
+    ++mDumpSeq;
+    mDumpFailed = false;
+    mIsIncremental = true;
+    mCompacting = false;
+    mFile = fopen(mFilePath.c_str(), "ab");
+    if (mFile == nullptr) {
+        LOG_ERROR(sLogger, ("open checkpoint log failed", mFilePath)("errno", errno));
+        mDumpFailed = true;
+    }
+    return true;
+}
+
+bool CheckPointLogStore::Put(const string& key, const string& value) {
+    if (mDumpFailed) {
+        return false;
+    }
+    auto it = mRecords.find(key);
+    auto& meta = it == mRecords.end() ? mRecords[key] : it->second;
+    size_t sizeBefore = mFileSize;
+    if (!AppendRecord(PUT_RECORD, key, value)) {
+        mDumpFailed = true;
+        return false;
+    }
+    // the live size of the record is accumulated again in compaction
+    if (!mCompacting) {
+        mLiveSize -= meta.mSize;
+    }
+    meta.mSize = mFileSize - sizeBefore;
+    meta.mDumpSeq = mDumpSeq;
+    mLiveSize += meta.mSize;
+    return true;
+}
+
+bool CheckPointLogStore::Keep(const string& key) {
+    if (mDumpFailed || mCompacting) {
+        return false;
+    }
+    auto it = mRecords.find(key);
+    if (it == mRecords.end()) {
+        return false;
+    }
+    it->second.mDumpSeq = mDumpSeq;
+    return true;
+}
+
+bool CheckPointLogStore::Delete(const string& key) {
+    if (mDumpFailed) {
+        return false;
+    }
+    auto it = mRecords.find(key);
+    if (it == mRecords.end()) {
+        return true;
+    }
+    if (!mCompacting) {
+        if (!AppendRecord(DELETE_RECORD, key, string())) {
+            mDumpFailed = true;
+            return false;
+        }
+        mLiveSize -= it->second.mSize;
+    } else if (it->second.mDumpSeq == mDumpSeq) {
+        // only records put in this compaction are accumulated in the live size
+        mLiveSize -= it->second.mSize;
+    }
+    mRecords.erase(it);
+    return true;
+}
+
+bool CheckPointLogStore::EndDump() {
+    // records not mentioned in an incremental dump are unchanged
+    for (auto it = mRecords.begin(); !mIsIncremental && it != mRecords.end();) {
+        if (it->second.mDumpSeq == mDumpSeq) {
+            ++it;
+            continue;
+        }
+        if (!mCompacting && !mDumpFailed && !AppendRecord(DELETE_RECORD, it->first, string())) {
+            mDumpFailed = true;
+        }
+        if (!mCompacting) {
+            mLiveSize -= it->second.mSize;
+        }
+        it = mRecords.erase(it);
+    }
+    if (mFile != nullptr && (fflush(mFile) != 0 || !SyncFile())) {
+        LOG_ERROR(sLogger, ("flush checkpoint log failed", mFilePath)("errno", errno));
+        mDumpFailed = true;
+    }
+    CloseFile();
+
+    if (mCompacting && !mDumpFailed) {
+        string tmpFilePath = mFilePath + ".tmp";
+#if defined(_MSC_VER)
+        // The rename on Windows will fail if the destination is existing.
+        remove(mFilePath.c_str());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+        if (rename(tmpFilePath.c_str(), mFilePath.c_str()) == -1) {
+            LOG_ERROR(sLogger, ("rename checkpoint log failed", mFilePath)("errno", errno));
+            mDumpFailed = true;
+        }
+    }
+    mCompacting = false;
+    mIsIncremental = false;
+    // the content of the file is uncertain after failure, rewrite it next time
+    mNeedCompact = mDumpFailed;
+    return !mDumpFailed;
+}
+
+void CheckPointLogStore::Remove() {
+    CloseFile();
+    remove(mFilePath.c_str());
+    mRecords.clear();
+    mNeedCompact = true;
+    mFileSize = 0;
+    mLiveSize = 0;
+}
+
+bool CheckPointLogStore::WriteHeader(int32_t version) {
+    mBuffer.assign(kMagic, sizeof(kMagic));
+    AppendUint32(mBuffer, kFormatVersion);
+    AppendUint32(mBuffer, static_cast<uint32_t>(version));
+    if (fwrite(mBuffer.data(), 1, mBuffer.size(), mFile) != mBuffer.size()) {
+        LOG_ERROR(sLogger, ("write checkpoint log failed", mFilePath)("errno", errno));
+        return false;
+    }
+    mFileSize += mBuffer.size();
+    return true;
+}
+
+bool CheckPointLogStore::AppendRecord(RecordOp op, const string& key, const string& value) {
+    uint32_t size = 1 + 4 + key.size() + value.size();
+    mBuffer.clear();
+    AppendUint32(mBuffer, size);
+    // placeholder for checksum
+    AppendUint32(mBuffer, 0);
+    mBuffer.push_back(static_cast<char>(op));
+    AppendUint32(mBuffer, static_cast<uint32_t>(key.size()));
+    mBuffer.append(key).append(value);
+    uint32_t checksum = XXH32(mBuffer.data() + kRecordHeaderSize, size, 0);
+    for (int i = 0; i < 4; ++i) {
+        mBuffer[4 + i] = static_cast<char>((checksum >> (8 * i)) & 0xFF);
+    }
+    if (fwrite(mBuffer.data(), 1, mBuffer.size(), mFile) != mBuffer.size()) {
+        LOG_ERROR(sLogger, ("write checkpoint log failed", mFilePath)("errno", errno));
+        return false;
+    }
+    mFileSize += mBuffer.size();
+    return true;
+}
+
+// appended records must reach the disk before the next dump relies on them, otherwise a crash may leave a torn log
+bool CheckPointLogStore::SyncFile() {
+#if defined(__linux__)
+    return fdatasync(fileno(mFile)) == 0;
+#elif defined(_MSC_VER)
+    return _commit(_fileno(mFile)) == 0;
+#else
+    return true;
+#endif
+}
+
+void CheckPointLogStore::CloseFile() {
+    if (mFile != nullptr) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+}
+
+} // namespace logtail
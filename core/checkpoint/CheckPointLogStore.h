@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace logtail {
+
+// CheckPointLogStore persists checkpoints as binary key-value records in an append-only log file.
+//
+// A full dump is a snapshot of the current checkpoints, i.e., BeginDump + Put or Keep for every checkpoint + EndDump.
+// The caller tracks which checkpoints have changed since the last dump: changed ones are appended by Put, unchanged ones
+// are marked by Keep without being encoded again, and records neither put nor kept in this dump are appended as
+// deletions. An incremental dump, i.e., BeginIncrementalDump + Put or Delete for changed checkpoints only + EndDump,
+// leaves the other records as they are. When the log grows much larger than the live records, the next dump must be a
+// full one, which rewrites the whole file instead and is called compaction. The log is synced to disk at the end of
+// each dump.
+//
+// File format: header (magic, format version, user version), followed by records of
+//  [payload size: u32][xxhash32 of payload: u32][payload: op (u8), key size (u32), key, value].
+// A broken record at the tail, e.g., due to process crash, is discarded on load.
+class CheckPointLogStore {
+public:
+    CheckPointLogStore() = default;
+    ~CheckPointLogStore();
+    CheckPointLogStore(const CheckPointLogStore&) = delete;
+    CheckPointLogStore& operator=(const CheckPointLogStore&) = delete;
+
+    void SetFilePath(const std::string& filePath);
+    const std::string& GetFilePath() const { return mFilePath; }
+    bool Exists() const;
+
+    // Replay the log file to records.
+    // @return false if the file does not exist or is not valid.
+    bool Load(std::unordered_map<std::string, std::string>& records, int32_t& version);
+
+    bool BeginDump(int32_t version);
+    // @return false if the log is to be compacted, in which case a full dump should be done instead.
+    bool BeginIncrementalDump(int32_t version);
+    bool Put(const std::string& key, const std::string& value);
+    bool Delete(const std::string& key);
+    // Keep the record of key unchanged in this dump.
+    // @return false if the record should be put instead, i.e., it does not exist or the log is being compacted.
+    bool Keep(const std::string& key);
+    bool EndDump();
+
+    // Remove the log file and forget all records.
+    void Remove();
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    size_t GetFileSize() const { return mFileSize; }
+    bool IsCompacting() const { return mCompacting; }
+#endif
+
+private:
+    enum RecordOp : uint8_t { PUT_RECORD = 1, DELETE_RECORD = 2 };
+
+    struct RecordMeta {
+        size_t mSize = 0;
+        uint64_t mDumpSeq = 0;
+    };
+
+    bool NeedCompact(int32_t version) const;
+    bool WriteHeader(int32_t version);
+    bool AppendRecord(RecordOp op, const std::string& key, const std::string& value);
+    bool SyncFile();
+    void CloseFile();
+
+    std::string mFilePath;
+    FILE* mFile = nullptr;
+    bool mCompacting = false;
+    bool mIsIncremental = false;
+    // the log is corrupted or not loaded, rewrite it on next dump
+    bool mNeedCompact = true;
+    bool mDumpFailed = false;
+    size_t mFileSize = 0;
+    size_t mLiveSize = 0;
+    uint64_t mDumpSeq = 0;
+    int32_t mLoadedVersion = 0;
+    std::unordered_map<std::string, RecordMeta> mRecords;
+    std::string mBuffer;
+};
+
+} // namespace logtail
@@ -38,8 +38,15 @@ DEFINE_FLAG_INT32(mem_check_point_time_out, "seconds", 7200);
 DEFINE_FLAG_INT32(check_point_check_interval, "default 15 min", 14 * 60);
 DEFINE_FLAG_INT32(check_point_version, "now check point version xx.xx.xx such as 0.1.0 is 100", 200);
 DEFINE_FLAG_INT32(check_point_dump_interval, "default 15 min", 15 * 60);
+DEFINE_FLAG_INT32(binary_check_point_dump_interval,
+                  "seconds, only changed checkpoints are dumped when enable_binary_checkpoint is true",
+                  5);
 DEFINE_FLAG_INT32(check_point_max_count, "max check point count", 100000);
 DEFINE_FLAG_INT32(checkpoint_find_max_file_count, "", 1000);
+DEFINE_FLAG_BOOL(enable_binary_checkpoint,
+                 "dump checkpoints in binary format incrementally, json checkpoint is migrated on load. Versions "
+                 "before the binary format only read json checkpoint, so do not enable it if rollback is possible",
+                 false);
 
 namespace logtail {
 
@@ -48,18 +55,18 @@ bool CheckPointManager::CheckVersion() {
 }
 
 void CheckPointManager::AddCheckPoint(CheckPoint* checkPointPtr) {
-    DevInodeCheckPointHashMap::iterator it
-        = mDevInodeCheckPointPtrMap.find(CheckPointKey(checkPointPtr->mDevInode, checkPointPtr->mConfigName));
-    if (it != mDevInodeCheckPointPtrMap.end())
-        mDevInodeCheckPointPtrMap.erase(it);
-    mDevInodeCheckPointPtrMap.insert(std::make_pair<CheckPointKey, CheckPointPtr>(
-        CheckPointKey(checkPointPtr->mDevInode, checkPointPtr->mConfigName), CheckPointPtr(checkPointPtr)));
+    CheckPointKey key(checkPointPtr->mDevInode, checkPointPtr->mConfigName);
+    checkPointPtr->mRefreshTime = time(NULL);
+    mDevInodeCheckPointPtrMap[key] = CheckPointPtr(checkPointPtr);
+    mDirtyCheckPoints.insert(key);
 }
 
 void CheckPointManager::DeleteCheckPoint(DevInode devInode, const std::string& configName) {
     DevInodeCheckPointHashMap::iterator it = mDevInodeCheckPointPtrMap.find(CheckPointKey(devInode, configName));
-    if (it != mDevInodeCheckPointPtrMap.end())
+    if (it != mDevInodeCheckPointPtrMap.end()) {
+        mDirtyCheckPoints.insert(it->first);
         mDevInodeCheckPointPtrMap.erase(it);
+    }
 }
 
 bool CheckPointManager::GetCheckPoint(DevInode devInode, const std::string& configName, CheckPointPtr& checkPointPtr) {
@@ -73,8 +80,10 @@ bool CheckPointManager::GetCheckPoint(DevInode devInode, const std::string& conf
 
 void CheckPointManager::DeleteDirCheckPoint(const std::string& filename) {
     std::unordered_map<std::string, DirCheckPointPtr>::iterator it = mDirNameMap.find(filename);
-    if (it != mDirNameMap.end())
+    if (it != mDirNameMap.end()) {
+        mDirtyDirCheckPoints.insert(it->first);
         mDirNameMap.erase(it);
+    }
 }
 
 bool CheckPointManager::GetDirCheckPoint(const std::string& dirname, DirCheckPointPtr& dirCheckPointPtr) {
@@ -87,10 +96,12 @@ bool CheckPointManager::GetDirCheckPoint(const std::string& dirname, DirCheckPoi
 }
 
 bool CheckPointManager::NeedDump(int32_t curTime) {
+    // binary dumps only write changed checkpoints, so they can be done much more often
+    int32_t interval = BOOL_FLAG(enable_binary_checkpoint) ? INT32_FLAG(binary_check_point_dump_interval)
+                                                           : INT32_FLAG(check_point_dump_interval);
     // random 60 second to protect burst
     // remember "+1", to avoid mod 0 which will cause SIGFPE
-    return curTime - mLastDumpTime
-        > rand() % (INT32_FLAG(check_point_dump_interval) / 15 + 1) + INT32_FLAG(check_point_dump_interval);
+    return curTime - mLastDumpTime > rand() % (interval / 15 + 1) + interval;
 }
 
 void CheckPointManager::ResetLastDumpTime() {
@@ -117,9 +128,22 @@ void CheckPointManager::AddDirCheckPoint(const string& dirname) {
         mDirNameMap.insert(make_pair(parent, DirCheckPointPtr(ptr)));
     } else
         ptr = it->second.get();
-    ptr->mSubDir.insert(dirname);
+    if (ptr->mSubDir.insert(dirname).second) {
+        mDirtyDirCheckPoints.insert(parent);
+    }
 }
 void CheckPointManager::LoadCheckPoint() {
+    // load the other format if the preferred one does not exist, so that checkpoints are migrated on the next dump
+    if (BOOL_FLAG(enable_binary_checkpoint)) {
+        if (!LoadBinaryCheckPoint()) {
+            LoadJsonCheckPoint();
+        }
+    } else if (!LoadJsonCheckPoint()) {
+        LoadBinaryCheckPoint();
+    }
+}
+
+bool CheckPointManager::LoadJsonCheckPoint() {
     Json::Value root;
     ParseConfResult cptRes = ParseConfig(AppConfig::GetInstance()->GetCheckPointFilePath(), root);
     // if new checkpoint file not exist, check old checkpoint file.
@@ -136,7 +160,7 @@ void CheckPointManager::LoadCheckPoint() {
                        AppConfig::GetInstance()->GetCheckPointFilePath()));
             LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "content of check point file is not valid json");
         }
-        return;
+        return cptRes != CONFIG_NOT_EXIST;
     }
     if (root.isMember("version")) {
         mLoadVersion = root["version"].asUInt();
@@ -149,6 +173,7 @@ void CheckPointManager::LoadCheckPoint() {
     LOG_INFO(sLogger,
              ("load checkpoint, version", mLoadVersion)("file check point", mDevInodeCheckPointPtrMap.size())(
                  "dir check point", mDirNameMap.size()));
+    return true;
 }
 
 void CheckPointManager::LoadDirCheckPoint(const Json::Value& root) {
@@ -307,7 +332,6 @@ void CheckPointManager::LoadFileCheckPoint(const Json::Value& root) {
 bool CheckPointManager::DumpCheckPointToLocal() {
     mLastDumpTime = time(NULL);
     string checkPointFile = AppConfig::GetInstance()->GetCheckPointFilePath();
-    string checkPointTempFile = checkPointFile + ".bak";
 
     if (!Mkdirs(ParentPath(checkPointFile))) {
         LOG_ERROR(sLogger, ("open check point file dir error", checkPointFile));
@@ -315,6 +339,31 @@ bool CheckPointManager::DumpCheckPointToLocal() {
         return false;
     }
 
+    if (BOOL_FLAG(enable_binary_checkpoint)) {
+        if (!DumpBinaryCheckPoint()) {
+            return false;
+        }
+        // checkpoints have been migrated to binary format
+        if (CheckExistance(checkPointFile)) {
+            remove(checkPointFile.c_str());
+        }
+        return true;
+    }
+    if (!DumpJsonCheckPoint(checkPointFile)) {
+        return false;
+    }
+    mCheckPointLogStore.SetFilePath(GetBinaryCheckPointFilePath());
+    if (mCheckPointLogStore.Exists()) {
+        mCheckPointLogStore.Remove();
+    }
+    mDumpedCheckPointPtrMap.clear();
+    mDirtyCheckPoints.clear();
+    mDirtyDirCheckPoints.clear();
+    return true;
+}
+
+bool CheckPointManager::DumpJsonCheckPoint(const string& checkPointFile) {
+    string checkPointTempFile = checkPointFile + ".bak";
     Json::Value root;
     mReaderCount = mDevInodeCheckPointPtrMap.size();
     if (mDevInodeCheckPointPtrMap.size() <= (size_t)INT32_FLAG(check_point_max_count)) {
@@ -425,6 +474,344 @@ bool CheckPointManager::DumpCheckPointToLocal() {
     return true;
 }
 
+// Binary checkpoint layout, integers are little endian.
+// file checkpoint:
+//  key: 'f' dev(u64) inode(u64) config_name
+//  value: dev(u64) inode(u64) offset(i64) sig_hash(u64) sig_size(u32) update_time(i32) flags(u8) config_name
+//         file_name real_file_name, where strings are prefixed by their size(u32).
+// dir checkpoint:
+//  key: 'd' dir_name
+//  value: update_time(i32) sub_dir_count(u32) sub_dir...
+// dump time, which dir checkpoints are regarded as updated at since they are not rewritten on each dump:
+//  key: 't'
+//  value: dump_time(i32)
+static const char kFileCheckPointKeyPrefix = 'f';
+static const char kDirCheckPointKeyPrefix = 'd';
+static const string kDumpTimeKey = "t";
+static const uint8_t kFileOpenFlag = 0x1;
+static const uint8_t kContainerStoppedFlag = 0x2;
+static const uint8_t kLastForceReadFlag = 0x4;
+
+static void AppendFixed(string& buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static void AppendSizedString(string& buf, const string& str) {
+    AppendFixed(buf, str.size(), 4);
+    buf.append(str);
+}
+
+namespace {
+
+class BinaryReader {
+public:
+    explicit BinaryReader(const string& data) : mData(data) {}
+
+    uint64_t ReadFixed(size_t bytes) {
+        if (mData.size() - mPos < bytes) {
+            mIsValid = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(mData[mPos + i])) << (8 * i);
+        }
+        mPos += bytes;
+        return value;
+    }
+
+    string ReadSizedString() {
+        size_t size = ReadFixed(4);
+        if (!mIsValid || mData.size() - mPos < size) {
+            mIsValid = false;
+            return string();
+        }
+        mPos += size;
+        return mData.substr(mPos - size, size);
+    }
+
+    bool IsValid() const { return mIsValid; }
+
+private:
+    const string& mData;
+    size_t mPos = 0;
+    bool mIsValid = true;
+};
+
+} // namespace
+
+static void EncodeFileCheckPointKey(const CheckPoint& cpt, string& key) {
+    key.clear();
+    key.push_back(kFileCheckPointKeyPrefix);
+    AppendFixed(key, cpt.mDevInode.dev, 8);
+    AppendFixed(key, cpt.mDevInode.inode, 8);
+    key.append(cpt.mConfigName);
+}
+
+static void EncodeFileCheckPointValue(const CheckPoint& cpt, string& value) {
+    value.clear();
+    AppendFixed(value, cpt.mDevInode.dev, 8);
+    AppendFixed(value, cpt.mDevInode.inode, 8);
+    AppendFixed(value, static_cast<uint64_t>(cpt.mOffset), 8);
+    AppendFixed(value, cpt.mSignatureHash, 8);
+    AppendFixed(value, cpt.mSignatureSize, 4);
+    AppendFixed(value, static_cast<uint32_t>(cpt.mLastUpdateTime), 4);
+    uint8_t flags = (cpt.mFileOpenFlag ? kFileOpenFlag : 0) | (cpt.mContainerStopped ? kContainerStoppedFlag : 0)
+        | (cpt.mLastForceRead ? kLastForceReadFlag : 0);
+    AppendFixed(value, flags, 1);
+    AppendSizedString(value, cpt.mConfigName);
+    AppendSizedString(value, cpt.mFileName);
+    AppendSizedString(value, cpt.mRealFileName);
+}
+
+// whether all fields in the binary value are equal
+static bool IsSameFileCheckPoint(const CheckPoint& lhs, const CheckPoint& rhs) {
+    return lhs.mDevInode == rhs.mDevInode && lhs.mOffset == rhs.mOffset && lhs.mSignatureHash == rhs.mSignatureHash
+        && lhs.mSignatureSize == rhs.mSignatureSize && lhs.mLastUpdateTime == rhs.mLastUpdateTime
+        && lhs.mFileOpenFlag == rhs.mFileOpenFlag && lhs.mContainerStopped == rhs.mContainerStopped
+        && lhs.mLastForceRead == rhs.mLastForceRead && lhs.mConfigName == rhs.mConfigName
+        && lhs.mFileName == rhs.mFileName && lhs.mRealFileName == rhs.mRealFileName;
+}
+
+static CheckPoint* DecodeFileCheckPoint(const string& value) {
+    BinaryReader reader(value);
+    DevInode devInode;
+    devInode.dev = reader.ReadFixed(8);
+    devInode.inode = reader.ReadFixed(8);
+    int64_t offset = static_cast<int64_t>(reader.ReadFixed(8));
+    uint64_t sigHash = reader.ReadFixed(8);
+    uint32_t sigSize = static_cast<uint32_t>(reader.ReadFixed(4));
+    int32_t updateTime = static_cast<int32_t>(reader.ReadFixed(4));
+    uint8_t flags = static_cast<uint8_t>(reader.ReadFixed(1));
+    string configName = reader.ReadSizedString();
+    string fileName = reader.ReadSizedString();
+    string realFileName = reader.ReadSizedString();
+    if (!reader.IsValid()) {
+        return nullptr;
+    }
+    CheckPoint* ptr = new CheckPoint(fileName,
+                                     offset,
+                                     sigSize,
+                                     sigHash,
+                                     devInode,
+                                     configName,
+                                     realFileName,
+                                     (flags & kFileOpenFlag) != 0,
+                                     (flags & kContainerStoppedFlag) != 0,
+                                     (flags & kLastForceReadFlag) != 0);
+    ptr->mLastUpdateTime = updateTime;
+    return ptr;
+}
+
+static void EncodeDirCheckPoint(const string& dirName, const DirCheckPoint& cpt, string& key, string& value) {
+    key.clear();
+    key.push_back(kDirCheckPointKeyPrefix);
+    key.append(dirName);
+
+    value.clear();
+    AppendFixed(value, static_cast<uint32_t>(cpt.mUpdateTime), 4);
+    AppendFixed(value, cpt.mSubDir.size(), 4);
+    for (const auto& subDir : cpt.mSubDir) {
+        AppendSizedString(value, subDir);
+    }
+}
+
+static DirCheckPoint* DecodeDirCheckPoint(const string& dirName, const string& value) {
+    BinaryReader reader(value);
+    int32_t updateTime = static_cast<int32_t>(reader.ReadFixed(4));
+    uint32_t subDirCnt = static_cast<uint32_t>(reader.ReadFixed(4));
+    unique_ptr<DirCheckPoint> ptr(new DirCheckPoint(dirName));
+    ptr->mUpdateTime = updateTime;
+    for (uint32_t i = 0; i < subDirCnt && reader.IsValid(); ++i) {
+        ptr->mSubDir.insert(reader.ReadSizedString());
+    }
+    if (!reader.IsValid()) {
+        return nullptr;
+    }
+    return ptr.release();
+}
+
+string CheckPointManager::GetBinaryCheckPointFilePath() const {
+    return AppConfig::GetInstance()->GetCheckPointFilePath() + ".bin";
+}
+
+bool CheckPointManager::LoadBinaryCheckPoint() {
+    mCheckPointLogStore.SetFilePath(GetBinaryCheckPointFilePath());
+    unordered_map<string, string> records;
+    int32_t version = NO_CHECKPOINT_VERSION;
+    if (!mCheckPointLogStore.Load(records, version)) {
+        LOG_INFO(sLogger, ("no binary check point file to load", mCheckPointLogStore.GetFilePath()));
+        return false;
+    }
+    mLoadVersion = version;
+    int32_t minDirUpdateTime = time(NULL) - INT32_FLAG(file_check_point_time_out);
+    int32_t dumpTime = 0;
+    auto dumpTimeIt = records.find(kDumpTimeKey);
+    if (dumpTimeIt != records.end()) {
+        dumpTime = static_cast<int32_t>(BinaryReader(dumpTimeIt->second).ReadFixed(4));
+    }
+    for (const auto& record : records) {
+        if (record.first.empty()) {
+            continue;
+        }
+        if (record.first[0] == kFileCheckPointKeyPrefix) {
+            CheckPoint* ptr = DecodeFileCheckPoint(record.second);
+            if (ptr == nullptr) {
+                LOG_ERROR(sLogger, ("failed to parse file checkpoint", "invalid binary data"));
+                LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "failed to parse binary file checkpoint");
+                continue;
+            }
+            if (!ptr->mDevInode.IsValid()) {
+                LOG_WARNING(sLogger, ("can not find check point dev inode, discard it", ptr->mFileName));
+                delete ptr;
+                continue;
+            }
+            AddCheckPoint(ptr);
+        } else if (record.first[0] == kDirCheckPointKeyPrefix) {
+            string dirName = record.first.substr(1);
+            DirCheckPoint* ptr = DecodeDirCheckPoint(dirName, record.second);
+            if (ptr == nullptr) {
+                LOG_ERROR(sLogger, ("failed to parse dir checkpoint", "invalid binary data"));
+                LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "failed to parse binary dir checkpoint");
+                continue;
+            }
+            if (max(ptr->mUpdateTime, dumpTime) < minDirUpdateTime) {
+                LOG_INFO(sLogger,
+                         ("load timeout dir check point, ignore", dirName)(ToString(ptr->mUpdateTime), time(NULL)));
+                delete ptr;
+                continue;
+            }
+            mDirNameMap.insert(make_pair(dirName, DirCheckPointPtr(ptr)));
+        }
+    }
+    // the loaded checkpoints are what the binary log holds
+    mDumpedCheckPointPtrMap = mDevInodeCheckPointPtrMap;
+    mDirtyCheckPoints.clear();
+    mDirtyDirCheckPoints.clear();
+    mNeedFullDump = false;
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    LOG_INFO(sLogger,
+             ("load binary checkpoint, version", mLoadVersion)("file check point", mDevInodeCheckPointPtrMap.size())(
+                 "dir check point", mDirNameMap.size()));
+    return true;
+}
+
+bool CheckPointManager::DumpBinaryCheckPoint() {
+    mCheckPointLogStore.SetFilePath(GetBinaryCheckPointFilePath());
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    // only the checkpoints added or deleted since the last dump are written, unless the log is to be compacted, or some
+    // checkpoints are removed without being tracked or dropped due to the count limit
+    bool isIncremental = !mNeedFullDump && mDevInodeCheckPointPtrMap.size() <= (size_t)INT32_FLAG(check_point_max_count)
+        && mCheckPointLogStore.BeginIncrementalDump(INT32_FLAG(check_point_version));
+    if (!isIncremental && !mCheckPointLogStore.BeginDump(INT32_FLAG(check_point_version))) {
+        mCheckPointLogStore.EndDump();
+        LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "open check point file failed");
+        return false;
+    }
+
+    string key, value;
+    if (isIncremental) {
+        // a checkpoint added again by a reader may be the same as the one dumped last time
+        for (const auto& cptKey : mDirtyCheckPoints) {
+            auto it = mDevInodeCheckPointPtrMap.find(cptKey);
+            auto dumpedIt = mDumpedCheckPointPtrMap.find(cptKey);
+            if (it == mDevInodeCheckPointPtrMap.end()) {
+                if (dumpedIt != mDumpedCheckPointPtrMap.end()) {
+                    EncodeFileCheckPointKey(*dumpedIt->second, key);
+                    mCheckPointLogStore.Delete(key);
+                    mDumpedCheckPointPtrMap.erase(dumpedIt);
+                }
+                continue;
+            }
+            if (dumpedIt != mDumpedCheckPointPtrMap.end()
+                && (dumpedIt->second == it->second || IsSameFileCheckPoint(*dumpedIt->second, *it->second))) {
+                continue;
+            }
+            EncodeFileCheckPointKey(*it->second, key);
+            EncodeFileCheckPointValue(*it->second, value);
+            mCheckPointLogStore.Put(key, value);
+            mDumpedCheckPointPtrMap[cptKey] = it->second;
+        }
+        for (const auto& dirName : mDirtyDirCheckPoints) {
+            auto it = mDirNameMap.find(dirName);
+            if (it == mDirNameMap.end()) {
+                key.clear();
+                key.push_back(kDirCheckPointKeyPrefix);
+                key.append(dirName);
+                mCheckPointLogStore.Delete(key);
+                continue;
+            }
+            EncodeDirCheckPoint(dirName, *it->second, key, value);
+            mCheckPointLogStore.Put(key, value);
+        }
+    } else {
+        // a checkpoint is known to be unchanged only if it equals the one dumped last time
+        DevInodeCheckPointHashMap dumpedCheckPointPtrMap;
+        auto dumpFileCheckPoint = [&](const CheckPointKey& cptKey, const CheckPointPtr& cpt) {
+            EncodeFileCheckPointKey(*cpt, key);
+            auto it = mDumpedCheckPointPtrMap.find(cptKey);
+            bool isDirty = it == mDumpedCheckPointPtrMap.end()
+                || (it->second != cpt && !IsSameFileCheckPoint(*it->second, *cpt));
+            if (isDirty || !mCheckPointLogStore.Keep(key)) {
+                EncodeFileCheckPointValue(*cpt, value);
+                mCheckPointLogStore.Put(key, value);
+            }
+            dumpedCheckPointPtrMap.emplace(cptKey, cpt);
+        };
+        if (mDevInodeCheckPointPtrMap.size() <= (size_t)INT32_FLAG(check_point_max_count)) {
+            for (const auto& item : mDevInodeCheckPointPtrMap) {
+                dumpFileCheckPoint(item.first, item.second);
+            }
+        } else {
+            vector<CheckPoint*> sortedCheckPointVec;
+            for (const auto& item : mDevInodeCheckPointPtrMap) {
+                sortedCheckPointVec.push_back(item.second.get());
+            }
+            sort(sortedCheckPointVec.begin(),
+                 sortedCheckPointVec.end(),
+                 CheckPointManager::CheckPointCmpByUpdateTime);
+            for (int32_t i = 0; i < INT32_FLAG(check_point_max_count); ++i) {
+                CheckPointKey cptKey(sortedCheckPointVec[i]->mDevInode, sortedCheckPointVec[i]->mConfigName);
+                dumpFileCheckPoint(cptKey, mDevInodeCheckPointPtrMap[cptKey]);
+            }
+            LOG_WARNING(sLogger, ("Too many check point", mDevInodeCheckPointPtrMap.size()));
+            LogtailAlarm::GetInstance()->SendAlarm(
+                CHECKPOINT_ALARM, "Too many check point:" + ToString(mDevInodeCheckPointPtrMap.size()));
+        }
+        for (const auto& item : mDirNameMap) {
+            key.clear();
+            key.push_back(kDirCheckPointKeyPrefix);
+            key.append(item.first);
+            if (mDirtyDirCheckPoints.find(item.first) == mDirtyDirCheckPoints.end()
+                && mCheckPointLogStore.Keep(key)) {
+                continue;
+            }
+            EncodeDirCheckPoint(item.first, *item.second, key, value);
+            mCheckPointLogStore.Put(key, value);
+        }
+        mDumpedCheckPointPtrMap.swap(dumpedCheckPointPtrMap);
+    }
+    value.clear();
+    AppendFixed(value, static_cast<uint32_t>(mLastDumpTime), 4);
+    mCheckPointLogStore.Put(kDumpTimeKey, value);
+    // on failure, the whole log is rewritten next time, so the dumped state need not be accurate
+    mDirtyCheckPoints.clear();
+    mDirtyDirCheckPoints.clear();
+    mNeedFullDump = false;
+
+    if (!mCheckPointLogStore.EndDump()) {
+        LOG_ERROR(sLogger, ("dump check point to file failed", mCheckPointLogStore.GetFilePath()));
+        LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "dump check point to file failed");
+        return false;
+    }
+    LOG_DEBUG(sLogger,
+              ("dump binary checkpoint, version", INT32_FLAG(check_point_version))("incremental", isIncremental)(
+                  "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
+    return true;
+}
+
 int32_t CheckPointManager::GetReaderCount() {
     return mReaderCount;
 }
@@ -467,6 +854,44 @@ void CheckPointManager::CheckTimeoutCheckPoint() {
 void CheckPointManager::RemoveAllCheckPoint() {
     mDirNameMap.clear();
     mDevInodeCheckPointPtrMap.clear();
+    mDirtyCheckPoints.clear();
+    mDirtyDirCheckPoints.clear();
+    mNeedFullDump = true;
+}
+
+void CheckPointManager::RemoveStaleCheckPoint(int32_t curTime,
+                                              const std::function<bool(const std::string&)>& isDirWatched) {
+    if (curTime - mLastCheckTime < INT32_FLAG(check_point_check_interval)) {
+        return;
+    }
+    mLastCheckTime = curTime;
+    // checkpoints not reported by readers, i.e., those of removed readers and loaded ones not claimed yet, are kept for
+    // a dump interval, as they were when all checkpoints were removed after each dump
+    for (auto it = mDevInodeCheckPointPtrMap.begin(); it != mDevInodeCheckPointPtrMap.end();) {
+        if (curTime - it->second->mRefreshTime > INT32_FLAG(check_point_dump_interval)) {
+            mDirtyCheckPoints.insert(it->first);
+            it = mDevInodeCheckPointPtrMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = mDirNameMap.begin(); it != mDirNameMap.end();) {
+        auto& subDirs = it->second->mSubDir;
+        for (auto subIt = subDirs.begin(); subIt != subDirs.end();) {
+            if (isDirWatched(*subIt)) {
+                ++subIt;
+            } else {
+                mDirtyDirCheckPoints.insert(it->first);
+                subIt = subDirs.erase(subIt);
+            }
+        }
+        if (subDirs.empty()) {
+            mDirtyDirCheckPoints.insert(it->first);
+            it = mDirNameMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 boost::optional<std::string> SearchFilePathByDevInodeInDirectory(const std::string& baseDirPath,
@@ -16,12 +16,15 @@
 
 #pragma once
 #include <string>
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <set>
 #include <ctime>
 #include <json/json.h>
 #include <boost/optional.hpp>
+#include "checkpoint/CheckPointLogStore.h"
 #include "common/DevInode.h"
 #include "common/EncodingConverter.h"
 #include "common/SplitedFilePath.h"
@@ -43,6 +46,8 @@ public:
     bool mFileOpenFlag = false;
     bool mContainerStopped = false;
     bool mLastForceRead = false;
+    // the last time a reader reported this checkpoint, not dumped
+    int32_t mRefreshTime = 0;
     std::string mCache;
     std::string mConfigName;
     std::string mFileName;
@@ -114,9 +119,25 @@ private:
     int32_t mLastDumpTime;
     int32_t mLoadVersion;
     int32_t mReaderCount;
+    // binary checkpoints, only changed checkpoints are written on dump
+    CheckPointLogStore mCheckPointLogStore;
+    // file checkpoints in the binary log, against which the current ones are compared to find the changed ones
+    DevInodeCheckPointHashMap mDumpedCheckPointPtrMap;
+    // file checkpoints added or deleted since the last binary dump
+    std::set<CheckPointKey> mDirtyCheckPoints;
+    // dir checkpoints modified since the last binary dump
+    std::unordered_set<std::string> mDirtyDirCheckPoints;
+    // checkpoints are removed without being tracked, so the next binary dump must write all of them
+    bool mNeedFullDump = false;
     CheckPointManager()
         : mLastCheckTime(time(NULL)), mLastDumpTime(time(NULL)), mLoadVersion(NO_CHECKPOINT_VERSION), mReaderCount(0) {}
 
+    bool LoadJsonCheckPoint();
+    bool LoadBinaryCheckPoint();
+    bool DumpJsonCheckPoint(const std::string& checkPointFile);
+    bool DumpBinaryCheckPoint();
+    std::string GetBinaryCheckPointFilePath() const;
+
 public:
     bool CheckVersion();
     void AddCheckPoint(CheckPoint* checkPointPtr);
@@ -131,6 +152,9 @@ public:
     bool GetCheckPoint(DevInode devInode, const std::string& configName, CheckPointPtr& checkPointPtr);
     bool GetDirCheckPoint(const std::string& filename, DirCheckPointPtr& checkPointPtr);
     void RemoveAllCheckPoint();
+    // Remove file checkpoints not reported by any reader for a dump interval, and sub dirs no longer watched. It takes
+    // the place of RemoveAllCheckPoint when checkpoints are dumped in binary format.
+    void RemoveStaleCheckPoint(int32_t curTime, const std::function<bool(const std::string&)>& isDirWatched);
     void CheckTimeoutCheckPoint();
     bool NeedDump(int32_t curTime);
     void ResetLastDumpTime();
@@ -147,6 +171,7 @@ public:
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ConfigUpdatorUnittest;
+    friend class CheckpointManagerUnittest;
     void RemoveLocalCheckPoint();
     void PrintStatus();
 #endif
@@ -0,0 +1,76 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/AdaptiveConcurrencyLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace logtail {
+
+AdaptiveConcurrencyLimiter::AdaptiveConcurrencyLimiter(int32_t minLimit, int32_t maxLimit) {
+    SetLimitRange(minLimit, maxLimit);
+    mLimit = mMaxLimit;
+}
+
+void AdaptiveConcurrencyLimiter::SetLimitRange(int32_t minLimit, int32_t maxLimit) {
+    mMinLimit = max(minLimit, 1);
+    mMaxLimit = max(maxLimit, mMinLimit);
+    mLimit = min(max(mLimit, static_cast<double>(mMinLimit)), static_cast<double>(mMaxLimit));
+}
+
+void AdaptiveConcurrencyLimiter::OnSendDone(bool success, int64_t rttInUs) {
+    // requests may be started without being counted, e.g., when flushing on exit
+    if (mInFlight > 0) {
+        --mInFlight;
+    }
+    if (!success || rttInUs <= 0) {
+        return;
+    }
+    mMinRtt = mMinRtt == 0 ? rttInUs : min(mMinRtt, static_cast<double>(rttInUs));
+    mWindowRttSum += rttInUs;
+    mWindowMaxInFlight = max(mWindowMaxInFlight, mInFlight + 1);
+    // the limit is updated once per round, i.e., after about limit requests are done, since requests done in the same
+    // round share the same congestion state
+    if (++mWindowSampleCnt < GetLimit()) {
+        return;
+    }
+    double rtt = mWindowRttSum / mWindowSampleCnt;
+    double gradient = max(0.5, min(1.0, kRttTolerance * mMinRtt / rtt));
+    double newLimit = mLimit * gradient;
+    // the limit is not increased unless it is nearly used up, otherwise it grows without any feedback
+    if (gradient >= 1.0 && mWindowMaxInFlight * 2 >= mLimit) {
+        newLimit += sqrt(mLimit) * kIncreaseRatio;
+    }
+    mLimit = min(max(newLimit, static_cast<double>(mMinLimit)), static_cast<double>(mMaxLimit));
+    // the min latency drifts up slowly, so that it follows the change of network path
+    mMinRtt *= 1 + kMinRttDrift;
+    mWindowRttSum = 0;
+    mWindowSampleCnt = 0;
+    mWindowMaxInFlight = 0;
+}
+
+void AdaptiveConcurrencyLimiter::OnOverload(int64_t curTimeInUs) {
+    // all requests in flight may fail at the same time, which should be regarded as one congestion signal
+    if (curTimeInUs - mLastBackoffTime < static_cast<int64_t>(mMinRtt)) {
+        return;
+    }
+    mLastBackoffTime = curTimeInUs;
+    mLimit = max(mLimit * kBackoffRatio, static_cast<double>(mMinLimit));
+}
+
+} // namespace logtail
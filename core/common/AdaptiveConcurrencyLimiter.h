@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace logtail {
+
+// Limit of requests in flight adjusted by the results of finished requests. Once per round, the limit grows while the
+// latency stays close to the min latency, and shrinks with the latency gradient once requests start to queue up at the
+// server. It is halved on server errors, network errors or quota exceeding. Not thread-safe.
+class AdaptiveConcurrencyLimiter {
+public:
+    AdaptiveConcurrencyLimiter(int32_t minLimit, int32_t maxLimit);
+
+    void SetLimitRange(int32_t minLimit, int32_t maxLimit);
+
+    bool IsValidToSend() const { return mInFlight < GetLimit(); }
+    int32_t GetLimit() const { return static_cast<int32_t>(mLimit); }
+    int32_t GetInFlight() const { return mInFlight; }
+    int32_t GetAvailable() const { return IsValidToSend() ? GetLimit() - mInFlight : 0; }
+
+    void OnSendStart(int32_t cnt = 1) { mInFlight += cnt; }
+    // should be called exactly once for each request started, no matter how many times it is retried
+    void OnSendDone(bool success, int64_t rttInUs);
+    // called on server error, network error or quota exceeding, which can be called for each failed try since the
+    // limit is decreased at most once per round trip
+    void OnOverload(int64_t curTimeInUs);
+
+private:
+    static constexpr double kMinRttDrift = 0.0001;
+    static constexpr double kIncreaseRatio = 0.2;
+    static constexpr double kRttTolerance = 1.5;
+    static constexpr double kBackoffRatio = 0.5;
+
+    int32_t mMinLimit = 1;
+    int32_t mMaxLimit = 1;
+    double mLimit = 1;
+    int32_t mInFlight = 0;
+
+    double mMinRtt = 0;
+    double mWindowRttSum = 0;
+    int32_t mWindowSampleCnt = 0;
+    int32_t mWindowMaxInFlight = 0;
+    int64_t mLastBackoffTime = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class AdaptiveConcurrencyLimiterUnittest;
+#endif
+};
+
+} // namespace logtail
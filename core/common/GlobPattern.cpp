@@ -0,0 +1,103 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/GlobPattern.h"
+
+#if defined(__linux__)
+#include <fnmatch.h>
+#endif
+
+#include "common/StringTools.h"
+
+using namespace std;
+
+namespace logtail {
+
+GlobPattern::GlobPattern(const string& pattern, bool matchPathName)
+    : mPattern(pattern), mMatchPathName(matchPathName) {
+#if defined(__linux__)
+    if (mPattern.find_first_of("[\\") != string::npos) {
+        mType = Type::FNMATCH;
+    } else if (mPattern.find_first_of("*?") == string::npos) {
+        mType = Type::LITERAL;
+    } else if (mPattern == "*" && !mMatchPathName) {
+        mType = Type::ANY;
+    } else {
+        mType = Type::WILDCARD;
+    }
+#else
+    mType = Type::FNMATCH;
+#endif
+}
+
+bool GlobPattern::Match(StringView str) const {
+    switch (mType) {
+        case Type::LITERAL:
+            return str == mPattern;
+        case Type::ANY:
+            return true;
+        case Type::WILDCARD:
+            break;
+        case Type::FNMATCH:
+            return fnmatch(mPattern.c_str(), string(str.data(), str.size()).c_str(), mMatchPathName ? FNM_PATHNAME : 0)
+                == 0;
+    }
+    if (!mMatchPathName) {
+        return MatchWildcard(mPattern, str);
+    }
+    // with FNM_PATHNAME, every slash in str must be matched by a slash in the pattern, so the pattern and str are
+    // matched component by component
+    StringView pattern(mPattern);
+    while (true) {
+        size_t patternPos = pattern.find('/');
+        size_t strPos = str.find('/');
+        if ((patternPos == StringView::npos) != (strPos == StringView::npos)) {
+            return false;
+        }
+        if (patternPos == StringView::npos) {
+            return MatchWildcard(pattern, str);
+        }
+        if (!MatchWildcard(pattern.substr(0, patternPos), str.substr(0, strPos))) {
+            return false;
+        }
+        pattern.remove_prefix(patternPos + 1);
+        str.remove_prefix(strPos + 1);
+    }
+}
+
+// backtracks to the last * only, which takes linear time in most cases
+bool GlobPattern::MatchWildcard(StringView pattern, StringView str) {
+    size_t p = 0, s = 0;
+    size_t starP = StringView::npos, starS = 0;
+    while (s < str.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starS = s;
+        } else if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s])) {
+            ++p;
+            ++s;
+        } else if (starP != StringView::npos) {
+            p = starP + 1;
+            s = ++starS;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+} // namespace logtail
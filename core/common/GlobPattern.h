@@ -0,0 +1,46 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Glob pattern parsed once for repeated matching, which gives the same result as fnmatch with flags 0, or
+// FNM_PATHNAME if matchPathName is true. Patterns consisting of * and ? only are matched natively, while those with
+// brackets or escapes, as well as all patterns on Windows, fall back to fnmatch.
+class GlobPattern {
+public:
+    GlobPattern() = default;
+    GlobPattern(const std::string& pattern, bool matchPathName);
+
+    bool Match(StringView str) const;
+    const std::string& GetPattern() const { return mPattern; }
+
+private:
+    enum class Type { LITERAL, ANY, WILDCARD, FNMATCH };
+
+    static bool MatchWildcard(StringView pattern, StringView str);
+
+    std::string mPattern;
+    bool mMatchPathName = false;
+    Type mType = Type::LITERAL;
+};
+
+} // namespace logtail
@@ -0,0 +1,302 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/JsonScanner.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace logtail {
+
+// quote and backslash first, followed by structural chars
+static const char kBlockChars[] = {'"', '\\', '{', '}', '[', ']', ':', ','};
+static const size_t kBlockCharCnt = sizeof(kBlockChars);
+
+static inline bool IsJsonSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool IsBlank(const char* data, size_t begin, size_t end) {
+    for (; begin < end; ++begin) {
+        if (!IsJsonSpace(data[begin])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Only literals whose text is the same as that converted from the parsed value are supported, i.e. booleans and
+// integers in canonical form which surely fit in int64. null is also supported, which is converted to empty string.
+static bool IsSupportedLiteral(StringView literal) {
+    if (literal == "true" || literal == "false" || literal == "null") {
+        return true;
+    }
+    size_t i = 0;
+    if (!literal.empty() && literal[0] == '-') {
+        ++i;
+    }
+    size_t digits = literal.size() - i;
+    if (digits == 0 || digits > 18 || (literal[i] == '0' && (digits > 1 || i > 0))) {
+        return false;
+    }
+    for (; i < literal.size(); ++i) {
+        if (literal[i] < '0' || literal[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool JsonScanner::BuildIndex(StringView data) {
+    mIndex.clear();
+    mHasBackslash = false;
+    // all ones if the previous block ends inside a string
+    uint64_t inStringCarry = 0;
+    // whether the first char of the block is escaped by the last backslash of the previous block
+    bool escapedCarry = false;
+    char tail[64];
+    for (size_t base = 0; base < data.size(); base += 64) {
+        const char* block = data.data() + base;
+        if (data.size() - base < 64) {
+            // spaces are neutral to both structural and control chars
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, data.size() - base);
+            block = tail;
+        }
+        uint64_t masks[kBlockCharCnt];
+        FindCharsInBlock(block, kBlockChars, kBlockCharCnt, masks, mLevel);
+        uint64_t quotes = masks[0], backslashes = masks[1];
+        uint64_t structurals = 0;
+        for (size_t k = 2; k < kBlockCharCnt; ++k) {
+            structurals |= masks[k];
+        }
+
+        // a backslash escapes the next char, unless it is escaped itself
+        uint64_t escaped = 0;
+        if (escapedCarry) {
+            escaped = 1;
+            backslashes &= ~1ULL;
+            escapedCarry = false;
+        }
+        if (backslashes != 0) {
+            mHasBackslash = true;
+            while (backslashes != 0) {
+                uint64_t bit = backslashes & (0 - backslashes);
+                escaped |= bit << 1;
+                escapedCarry = (bit >> 63) != 0;
+                backslashes &= ~(bit | (bit << 1));
+            }
+        }
+        quotes &= ~escaped;
+
+        // strings contain opening quotes but not closing quotes
+        uint64_t strings = PrefixXor(quotes) ^ inStringCarry;
+        inStringCarry = 0 - (strings >> 63);
+        if ((FindBytesBelowInBlock(block, 0x20, mLevel) & strings) != 0) {
+            // unescaped control chars in strings
+            return false;
+        }
+
+        uint64_t tokens = (structurals & ~strings) | quotes;
+        while (tokens != 0) {
+            mIndex.push_back(static_cast<uint32_t>(base + CountTrailingZeros64(tokens)));
+            tokens &= tokens - 1;
+        }
+    }
+    return inStringCarry == 0;
+}
+
+bool JsonScanner::Scan(StringView data, vector<Field>& fields) {
+    fields.clear();
+    if (data.size() > numeric_limits<uint32_t>::max() || !BuildIndex(data)) {
+        return false;
+    }
+
+    // Every byte between two adjacent tokens is either the content of a string, or part of a literal, or blank.
+    const char* p = data.data();
+    const size_t n = mIndex.size();
+    if (n < 2 || p[mIndex[0]] != '{' || !IsBlank(p, 0, mIndex[0])) {
+        return false;
+    }
+    size_t k = 1;
+    if (p[mIndex[k]] == '}') {
+        if (!IsBlank(p, mIndex[0] + 1, mIndex[k])) {
+            return false;
+        }
+        ++k;
+    } else {
+        while (true) {
+            // key
+            if (k + 3 >= n) {
+                return false;
+            }
+            size_t keyBegin = mIndex[k], keyEnd = mIndex[k + 1], colon = mIndex[k + 2];
+            if (p[keyBegin] != '"' || !IsBlank(p, mIndex[k - 1] + 1, keyBegin) || p[colon] != ':'
+                || !IsBlank(p, keyEnd + 1, colon)) {
+                return false;
+            }
+            Field field;
+            field.mKey = StringView(p + keyBegin + 1, keyEnd - keyBegin - 1);
+            k += 3;
+
+            // value
+            size_t valueBegin = mIndex[k];
+            if (p[valueBegin] == '"') {
+                if (k + 2 >= n || !IsBlank(p, colon + 1, valueBegin)) {
+                    return false;
+                }
+                size_t valueEnd = mIndex[k + 1];
+                field.mValue = StringView(p + valueBegin + 1, valueEnd - valueBegin - 1);
+                k += 2;
+                if (!IsBlank(p, valueEnd + 1, mIndex[k])) {
+                    return false;
+                }
+                if (mHasBackslash) {
+                    field.mKeyEscaped = memchr(field.mKey.data(), '\\', field.mKey.size()) != nullptr;
+                    field.mValueEscaped = memchr(field.mValue.data(), '\\', field.mValue.size()) != nullptr;
+                }
+            } else if (p[valueBegin] == ',' || p[valueBegin] == '}') {
+                size_t begin = colon + 1, end = valueBegin;
+                while (begin < end && IsJsonSpace(p[begin])) {
+                    ++begin;
+                }
+                while (end > begin && IsJsonSpace(p[end - 1])) {
+                    --end;
+                }
+                StringView literal(p + begin, end - begin);
+                if (!IsSupportedLiteral(literal)) {
+                    return false;
+                }
+                if (literal[0] != 'n') {
+                    field.mValue = literal;
+                }
+                if (mHasBackslash) {
+                    field.mKeyEscaped = memchr(field.mKey.data(), '\\', field.mKey.size()) != nullptr;
+                }
+            } else {
+                // nested objects and arrays, or malformed json
+                return false;
+            }
+            fields.push_back(field);
+
+            // separator
+            if (p[mIndex[k]] == '}') {
+                ++k;
+                break;
+            }
+            if (p[mIndex[k]] != ',') {
+                return false;
+            }
+            ++k;
+        }
+    }
+    return k == n && IsBlank(p, mIndex[n - 1] + 1, data.size());
+}
+
+bool JsonScanner::Unescape(StringView src, char* dst, size_t& size) {
+    const char* s = src.data();
+    const char* end = s + src.size();
+    char* d = dst;
+    while (s < end) {
+        const char* backslash = static_cast<const char*>(memchr(s, '\\', end - s));
+        size_t len = (backslash == nullptr ? end : backslash) - s;
+        if (d != s) {
+            memmove(d, s, len);
+        }
+        d += len;
+        s += len;
+        if (backslash == nullptr) {
+            break;
+        }
+        if (end - s < 2) {
+            return false;
+        }
+        switch (s[1]) {
+            case '"':
+                *d++ = '"';
+                break;
+            case '\\':
+                *d++ = '\\';
+                break;
+            case '/':
+                *d++ = '/';
+                break;
+            case 'b':
+                *d++ = '\b';
+                break;
+            case 'f':
+                *d++ = '\f';
+                break;
+            case 'n':
+                *d++ = '\n';
+                break;
+            case 'r':
+                *d++ = '\r';
+                break;
+            case 't':
+                *d++ = '\t';
+                break;
+            case 'u': {
+                if (end - s < 6) {
+                    return false;
+                }
+                uint32_t codepoint = 0;
+                for (size_t i = 2; i < 6; ++i) {
+                    int value = HexValue(s[i]);
+                    if (value < 0) {
+                        return false;
+                    }
+                    codepoint = (codepoint << 4) | value;
+                }
+                if (codepoint == 0 || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+                    return false;
+                }
+                if (codepoint < 0x80) {
+                    *d++ = static_cast<char>(codepoint);
+                } else if (codepoint < 0x800) {
+                    *d++ = static_cast<char>(0xC0 | (codepoint >> 6));
+                    *d++ = static_cast<char>(0x80 | (codepoint & 0x3F));
+                } else {
+                    *d++ = static_cast<char>(0xE0 | (codepoint >> 12));
+                    *d++ = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                    *d++ = static_cast<char>(0x80 | (codepoint & 0x3F));
+                }
+                s += 6;
+                continue;
+            }
+            default:
+                return false;
+        }
+        s += 2;
+    }
+    size = d - dst;
+    return true;
+}
+
+} // namespace logtail
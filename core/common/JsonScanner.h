@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/SimdUtil.h"
+#include "models/StringView.h"
+
+namespace logtail {
+
+// On-demand scanner of flat json objects in the style of simdjson. The first stage indexes the positions of all
+// structural chars and quotes outside strings, 64 bytes at a time with SIMD bitmasks. The second stage walks through
+// the index to locate keys and values in place, without building a DOM or copying anything.
+//
+// Only objects whose values are strings, integers, booleans or null are supported. Scan returns false for anything
+// else, including malformed json, nested values and floating point numbers, and the caller should fall back to a full
+// json parser, which also reports the error if any.
+class JsonScanner {
+public:
+    struct Field {
+        StringView mKey;
+        // content of strings without quotes, text of integers and booleans, and empty for null
+        StringView mValue;
+        // escaped strings should be unescaped by Unescape before use
+        bool mKeyEscaped = false;
+        bool mValueEscaped = false;
+    };
+
+    explicit JsonScanner(SimdLevel level = GetSupportedSimdLevel()) : mLevel(level) {}
+
+    // Fields refer to data, and are in the same order as in data.
+    bool Scan(StringView data, std::vector<Field>& fields);
+
+    // Unescape the content of a json string to dst, which should be at least src.size() bytes and may be src.data()
+    // itself. Returns false on invalid escapes, as well as on surrogates and \u0000, which are left to the full parser.
+    static bool Unescape(StringView src, char* dst, size_t& size);
+
+private:
+    bool BuildIndex(StringView data);
+
+    SimdLevel mLevel;
+    std::vector<uint32_t> mIndex;
+    bool mHasBackslash = false;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class JsonScannerUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -15,6 +15,7 @@
 #include "LogstoreSenderQueue.h"
 #include "common/Flags.h"
 #include "common/StringTools.h"
+#include "common/TimeUtil.h"
 #include "monitor/LogtailAlarm.h"
 
 
@@ -36,6 +37,9 @@ DEFINE_FLAG_INT32(client_send_concurrency_trigger,
 DEFINE_FLAG_INT32(client_send_concurrency_max, "max concurrency of one client", 512);
 DEFINE_FLAG_INT32(client_send_concurrency_max_update_time, "max update time seconds", 300);
 DEFINE_FLAG_DOUBLE(client_quota_send_retry_interval_scale, "", 2.0);
+DEFINE_FLAG_BOOL(enable_adaptive_send_concurrency,
+                 "adjust send concurrency of each logstore and region by latency and errors of finished requests",
+                 false);
 
 namespace logtail {
 
@@ -48,7 +52,8 @@ LogstoreSenderInfo::LogstoreSenderInfo()
       mQuotaRetryInterval((double)INT32_FLAG(client_quota_send_retry_interval)),
       mNetworkValidFlag(true),
       mQuotaValidFlag(true),
-      mSendConcurrency(INT32_FLAG(client_send_concurrency_max)) {
+      mSendConcurrency(INT32_FLAG(client_send_concurrency_max)),
+      mConcurrencyLimiter(INT32_FLAG(client_quota_send_concurrency_min), INT32_FLAG(client_send_concurrency_max)) {
     mSendConcurrencyUpdateTime = time(NULL);
 }
 
@@ -188,6 +193,9 @@ void LogstoreSenderInfo::SetRegion(const std::string& region) {
 }
 
 bool LogstoreSenderInfo::ConcurrencyValid() {
+    if (BOOL_FLAG(enable_adaptive_send_concurrency)) {
+        return mConcurrencyLimiter.IsValidToSend();
+    }
     if (mSendConcurrency <= 0) {
         // check consurrency update time
         int32_t nowTime = time(NULL);
@@ -199,6 +207,33 @@ bool LogstoreSenderInfo::ConcurrencyValid() {
     return mSendConcurrency > 0;
 }
 
+void LogstoreSenderInfo::ConcurrencyDec() {
+    if (BOOL_FLAG(enable_adaptive_send_concurrency)) {
+        mConcurrencyLimiter.OnSendStart();
+        return;
+    }
+    --mSendConcurrency;
+}
+
+bool LogstoreSenderInfo::RecordConcurrencyResult(SendResult rst, int64_t sendTimeInUs) {
+    if (!BOOL_FLAG(enable_adaptive_send_concurrency)) {
+        return false;
+    }
+    bool usedUp = !mConcurrencyLimiter.IsValidToSend();
+    int32_t oldLimit = mConcurrencyLimiter.GetLimit();
+    int64_t curTime = GetCurrentTimeInMicroSeconds();
+    if (rst == LogstoreSenderInfo::SendResult_NetworkFail || rst == LogstoreSenderInfo::SendResult_QuotaFail) {
+        mConcurrencyLimiter.OnOverload(curTime);
+    }
+    mConcurrencyLimiter.OnSendDone(rst == LogstoreSenderInfo::SendResult_OK, curTime - sendTimeInUs);
+    if (oldLimit != mConcurrencyLimiter.GetLimit()) {
+        LOG_DEBUG(sLogger,
+                  ("logstore send concurrency changed, region", mRegion)("from", oldLimit)(
+                      "to", mConcurrencyLimiter.GetLimit()));
+    }
+    return usedUp && mConcurrencyLimiter.IsValidToSend();
+}
+
 LogstoreSenderStatistics::LogstoreSenderStatistics() {
     Reset();
 }
@@ -22,6 +22,7 @@
 #include <unordered_map>
 
 #include "Lock.h"
+#include "common/AdaptiveConcurrencyLimiter.h"
 #include "LogGroupContext.h"
 #include "common/FeedbackInterface.h"
 #include "common/LogstoreFeedbackKey.h"
@@ -66,6 +67,7 @@ struct LoggroupTimeValue {
 
     int32_t mSendRetryTimes;
     int32_t mLastSendTime;
+    int64_t mLastSendTimeInUs;
     int32_t mLastLogWarningTime;
     std::string mAliuid;
     std::string mRegion;
@@ -102,6 +104,7 @@ struct LoggroupTimeValue {
         mEnqueueTime = lastUpdateTime;
         mSendRetryTimes = 0;
         mLastSendTime = 0;
+        mLastSendTimeInUs = 0;
         mLastLogWarningTime = 0;
         mLogData.clear();
         mShardHashKey = shardHashKey;
@@ -138,18 +141,23 @@ struct LogstoreSenderInfo {
     volatile bool mQuotaValidFlag;
     volatile int32_t mSendConcurrency;
     volatile int32_t mSendConcurrencyUpdateTime;
+    // used instead of mSendConcurrency when enable_adaptive_send_concurrency is set
+    AdaptiveConcurrencyLimiter mConcurrencyLimiter;
 
     LogstoreSenderInfo();
 
     void SetRegion(const std::string& region);
 
     bool ConcurrencyValid();
-    void ConcurrencyDec() { --mSendConcurrency; }
+    void ConcurrencyDec();
 
     bool CanSend(int32_t curTime);
     // RecordSendResult
     // @return true if need to trigger.
     bool RecordSendResult(SendResult rst, LogstoreSenderStatistics& statisticsItem);
+    // update the adaptive concurrency limit with the result of a request counted by ConcurrencyDec
+    // @return true if need to trigger, i.e., concurrency is released while it was used up.
+    bool RecordConcurrencyResult(SendResult rst, int64_t sendTimeInUs);
     // return value, recover sucess flag(if logstore is invalid before, return true, else return false)
     bool OnRegionRecover(const std::string& region);
 };
@@ -416,6 +424,7 @@ public:
 
     int32_t OnSendDone(LoggroupTimeValue* item, LogstoreSenderInfo::SendResult sendRst, bool& needTrigger) {
         needTrigger = mSenderInfo.RecordSendResult(sendRst, mSenderStatistics);
+        needTrigger |= mSenderInfo.RecordConcurrencyResult(sendRst, item->mLastSendTimeInUs);
         if (!mSenderInfo.mNetworkValidFlag) {
             LOG_WARNING(sLogger,
                         ("Network fail, pause logstore", item->mLogstore)("project", item->mProjectName)(
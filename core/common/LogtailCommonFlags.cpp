@@ -114,6 +114,9 @@ DEFINE_FLAG_INT32(monitor_interval, "program monitor interval, seconds", 30);
 // process
 DEFINE_FLAG_BOOL(ilogtail_discard_old_data, "if discard the old data flag", true);
 DEFINE_FLAG_INT32(ilogtail_discard_interval, "if the data is old than the interval, it will be discard", 43200);
+DEFINE_FLAG_BOOL(enable_json_scanner,
+                 "parse json logs with the SIMD structural index first, and fall back to the full parser if unsupported",
+                 true);
 
 // file source
 DEFINE_FLAG_BOOL(enable_root_path_collection, "", false);
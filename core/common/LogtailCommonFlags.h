@@ -53,6 +53,7 @@ DECLARE_FLAG_INT32(monitor_interval);
 // process
 DECLARE_FLAG_BOOL(ilogtail_discard_old_data);
 DECLARE_FLAG_INT32(ilogtail_discard_interval);
+DECLARE_FLAG_BOOL(enable_json_scanner);
 
 // file source
 DECLARE_FLAG_BOOL(enable_root_path_collection);
@@ -0,0 +1,256 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/SimdUtil.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LOGTAIL_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 functions are compiled for AVX2 without changing the target of the whole binary, and only called after the
+// runtime check.
+#if defined(LOGTAIL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LOGTAIL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LOGTAIL_TARGET_AVX2
+#endif
+
+namespace logtail {
+
+#ifdef LOGTAIL_SIMD_X86
+static inline uint32_t CountTrailingZeros(uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+static inline void AppendPositions(uint32_t mask, size_t base, std::vector<size_t>& positions) {
+    while (mask != 0) {
+        positions.push_back(base + CountTrailingZeros(mask));
+        mask &= mask - 1;
+    }
+}
+
+static SimdLevel DetectSimdLevel() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool hasSSE2 = (info[3] & (1 << 26)) != 0;
+    // AVX registers must be enabled by the os as well
+    bool osUsesXSave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+    bool hasAVX2 = false;
+    if (maxLeaf >= 7 && osUsesXSave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        hasAVX2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool hasSSE2 = __builtin_cpu_supports("sse2");
+    bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+    if (hasAVX2) {
+        return SimdLevel::AVX2;
+    }
+    if (hasSSE2) {
+        return SimdLevel::SSE2;
+    }
+    return SimdLevel::NONE;
+}
+
+static size_t FindAllCharPositionsSSE2(const char* data, size_t size, char c, std::vector<size_t>& positions) {
+    const __m128i target = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        AppendPositions(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target))), i, positions);
+    }
+    return i;
+}
+
+LOGTAIL_TARGET_AVX2 static size_t
+FindAllCharPositionsAVX2(const char* data, size_t size, char c, std::vector<size_t>& positions) {
+    const __m256i target = _mm256_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        uint32_t loMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, target)));
+        uint32_t hiMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, target)));
+        AppendPositions(loMask, i, positions);
+        AppendPositions(hiMask, i + 32, positions);
+    }
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        AppendPositions(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target))), i, positions);
+    }
+    return i;
+}
+
+static void FindCharsInBlockSSE2(const char* block, const char* chars, size_t charCnt, uint64_t* masks) {
+    __m128i chunks[4];
+    for (size_t j = 0; j < 4; ++j) {
+        chunks[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + j * 16));
+    }
+    for (size_t k = 0; k < charCnt; ++k) {
+        const __m128i target = _mm_set1_epi8(chars[k]);
+        uint64_t mask = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[j], target))))
+                << (j * 16);
+        }
+        masks[k] = mask;
+    }
+}
+
+static uint64_t FindBytesBelowInBlockSSE2(const char* block, unsigned char bound) {
+    // x < bound <=> max(x, bound - 1) == bound - 1 for unsigned bytes
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(bound - 1));
+    uint64_t mask = 0;
+    for (size_t j = 0; j < 4; ++j) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + j * 16));
+        mask |= static_cast<uint64_t>(
+                    static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, limit), limit))))
+            << (j * 16);
+    }
+    return mask;
+}
+
+LOGTAIL_TARGET_AVX2 static void
+FindCharsInBlockAVX2(const char* block, const char* chars, size_t charCnt, uint64_t* masks) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    for (size_t k = 0; k < charCnt; ++k) {
+        const __m256i target = _mm256_set1_epi8(chars[k]);
+        uint32_t loMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, target)));
+        uint32_t hiMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, target)));
+        masks[k] = loMask | (static_cast<uint64_t>(hiMask) << 32);
+    }
+}
+
+LOGTAIL_TARGET_AVX2 static uint64_t FindBytesBelowInBlockAVX2(const char* block, unsigned char bound) {
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(bound - 1));
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    uint32_t loMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(lo, limit), limit)));
+    uint32_t hiMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(hi, limit), limit)));
+    return loMask | (static_cast<uint64_t>(hiMask) << 32);
+}
+#else
+static SimdLevel DetectSimdLevel() {
+    return SimdLevel::NONE;
+}
+#endif
+
+SimdLevel GetSupportedSimdLevel() {
+    static const SimdLevel sLevel = DetectSimdLevel();
+    return sLevel;
+}
+
+const char* SimdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+        default:
+            return "none";
+    }
+}
+
+void FindAllCharPositions(const char* data, size_t size, char c, std::vector<size_t>& positions) {
+    FindAllCharPositions(data, size, c, positions, GetSupportedSimdLevel());
+}
+
+void FindAllCharPositions(const char* data, size_t size, char c, std::vector<size_t>& positions, SimdLevel level) {
+    if (level > GetSupportedSimdLevel()) {
+        level = GetSupportedSimdLevel();
+    }
+    size_t i = 0;
+#ifdef LOGTAIL_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        i = FindAllCharPositionsAVX2(data, size, c, positions);
+    } else if (level == SimdLevel::SSE2) {
+        i = FindAllCharPositionsSSE2(data, size, c, positions);
+    }
+#endif
+    // memchr is usually vectorized by libc on other architectures
+    while (i < size) {
+        const char* found = static_cast<const char*>(memchr(data + i, c, size - i));
+        if (found == nullptr) {
+            break;
+        }
+        i = found - data;
+        positions.push_back(i++);
+    }
+}
+
+void FindCharsInBlock(const char* block, const char* chars, size_t charCnt, uint64_t* masks, SimdLevel level) {
+    if (level > GetSupportedSimdLevel()) {
+        level = GetSupportedSimdLevel();
+    }
+#ifdef LOGTAIL_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        FindCharsInBlockAVX2(block, chars, charCnt, masks);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        FindCharsInBlockSSE2(block, chars, charCnt, masks);
+        return;
+    }
+#endif
+    for (size_t k = 0; k < charCnt; ++k) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            mask |= static_cast<uint64_t>(block[i] == chars[k]) << i;
+        }
+        masks[k] = mask;
+    }
+}
+
+uint64_t FindBytesBelowInBlock(const char* block, unsigned char bound, SimdLevel level) {
+    if (bound == 0) {
+        return 0;
+    }
+    if (level > GetSupportedSimdLevel()) {
+        level = GetSupportedSimdLevel();
+    }
+#ifdef LOGTAIL_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        return FindBytesBelowInBlockAVX2(block, bound);
+    }
+    if (level == SimdLevel::SSE2) {
+        return FindBytesBelowInBlockSSE2(block, bound);
+    }
+#endif
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; ++i) {
+        mask |= static_cast<uint64_t>(static_cast<unsigned char>(block[i]) < bound) << i;
+    }
+    return mask;
+}
+
+} // namespace logtail
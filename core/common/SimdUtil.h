@@ -0,0 +1,70 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace logtail {
+
+enum class SimdLevel { NONE, SSE2, AVX2 };
+
+// The highest SIMD instruction set supported by the cpu, detected once at runtime.
+// SSE2 and AVX2 are only available on x86.
+SimdLevel GetSupportedSimdLevel();
+const char* SimdLevelToString(SimdLevel level);
+
+// Append the positions of all occurrences of c in [data, data + size) to positions in ascending order.
+// The level is lowered to the supported one if necessary.
+void FindAllCharPositions(const char* data, size_t size, char c, std::vector<size_t>& positions);
+void FindAllCharPositions(const char* data, size_t size, char c, std::vector<size_t>& positions, SimdLevel level);
+
+// Building blocks of bitmask based scanners, which classify 64 bytes at a time, and bit i of a mask stands for
+// block[i]. Set bit i of masks[k] if block[i] equals chars[k], for k in [0, charCnt).
+void FindCharsInBlock(const char* block, const char* chars, size_t charCnt, uint64_t* masks, SimdLevel level);
+// Set bit i of the result if block[i] is less than bound as unsigned char.
+uint64_t FindBytesBelowInBlock(const char* block, unsigned char bound, SimdLevel level);
+
+// Index of the lowest set bit of mask, which should not be 0.
+inline uint32_t CountTrailingZeros64(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Bit i of the result is the xor of bits [0, i] of mask, which turns the mask of quotes into the mask of quoted
+// ranges, including opening quotes but not closing quotes.
+inline uint64_t PrefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+} // namespace logtail
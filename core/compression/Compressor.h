@@ -19,6 +19,7 @@
 #include <string>
 
 #include "compression/CompressType.h"
+#include "models/StringView.h"
 
 namespace logtail {
 
@@ -27,7 +28,23 @@ public:
     Compressor(CompressType type) : mType(type) {}
     virtual ~Compressor() = default;
 
-    virtual bool Compress(const std::string& input, std::string& output, std::string& errorMsg) = 0;
+    bool Compress(const std::string& input, std::string& output, std::string& errorMsg) {
+        return Compress(StringView(input), output, errorMsg);
+    }
+    // output is resized to the compressed size, so reusing the same output across calls saves reallocation
+    bool Compress(StringView input, std::string& output, std::string& errorMsg) {
+        output.resize(GetCompressBound(input.size()));
+        size_t outputSize = output.size();
+        if (!Compress(input, &output[0], outputSize, errorMsg)) {
+            return false;
+        }
+        output.resize(outputSize);
+        return true;
+    }
+    // output is owned by the caller, whose capacity should be passed in as outputSize and must be no less than
+    // GetCompressBound(input.size()). On success, outputSize is set to the compressed size.
+    virtual bool Compress(StringView input, char* output, size_t& outputSize, std::string& errorMsg) = 0;
+    virtual size_t GetCompressBound(size_t inputSize) const = 0;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     // buffer shoudl be reserved for output before calling this function
@@ -14,35 +14,53 @@
 
 #include "compression/LZ4Compressor.h"
 
+// LZ4_compress_fast_extState_fastReset is only exposed for static linking
+#define LZ4_STATIC_LINKING_ONLY
 #include <lz4/lz4.h>
 
+#include <algorithm>
+#include <climits>
+
 #include "common/StringTools.h"
 
 using namespace std;
 
 namespace logtail {
 
-bool LZ4Compressor::Compress(const string& input, string& output, string& errorMsg) {
-    int encodingSize = LZ4_compressBound(input.size());
-    if (encodingSize <= 0) {
+bool LZ4Compressor::Compress(StringView input, char* output, size_t& outputSize, string& errorMsg) {
+    if (input.size() > LZ4_MAX_INPUT_SIZE) {
         errorMsg = "input size is incorrect";
         return false;
     }
-    output.resize(static_cast<size_t>(encodingSize));
+    // the compression state is reused by all compressors running in the same thread. It is fully initialized only
+    // once per thread, and then only reset cheaply for each batch.
+    thread_local static LZ4_stream_t sState;
+    thread_local static bool sStateInited = false;
+    if (!sStateInited) {
+        LZ4_initStream(&sState, sizeof(sState));
+        sStateInited = true;
+    }
+    int capacity = static_cast<int>(min(outputSize, static_cast<size_t>(INT32_MAX)));
     try {
-        encodingSize = static_cast<size_t>(
-            LZ4_compress_default(input.c_str(), const_cast<char*>(output.c_str()), input.size(), encodingSize));
+        int encodingSize = LZ4_compress_fast_extState_fastReset(
+            &sState, input.data(), output, static_cast<int>(input.size()), capacity, 1);
         if (encodingSize <= 0) {
             errorMsg = "error code: " + ToString(encodingSize);
             return false;
         }
-        output.resize(static_cast<size_t>(encodingSize));
+        outputSize = static_cast<size_t>(encodingSize);
         return true;
     } catch (...) {
     }
     return false;
 }
 
+size_t LZ4Compressor::GetCompressBound(size_t inputSize) const {
+    int bound = LZ4_compressBound(static_cast<int>(min(inputSize, static_cast<size_t>(INT32_MAX))));
+    // LZ4_compressBound returns 0 if input size is too large, which will be reported by Compress
+    return bound > 0 ? static_cast<size_t>(bound) : 0;
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 bool LZ4Compressor::UnCompress(const string& input, string& output, string& errorMsg) {
     try {
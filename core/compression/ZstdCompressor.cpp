@@ -16,27 +16,51 @@
 
 #include <zstd/zstd.h>
 
+#include <memory>
+
 using namespace std;
 
 namespace logtail {
 
-bool ZstdCompressor::Compress(const string& input, string& output, string& errorMsg) {
-    size_t encodingSize = ZSTD_compressBound(input.size());
-    output.resize(encodingSize);
+namespace {
+
+struct ZstdCCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+
+// the compression context is reused by all compressors running in the same thread, so that its internal tables need
+// not be allocated and initialized for each batch
+ZSTD_CCtx* GetThreadLocalCCtx() {
+    thread_local static unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter> sCtx(ZSTD_createCCtx());
+    return sCtx.get();
+}
+
+} // namespace
+
+bool ZstdCompressor::Compress(StringView input, char* output, size_t& outputSize, string& errorMsg) {
+    ZSTD_CCtx* ctx = GetThreadLocalCCtx();
+    if (ctx == nullptr) {
+        errorMsg = "failed to create compression context";
+        return false;
+    }
     try {
-        encodingSize = ZSTD_compress(
-            const_cast<char*>(output.c_str()), encodingSize, input.c_str(), input.size(), mCompressionLevel);
+        size_t encodingSize
+            = ZSTD_compressCCtx(ctx, output, outputSize, input.data(), input.size(), mCompressionLevel);
         if (ZSTD_isError(encodingSize)) {
             errorMsg = ZSTD_getErrorName(encodingSize);
             return false;
         }
-        output.resize(encodingSize);
+        outputSize = encodingSize;
         return true;
     } catch (...) {
     }
     return false;
 }
 
+size_t ZstdCompressor::GetCompressBound(size_t inputSize) const {
+    return ZSTD_compressBound(inputSize);
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 bool ZstdCompressor::UnCompress(const string& input, string& output, string& errorMsg) {
     try {
@@ -24,7 +24,9 @@ class ZstdCompressor : public Compressor {
 public:
     ZstdCompressor(CompressType type, int32_t level = 1) : Compressor(type), mCompressionLevel(level){};
 
-    bool Compress(const std::string& input, std::string& output, std::string& errorMsg) override;
+    using Compressor::Compress;
+    bool Compress(StringView input, char* output, size_t& outputSize, std::string& errorMsg) override;
+    size_t GetCompressBound(size_t inputSize) const override;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     bool UnCompress(const std::string& input, std::string& output, std::string& errorMsg) override;
@@ -90,6 +90,8 @@ DEFINE_FLAG_INT32(max_watch_dir_count, "", 100 * 1000);
 DEFINE_FLAG_STRING(inotify_watcher_dirs_dump_filename, "", "inotify_watcher_dirs");
 DEFINE_FLAG_INT32(default_max_inotify_watch_num, "the max allowed inotify watch dir number", 3000);
 
+DECLARE_FLAG_BOOL(enable_binary_checkpoint);
+
 namespace logtail {
 
 EventDispatcher::EventDispatcher() : mWatchNum(0), mInotifyWatchNum(0) {
@@ -619,7 +621,7 @@ void EventDispatcher::AddExistedCheckPointFileEvents() {
         }
     }
     for (size_t i = 0; i < deleteKeyVec.size(); ++i) {
-        checkPointMap.erase(deleteKeyVec[i]);
+        CheckPointManager::Instance()->DeleteCheckPoint(deleteKeyVec[i].mDevInode, deleteKeyVec[i].mConfigName);
     }
     LOG_INFO(sLogger,
              ("checkpoint verification ends, generated event count", eventVec.size())("checkpoint deletion count",
@@ -994,6 +996,10 @@ void EventDispatcher::ProcessHandlerTimeOut() {
 }
 
 void EventDispatcher::DumpCheckPointPeriod(int32_t curTime) {
+    // binary checkpoints are dumped by DumpChangedCheckPoint instead
+    if (BOOL_FLAG(enable_binary_checkpoint)) {
+        return;
+    }
     if (CheckPointManager::Instance()->NeedDump(curTime)) {
         LOG_INFO(sLogger, ("checkpoint dump", "starts"));
         FileServer::GetInstance()->Pause(false);
@@ -1010,6 +1016,26 @@ void EventDispatcher::DumpCheckPointPeriod(int32_t curTime) {
     }
 }
 
+void EventDispatcher::DumpChangedCheckPoint(int32_t curTime) {
+    if (!BOOL_FLAG(enable_binary_checkpoint) || !CheckPointManager::Instance()->NeedDump(curTime)) {
+        return;
+    }
+    // readers are only accessed by the log input thread, so the file server need not be paused. Checkpoints are kept
+    // across dumps instead of being rebuilt, and readers only renew the changed ones, which are the ones dumped.
+    MapType<int, DirInfo*>::Type::iterator it;
+    for (it = mWdDirInfoMap.begin(); it != mWdDirInfoMap.end(); ++it) {
+        ((it->second)->mHandler)->DumpReaderMeta(true, false);
+    }
+    for (it = mWdDirInfoMap.begin(); it != mWdDirInfoMap.end(); ++it) {
+        ((it->second)->mHandler)->DumpReaderMeta(false, false);
+        CheckPointManager::Instance()->AddDirCheckPoint((it->second)->mPath);
+    }
+    CheckPointManager::Instance()->RemoveStaleCheckPoint(
+        curTime, [this](const string& path) { return mPathWdMap.find(path) != mPathWdMap.end(); });
+    if (!(CheckPointManager::Instance()->DumpCheckPointToLocal()))
+        LOG_WARNING(sLogger, ("dump checkpoint to local", "failed"));
+}
+
 bool EventDispatcher::IsAllFileRead() {
     for (auto it = mWdDirInfoMap.begin(); it != mWdDirInfoMap.end(); ++it) {
         if (!((it->second)->mHandler)->IsAllFileRead()) {
@@ -203,6 +203,8 @@ public:
     void CheckSymbolicLink();
 
     void DumpCheckPointPeriod(int32_t curTime);
+    // Dump checkpoints in binary format, which must be called by the log input thread.
+    void DumpChangedCheckPoint(int32_t curTime);
 
     void StartTimeCount();
     void PropagateTimeout(const char* path);
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "LogInput.h"
+#include "ReaderWorkerPool.h"
 #include "app_config/AppConfig.h"
 #include "common/FileSystemUtil.h"
 #include "common/RuntimeUtil.h"
@@ -482,6 +483,12 @@ void ModifyHandler::Handle(const Event& event) {
         }
     }
 
+    // readers being read by reader workers must not be touched until the reading is finished
+    if (ReaderWorkerPool::GetInstance()->HasPendingTask()
+        && (event.IsContainerStopped() || IsReaderInReading(name, devInode))) {
+        LogInput::GetInstance()->WaitForReading();
+    }
+
     DevInodeLogFileReaderMap::iterator devInodeIter
         = devInode.IsValid() ? mDevInodeReaderMap.find(devInode) : mDevInodeReaderMap.end();
 
@@ -734,118 +741,17 @@ void ModifyHandler::Handle(const Event& event) {
             }
         }
 
-        bool hasMoreData;
-        do {
-            if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
-                static int32_t s_lastOutPutTime = 0;
-                int32_t curTime = time(NULL);
-                if (curTime - s_lastOutPutTime > 600) {
-                    s_lastOutPutTime = curTime;
-                    LOG_WARNING(sLogger,
-                                ("logprocess queue is full, put modify event to event queue again",
-                                 reader->GetHostLogPath())(reader->GetProject(), reader->GetLogstore()));
-
-                    LogtailAlarm::GetInstance()->SendAlarm(
-                        PROCESS_QUEUE_BUSY_ALARM,
-                        string("logprocess queue is full, put modify event to event queue again, file:")
-                            + reader->GetHostLogPath() + " ,project:" + reader->GetProject()
-                            + " ,logstore:" + reader->GetLogstore());
-                }
-
-                BlockedEventManager::GetInstance()->UpdateBlockEvent(
-                    reader->GetQueueKey(), mConfigName, event, reader->GetDevInode(), curTime);
-                return;
-            }
-            unique_ptr<LogBuffer> logBuffer(new LogBuffer);
-            hasMoreData = reader->ReadLog(*logBuffer, &event);
-            int32_t pushRetry = PushLogToProcessor(reader, logBuffer.get());
-            if (!hasMoreData) {
-                if (reader->IsFileDeleted()) {
-                    LOG_INFO(sLogger,
-                             ("close the file", "current file has been read, and is marked deleted")(
-                                 "project", reader->GetProject())("logstore", reader->GetLogstore())(
-                                 "config", mConfigName)("log reader queue name", reader->GetHostLogPath())(
-                                 "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
-                                 "file size", reader->GetFileSize()));
-                    reader->CloseFilePtr();
-                } else if (reader->IsContainerStopped()) {
-                    // release fd as quick as possible
-                    LOG_INFO(
-                        sLogger,
-                        ("close the file", "current file has been read, and the relative container has been stopped")(
-                            "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
-                            "log reader queue name", reader->GetHostLogPath())("file device",
-                                                                               reader->GetDevInode().dev)(
-                            "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
-                    ForceReadLogAndPush(reader);
-                    reader->CloseFilePtr();
-                }
-                break;
-            }
-            if (pushRetry >= 5 || GetCurrentTimeInMicroSeconds() - beginTime > mReadFileTimeSlice) {
-                LOG_DEBUG(
-                    sLogger,
-                    ("read log breakout", "file io cost 1 time slice (50ms) or push blocked")("pushRetry", pushRetry)(
-                        "begin time", beginTime)("path", event.GetSource())("file", event.GetObject()));
-                Event* ev = new Event(event);
-                ev->SetConfigName(mConfigName);
-                LogInput::GetInstance()->PushEventQueue(ev);
-                break;
-            }
-
-            // When loginput thread hold on, we should repush this event back.
-            // If we don't repush and this file has no modify event, this reader will never been read.
-            if (LogInput::GetInstance()->IsInterupt()) {
-                if (hasMoreData) {
-                    LOG_INFO(
-                        sLogger,
-                        ("read log interupt but has more data, reason", "log input thread hold on")(
-                            "action", "repush modify event to event queue")("begin time", beginTime)(
-                            "path", event.GetSource())("file", event.GetObject())("inode", reader->GetDevInode().inode)(
-                            "offset", reader->GetLastFilePos())("size", reader->GetFileSize()));
-                } else {
-                    LOG_DEBUG(
-                        sLogger,
-                        ("read log breakout, reason", "log input thread hold on")(
-                            "action", "repush modify event to event queue")("begin time", beginTime)(
-                            "path", event.GetSource())("file", event.GetObject())("inode", reader->GetDevInode().inode)(
-                            "offset", reader->GetLastFilePos())("size", reader->GetFileSize()));
-                }
-                Event* ev = new Event(event);
-                ev->SetConfigName(mConfigName);
-                LogInput::GetInstance()->PushEventQueue(ev);
-                break;
-            }
-        } while (true);
-
-        if (!hasMoreData && readerArrayPtr->size() > (size_t)1) {
-            // when a rotated reader finish its reading, it's unlikely that there will be data again
-            // so release file fd as quick as possible (open again if new data coming)
-            LOG_INFO(sLogger,
-                     ("close the file and move the corresponding reader to the rotator reader pool",
-                      "current file has been read and more files are waiting in the log reader queue")(
-                         "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
-                         "log reader queue name", reader->GetHostLogPath())("log reader queue size",
-                                                                            readerArrayPtr->size() - 1)(
-                         "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
-                         "file size", reader->GetFileSize())("rotator reader pool size", mRotatorReaderMap.size() + 1));
-            ForceReadLogAndPush(reader);
-            reader->CloseFilePtr();
-            readerArrayPtr->pop_front();
-            mDevInodeReaderMap.erase(reader->GetDevInode());
-            mRotatorReaderMap[reader->GetDevInode()] = reader;
-            // need to push modify event again, but without dev inode
-            // use head dev + inode
-            Event* ev = new Event(event.GetSource(),
-                                  event.GetObject(),
-                                  event.GetType(),
-                                  event.GetWd(),
-                                  event.GetCookie(),
-                                  (*readerArrayPtr)[0]->GetDevInode().dev,
-                                  (*readerArrayPtr)[0]->GetDevInode().inode);
-            ev->SetConfigName(mConfigName);
-            LogInput::GetInstance()->PushEventQueue(ev);
+        ReaderWorkerPool* workerPool = ReaderWorkerPool::GetInstance();
+        if (workerPool->IsEnabled()) {
+            shared_ptr<Event> ev = make_shared<Event>(event);
+            shared_ptr<ReadResult> res = make_shared<ReadResult>(ReadResult::READ_TO_END);
+            workerPool->Submit(
+                reader.get(),
+                [this, reader, ev, res, beginTime]() { *res = ReadLogAndPush(reader, *ev, beginTime); },
+                [this, reader, ev, res]() { OnReadFinished(reader, *ev, *res); });
+            return;
         }
+        OnReadFinished(reader, event, ReadLogAndPush(reader, event, beginTime));
     }
     // if a file is created, and dev inode cannot found(this means it's a new file), create reader for this file, then
     // insert reader into mDevInodeReaderMap
@@ -1040,6 +946,134 @@ void ModifyHandler::DeleteRollbackReader() {
         mRotatorReaderMap.erase(*keyIter);
 }
 
+ModifyHandler::ReadResult
+ModifyHandler::ReadLogAndPush(const LogFileReaderPtr& reader, const Event& event, uint64_t beginTime) {
+    do {
+        if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
+            return ReadResult::BLOCKED;
+        }
+        unique_ptr<LogBuffer> logBuffer(new LogBuffer);
+        bool hasMoreData = reader->ReadLog(*logBuffer, &event);
+        int32_t pushRetry = PushLogToProcessor(reader, logBuffer.get());
+        if (!hasMoreData) {
+            return ReadResult::READ_TO_END;
+        }
+        if (pushRetry >= 5 || GetCurrentTimeInMicroSeconds() - beginTime > mReadFileTimeSlice) {
+            LOG_DEBUG(sLogger,
+                      ("read log breakout", "file io cost 1 time slice (50ms) or push blocked")("pushRetry", pushRetry)(
+                          "begin time", beginTime)("path", event.GetSource())("file", event.GetObject()));
+            return ReadResult::HAS_MORE_DATA;
+        }
+
+        // When loginput thread hold on, we should repush this event back.
+        // If we don't repush and this file has no modify event, this reader will never been read.
+        if (LogInput::GetInstance()->IsInterupt()) {
+            LOG_INFO(sLogger,
+                     ("read log interupt but has more data, reason", "log input thread hold on")(
+                         "action", "repush modify event to event queue")("begin time", beginTime)(
+                         "path", event.GetSource())("file", event.GetObject())("inode", reader->GetDevInode().inode)(
+                         "offset", reader->GetLastFilePos())("size", reader->GetFileSize()));
+            return ReadResult::HAS_MORE_DATA;
+        }
+    } while (true);
+}
+
+void ModifyHandler::OnReadFinished(const LogFileReaderPtr& reader, const Event& event, ReadResult result) {
+    if (result == ReadResult::BLOCKED) {
+        static int32_t s_lastOutPutTime = 0;
+        int32_t curTime = time(NULL);
+        if (curTime - s_lastOutPutTime > 600) {
+            s_lastOutPutTime = curTime;
+            LOG_WARNING(sLogger,
+                        ("logprocess queue is full, put modify event to event queue again",
+                         reader->GetHostLogPath())(reader->GetProject(), reader->GetLogstore()));
+
+            LogtailAlarm::GetInstance()->SendAlarm(
+                PROCESS_QUEUE_BUSY_ALARM,
+                string("logprocess queue is full, put modify event to event queue again, file:")
+                    + reader->GetHostLogPath() + " ,project:" + reader->GetProject()
+                    + " ,logstore:" + reader->GetLogstore());
+        }
+
+        BlockedEventManager::GetInstance()->UpdateBlockEvent(
+            reader->GetQueueKey(), mConfigName, event, reader->GetDevInode(), curTime);
+        return;
+    }
+    if (result == ReadResult::HAS_MORE_DATA) {
+        Event* ev = new Event(event);
+        ev->SetConfigName(mConfigName);
+        LogInput::GetInstance()->PushEventQueue(ev);
+        return;
+    }
+
+    if (reader->IsFileDeleted()) {
+        LOG_INFO(sLogger,
+                 ("close the file", "current file has been read, and is marked deleted")(
+                     "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                     "log reader queue name", reader->GetHostLogPath())("file device", reader->GetDevInode().dev)(
+                     "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
+        reader->CloseFilePtr();
+    } else if (reader->IsContainerStopped()) {
+        // release fd as quick as possible
+        LOG_INFO(sLogger,
+                 ("close the file", "current file has been read, and the relative container has been stopped")(
+                     "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                     "log reader queue name", reader->GetHostLogPath())("file device", reader->GetDevInode().dev)(
+                     "file inode", reader->GetDevInode().inode)("file size", reader->GetFileSize()));
+        ForceReadLogAndPush(reader);
+        reader->CloseFilePtr();
+    }
+
+    LogFileReaderPtrArray* readerArrayPtr = reader->GetReaderArray();
+    if (readerArrayPtr->size() > (size_t)1) {
+        // when a rotated reader finish its reading, it's unlikely that there will be data again
+        // so release file fd as quick as possible (open again if new data coming)
+        LOG_INFO(sLogger,
+                 ("close the file and move the corresponding reader to the rotator reader pool",
+                  "current file has been read and more files are waiting in the log reader queue")(
+                     "project", reader->GetProject())("logstore", reader->GetLogstore())("config", mConfigName)(
+                     "log reader queue name", reader->GetHostLogPath())("log reader queue size",
+                                                                        readerArrayPtr->size() - 1)(
+                     "file device", reader->GetDevInode().dev)("file inode", reader->GetDevInode().inode)(
+                     "file size", reader->GetFileSize())("rotator reader pool size", mRotatorReaderMap.size() + 1));
+        ForceReadLogAndPush(reader);
+        reader->CloseFilePtr();
+        readerArrayPtr->pop_front();
+        mDevInodeReaderMap.erase(reader->GetDevInode());
+        mRotatorReaderMap[reader->GetDevInode()] = reader;
+        // need to push modify event again, but without dev inode
+        // use head dev + inode
+        Event* ev = new Event(event.GetSource(),
+                              event.GetObject(),
+                              event.GetType(),
+                              event.GetWd(),
+                              event.GetCookie(),
+                              (*readerArrayPtr)[0]->GetDevInode().dev,
+                              (*readerArrayPtr)[0]->GetDevInode().inode);
+        ev->SetConfigName(mConfigName);
+        LogInput::GetInstance()->PushEventQueue(ev);
+    }
+}
+
+bool ModifyHandler::IsReaderInReading(const string& name, const DevInode& devInode) const {
+    ReaderWorkerPool* workerPool = ReaderWorkerPool::GetInstance();
+    auto nameIter = mNameReaderMap.find(name);
+    if (nameIter != mNameReaderMap.end()) {
+        for (const auto& reader : nameIter->second) {
+            if (workerPool->IsReading(reader.get())) {
+                return true;
+            }
+        }
+    }
+    if (devInode.IsValid()) {
+        auto devInodeIter = mDevInodeReaderMap.find(devInode);
+        if (devInodeIter != mDevInodeReaderMap.end() && workerPool->IsReading(devInodeIter->second.get())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ModifyHandler::ForceReadLogAndPush(LogFileReaderPtr reader) {
     LogBuffer* logBuffer = new LogBuffer;
     auto pEvent = reader->CreateFlushTimeoutEvent();
@@ -1067,7 +1101,8 @@ int32_t ModifyHandler::PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* lo
         while (!LogProcess::GetInstance()->PushBuffer(reader->GetQueueKey(), 0, std::move(group))) // 10ms
         {
             ++pushRetry;
-            if (pushRetry % 10 == 0)
+            // events are read by LogInput thread itself when reading is done by reader workers
+            if (pushRetry % 10 == 0 && !ReaderWorkerPool::IsWorkerThread())
                 LogInput::GetInstance()->TryReadEvents(false);
         }
     }
@@ -85,6 +85,12 @@ private:
 
     int32_t PushLogToProcessor(LogFileReaderPtr reader, LogBuffer* logBuffer);
 
+    enum class ReadResult { BLOCKED, HAS_MORE_DATA, READ_TO_END };
+    // may be called by reader workers, so only the reader itself can be touched
+    ReadResult ReadLogAndPush(const LogFileReaderPtr& reader, const Event& event, uint64_t beginTime);
+    void OnReadFinished(const LogFileReaderPtr& reader, const Event& event, ReadResult result);
+    bool IsReaderInReading(const std::string& name, const DevInode& devInode) const;
+
     void ForceReadLogAndPush(LogFileReaderPtr reader);
 
     // no copy
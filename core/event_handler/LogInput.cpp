@@ -18,6 +18,7 @@
 
 #include "EventHandler.h"
 #include "HistoryFileImporter.h"
+#include "ReaderWorkerPool.h"
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
 #include "checkpoint/CheckPointManager.h"
@@ -61,6 +62,12 @@ DEFINE_FLAG_INT32(read_local_event_interval, "seconds", 60);
 DEFINE_FLAG_BOOL(force_close_file_on_container_stopped,
                  "whether close file handler immediately when associate container stopped",
                  false);
+DEFINE_FLAG_INT32(log_input_reader_thread_count,
+                  "threads reading files in parallel for log input thread, files are read by log input thread if 0",
+                  0);
+DEFINE_FLAG_INT32(log_input_event_batch_size,
+                  "max events handled before waiting for reader threads to finish reading",
+                  256);
 
 DECLARE_FLAG_BOOL(send_prefer_real_ip);
 
@@ -89,6 +96,9 @@ void LogInput::Start() {
         initialized = true;
 
     mInteruptFlag = false;
+    if (INT32_FLAG(log_input_reader_thread_count) > 0) {
+        ReaderWorkerPool::GetInstance()->Start(INT32_FLAG(log_input_reader_thread_count));
+    }
     new Thread([this]() { ProcessLoop(); });
 }
 
@@ -111,6 +121,10 @@ void LogInput::HoldOn() {
     LOG_INFO(sLogger, ("event handle daemon pause", "succeeded"));
 }
 
+void LogInput::Stop() {
+    ReaderWorkerPool::GetInstance()->Stop();
+}
+
 void LogInput::TryReadEvents(bool forceRead) {
     if (mInteruptFlag)
         return;
@@ -148,15 +162,16 @@ void LogInput::TryReadEvents(bool forceRead) {
 void LogInput::FlowControl() {
     const static int32_t FLOW_CONTROL_SLEEP_MICROSECONDS = 20 * 1000; // 20ms
     const static int32_t MAX_SLEEP_COUNT = 50; // 1s
-    static int32_t sleepCount = 10;
-    static int32_t lastCheckTime = 0;
+    // may be called by reader workers concurrently
+    static std::atomic_int sleepCount{10};
+    static std::atomic_int lastCheckTime{0};
     int32_t i = 0;
     while (i < sleepCount) {
         if (mInteruptFlag)
             return;
         usleep(FLOW_CONTROL_SLEEP_MICROSECONDS);
         ++i;
-        if (i % 5 == 0)
+        if (i % 5 == 0 && !ReaderWorkerPool::IsWorkerThread())
             TryReadEvents(true);
     }
 
@@ -300,19 +315,23 @@ void LogInput::ProcessEvent(EventDispatcher* dispatcher, Event* ev) {
     LOG_DEBUG(sLogger,
               ("process event, type", ev->GetTypeString())("dir", ev->GetSource())("filename", ev->GetObject())(
                   "config", ev->GetConfigName()));
-    if (ev->IsTimeout())
+    if (ev->IsTimeout()) {
+        // handlers may be deleted
+        WaitForReading();
         dispatcher->UnregisterAllDir(source);
-    else {
+    } else {
         if (ev->IsDir()
             && (ev->IsMoveFrom() || (ev->IsContainerStopped() && BOOL_FLAG(force_close_file_on_container_stopped)))) {
             string path = source;
             if (object.size() > 0)
                 path += PATH_SEPARATOR + object;
+            WaitForReading();
             dispatcher->UnregisterAllDir(path);
         } else if (ev->IsDir() && ev->IsContainerStopped()) {
             string path = source;
             if (object.size() > 0)
                 path += PATH_SEPARATOR + object;
+            WaitForReading();
             dispatcher->StopAllDir(path);
         } else {
             EventHandler* handler = dispatcher->GetHandler(source.c_str());
@@ -336,6 +355,10 @@ void LogInput::ProcessEvent(EventDispatcher* dispatcher, Event* ev) {
     delete ev;
 }
 
+void LogInput::WaitForReading() {
+    ReaderWorkerPool::GetInstance()->WaitAll([this]() { TryReadEvents(false); });
+}
+
 void LogInput::UpdateCriticalMetric(int32_t curTime) {
     LogtailMonitor::GetInstance()->UpdateMetric("last_read_event_time",
                                                 GetTimeStamp(mLastReadEventTime, "%Y-%m-%d %H:%M:%S"));
@@ -376,11 +399,23 @@ void* LogInput::ProcessLoop() {
         TryReadEvents(false);
         Event* ev = PopEventQueue();
         if (ev != NULL) {
-            ++mEventProcessCount;
-            if (mIdleFlag)
-                delete ev;
-            else
-                ProcessEvent(dispatcher, ev);
+            // when files are read by reader workers, handle events in batch so that different files are read in
+            // parallel, and all readings must be finished before anything else is done
+            // the number of events to handle in this round, including ev
+            size_t batchSize = ReaderWorkerPool::GetInstance()->IsEnabled()
+                ? min(mInotifyEventQueue.size() + 1, (size_t)max(INT32_FLAG(log_input_event_batch_size), 1))
+                : 1;
+            while (true) {
+                ++mEventProcessCount;
+                if (mIdleFlag)
+                    delete ev;
+                else
+                    ProcessEvent(dispatcher, ev);
+                if (--batchSize == 0 || (ev = PopEventQueue()) == NULL) {
+                    break;
+                }
+            }
+            WaitForReading();
         } else
             usleep(INT32_FLAG(log_input_thread_wait_interval));
         if (mIdleFlag)
@@ -438,6 +473,8 @@ void* LogInput::ProcessLoop() {
             lastCheckHandlerTimeOut = curTime;
         }
 
+        dispatcher->DumpChangedCheckPoint(curTime);
+
         if (curTime - lastDumpInotifyWatcherTime > INT32_FLAG(dump_inotify_watcher_interval)) {
             dispatcher->DumpInotifyWatcherDirs();
             lastDumpInotifyWatcherTime = curTime;
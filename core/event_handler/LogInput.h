@@ -17,6 +17,7 @@
 #ifndef __LOG_ILOGTAIL_LOG_INPUT_H__
 #define __LOG_ILOGTAIL_LOG_INPUT_H__
 
+#include <atomic>
 #include <condition_variable>
 #include <queue>
 #include <string>
@@ -41,6 +42,8 @@ public:
     void Resume();
     void Start();
     void HoldOn();
+    // should only be called on exit after HoldOn, since the reader workers are started only once
+    void Stop();
     void PushEventQueue(std::vector<Event*>& eventVec);
     void PushEventQueue(Event* ev);
     void TryReadEvents(bool forceRead);
@@ -59,6 +62,9 @@ public:
 
     int32_t GetLastReadEventTime() { return mLastReadEventTime; }
 
+    // wait for reader workers to finish reading, should only be called by log input thread
+    void WaitForReading();
+
 private:
     LogInput();
     ~LogInput();
@@ -0,0 +1,118 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "event_handler/ReaderWorkerPool.h"
+
+#include "common/DevInode.h"
+#include "logger/Logger.h"
+#include "reader/LogFileReader.h"
+
+using namespace std;
+
+namespace logtail {
+
+static thread_local bool sIsWorkerThread = false;
+
+void ReaderWorkerPool::Start(size_t workerCount) {
+    if (mIsRunning || workerCount == 0) {
+        return;
+    }
+    mIsRunning = true;
+    for (size_t i = 0; i < workerCount; ++i) {
+        mWorkers.emplace_back(new Worker());
+        Worker* worker = mWorkers.back().get();
+        worker->mThread = thread([this, worker]() { Run(worker); });
+    }
+    LOG_INFO(sLogger, ("reader worker pool", "started")("worker count", workerCount));
+}
+
+void ReaderWorkerPool::Stop() {
+    if (!mIsRunning) {
+        return;
+    }
+    WaitAll([]() {});
+    mIsRunning = false;
+    for (auto& worker : mWorkers) {
+        {
+            lock_guard<mutex> lock(worker->mMux);
+            worker->mCV.notify_one();
+        }
+        if (worker->mThread.joinable()) {
+            worker->mThread.join();
+        }
+    }
+    mWorkers.clear();
+    LOG_INFO(sLogger, ("reader worker pool", "stopped"));
+}
+
+void ReaderWorkerPool::Submit(const LogFileReader* reader, Task&& read, Task&& callback) {
+    Worker* worker = mWorkers[DevInodeHash()(reader->GetDevInode()) % mWorkers.size()].get();
+    mReadingReaders.insert(reader);
+    mCallbacks.emplace_back(std::move(callback));
+    {
+        lock_guard<mutex> lock(mUnfinishedMux);
+        ++mUnfinishedCount;
+    }
+    lock_guard<mutex> lock(worker->mMux);
+    worker->mTasks.emplace_back(std::move(read));
+    worker->mCV.notify_one();
+}
+
+void ReaderWorkerPool::WaitAll(const Task& onWaiting) {
+    if (mCallbacks.empty()) {
+        return;
+    }
+    {
+        unique_lock<mutex> lock(mUnfinishedMux);
+        while (!mUnfinishedCV.wait_for(lock, chrono::milliseconds(10), [this]() { return mUnfinishedCount == 0; })) {
+            lock.unlock();
+            onWaiting();
+            lock.lock();
+        }
+    }
+    mReadingReaders.clear();
+    // callbacks may submit new tasks
+    vector<Task> callbacks;
+    callbacks.swap(mCallbacks);
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+bool ReaderWorkerPool::IsWorkerThread() {
+    return sIsWorkerThread;
+}
+
+void ReaderWorkerPool::Run(Worker* worker) {
+    sIsWorkerThread = true;
+    while (true) {
+        Task task;
+        {
+            unique_lock<mutex> lock(worker->mMux);
+            worker->mCV.wait(lock, [this, worker]() { return !worker->mTasks.empty() || !mIsRunning; });
+            if (worker->mTasks.empty()) {
+                return;
+            }
+            task = std::move(worker->mTasks.front());
+            worker->mTasks.pop_front();
+        }
+        task();
+        lock_guard<mutex> lock(mUnfinishedMux);
+        if (--mUnfinishedCount == 0) {
+            mUnfinishedCV.notify_one();
+        }
+    }
+}
+
+} // namespace logtail
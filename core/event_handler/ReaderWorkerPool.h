@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace logtail {
+
+class LogFileReader;
+
+// ReaderWorkerPool reads log files for LogInput in parallel.
+//
+// LogInput thread still handles all events and owns all readers. When a reader is ready to be read, the reading is
+// submitted to the worker chosen by the dev inode of the file, so the readings of one file are always done by the same
+// worker in submission order. A reader being read must not be touched by LogInput thread until WaitAll returns, where
+// the callbacks of all tasks are invoked in LogInput thread in submission order.
+class ReaderWorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    static ReaderWorkerPool* GetInstance() {
+        static ReaderWorkerPool* ptr = new ReaderWorkerPool();
+        return ptr;
+    }
+
+    void Start(size_t workerCount);
+    void Stop();
+    bool IsEnabled() const { return !mWorkers.empty(); }
+
+    // The following methods should only be called by LogInput thread.
+    void Submit(const LogFileReader* reader, Task&& read, Task&& callback);
+    bool HasPendingTask() const { return !mCallbacks.empty(); }
+    bool IsReading(const LogFileReader* reader) const { return mReadingReaders.find(reader) != mReadingReaders.end(); }
+    // onWaiting is called about every 10ms until all submitted tasks are done.
+    void WaitAll(const Task& onWaiting);
+
+    static bool IsWorkerThread();
+
+private:
+    struct Worker {
+        std::thread mThread;
+        std::mutex mMux;
+        std::condition_variable mCV;
+        std::deque<Task> mTasks;
+    };
+
+    ReaderWorkerPool() = default;
+    ~ReaderWorkerPool() = default;
+
+    void Run(Worker* worker);
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::atomic_bool mIsRunning{false};
+
+    std::mutex mUnfinishedMux;
+    std::condition_variable mUnfinishedCV;
+    size_t mUnfinishedCount = 0;
+
+    std::vector<Task> mCallbacks;
+    std::unordered_set<const LogFileReader*> mReadingReaders;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ReaderWorkerPoolUnittest;
+#endif
+};
+
+} // namespace logtail
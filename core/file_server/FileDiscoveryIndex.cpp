@@ -0,0 +1,148 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/FileDiscoveryIndex.h"
+
+#include <algorithm>
+
+#include "common/FileSystemUtil.h"
+
+using namespace std;
+
+namespace logtail {
+
+#if defined(_MSC_VER)
+static const char* kGlobChars = "*?";
+#else
+// fnmatch also treats brackets and backslashes specially
+static const char* kGlobChars = "*?[\\";
+#endif
+
+void FileDiscoveryIndex::Add(const string& name, const FileDiscoveryConfig& config) {
+    Remove(name);
+    auto& paths = mConfigPaths[name];
+    paths = GetIndexPaths(*config.first);
+    for (const auto& path : paths) {
+        Node* node = &mRoot;
+        for (const auto& component : SplitPath(path)) {
+            auto it = node->mChildren.find(component);
+            if (it == node->mChildren.end()) {
+                it = node->mChildren.emplace(string(component), make_unique<Node>()).first;
+            }
+            node = it->second.get();
+        }
+        node->mConfigs[name] = config;
+    }
+    if (paths.size() > 1) {
+        ++mMultiPathConfigCnt;
+    }
+}
+
+void FileDiscoveryIndex::Remove(const string& name) {
+    auto it = mConfigPaths.find(name);
+    if (it == mConfigPaths.end()) {
+        return;
+    }
+    for (const auto& path : it->second) {
+        Remove(mRoot, SplitPath(path), 0, name);
+    }
+    if (it->second.size() > 1) {
+        --mMultiPathConfigCnt;
+    }
+    mConfigPaths.erase(it);
+}
+
+void FileDiscoveryIndex::FindCandidates(const string& path, vector<FileDiscoveryConfig>& res) const {
+    size_t begin = res.size();
+    string_view remaining(path);
+    const Node* node = &mRoot;
+    while (true) {
+        for (const auto& item : node->mConfigs) {
+            res.push_back(item.second);
+        }
+        size_t pos = remaining.find_first_not_of(PATH_SEPARATOR[0]);
+        if (pos == string_view::npos) {
+            break;
+        }
+        remaining.remove_prefix(pos);
+        pos = min(remaining.find(PATH_SEPARATOR[0]), remaining.size());
+        auto it = node->mChildren.find(remaining.substr(0, pos));
+        if (it == node->mChildren.end()) {
+            break;
+        }
+        node = it->second.get();
+        remaining.remove_prefix(pos);
+    }
+    if (mMultiPathConfigCnt > 0) {
+        // a container config is indexed by several paths, which may be nested
+        sort(res.begin() + begin, res.end());
+        res.erase(unique(res.begin() + begin, res.end()), res.end());
+    }
+}
+
+vector<string> FileDiscoveryIndex::GetIndexPaths(const FileDiscoveryOptions& opts) {
+    vector<string> paths;
+    if (opts.IsContainerDiscoveryEnabled()) {
+        if (opts.GetContainerInfo()) {
+            for (const auto& info : *opts.GetContainerInfo()) {
+                paths.push_back(info.mRealBaseDir);
+            }
+        }
+        return paths;
+    }
+    const string& basePath = opts.GetBasePath();
+    if (opts.GetWildcardPaths().empty()) {
+        paths.push_back(basePath);
+        return paths;
+    }
+    size_t pos = basePath.rfind(PATH_SEPARATOR[0], basePath.find_first_of(kGlobChars));
+    paths.push_back(pos == string::npos ? string() : basePath.substr(0, pos));
+    return paths;
+}
+
+vector<string_view> FileDiscoveryIndex::SplitPath(string_view path) {
+    vector<string_view> components;
+    while (true) {
+        size_t pos = path.find_first_not_of(PATH_SEPARATOR[0]);
+        if (pos == string_view::npos) {
+            break;
+        }
+        path.remove_prefix(pos);
+        pos = min(path.find(PATH_SEPARATOR[0]), path.size());
+        components.push_back(path.substr(0, pos));
+        path.remove_prefix(pos);
+    }
+    return components;
+}
+
+// empty nodes are removed on the way back
+void FileDiscoveryIndex::Remove(Node& node,
+                                const vector<string_view>& components,
+                                size_t depth,
+                                const string& name) {
+    if (depth == components.size()) {
+        node.mConfigs.erase(name);
+        return;
+    }
+    auto it = node.mChildren.find(components[depth]);
+    if (it == node.mChildren.end()) {
+        return;
+    }
+    Remove(*it->second, components, depth + 1, name);
+    if (it->second->mConfigs.empty() && it->second->mChildren.empty()) {
+        node.mChildren.erase(it);
+    }
+}
+
+} // namespace logtail
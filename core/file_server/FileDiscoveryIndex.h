@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "file_server/FileDiscoveryOptions.h"
+
+namespace logtail {
+
+// Any object matched by a config must be located under the constant part of its base path, i.e., the components
+// before the first one containing wildcards, or the real base dir of a container for container discovery. Configs are
+// indexed in a trie of path components by these prefixes, so that the configs that may match a path can be found by
+// walking down the components of the path, instead of testing every config.
+class FileDiscoveryIndex {
+public:
+    // the config is reindexed if it has been added already
+    void Add(const std::string& name, const FileDiscoveryConfig& config);
+    void Remove(const std::string& name);
+    // Append configs indexed by path or any of its ancestors to res, each config once only. The caller should check
+    // them further with FileDiscoveryOptions::IsMatch.
+    void FindCandidates(const std::string& path, std::vector<FileDiscoveryConfig>& res) const;
+    size_t Size() const { return mConfigPaths.size(); }
+
+private:
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> mChildren;
+        std::map<std::string, FileDiscoveryConfig> mConfigs;
+    };
+
+    static std::vector<std::string> GetIndexPaths(const FileDiscoveryOptions& opts);
+    static std::vector<std::string_view> SplitPath(std::string_view path);
+
+    void Remove(Node& node, const std::vector<std::string_view>& components, size_t depth, const std::string& name);
+
+    Node mRoot;
+    std::unordered_map<std::string, std::vector<std::string>> mConfigPaths;
+    size_t mMultiPathConfigCnt = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileDiscoveryIndexUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -194,6 +194,8 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
         }
     }
     ParseWildcardPath();
+    mCompiledBasePath = GlobPattern(mBasePath, true);
+    mCompiledFilePattern = GlobPattern(mFilePattern, false);
 
     // PreservedDirDepth
     if (!GetOptionalIntParam(config, "PreservedDirDepth", mPreservedDirDepth, errorMsg)) {
@@ -233,9 +235,9 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
             }
             bool isMultipleLevelWildcard = mExcludeFilePaths[i].find("**") != string::npos;
             if (isMultipleLevelWildcard) {
-                mMLFilePathBlacklist.push_back(mExcludeFilePaths[i]);
+                mMLFilePathBlacklist.emplace_back(mExcludeFilePaths[i], false);
             } else {
-                mFilePathBlacklist.push_back(mExcludeFilePaths[i]);
+                mFilePathBlacklist.emplace_back(mExcludeFilePaths[i], true);
             }
         }
     }
@@ -263,7 +265,7 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
                                      ctx.GetRegion());
                 continue;
             }
-            mFileNameBlacklist.push_back(mExcludeFiles[i]);
+            mFileNameBlacklist.emplace_back(mExcludeFiles[i], false);
         }
     }
 
@@ -292,13 +294,13 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
             }
             bool isMultipleLevelWildcard = mExcludeDirs[i].find("**") != string::npos;
             if (isMultipleLevelWildcard) {
-                mMLWildcardDirPathBlacklist.push_back(mExcludeDirs[i]);
+                mMLWildcardDirPathBlacklist.emplace_back(mExcludeDirs[i], false);
                 continue;
             }
             bool isWildcardPath
                 = mExcludeDirs[i].find("*") != string::npos || mExcludeDirs[i].find("?") != string::npos;
             if (isWildcardPath) {
-                mWildcardDirPathBlacklist.push_back(mExcludeDirs[i]);
+                mWildcardDirPathBlacklist.emplace_back(mExcludeDirs[i], true);
             } else {
                 mDirPathBlacklist.push_back(mExcludeDirs[i]);
             }
@@ -428,12 +430,12 @@ bool FileDiscoveryOptions::IsDirectoryInBlacklist(const string& dirPath) const {
         }
     }
     for (auto& dp : mWildcardDirPathBlacklist) {
-        if (0 == fnmatch(dp.c_str(), dirPath.c_str(), FNM_PATHNAME)) {
+        if (dp.Match(dirPath)) {
             return true;
         }
     }
     for (auto& dp : mMLWildcardDirPathBlacklist) {
-        if (0 == fnmatch(dp.c_str(), dirPath.c_str(), 0)) {
+        if (dp.Match(dirPath)) {
             return true;
         }
     }
@@ -454,12 +456,12 @@ bool FileDiscoveryOptions::IsObjectInBlacklist(const string& path, const string&
 
     auto const filePath = PathJoin(path, name);
     for (auto& fp : mFilePathBlacklist) {
-        if (0 == fnmatch(fp.c_str(), filePath.c_str(), FNM_PATHNAME)) {
+        if (fp.Match(filePath)) {
             return true;
         }
     }
     for (auto& fp : mMLFilePathBlacklist) {
-        if (0 == fnmatch(fp.c_str(), filePath.c_str(), 0)) {
+        if (fp.Match(filePath)) {
             return true;
         }
     }
@@ -473,7 +475,7 @@ bool FileDiscoveryOptions::IsFileNameInBlacklist(const string& fileName) const {
     }
 
     for (auto& pattern : mFileNameBlacklist) {
-        if (0 == fnmatch(pattern.c_str(), fileName.c_str(), 0)) {
+        if (pattern.Match(fileName)) {
             return true;
         }
     }
@@ -486,7 +488,7 @@ bool FileDiscoveryOptions::IsFileNameInBlacklist(const string& fileName) const {
 bool FileDiscoveryOptions::IsMatch(const string& path, const string& name) const {
     // Check if the file name is matched or blacklisted.
     if (!name.empty()) {
-        if (fnmatch(mFilePattern.c_str(), name.c_str(), 0) != 0)
+        if (!mCompiledFilePattern.Match(name))
             return false;
         if (IsFileNameInBlacklist(name)) {
             return false;
@@ -549,10 +551,9 @@ bool FileDiscoveryOptions::IsWildcardPathMatch(const string& path, const string&
     if (d < mWildcardDepth)
         return false;
     else if (d == mWildcardDepth) {
-        return fnmatch(mBasePath.c_str(), path.c_str(), FNM_PATHNAME) == 0 && !IsObjectInBlacklist(path, name);
+        return mCompiledBasePath.Match(path) && !IsObjectInBlacklist(path, name);
     } else if (pos > 0) {
-        if (!(fnmatch(mBasePath.c_str(), path.substr(0, pos - 1).c_str(), FNM_PATHNAME) == 0
-              && !IsObjectInBlacklist(path, name))) {
+        if (!(mCompiledBasePath.Match(StringView(path.data(), pos - 1)) && !IsObjectInBlacklist(path, name))) {
             return false;
         }
     } else
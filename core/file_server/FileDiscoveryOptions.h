@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "common/GlobPattern.h"
 #include "file_server/ContainerInfo.h"
 #include "pipeline/PipelineContext.h"
 
@@ -84,6 +85,9 @@ private:
     std::vector<std::string> mConstWildcardPaths;
     std::vector<std::string> mWildcardPaths;
     uint16_t mWildcardDepth;
+    // compiled from mBasePath with FNM_PATHNAME, and mFilePattern with 0 as flags
+    GlobPattern mCompiledBasePath;
+    GlobPattern mCompiledFilePattern;
 
     // Blacklist control.
     bool mHasBlacklist = false;
@@ -95,17 +99,17 @@ private:
     // /app/log but keep /app/text.log, because /app does not match /app/*. And
     // because /app/log is filtered, so any changes under it will be ignored, so
     // both /app/log/sub and /app/log/text.log will be blacklisted.
-    std::vector<std::string> mWildcardDirPathBlacklist;
+    std::vector<GlobPattern> mWildcardDirPathBlacklist;
     // Multiple level wildcard (**) is included, use fnmatch with 0 as flags to filter,
     // which will blacklist /path/a/b with pattern /path/**.
-    std::vector<std::string> mMLWildcardDirPathBlacklist;
+    std::vector<GlobPattern> mMLWildcardDirPathBlacklist;
     // Absolute path of files to filter, */? is supported, such as /app/log/100*.log.
-    std::vector<std::string> mFilePathBlacklist;
+    std::vector<GlobPattern> mFilePathBlacklist;
     // Multiple level wildcard (**) is included.
-    std::vector<std::string> mMLFilePathBlacklist;
+    std::vector<GlobPattern> mMLFilePathBlacklist;
     // File name only, */? is supported too, such as 100*.log. It is similar to
     // mFilePattern, but works in reversed way.
-    std::vector<std::string> mFileNameBlacklist;
+    std::vector<GlobPattern> mFileNameBlacklist;
 
     bool mEnableContainerDiscovery = false;
     std::shared_ptr<std::vector<ContainerInfo>> mContainerInfos; // must not be null if container discovery is enabled
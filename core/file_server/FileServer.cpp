@@ -105,6 +105,7 @@ void FileServer::Stop() {
     PauseInner();
     EventDispatcher::GetInstance()->DumpAllHandlersMeta(false);
     CheckPointManager::Instance()->DumpCheckPointToLocal();
+    LogInput::GetInstance()->Stop();
 }
 
 // 获取给定名称的文件发现配置
@@ -119,11 +120,21 @@ FileDiscoveryConfig FileServer::GetFileDiscoveryConfig(const string& name) const
 // 添加文件发现配置
 void FileServer::AddFileDiscoveryConfig(const string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx) {
     mPipelineNameFileDiscoveryConfigsMap[name] = make_pair(opts, ctx);
+    mFileDiscoveryIndex.Add(name, make_pair(opts, ctx));
 }
 
 // 移除给定名称的文件发现配置
 void FileServer::RemoveFileDiscoveryConfig(const string& name) {
     mPipelineNameFileDiscoveryConfigsMap.erase(name);
+    mFileDiscoveryIndex.Remove(name);
+}
+
+// 容器信息变化后重建给定名称的文件发现配置的索引
+void FileServer::UpdateFileDiscoveryIndex(const string& name) {
+    auto itr = mPipelineNameFileDiscoveryConfigsMap.find(name);
+    if (itr != mPipelineNameFileDiscoveryConfigsMap.end()) {
+        mFileDiscoveryIndex.Add(name, itr->second);
+    }
 }
 
 // 获取给定名称的文件读取器配置
@@ -20,6 +20,7 @@
 #include <unordered_map>
 #include <utility>
 
+#include "file_server/FileDiscoveryIndex.h"
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/MultilineOptions.h"
 #include "pipeline/PipelineContext.h"
@@ -46,6 +47,9 @@ public:
     }
     void AddFileDiscoveryConfig(const std::string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx);
     void RemoveFileDiscoveryConfig(const std::string& name);
+    const FileDiscoveryIndex& GetFileDiscoveryIndex() const { return mFileDiscoveryIndex; }
+    // should be called once the container info of the config is changed
+    void UpdateFileDiscoveryIndex(const std::string& name);
 
     FileReaderConfig GetFileReaderConfig(const std::string& name) const;
     const std::unordered_map<std::string, FileReaderConfig>& GetAllFileReaderConfigs() const {
@@ -79,6 +83,7 @@ private:
     void PauseInner();
 
     std::unordered_map<std::string, FileDiscoveryConfig> mPipelineNameFileDiscoveryConfigsMap;
+    FileDiscoveryIndex mFileDiscoveryIndex;
     std::unordered_map<std::string, FileReaderConfig> mPipelineNameFileReaderConfigsMap;
     std::unordered_map<std::string, MultilineConfig> mPipelineNameMultilineConfigsMap;
     std::unordered_map<std::string, std::shared_ptr<std::vector<ContainerInfo>>> mAllContainerInfoMap;
@@ -308,6 +308,15 @@ void FlusherSLS::FlushAll() {
 }
 
 bool FlusherSLS::Send(string&& data, const string& shardHashKey, const string& logstore) {
+    if (!mCompressor) {
+        size_t rawSize = data.size();
+        PushToQueue(std::move(data), rawSize, LOGGROUP_COMPRESSED, logstore);
+        return true;
+    }
+    return Send(StringView(data), shardHashKey, logstore);
+}
+
+bool FlusherSLS::Send(StringView data, const string& shardHashKey, const string& logstore) {
     string compressedData;
     if (mCompressor) {
         string errorMsg;
@@ -324,7 +333,7 @@ bool FlusherSLS::Send(string&& data, const string& shardHashKey, const string& l
             return false;
         }
     } else {
-        compressedData = data;
+        compressedData = data.to_string();
     }
     PushToQueue(std::move(compressedData), data.size(), LOGGROUP_COMPRESSED, logstore);
     return true;
@@ -367,6 +376,7 @@ void FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
                                        mContext->GetRegion());
         return;
     }
+    size_t rawSize = serializedData.size();
     if (mCompressor) {
         if (!mCompressor->Compress(serializedData, compressedData, errorMsg)) {
             LOG_WARNING(mContext->GetLogger(),
@@ -382,10 +392,10 @@ void FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
             return;
         }
     } else {
-        compressedData = serializedData;
+        compressedData.swap(serializedData);
     }
     PushToQueue(std::move(compressedData),
-                serializedData.size(),
+                rawSize,
                 LOGGROUP_COMPRESSED,
                 "",
                 g.mExactlyOnceCheckpoint->data.hash_key(),
@@ -420,6 +430,7 @@ void FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
                                            mContext->GetRegion());
             return;
         }
+        size_t rawSize = serializedData.size();
         if (mCompressor) {
             if (!mCompressor->Compress(serializedData, compressedData, errorMsg)) {
                 LOG_WARNING(mContext->GetLogger(),
@@ -435,21 +446,21 @@ void FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
                 return;
             }
         } else {
-            compressedData = serializedData;
+            compressedData.swap(serializedData);
         }
         if (enablePackageList) {
-            packageSize += serializedData.size();
-            compressedLogGroups.emplace_back(std::move(compressedData), serializedData.size());
+            packageSize += rawSize;
+            compressedLogGroups.emplace_back(std::move(compressedData), rawSize);
         } else {
             if (group.mExactlyOnceCheckpoint) {
                 PushToQueue(std::move(compressedData),
-                            serializedData.size(),
+                            rawSize,
                             LOGGROUP_COMPRESSED,
                             "",
                             group.mExactlyOnceCheckpoint->data.hash_key(),
                             group.mExactlyOnceCheckpoint);
             } else {
-                PushToQueue(std::move(compressedData), serializedData.size(), LOGGROUP_COMPRESSED, "", shardHashKey);
+                PushToQueue(std::move(compressedData), rawSize, LOGGROUP_COMPRESSED, "", shardHashKey);
             }
         }
     }
@@ -503,7 +514,7 @@ void FlusherSLS::PushToQueue(string&& data,
                              const string& shardHashKey,
                              const RangeCheckpointPtr& eoo) {
     sls_logs::SlsCompressType compressType = sls_logs::SLS_CMP_NONE;
-    switch (mCompressor->GetCompressType()) {
+    switch (GetCompressType()) {
         case CompressType::LZ4:
             compressType = sls_logs::SLS_CMP_LZ4;
             break;
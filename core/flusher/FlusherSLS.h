@@ -55,6 +55,8 @@ public:
 
     // for use of Go pipeline, stream, observer and shennong
     bool Send(std::string&& data, const std::string& shardHashKey, const std::string& logstore = "");
+    // data is not owned by the flusher, which avoids an extra copy when compression is enabled
+    bool Send(StringView data, const std::string& shardHashKey, const std::string& logstore = "");
 
     std::string mProject;
     std::string mLogstore;
@@ -49,6 +49,7 @@ LogtailPlugin::LogtailPlugin() {
     mResumeFun = NULL;
     mLoadGlobalConfigFun = NULL;
     mProcessRawLogFun = NULL;
+    mProcessFlatLogGroupFun = NULL;
     mPluginValid = false;
     mPluginAlarmConfig.mLogstore = "logtail_alarm";
     mPluginAlarmConfig.mAliuid = STRING_FLAG(logtail_profile_aliuid);
@@ -195,7 +196,7 @@ int LogtailPlugin::SendPbV2(const char* configName,
     if (shardHashSize > 0) {
         shardHashStr.assign(shardHash, static_cast<size_t>(shardHashSize));
     }
-    return pConfig->Send(std::string(pbBuffer, pbSize), shardHash, logstore) ? 0 : -1;
+    return pConfig->Send(StringView(pbBuffer, pbSize), shardHashStr, logstore) ? 0 : -1;
 }
 
 int LogtailPlugin::ExecPluginCmd(
@@ -361,6 +362,12 @@ bool LogtailPlugin::LoadPluginBase() {
             LOG_ERROR(sLogger, ("load ProcessLogGroup error, Message", error));
             return mPluginValid;
         }
+        // optional, fall back to ProcessLogGroup if not found
+        mProcessFlatLogGroupFun = (ProcessFlatLogGroupFun)loader.LoadMethod("ProcessFlatLogGroup", error);
+        if (!error.empty()) {
+            LOG_WARNING(sLogger, ("load ProcessFlatLogGroup error", error)("action", "use ProcessLogGroup instead"));
+            mProcessFlatLogGroupFun = NULL;
+        }
 
         mPluginBasePtr = loader.Release();
     }
@@ -443,6 +450,29 @@ void LogtailPlugin::ProcessLogGroup(const std::string& configName,
     }
 }
 
+void LogtailPlugin::ProcessFlatLogGroup(const std::string& configName,
+                                        const std::string& logGroup,
+                                        const std::string& packId) {
+    if (logGroup.empty() || !IsFlatLogGroupSupported()) {
+        return;
+    }
+    std::string realConfigName = configName + "/2";
+    std::string packIdPrefix = ToHexString(HashString(packId));
+    GoString goConfigName;
+    GoSlice goLog;
+    GoString goPackId;
+    goConfigName.n = realConfigName.size();
+    goConfigName.p = realConfigName.c_str();
+    goPackId.n = packIdPrefix.size();
+    goPackId.p = packIdPrefix.c_str();
+    goLog.len = goLog.cap = logGroup.length();
+    goLog.data = (void*)logGroup.c_str();
+    GoInt rst = mProcessFlatLogGroupFun(goConfigName, goLog, goPackId);
+    if (rst != (GoInt)0) {
+        LOG_WARNING(sLogger, ("process flat loggroup error", configName)("result", rst));
+    }
+}
+
 K8sContainerMeta LogtailPlugin::GetContainerMeta(const string& containerID) {
     if (mPluginValid && mGetContainerMetaFun != nullptr) {
         GoString id;
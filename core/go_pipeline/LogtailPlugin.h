@@ -126,6 +126,7 @@ typedef GoInt (*InitPluginBaseFun)();
 typedef GoInt (*InitPluginBaseV2Fun)(GoString cfg);
 typedef GoInt (*ProcessLogsFun)(GoString c, GoSlice l, GoString p, GoString t, GoSlice tags);
 typedef GoInt (*ProcessLogGroupFun)(GoString c, GoSlice l, GoString p);
+typedef GoInt (*ProcessFlatLogGroupFun)(GoString c, GoSlice l, GoString p);
 typedef struct innerContainerMeta* (*GetContainerMetaFun)(GoString containerID);
 
 // Methods export by adapter.
@@ -220,6 +221,9 @@ public:
                     const std::string& tags);
 
     void ProcessLogGroup(const std::string& configName, const std::string& logGroup, const std::string& packId);
+    // logGroup is in the format written by FlatLogGroupWriter, which is only supported by newer plugin base
+    void ProcessFlatLogGroup(const std::string& configName, const std::string& logGroup, const std::string& packId);
+    bool IsFlatLogGroupSupported() const { return mPluginValid && mProcessFlatLogGroupFun != NULL; }
 
     static int IsValidToSend(long long logstoreKey);
 
@@ -264,6 +268,7 @@ private:
     logtail::FlusherSLS mPluginContainerConfig;
     ProcessLogsFun mProcessLogsFun;
     ProcessLogGroupFun mProcessLogGroupFun;
+    ProcessFlatLogGroupFun mProcessFlatLogGroupFun;
     GetContainerMetaFun mGetContainerMetaFun;
 
     // Configuration for plugin system in JSON format.
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "common/memory/SourceBuffer.h"
+
+namespace logtail {
+
+// Memory of the events created by a group is carved out of chunks owned by the arena, and returned to the heap all at
+// once instead of one free per event. The arena is referenced by the group and every live event allocated from it, so
+// that events moved to other groups or batches remain valid after the group is gone. Memory of an event destroyed
+// earlier is not reused before the arena is released.
+//
+// only Allocate is not thread safe, which should be called by the owner group only
+class EventArena {
+public:
+    static constexpr size_t kAlignSize = alignof(std::max_align_t);
+
+    EventArena() : mAllocator(kFirstChunkSize) {}
+    EventArena(const EventArena&) = delete;
+    EventArena& operator=(const EventArena&) = delete;
+
+    void* Allocate(size_t bytes) {
+        AddRef();
+        // chunks are allocated by new[], which are aligned to kAlignSize already
+        return mAllocator.Allocate((bytes + kAlignSize - 1) & ~(kAlignSize - 1));
+    }
+
+    // the caller must have a reference already
+    void AddRef() { mRefCnt.fetch_add(1, std::memory_order_relaxed); }
+    void Release() {
+        if (mRefCnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    int64_t GetAllocatedSize() const { return mAllocator.GetAllocatedSize(); }
+
+private:
+    static constexpr uint32_t kFirstChunkSize = 2048;
+
+    ~EventArena() = default;
+
+    BufferAllocator mAllocator;
+    // the creator holds the first reference
+    std::atomic_uint32_t mRefCnt{1};
+};
+
+} // namespace logtail
@@ -16,6 +16,8 @@
 
 #include "models/LogEvent.h"
 
+#include <cstring>
+
 using namespace std;
 
 namespace logtail {
@@ -28,15 +30,15 @@ unique_ptr<PipelineEvent> LogEvent::Copy() const {
 }
 
 StringView LogEvent::GetContent(StringView key) const {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return mContents[it->second].first.second;
+    size_t idx = FindContentIndex(key);
+    if (idx != mContents.size()) {
+        return mContents[idx].first.second;
     }
     return gEmptyStringView;
 }
 
 bool LogEvent::HasContent(StringView key) const {
-    return mIndex.find(key) != mIndex.end();
+    return FindContentIndex(key) != mContents.size();
 }
 
 void LogEvent::SetContent(StringView key, StringView val) {
@@ -56,42 +58,35 @@ void LogEvent::SetContentNoCopy(const StringBuffer& key, const StringBuffer& val
 }
 
 void LogEvent::SetContentNoCopy(StringView key, StringView val) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        auto& field = mContents[it->second].first;
+    size_t idx = FindContentIndex(key);
+    if (idx != mContents.size()) {
+        auto& field = mContents[idx].first;
         mAllocatedContentSize += key.size() + val.size() - field.first.size() - field.second.size();
         field = make_pair(key, val);
     } else {
-        mAllocatedContentSize += key.size() + val.size();
-        mContents.emplace_back(make_pair(key, val), true);
-        mIndex[key] = mContents.size() - 1;
+        AppendContentNoCopy(key, val);
     }
 }
 
 void LogEvent::DelContent(StringView key) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        auto& field = mContents[it->second].first;
+    size_t idx = FindContentIndex(key);
+    if (idx != mContents.size()) {
+        auto& field = mContents[idx].first;
         mAllocatedContentSize -= field.first.size() + field.second.size();
-        mContents[it->second].second = false;
-        mIndex.erase(it);
+        mContents[idx].second = false;
+        --mContentCnt;
+        if (mContents.size() > kContentIndexThreshold) {
+            mIndex.erase(key);
+        }
     }
 }
 
 LogEvent::ContentIterator LogEvent::FindContent(StringView key) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return ContentIterator(mContents.begin() + it->second, mContents);
-    }
-    return ContentIterator(mContents.end(), mContents);
+    return ContentIterator(mContents.begin() + FindContentIndex(key), mContents);
 }
 
 LogEvent::ConstContentIterator LogEvent::FindContent(StringView key) const {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return ConstContentIterator(mContents.begin() + it->second, mContents);
-    }
-    return ConstContentIterator(mContents.end(), mContents);
+    return ConstContentIterator(mContents.begin() + FindContentIndex(key), mContents);
 }
 
 LogEvent::ContentIterator LogEvent::begin() {
@@ -130,11 +125,44 @@ LogEvent::ConstContentIterator LogEvent::cend() const {
 void LogEvent::AppendContentNoCopy(StringView key, StringView val) {
     mAllocatedContentSize += key.size() + val.size();
     mContents.emplace_back(make_pair(key, val), true);
-    mIndex[key] = mContents.size() - 1;
+    ++mContentCnt;
+    // invalidated contents are never removed from mContents, so the threshold is crossed only once
+    if (mContents.size() == kContentIndexThreshold + 1) {
+        BuildContentIndex();
+    } else if (mContents.size() > kContentIndexThreshold) {
+        mIndex[key] = mContents.size() - 1;
+    }
+}
+
+size_t LogEvent::FindContentIndex(StringView key) const {
+    if (mContents.size() > kContentIndexThreshold) {
+        auto it = mIndex.find(key);
+        return it == mIndex.end() ? mContents.size() : it->second;
+    }
+    // searched backwards, so that the last one is found when the same key is appended more than once
+    for (size_t i = mContents.size(); i > 0; --i) {
+        const auto& item = mContents[i - 1];
+        // keys differ in size mostly, so the content is compared only when necessary
+        const StringView& k = item.first.first;
+        if (k.size() == key.size() && item.second && memcmp(k.data(), key.data(), key.size()) == 0) {
+            return i - 1;
+        }
+    }
+    return mContents.size();
+}
+
+void LogEvent::BuildContentIndex() {
+    mIndex.reserve(mContents.size() * 2);
+    for (size_t i = 0; i < mContents.size(); ++i) {
+        if (mContents[i].second) {
+            mIndex[mContents[i].first.first] = i;
+        }
+    }
 }
 
 size_t LogEvent::DataSize() const {
-    return PipelineEvent::DataSize() + sizeof(decltype(mContents)) + mAllocatedContentSize;
+    // the inline storage of mContents is not counted, so that size based batching is not affected by the layout
+    return PipelineEvent::DataSize() + sizeof(std::vector<std::pair<LogContent, bool>>) + mAllocatedContentSize;
 }
 
 #ifdef APSARA_UNIT_TEST_MAIN
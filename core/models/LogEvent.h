@@ -16,12 +16,18 @@
 
 #pragma once
 
+#include <string_view>
+#include <unordered_map>
+
+#include <boost/container/small_vector.hpp>
+
 #include "models/PipelineEvent.h"
 
 namespace logtail {
 
 using LogContent = std::pair<StringView, StringView>;
-using ContentsContainer = std::vector<std::pair<LogContent, bool>>;
+// most events have only a few contents, which are stored inline without any allocation
+using ContentsContainer = boost::container::small_vector<std::pair<LogContent, bool>, 8>;
 
 template <class T, class F>
 class BaseContentIterator {
@@ -87,8 +93,8 @@ public:
     }
     std::pair<uint32_t, uint32_t> GetPosition() const { return {mFileOffset, mRawSize}; }
 
-    bool Empty() const { return mIndex.empty(); }
-    size_t Size() const { return mIndex.size(); }
+    bool Empty() const { return mContentCnt == 0; }
+    size_t Size() const { return mContentCnt; }
 
     ContentIterator begin();
     ContentIterator end();
@@ -105,8 +111,20 @@ public:
 #endif
 
 private:
+    // contents are looked up by linear search, which is faster than any index for a few contents, until there are
+    // more than kContentIndexThreshold of them.
+    static constexpr size_t kContentIndexThreshold = 16;
+
+    struct StringViewHash {
+        size_t operator()(StringView s) const { return std::hash<std::string_view>()({s.data(), s.size()}); }
+    };
+
     LogEvent(PipelineEventGroup* ptr);
 
+    // return mContents.size() if not found
+    size_t FindContentIndex(StringView key) const;
+    void BuildContentIndex();
+
     // this is only used for ProcessorParseApsaraNative for backward compatability, since multiple keys are allowed.
     // We do not invalidate existing LogContent when the same key has arrived.
     friend class ProcessorParseApsaraNative;
@@ -116,7 +134,9 @@ private:
     // information for backward compatability.
     ContentsContainer mContents;
     size_t mAllocatedContentSize = 0;
-    std::map<StringView, size_t> mIndex;
+    size_t mContentCnt = 0;
+    // only maintained when there are more than kContentIndexThreshold contents
+    std::unordered_map<StringView, size_t, StringViewHash> mIndex;
     uint32_t mFileOffset = 0;
     uint32_t mRawSize = 0;
 };
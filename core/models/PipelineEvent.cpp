@@ -17,6 +17,7 @@
 #include <sstream>
 
 #include "logger/Logger.h"
+#include "models/EventArena.h"
 #include "models/PipelineEventGroup.h"
 
 using namespace std;
@@ -25,6 +26,42 @@ namespace logtail {
 
 StringView gEmptyStringView;
 
+// the arena the event is allocated from is stored in the header, which is nullptr if allocated from the heap
+static constexpr size_t kEventHeaderSize = EventArena::kAlignSize;
+
+static void* InitEventHeader(void* header, EventArena* arena) {
+    *static_cast<EventArena**>(header) = arena;
+    return static_cast<char*>(header) + kEventHeaderSize;
+}
+
+void* PipelineEvent::operator new(size_t size) {
+    return InitEventHeader(::operator new(size + kEventHeaderSize), nullptr);
+}
+
+void* PipelineEvent::operator new(size_t size, EventArena* arena) {
+    if (arena == nullptr) {
+        return PipelineEvent::operator new(size);
+    }
+    return InitEventHeader(arena->Allocate(size + kEventHeaderSize), arena);
+}
+
+void PipelineEvent::operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    void* header = static_cast<char*>(ptr) - kEventHeaderSize;
+    EventArena* arena = *static_cast<EventArena**>(header);
+    if (arena == nullptr) {
+        ::operator delete(header);
+    } else {
+        arena->Release();
+    }
+}
+
+void PipelineEvent::operator delete(void* ptr, EventArena* arena) noexcept {
+    PipelineEvent::operator delete(ptr);
+}
+
 const string& PipelineEventTypeToString(PipelineEvent::Type t) {
     switch (t) {
         case PipelineEvent::Type::LOG:
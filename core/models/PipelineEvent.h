@@ -32,12 +32,20 @@
 
 namespace logtail {
 
+class EventArena;
 class PipelineEventGroup;
 
 class PipelineEvent {
 public:
     enum class Type { NONE, LOG, METRIC, SPAN };
 
+    // Events created by PipelineEventGroup are allocated from the arena of the group, while others (e.g., copies)
+    // are allocated from the heap. Either can be freed by delete, since where it comes from is recorded before it.
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, EventArena* arena);
+    static void operator delete(void* ptr) noexcept;
+    static void operator delete(void* ptr, EventArena* arena) noexcept;
+
     virtual ~PipelineEvent() = default;
 
     virtual std::unique_ptr<PipelineEvent> Copy() const = 0;
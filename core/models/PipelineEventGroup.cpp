@@ -17,11 +17,15 @@
 #include "models/PipelineEventGroup.h"
 
 #include <sstream>
+#include <string_view>
 
+#include "common/Flags.h"
 #include "common/HashUtil.h"
 #include "logger/Logger.h"
 #include "processor/inner/ProcessorParseContainerLogNative.h"
 
+DEFINE_FLAG_BOOL(enable_event_arena, "allocate events from the arena of the event group", true);
+
 using namespace std;
 
 namespace logtail {
@@ -30,9 +34,11 @@ PipelineEventGroup::PipelineEventGroup(PipelineEventGroup&& rhs) noexcept
     : mMetadata(std::move(rhs.mMetadata)),
       mTags(std::move(rhs.mTags)),
       mEvents(std::move(rhs.mEvents)),
-      mSourceBuffer(std::move(rhs.mSourceBuffer)) {
+      mSourceBuffer(std::move(rhs.mSourceBuffer)),
+      mEventArena(rhs.mEventArena) {
+    rhs.mEventArena = nullptr;
     for (auto& item : mEvents) {
-        item->ResetPipelineEventGroup(this);
+        item.ResetPipelineEventGroup(this);
     }
 }
 
@@ -42,13 +48,25 @@ PipelineEventGroup& PipelineEventGroup::operator=(PipelineEventGroup&& rhs) noex
         mTags = std::move(rhs.mTags);
         mEvents = std::move(rhs.mEvents);
         mSourceBuffer = std::move(rhs.mSourceBuffer);
+        if (mEventArena) {
+            mEventArena->Release();
+        }
+        mEventArena = rhs.mEventArena;
+        rhs.mEventArena = nullptr;
         for (auto& item : mEvents) {
-            item->ResetPipelineEventGroup(this);
+            item.ResetPipelineEventGroup(this);
         }
     }
     return *this;
 }
 
+PipelineEventGroup::~PipelineEventGroup() {
+    // events still in the group hold their own references to the arena
+    if (mEventArena) {
+        mEventArena->Release();
+    }
+}
+
 PipelineEventGroup PipelineEventGroup::Copy() const {
     PipelineEventGroup res(mSourceBuffer);
     res.mMetadata = mMetadata;
@@ -56,44 +74,65 @@ PipelineEventGroup PipelineEventGroup::Copy() const {
     res.mExactlyOnceCheckpoint = mExactlyOnceCheckpoint;
     for (auto& event : mEvents) {
         res.mEvents.emplace_back(event.Copy());
-        res.mEvents.back()->ResetPipelineEventGroup(&res);
+        res.mEvents.back().ResetPipelineEventGroup(&res);
+    }
+    return res;
+}
+
+PipelineEventGroup PipelineEventGroup::Share() {
+    PipelineEventGroup res(mSourceBuffer);
+    res.mMetadata = mMetadata;
+    res.mTags = mTags;
+    res.mExactlyOnceCheckpoint = mExactlyOnceCheckpoint;
+    res.mEvents.reserve(mEvents.size());
+    for (auto& event : mEvents) {
+        res.mEvents.emplace_back(event.Share());
+        event.ResetPipelineEventGroup(this);
+        res.mEvents.back().ResetPipelineEventGroup(&res);
     }
     return res;
 }
 
 unique_ptr<LogEvent> PipelineEventGroup::CreateLogEvent() {
     // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<LogEvent>(new LogEvent(this));
+    return unique_ptr<LogEvent>(new (AcquireEventArena()) LogEvent(this));
 }
 
 unique_ptr<MetricEvent> PipelineEventGroup::CreateMetricEvent() {
     // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<MetricEvent>(new MetricEvent(this));
+    return unique_ptr<MetricEvent>(new (AcquireEventArena()) MetricEvent(this));
 }
 
 unique_ptr<SpanEvent> PipelineEventGroup::CreateSpanEvent() {
     // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<SpanEvent>(new SpanEvent(this));
+    return unique_ptr<SpanEvent>(new (AcquireEventArena()) SpanEvent(this));
 }
 
 LogEvent* PipelineEventGroup::AddLogEvent() {
-    LogEvent* e = new LogEvent(this);
+    LogEvent* e = new (AcquireEventArena()) LogEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
 
 MetricEvent* PipelineEventGroup::AddMetricEvent() {
-    MetricEvent* e = new MetricEvent(this);
+    MetricEvent* e = new (AcquireEventArena()) MetricEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
 
 SpanEvent* PipelineEventGroup::AddSpanEvent() {
-    SpanEvent* e = new SpanEvent(this);
+    SpanEvent* e = new (AcquireEventArena()) SpanEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
 
+EventArena* PipelineEventGroup::AcquireEventArena() {
+    if (!mEventArena && BOOL_FLAG(enable_event_arena)) {
+        mEventArena = new EventArena();
+    }
+    return mEventArena;
+}
+
 void PipelineEventGroup::SetMetadata(EventGroupMetaKey key, StringView val) {
     SetMetadataNoCopy(key, mSourceBuffer->CopyString(val));
 }
@@ -107,22 +146,18 @@ void PipelineEventGroup::SetMetadataNoCopy(EventGroupMetaKey key, const StringBu
 }
 
 bool PipelineEventGroup::HasMetadata(EventGroupMetaKey key) const {
-    return mMetadata.find(key) != mMetadata.end();
+    return mMetadata.Has(key);
 }
 void PipelineEventGroup::SetMetadataNoCopy(EventGroupMetaKey key, StringView val) {
-    mMetadata[key] = val;
+    mMetadata.Set(key, val);
 }
 
 StringView PipelineEventGroup::GetMetadata(EventGroupMetaKey key) const {
-    auto it = mMetadata.find(key);
-    if (it != mMetadata.end()) {
-        return it->second;
-    }
-    return gEmptyStringView;
+    return mMetadata.Get(key);
 }
 
 void PipelineEventGroup::DelMetadata(EventGroupMetaKey key) {
-    mMetadata.erase(key);
+    mMetadata.Erase(key);
 }
 
 void PipelineEventGroup::SetTag(StringView key, StringView val) {
@@ -161,13 +196,17 @@ void PipelineEventGroup::DelTag(StringView key) {
     mTags.Erase(key);
 }
 
+static size_t HashStringView(StringView s) {
+    return hash<string_view>{}(string_view(s.data(), s.size()));
+}
+
 size_t PipelineEventGroup::GetTagsHash() const {
     size_t seed = 0;
     for (const auto& item : mTags.mInner) {
-        HashCombine(seed, hash<string>{}(item.first.to_string()));
-        HashCombine(seed, hash<string>{}(item.second.to_string()));
+        HashCombine(seed, HashStringView(item.first));
+        HashCombine(seed, HashStringView(item.second));
     }
-    HashCombine(seed, hash<string>{}(GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string()));
+    HashCombine(seed, HashStringView(GetMetadata(EventGroupMetaKey::SOURCE_ID)));
     return seed;
 }
 
@@ -250,10 +289,13 @@ EventGroupMetaKey StringToEventGroupMetaKey(const string& key) {
 
 Json::Value PipelineEventGroup::ToJson(bool enableEventMeta) const {
     Json::Value root;
-    if (!mMetadata.empty()) {
+    if (!mMetadata.Empty()) {
         Json::Value metadata;
-        for (const auto& meta : mMetadata) {
-            metadata[EventGroupMetaKeyToString(meta.first)] = EventGroupMetaValueToString(meta.second.to_string());
+        for (size_t i = 0; i < GroupMetadata::kKeyCnt; ++i) {
+            auto key = static_cast<EventGroupMetaKey>(i);
+            if (mMetadata.Has(key)) {
+                metadata[EventGroupMetaKeyToString(key)] = EventGroupMetaValueToString(mMetadata.Get(key).to_string());
+            }
         }
         root["metadata"] = metadata;
     }
@@ -16,13 +16,17 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <memory>
 #include <string>
 
 #include "checkpoint/RangeCheckpoint.h"
 #include "common/Constants.h"
 #include "common/memory/SourceBuffer.h"
+#include "models/EventArena.h"
 #include "models/PipelineEventPtr.h"
+#include "models/SizedContainer.h"
 
 namespace logtail {
 
@@ -51,11 +55,33 @@ enum class EventGroupMetaKey {
     CONTAINER_IMAGE_NAME,
     CONTAINER_IMAGE_ID,
 
+    // should always be the last one, see GroupMetadata
     SOURCE_ID
 };
 
-using GroupMetadata = std::map<EventGroupMetaKey, StringView>;
-using GroupTags = std::map<StringView, StringView>;
+// Metadata keys are a small enum, so values are kept in a fixed array indexed by the key instead of a map.
+class GroupMetadata {
+public:
+    static constexpr size_t kKeyCnt = static_cast<size_t>(EventGroupMetaKey::SOURCE_ID) + 1;
+
+    void Set(EventGroupMetaKey key, StringView val) {
+        mValues[static_cast<size_t>(key)] = val;
+        mKeys.set(static_cast<size_t>(key));
+    }
+    StringView Get(EventGroupMetaKey key) const { return mValues[static_cast<size_t>(key)]; }
+    bool Has(EventGroupMetaKey key) const { return mKeys.test(static_cast<size_t>(key)); }
+    void Erase(EventGroupMetaKey key) {
+        mValues[static_cast<size_t>(key)] = StringView();
+        mKeys.reset(static_cast<size_t>(key));
+    }
+    bool Empty() const { return mKeys.none(); }
+
+private:
+    std::array<StringView, kKeyCnt> mValues;
+    std::bitset<kKeyCnt> mKeys;
+};
+
+using GroupTags = boost::container::flat_map<StringView, StringView>;
 
 // DeepCopy is required if we want to support no-linear topology
 // We cannot just use default copy constructor as it won't deep copy PipelineEvent pointed in Events vector.
@@ -67,8 +93,12 @@ public:
     PipelineEventGroup(const std::shared_ptr<SourceBuffer>& sourceBuffer) : mSourceBuffer(sourceBuffer) {}
     PipelineEventGroup(PipelineEventGroup&&) noexcept;
     PipelineEventGroup& operator=(PipelineEventGroup&&) noexcept;
+    ~PipelineEventGroup();
 
     PipelineEventGroup Copy() const;
+    // Unlike Copy, events are shared between the two groups and only copied when modified. Tags, metadata and source
+    // buffer are shared the same way as Copy does.
+    PipelineEventGroup Share();
 
     std::unique_ptr<LogEvent> CreateLogEvent();
     std::unique_ptr<MetricEvent> CreateMetricEvent();
@@ -112,6 +142,8 @@ public:
     size_t DataSize() const;
 
 #ifdef APSARA_UNIT_TEST_MAIN
+    EventArena* GetEventArena() const { return mEventArena; }
+
     // for debug and test
     Json::Value ToJson(bool enableEventMeta = false) const;
     bool FromJson(const Json::Value&);
@@ -120,11 +152,15 @@ public:
 #endif
 
 private:
+    EventArena* AcquireEventArena();
+
     GroupMetadata mMetadata; // Used to generate tag/log. Will not output.
     SizedMap mTags; // custom tags to output
     EventsContainer mEvents;
     std::shared_ptr<SourceBuffer> mSourceBuffer;
     RangeCheckpointPtr mExactlyOnceCheckpoint;
+    // created on first event creation, see EventArena
+    EventArena* mEventArena = nullptr;
 };
 
 } // namespace logtail
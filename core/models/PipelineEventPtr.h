@@ -26,56 +26,98 @@
 namespace logtail {
 
 // only movable
+// An event can be owned by several PipelineEventPtr in read-only mode via Share(), e.g., when the same event group is
+// sent to multiple flushers. A shared event is copied on the first mutable access by any owner, so the modification is
+// invisible to the other owners. The owners may live in different threads, so the reference count cannot tell whether
+// the event is still read by others, and the copy is made even if the other owners are gone.
 class PipelineEventPtr {
 public:
     PipelineEventPtr() = default;
     PipelineEventPtr(PipelineEvent* ptr) : mData(std::unique_ptr<PipelineEvent>(ptr)) {}
     PipelineEventPtr(std::unique_ptr<PipelineEvent>&& ptr) : mData(std::move(ptr)) {}
 
-    void Reset(std::unique_ptr<PipelineEvent>&& ptr) { mData.reset(ptr.release()); }
+    void Reset(std::unique_ptr<PipelineEvent>&& ptr) {
+        mData.reset(ptr.release());
+        mSharedData.reset();
+    }
     PipelineEventPtr& operator=(std::unique_ptr<PipelineEvent>&& ptr) {
         mData = std::move(ptr);
+        mSharedData.reset();
         return *this;
     }
 
     template <typename T>
     bool Is() const {
         if (typeid(T) == typeid(LogEvent)) {
-            return mData->GetType() == PipelineEvent::Type::LOG;
+            return Ptr()->GetType() == PipelineEvent::Type::LOG;
         }
         if (typeid(T) == typeid(MetricEvent)) {
-            return mData->GetType() == PipelineEvent::Type::METRIC;
+            return Ptr()->GetType() == PipelineEvent::Type::METRIC;
         }
         if (typeid(T) == typeid(SpanEvent)) {
-            return mData->GetType() == PipelineEvent::Type::SPAN;
+            return Ptr()->GetType() == PipelineEvent::Type::SPAN;
         }
         return false;
     }
     template <typename T>
     T& Cast() {
-        return *static_cast<T*>(mData.get());
+        return *static_cast<T*>(MutablePtr());
     }
     template <typename T>
     const T& Cast() const {
-        return *static_cast<const T*>(mData.get());
+        return *static_cast<const T*>(Ptr());
     }
     template <typename T>
     T* Get() {
-        return Is<T>() ? static_cast<T*>(mData.get()) : nullptr;
+        return Is<T>() ? static_cast<T*>(MutablePtr()) : nullptr;
     }
     template <typename T>
     const T* Get() const {
-        return Is<T>() ? static_cast<const T*>(mData.get()) : nullptr;
+        return Is<T>() ? static_cast<const T*>(Ptr()) : nullptr;
     }
 
-    operator bool() const { return static_cast<bool>(mData); }
-    PipelineEvent* operator->() { return mData.operator->(); }
-    const PipelineEvent* operator->() const { return mData.operator->(); }
+    operator bool() const { return mData || mSharedData; }
+    PipelineEvent* operator->() { return MutablePtr(); }
+    const PipelineEvent* operator->() const { return Ptr(); }
 
-    PipelineEventPtr Copy() const { return PipelineEventPtr(mData->Copy()); }
+    PipelineEventPtr Copy() const { return PipelineEventPtr(Ptr()->Copy()); }
+    // the event is owned by both *this and the returned object in read-only mode afterwards
+    PipelineEventPtr Share() {
+        if (mData) {
+            mSharedData = std::move(mData);
+        }
+        PipelineEventPtr res;
+        res.mSharedData = mSharedData;
+        res.mPipelineEventGroupPtr = mPipelineEventGroupPtr;
+        return res;
+    }
+    bool IsShared() const { return mSharedData != nullptr; }
+    // the group pointer of a shared event cannot be modified, so it is recorded here and applied on copy
+    void ResetPipelineEventGroup(PipelineEventGroup* ptr) {
+        if (mData) {
+            mData->ResetPipelineEventGroup(ptr);
+        } else {
+            mPipelineEventGroupPtr = ptr;
+        }
+    }
 
 private:
+    const PipelineEvent* Ptr() const { return mData ? mData.get() : mSharedData.get(); }
+    PipelineEvent* MutablePtr() {
+        if (mData || !mSharedData) {
+            return mData.get();
+        }
+        mData = mSharedData->Copy();
+        mSharedData.reset();
+        if (mPipelineEventGroupPtr) {
+            mData->ResetPipelineEventGroup(mPipelineEventGroupPtr);
+        }
+        return mData.get();
+    }
+
     std::unique_ptr<PipelineEvent> mData;
+    std::shared_ptr<PipelineEvent> mSharedData;
+    PipelineEventGroup* mPipelineEventGroupPtr = nullptr;
 };
 
 } // namespace logtail
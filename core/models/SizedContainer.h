@@ -16,9 +16,10 @@
 
 #pragma once
 
-#include <map>
 #include <vector>
 
+#include <boost/container/flat_map.hpp>
+
 #include "models/StringView.h"
 
 namespace logtail {
@@ -34,7 +35,7 @@ public:
             iter->second = val;
         } else {
             mAllocatedSize += key.size() + val.size();
-            mInner[key] = val;
+            mInner.emplace(key, val);
         }
     }
 
@@ -53,7 +54,9 @@ public:
         mAllocatedSize = 0;
     }
 
-    std::map<StringView, StringView> mInner;
+    // tags are few and iterated more often than modified, so they are kept sorted in a vector, which is iterated in
+    // the same order as std::map without allocating a node for each tag
+    boost::container::flat_map<StringView, StringView> mInner;
 
 private:
     size_t mAllocatedSize = 0;
@@ -49,7 +49,10 @@ namespace observer {
     std::string kCount = "count";
     std::string kProtocol = "protocol";
     std::string kVersion = "version";
-    std::string kTdigestLatency = "tdigest_latency";
+    std::string kLatencyP50Ns = "latency_p50_ns";
+    std::string kLatencyP90Ns = "latency_p90_ns";
+    std::string kLatencyP99Ns = "latency_p99_ns";
+    std::string kLatencySketch = "latency_sketch";
 
 } // namespace observer
 
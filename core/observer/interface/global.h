@@ -55,7 +55,10 @@ namespace observer {
     extern std::string kCount;
     extern std::string kProtocol;
     extern std::string kVersion;
-    extern std::string kTdigestLatency;
+    extern std::string kLatencyP50Ns;
+    extern std::string kLatencyP90Ns;
+    extern std::string kLatencyP99Ns;
+    extern std::string kLatencySketch;
 
 } // namespace observer
 } // namespace logtail
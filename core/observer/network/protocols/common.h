@@ -17,6 +17,7 @@
 #pragma once
 
 #include "interface/protocol.h"
+#include "network/protocols/sketch.h"
 #include <deque>
 #include "log_pb/sls_logs.pb.h"
 #include "interface/helper.h"
@@ -82,6 +83,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs = 0;
         TotalReqBytes = 0;
         TotalRespBytes = 0;
+        Latency.Clear();
     }
 
     bool IsEmpty() const { return TotalCount == 0; }
@@ -91,6 +93,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs += info.LatencyNs;
         TotalReqBytes += info.ReqBytes;
         TotalRespBytes += info.RespBytes;
+        Latency.Add(info.LatencyNs);
     }
 
     void Merge(CommonProtocolAggResult& aggResult) {
@@ -98,6 +101,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs += aggResult.TotalLatencyNs;
         TotalReqBytes += aggResult.TotalReqBytes;
         TotalRespBytes += aggResult.TotalRespBytes;
+        Latency.Merge(aggResult.Latency);
     }
 
     void ToPB(sls_logs::Log* log) const {
@@ -105,13 +109,17 @@ struct CommonProtocolAggResult {
         AddAnyLogContent(log, observer::kLatencyNs, TotalLatencyNs);
         AddAnyLogContent(log, observer::kReqBytes, TotalReqBytes);
         AddAnyLogContent(log, observer::kRespBytes, TotalRespBytes);
-        AddAnyLogContent(log, observer::kTdigestLatency, std::string("xxxxx"));
+        AddAnyLogContent(log, observer::kLatencyP50Ns, Latency.Quantile(0.5));
+        AddAnyLogContent(log, observer::kLatencyP90Ns, Latency.Quantile(0.9));
+        AddAnyLogContent(log, observer::kLatencyP99Ns, Latency.Quantile(0.99));
+        AddAnyLogContent(log, observer::kLatencySketch, Latency.Serialize());
     }
 
     int64_t TotalCount{0};
     int64_t TotalLatencyNs{0};
     int64_t TotalReqBytes{0};
     int64_t TotalRespBytes{0};
+    LatencySketch Latency;
 };
 
 
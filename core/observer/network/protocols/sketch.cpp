@@ -0,0 +1,152 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace logtail {
+
+static const double kGamma = (1 + LatencySketch::kRelativeAccuracy) / (1 - LatencySketch::kRelativeAccuracy);
+static const double kLogGamma = std::log(kGamma);
+
+static const std::string& GetSketchHeader() {
+    static const std::string sHeader = [] {
+        char buf[64];
+        snprintf(buf,
+                 sizeof(buf),
+                 "%g,%lld;",
+                 LatencySketch::kRelativeAccuracy,
+                 static_cast<long long>(LatencySketch::kMinLatencyNs));
+        return std::string(buf);
+    }();
+    return sHeader;
+}
+
+size_t LatencySketch::GetBucketIndex(int64_t latencyNs) {
+    if (latencyNs <= kMinLatencyNs) {
+        return 0;
+    }
+    double idx = std::ceil(std::log(static_cast<double>(latencyNs) / kMinLatencyNs) / kLogGamma);
+    if (idx >= kBucketCount - 1) {
+        return kBucketCount - 1;
+    }
+    return static_cast<size_t>(idx);
+}
+
+int64_t LatencySketch::GetBucketValue(size_t idx) {
+    if (idx == 0) {
+        return kMinLatencyNs;
+    }
+    // the value with the minimum relative error to both bounds of the bucket
+    return static_cast<int64_t>(2 * kMinLatencyNs * std::pow(kGamma, idx) / (kGamma + 1));
+}
+
+void LatencySketch::Merge(const LatencySketch& other) {
+    if (other.IsEmpty()) {
+        return;
+    }
+    for (size_t i = other.mMinIdx; i <= other.mMaxIdx; ++i) {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mMinIdx = std::min(mMinIdx, other.mMinIdx);
+    mMaxIdx = std::max(mMaxIdx, other.mMaxIdx);
+}
+
+void LatencySketch::Clear() {
+    if (IsEmpty()) {
+        return;
+    }
+    std::fill(mBuckets.begin() + mMinIdx, mBuckets.begin() + mMaxIdx + 1, 0);
+    mCount = 0;
+    mMinIdx = kBucketCount;
+    mMaxIdx = 0;
+}
+
+int64_t LatencySketch::Quantile(double q) const {
+    if (IsEmpty()) {
+        return 0;
+    }
+    q = std::max(0.0, std::min(1.0, q));
+    uint64_t rank = static_cast<uint64_t>(q * (mCount - 1));
+    uint64_t cnt = 0;
+    for (size_t i = mMinIdx; i <= mMaxIdx; ++i) {
+        cnt += mBuckets[i];
+        if (cnt > rank) {
+            return GetBucketValue(i);
+        }
+    }
+    return GetBucketValue(mMaxIdx);
+}
+
+std::string LatencySketch::Serialize() const {
+    std::string res = GetSketchHeader();
+    if (IsEmpty()) {
+        return res;
+    }
+    bool first = true;
+    for (size_t i = mMinIdx; i <= mMaxIdx; ++i) {
+        if (mBuckets[i] == 0) {
+            continue;
+        }
+        if (!first) {
+            res.push_back(',');
+        }
+        first = false;
+        res.append(std::to_string(i)).push_back(':');
+        res.append(std::to_string(mBuckets[i]));
+    }
+    return res;
+}
+
+bool LatencySketch::Deserialize(const std::string& data) {
+    Clear();
+    const std::string& header = GetSketchHeader();
+    if (data.compare(0, header.size(), header) != 0) {
+        return false;
+    }
+    const char* p = data.c_str() + header.size();
+    while (*p != '\0') {
+        char* end = nullptr;
+        unsigned long idx = std::strtoul(p, &end, 10);
+        if (end == p || *end != ':' || idx >= kBucketCount) {
+            Clear();
+            return false;
+        }
+        p = end + 1;
+        unsigned long cnt = std::strtoul(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0')) {
+            Clear();
+            return false;
+        }
+        p = *end == ',' ? end + 1 : end;
+        if (cnt == 0) {
+            continue;
+        }
+        mBuckets[idx] += static_cast<uint32_t>(cnt);
+        mCount += cnt;
+        mMinIdx = std::min(mMinIdx, static_cast<size_t>(idx));
+        mMaxIdx = std::max(mMaxIdx, static_cast<size_t>(idx));
+    }
+    return true;
+}
+
+} // namespace logtail
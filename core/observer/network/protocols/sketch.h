@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace logtail {
+
+/**
+ * A mergeable quantile sketch for latency with fixed memory, following the idea of DDSketch.
+ * Latencies are counted in logarithmic buckets, so any quantile has a relative error of at most kRelativeAccuracy.
+ * Latencies not greater than kMinLatencyNs fall into the first bucket, and those beyond the covered range (about 197s)
+ * fall into the last bucket.
+ * Both Add and Merge cost constant time, which is necessary for the event loop.
+ */
+class LatencySketch {
+public:
+    static constexpr double kRelativeAccuracy = 0.05;
+    static constexpr int64_t kMinLatencyNs = 1000;
+    static constexpr size_t kBucketCount = 192;
+
+    void Add(int64_t latencyNs) {
+        size_t idx = GetBucketIndex(latencyNs);
+        ++mBuckets[idx];
+        ++mCount;
+        if (idx < mMinIdx) {
+            mMinIdx = idx;
+        }
+        if (idx > mMaxIdx) {
+            mMaxIdx = idx;
+        }
+    }
+
+    void Merge(const LatencySketch& other);
+    void Clear();
+    bool IsEmpty() const { return mCount == 0; }
+    uint64_t Count() const { return mCount; }
+
+    /**
+     * @param q quantile in [0, 1]
+     * @return estimated latency in ns, 0 if the sketch is empty.
+     */
+    int64_t Quantile(double q) const;
+
+    /**
+     * Serialize as "<relative accuracy>,<min latency ns>;<bucket index>:<count>,<bucket index>:<count>...".
+     * Only non-empty buckets are serialized. Bucket i (i > 0) holds latencies in (min * gamma^(i-1), min * gamma^i],
+     * where gamma = (1 + accuracy) / (1 - accuracy).
+     */
+    std::string Serialize() const;
+    bool Deserialize(const std::string& data);
+
+private:
+    static size_t GetBucketIndex(int64_t latencyNs);
+    static int64_t GetBucketValue(size_t idx);
+
+    std::array<uint32_t, kBucketCount> mBuckets{};
+    uint64_t mCount = 0;
+    // range of non-empty buckets, used to accelerate Merge, Clear and Quantile
+    size_t mMinIdx = kBucketCount;
+    size_t mMaxIdx = 0;
+};
+
+} // namespace logtail
@@ -0,0 +1,143 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parser/DelimiterTokenizer.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace logtail {
+
+bool DelimiterTokenizer::Tokenize(StringView line,
+                                  vector<StringView>& columns,
+                                  vector<size_t>& escapedColumns) const {
+    columns.clear();
+    escapedColumns.clear();
+    const char chars[] = {mSeparator, mQuote};
+    const size_t charCnt = mUseQuote ? 2 : 1;
+    const char* data = line.data();
+    const size_t size = line.size();
+    const char* columnBegin = data;
+    // all ones if the previous block ends inside quotes
+    uint64_t inQuoteCarry = 0;
+    // whether the current column has quotes in the previous blocks
+    bool columnHasQuote = false;
+    char tail[64];
+    for (size_t base = 0; base < size; base += 64) {
+        const char* block = data + base;
+        uint64_t valid = ~0ULL;
+        if (size - base < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, size - base);
+            block = tail;
+            valid = (1ULL << (size - base)) - 1;
+        }
+        uint64_t masks[2] = {0, 0};
+        FindCharsInBlock(block, chars, charCnt, masks, mLevel);
+        uint64_t separators = masks[0] & valid;
+        uint64_t quotes = 0;
+        if (mUseQuote) {
+            quotes = masks[1] & valid;
+            // doubled quotes toggle the range twice, so they never let a separator in
+            uint64_t quoted = PrefixXor(quotes) ^ inQuoteCarry;
+            inQuoteCarry = 0 - (quoted >> 63);
+            separators &= ~quoted;
+        }
+        while (separators != 0) {
+            uint32_t pos = CountTrailingZeros64(separators);
+            const char* separator = data + base + pos;
+            // quotes of the block before the separator belong to the current column, since those of the previous
+            // columns have been cleared
+            uint64_t before = (1ULL << pos) - 1;
+            if (!AddColumn(columnBegin,
+                           separator,
+                           columnHasQuote || (quotes & before) != 0,
+                           columns,
+                           escapedColumns)) {
+                columns.clear();
+                escapedColumns.clear();
+                return false;
+            }
+            quotes &= ~before;
+            columnHasQuote = false;
+            columnBegin = separator + 1;
+            separators &= separators - 1;
+        }
+        columnHasQuote = columnHasQuote || quotes != 0;
+    }
+    // unclosed quotes
+    if (inQuoteCarry != 0 || !AddColumn(columnBegin, data + size, columnHasQuote, columns, escapedColumns)) {
+        columns.clear();
+        escapedColumns.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DelimiterTokenizer::AddColumn(const char* begin,
+                                   const char* end,
+                                   bool hasQuote,
+                                   vector<StringView>& columns,
+                                   vector<size_t>& escapedColumns) const {
+    size_t size = end - begin;
+    if (!hasQuote) {
+        columns.emplace_back(begin, size);
+        return true;
+    }
+    // quotes are only allowed in quoted columns
+    if (begin[0] != mQuote) {
+        return false;
+    }
+    // a quoted column should end with the closing quote, and all quotes inside should be doubled
+    if (size < 2 || end[-1] != mQuote) {
+        return false;
+    }
+    const char* contentEnd = end - 1;
+    bool escaped = false;
+    for (const char* p = begin + 1;; p += 2) {
+        p = static_cast<const char*>(memchr(p, mQuote, contentEnd - p));
+        if (p == nullptr) {
+            break;
+        }
+        if (p + 1 == contentEnd || p[1] != mQuote) {
+            return false;
+        }
+        escaped = true;
+    }
+    if (escaped) {
+        escapedColumns.push_back(columns.size());
+    }
+    columns.emplace_back(begin + 1, size - 2);
+    return true;
+}
+
+size_t DelimiterTokenizer::Unescape(StringView src, char* dst) const {
+    const char* s = src.data();
+    const char* end = s + src.size();
+    char* d = dst;
+    // copied to a local, as writes through dst may alias the member
+    const char quote = mQuote;
+    while (s < end) {
+        char c = *s++;
+        *d++ = c;
+        if (c == quote) {
+            // keep the first quote of the pair and skip the second one, which is known to exist
+            ++s;
+        }
+    }
+    return d - dst;
+}
+
+} // namespace logtail
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/SimdUtil.h"
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Tokenizer of delimiter separated lines, which accepts the same lines as DelimiterModeFsmParser. Instead of running
+// the state machine per char, it classifies 64 bytes at a time into bitmasks of separators and quotes, and derives the
+// quoted ranges from the quote mask, so that only separators outside quotes split columns. Lines are expected to be
+// split already, so newlines are just data here.
+class DelimiterTokenizer {
+public:
+    // Quotes are treated as data if useQuote is false.
+    DelimiterTokenizer(char separator, bool useQuote, char quote, SimdLevel level = GetSupportedSimdLevel())
+        : mSeparator(separator), mUseQuote(useQuote), mQuote(quote), mLevel(level) {}
+
+    // Columns refer to line, and quoted columns are without the enclosing quotes. The indexes of columns containing
+    // doubled quotes are appended to escapedColumns, and those columns should be unescaped by Unescape before use.
+    // Returns false and clears both if quotes are misplaced.
+    bool Tokenize(StringView line, std::vector<StringView>& columns, std::vector<size_t>& escapedColumns) const;
+
+    // Replace doubled quotes in src with single ones. dst should be at least src.size() bytes. Returns the size.
+    size_t Unescape(StringView src, char* dst) const;
+
+private:
+    bool AddColumn(const char* begin,
+                   const char* end,
+                   bool hasQuote,
+                   std::vector<StringView>& columns,
+                   std::vector<size_t>& escapedColumns) const;
+
+    char mSeparator;
+    bool mUseQuote;
+    char mQuote;
+    SimdLevel mLevel;
+};
+
+} // namespace logtail
@@ -293,7 +293,8 @@ void Pipeline::Send(vector<PipelineEventGroup>&& groupList) {
         // TODO: support route
         for (size_t i = 0; i < mFlushers.size(); ++i) {
             if (i + 1 != mFlushers.size()) {
-                mFlushers[i]->Send(group.Copy());
+                // events are shared among flushers and copied only when modified by some flusher
+                mFlushers[i]->Send(group.Share());
             } else {
                 mFlushers[i]->Send(std::move(group));
             }
@@ -50,6 +50,7 @@ public:
     const Json::Value& GetConfig() const { return *mConfig; }
     const std::vector<std::unique_ptr<FlusherInstance>>& GetFlushers() const { return mFlushers; }
     bool IsFlushingThroughGoPipeline() const { return !mGoPipelineWithoutInput.isNull(); }
+    bool HasGoPipelines() const { return !mGoPipelineWithInput.isNull() || !mGoPipelineWithoutInput.isNull(); }
     const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& GetPluginStatistics() const {
         return mPluginCntMap;
     }
@@ -79,6 +80,7 @@ private:
     friend class PipelineUnittest;
     friend class InputFileUnittest;
     friend class ProcessorTagNativeUnittest;
+    friend class PipelineManagerUnittest;
 #endif
 };
 
@@ -16,6 +16,7 @@
 
 #include "pipeline/PipelineManager.h"
 
+#include "batch/TimeoutFlushManager.h"
 #include "config_manager/ConfigManager.h"
 #include "file_server/FileServer.h"
 #include "go_pipeline/LogtailPlugin.h"
@@ -37,6 +38,9 @@ using namespace std;
 namespace logtail {
 
 void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
+    // Only the pipelines changed are drained and replaced, while the others keep running. For removed and modified
+    // pipelines, their process queues are disabled and items being processed are waited for, so that no process
+    // thread is using the old pipelines when they are stopped.
 #ifndef APSARA_UNIT_TEST_MAIN
     // 过渡使用
     static bool isFileServerStarted = false, isInputObserverStarted = false;
@@ -44,13 +48,15 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
     static bool isInputStreamStarted = false;
 #endif
     bool isInputObserverChanged = false, isInputFileChanged = false, isInputStreamChanged = false,
-         isInputContainerStdioChanged = false;
+         isInputContainerStdioChanged = false, isGoPipelineChanged = false;
     for (const auto& name : diff.mRemoved) {
-        CheckIfInputUpdated(mPipelineNameEntityMap[name]->GetConfig()["inputs"][0],
+        const auto& p = mPipelineNameEntityMap[name];
+        CheckIfInputUpdated(p->GetConfig()["inputs"][0],
                             isInputObserverChanged,
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged |= p->HasGoPipelines();
     }
     for (const auto& config : diff.mModified) {
         CheckIfInputUpdated(*config.mInputs[0],
@@ -58,6 +64,7 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged |= config.HasGoPlugin() || mPipelineNameEntityMap[config.mName]->HasGoPipelines();
     }
     for (const auto& config : diff.mAdded) {
         CheckIfInputUpdated(*config.mInputs[0],
@@ -65,6 +72,7 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged |= config.HasGoPlugin();
     }
 
 #if defined(__ENTERPRISE__) && defined(__linux__) && !defined(__ANDROID__)
@@ -83,17 +91,28 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
     if (isFileServerStarted && (isInputFileChanged || isInputContainerStdioChanged)) {
         FileServer::GetInstance()->Pause();
     }
-    LogProcess::GetInstance()->HoldOn();
-    LogtailPlugin::GetInstance()->HoldOn(false);
+    // Go pipelines can only be reloaded all together
+    if (isGoPipelineChanged) {
+        LogtailPlugin::GetInstance()->HoldOn(false);
+    }
 #endif
 
     for (const auto& name : diff.mRemoved) {
-        auto iter = mPipelineNameEntityMap.find(name);
-        iter->second->Stop(true);
-        DecreasePluginUsageCnt(iter->second->GetPluginStatistics());
-        iter->second->RemoveProcessQueue();
-        mPipelineNameEntityMap.erase(iter);
+        ProcessQueueManager::GetInstance()->InvalidatePop(name);
     }
+    LogProcess::GetInstance()->WaitForPoppedItems();
+    for (const auto& name : diff.mRemoved) {
+        auto p = mPipelineNameEntityMap[name];
+        ErasePipeline(name);
+        // batches are not flushed when the pipeline is removed, so the timeout records pointing to its flushers must
+        // be cleared before the pipeline is released
+        TimeoutFlushManager::GetInstance()->ClearRecords(name);
+        p->Stop(true);
+        DecreasePluginUsageCnt(p->GetPluginStatistics());
+        p->RemoveProcessQueue();
+    }
+
+    vector<pair<string, shared_ptr<Pipeline>>> modifiedPipelines;
     for (auto& config : diff.mModified) {
         auto p = BuildPipeline(std::move(config));
         if (!p) {
@@ -112,14 +131,22 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
         LOG_INFO(sLogger,
                  ("pipeline building for existing config succeeded",
                   "stop the old pipeline and start the new one")("config", config.mName));
-
-        auto iter = mPipelineNameEntityMap.find(config.mName);
-        iter->second->Stop(false);
-        DecreasePluginUsageCnt(iter->second->GetPluginStatistics());
-        mPipelineNameEntityMap[config.mName] = p;
-        IncreasePluginUsageCnt(p->GetPluginStatistics());
-        p->Start();
+        modifiedPipelines.emplace_back(config.mName, p);
+        ProcessQueueManager::GetInstance()->InvalidatePop(config.mName);
+    }
+    if (!modifiedPipelines.empty()) {
+        LogProcess::GetInstance()->WaitForPoppedItems();
     }
+    for (const auto& item : modifiedPipelines) {
+        auto old = mPipelineNameEntityMap[item.first];
+        old->Stop(false);
+        DecreasePluginUsageCnt(old->GetPluginStatistics());
+        SetPipeline(item.first, item.second);
+        IncreasePluginUsageCnt(item.second->GetPluginStatistics());
+        item.second->Start();
+        ProcessQueueManager::GetInstance()->ValidatePop(item.first);
+    }
+
     for (auto& config : diff.mAdded) {
         auto p = BuildPipeline(std::move(config));
         if (!p) {
@@ -135,22 +162,25 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
         }
         LOG_INFO(sLogger,
                  ("pipeline building for new config succeeded", "begin to start pipeline")("config", config.mName));
-        mPipelineNameEntityMap[config.mName] = p;
+        SetPipeline(config.mName, p);
         IncreasePluginUsageCnt(p->GetPluginStatistics());
         p->Start();
     }
 
 #ifndef APSARA_UNIT_TEST_MAIN
-    // 过渡使用，有变更的流水线的Go流水线加载在BuildPipeline中完成
-    for (auto& name : diff.mUnchanged) {
-        mPipelineNameEntityMap[name]->LoadGoPipelines();
+    if (isGoPipelineChanged) {
+        // 过渡使用，有变更的流水线的Go流水线加载在BuildPipeline中完成
+        for (auto& name : diff.mUnchanged) {
+            mPipelineNameEntityMap[name]->LoadGoPipelines();
+        }
     }
     // 在Flusher改造完成前，先不执行如下步骤，不会造成太大影响
     // Sender::CleanUnusedAk();
 
     // 过渡使用
-    LogtailPlugin::GetInstance()->Resume();
-    LogProcess::GetInstance()->Resume();
+    if (isGoPipelineChanged) {
+        LogtailPlugin::GetInstance()->Resume();
+    }
     if (isInputFileChanged || isInputContainerStdioChanged) {
         if (isFileServerStarted) {
             FileServer::GetInstance()->Resume();
@@ -190,6 +220,7 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
 }
 
 shared_ptr<Pipeline> PipelineManager::FindPipelineByName(const string& configName) const {
+    ReadLock lock(mPipelineMapRWL);
     auto it = mPipelineNameEntityMap.find(configName);
     if (it != mPipelineNameEntityMap.end()) {
         return it->second;
@@ -199,6 +230,7 @@ shared_ptr<Pipeline> PipelineManager::FindPipelineByName(const string& configNam
 
 vector<string> PipelineManager::GetAllPipelineNames() const {
     vector<string> res;
+    ReadLock lock(mPipelineMapRWL);
     for (const auto& item : mPipelineNameEntityMap) {
         res.push_back(item.first);
     }
@@ -257,6 +289,16 @@ shared_ptr<Pipeline> PipelineManager::BuildPipeline(Config&& config) {
     return p;
 }
 
+void PipelineManager::SetPipeline(const string& name, const shared_ptr<Pipeline>& p) {
+    WriteLock lock(mPipelineMapRWL);
+    mPipelineNameEntityMap[name] = p;
+}
+
+void PipelineManager::ErasePipeline(const string& name) {
+    WriteLock lock(mPipelineMapRWL);
+    mPipelineNameEntityMap.erase(name);
+}
+
 void PipelineManager::FlushAllBatch() {
     for (const auto& item : mPipelineNameEntityMap) {
         item.second->FlushBatch();
@@ -40,7 +40,7 @@ public:
     std::shared_ptr<Pipeline> FindPipelineByName(const std::string& configName) const;
     std::vector<std::string> GetAllPipelineNames() const;
     std::string GetPluginStatistics() const;
-    // for shennong only
+    // for shennong only, not thread safe with UpdatePipelines
     const std::unordered_map<std::string, std::shared_ptr<Pipeline>>& GetAllPipelines() const {
         return mPipelineNameEntityMap;
     }
@@ -57,6 +57,8 @@ private:
     void DecreasePluginUsageCnt(
         const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& statistics);
     void FlushAllBatch();
+    void SetPipeline(const std::string& name, const std::shared_ptr<Pipeline>& p);
+    void ErasePipeline(const std::string& name);
     // 过渡使用
     void CheckIfInputUpdated(const Json::Value& config,
                              bool& isInputObserverChanged,
@@ -64,7 +66,9 @@ private:
                              bool& isInputStreamChanged,
                              bool& isInputContainerStdioChanged);
 
+    // only modified by UpdatePipelines, while being read by other threads
     std::unordered_map<std::string, std::shared_ptr<Pipeline>> mPipelineNameEntityMap;
+    mutable ReadWriteLock mPipelineMapRWL;
     mutable SpinLock mPluginCntMapLock;
     std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> mPluginCntMap;
 
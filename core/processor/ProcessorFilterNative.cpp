@@ -16,6 +16,7 @@
 
 #include "processor/ProcessorFilterNative.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "common/ParamExtractor.h"
@@ -53,7 +54,6 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                              mContext->GetRegion());
     } else if (!filterKeys.empty()) {
         bool hasError = false;
-        std::vector<boost::regex> regs;
         for (const auto& reg : filterRegs) {
             if (!IsRegexValid(reg)) {
                 PARAM_WARNING_IGNORE(mContext->GetLogger(),
@@ -67,13 +67,16 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                 hasError = true;
                 break;
             }
-            regs.emplace_back(reg);
         }
         if (!hasError) {
             mFilterRule = std::make_shared<LogFilterRule>();
             mFilterRule->FilterKeys = filterKeys;
-            mFilterRule->FilterRegs = regs;
-            mFilterMode = Mode::RULE_MODE;
+            mFilterRule->FilterRegs = filterRegs;
+            if (mFilterRule->Compile()) {
+                mFilterMode = Mode::RULE_MODE;
+            } else {
+                mFilterRule.reset();
+            }
         }
     }
 
@@ -90,8 +93,7 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                                  mContext->GetLogstoreName(),
                                  mContext->GetRegion());
         } else if (!mInclude.empty()) {
-            std::vector<std::string> keys;
-            std::vector<boost::regex> regs;
+            std::vector<std::string> keys, regs;
             bool hasError = false;
             for (auto& include : mInclude) {
                 if (!IsRegexValid(include.second)) {
@@ -107,13 +109,17 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                     break;
                 }
                 keys.emplace_back(include.first);
-                regs.emplace_back(boost::regex(include.second));
+                regs.emplace_back(include.second);
             }
             if (!hasError) {
                 mFilterRule = std::make_shared<LogFilterRule>();
                 mFilterRule->FilterKeys = keys;
                 mFilterRule->FilterRegs = regs;
-                mFilterMode = Mode::RULE_MODE;
+                if (mFilterRule->Compile()) {
+                    mFilterMode = Mode::RULE_MODE;
+                } else {
+                    mFilterRule.reset();
+                }
             }
         }
     }
@@ -143,7 +149,7 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                                mContext->GetRegion());
         }
         BaseFilterNodePtr root = ParseExpressionFromJSON(*itr);
-        if (!root) {
+        if (!root || !mConditionProgram.Compile(root)) {
             PARAM_ERROR_RETURN(mContext->GetLogger(),
                                mContext->GetAlarm(),
                                "object param ConditionExp is not valid",
@@ -217,7 +223,7 @@ bool ProcessorFilterNative::ProcessEvent(PipelineEventPtr& e) {
     bool res = true;
 
     if (mFilterMode == Mode::EXPRESSION_MODE) {
-        res = FilterExpressionRoot(sourceEvent, mConditionExp);
+        res = FilterExpressionRoot(sourceEvent, mConditionProgram);
     } else if (mFilterMode == Mode::RULE_MODE) {
         res = FilterFilterRule(sourceEvent, mFilterRule.get());
     }
@@ -252,18 +258,13 @@ bool ProcessorFilterNative::IsSupportedEvent(const PipelineEventPtr& e) const {
     return e.Is<LogEvent>();
 }
 
-bool ProcessorFilterNative::FilterExpressionRoot(LogEvent& sourceEvent, const BaseFilterNodePtr& node) {
+bool ProcessorFilterNative::FilterExpressionRoot(LogEvent& sourceEvent, const FilterProgram& program) {
     if (sourceEvent.Empty()) {
         return false;
     }
 
-    // null node, all logs are passed
-    if (node.get() == nullptr) {
-        return true;
-    }
-
     try {
-        return node->Match(sourceEvent, GetContext());
+        return program.Match(sourceEvent, GetContext());
     } catch (...) {
         mProcFilterErrorTotal->Add(1);
         LOG_ERROR(GetContext().GetLogger(), ("filter error ", ""));
@@ -291,15 +292,13 @@ bool ProcessorFilterNative::FilterFilterRule(LogEvent& sourceEvent, const LogFil
 }
 
 bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterRule& rule) {
-    const std::vector<std::string>& keys = rule.FilterKeys;
-    const std::vector<boost::regex> regs = rule.FilterRegs;
     std::string exception;
-    for (uint32_t i = 0; i < keys.size(); ++i) {
-        const auto& content = contents.FindContent(keys[i]);
+    for (const auto& matcher : rule.Matchers) {
+        const auto& content = contents.FindContent(matcher.first);
         if (content == contents.end()) {
             return false;
         }
-        if (!BoostRegexMatch(content->second.data(), content->second.size(), regs[i], exception)) {
+        if (!matcher.second.Match(content->second, exception)) {
             if (!exception.empty()) {
                 LOG_ERROR(GetContext().GetLogger(), ("regex_match in Filter fail", exception));
                 if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
@@ -316,6 +315,31 @@ bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterR
     return true;
 }
 
+bool ProcessorFilterNative::LogFilterRule::Compile() {
+    // keep the order of keys as configured
+    std::vector<std::pair<std::string, std::vector<std::string>>> exps;
+    for (size_t i = 0; i < FilterKeys.size(); ++i) {
+        auto it = std::find_if(exps.begin(), exps.end(), [&](const std::pair<std::string, std::vector<std::string>>& e) {
+            return e.first == FilterKeys[i];
+        });
+        if (it == exps.end()) {
+            exps.emplace_back(FilterKeys[i], std::vector<std::string>{FilterRegs[i]});
+        } else {
+            it->second.emplace_back(FilterRegs[i]);
+        }
+    }
+    Matchers.clear();
+    for (auto& item : exps) {
+        FilterRegexMatcher matcher;
+        if (!matcher.Init(item.second)) {
+            LOG_ERROR(sLogger, ("failed to compile filter regex", "")("key", item.first));
+            return false;
+        }
+        Matchers.emplace_back(std::move(item.first), std::move(matcher));
+    }
+    return true;
+}
+
 static const char UTF8_BYTE_PREFIX = 0x80;
 static const char UTF8_BYTE_MASK = 0xc0;
 
@@ -561,4 +585,154 @@ bool UnaryFilterOperatorNode::Match(const LogEvent& contents, const PipelineCont
     return false;
 }
 
+static re2::RE2::Options GetFilterRE2Options() {
+    re2::RE2::Options options;
+    // match bytes as boost::regex does, so that non-utf8 values can also be matched
+    options.set_encoding(re2::RE2::Options::EncodingLatin1);
+    options.set_dot_nl(true);
+    options.set_log_errors(false);
+    return options;
+}
+
+static std::string GetRE2Pattern(const std::string& exp) {
+    // ^ and $ match at line boundaries in boost::regex by default
+    return "(?m)" + exp;
+}
+
+bool FilterRegexMatcher::Init(const std::vector<std::string>& exps) {
+    static const re2::RE2::Options sOptions = GetFilterRE2Options();
+
+    std::vector<std::string> re2Exps;
+    for (const auto& exp : exps) {
+        std::unique_ptr<re2::RE2> reg(new re2::RE2(GetRE2Pattern(exp), sOptions));
+        if (reg->ok()) {
+            if (re2Exps.empty()) {
+                mRE2 = std::move(reg);
+            }
+            re2Exps.emplace_back(GetRE2Pattern(exp));
+            continue;
+        }
+        if (!IsRegexValid(exp)) {
+            return false;
+        }
+        mBoostRegs.emplace_back(exp);
+    }
+    mRE2Cnt = re2Exps.size();
+    if (mRE2Cnt > 1) {
+        mRE2.reset();
+        mRE2Set.reset(new re2::RE2::Set(sOptions, re2::RE2::ANCHOR_BOTH));
+        for (const auto& exp : re2Exps) {
+            if (mRE2Set->Add(exp, nullptr) < 0) {
+                return false;
+            }
+        }
+        if (!mRE2Set->Compile()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FilterRegexMatcher::Match(const StringView& value, std::string& exception) const {
+    re2::StringPiece text(value.data(), value.size());
+    if (mRE2 && !re2::RE2::FullMatch(text, *mRE2)) {
+        return false;
+    }
+    if (mRE2Set) {
+        thread_local static std::vector<int> sMatched;
+        if (!mRE2Set->Match(text, &sMatched) || sMatched.size() != mRE2Cnt) {
+            return false;
+        }
+    }
+    for (const auto& reg : mBoostRegs) {
+        if (!BoostRegexMatch(value.data(), value.size(), reg, exception)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FilterProgram::Compile(const BaseFilterNodePtr& root) {
+    mInstructions.clear();
+    mMatchers.clear();
+    return CompileNode(root);
+}
+
+bool FilterProgram::CompileNode(const BaseFilterNodePtr& node) {
+    if (!node) {
+        return false;
+    }
+    uint32_t idx = mInstructions.size();
+    mInstructions.emplace_back();
+    if (const auto* valueNode = dynamic_cast<const RegexFilterValueNode*>(node.get())) {
+        FilterRegexMatcher matcher;
+        if (!matcher.Init({valueNode->GetExp()})) {
+            return false;
+        }
+        mInstructions[idx].mOp = OpCode::REGEX;
+        mInstructions[idx].mKey = valueNode->GetKey();
+        mInstructions[idx].mMatcherIdx = mMatchers.size();
+        mMatchers.emplace_back(std::move(matcher));
+    } else if (const auto* unaryNode = dynamic_cast<const UnaryFilterOperatorNode*>(node.get())) {
+        mInstructions[idx].mOp = OpCode::NOT;
+        if (!CompileNode(unaryNode->GetChild())) {
+            return false;
+        }
+    } else if (const auto* binaryNode = dynamic_cast<const BinaryFilterOperatorNode*>(node.get())) {
+        if (binaryNode->GetOperator() == AND_OPERATOR) {
+            mInstructions[idx].mOp = OpCode::AND;
+        } else if (binaryNode->GetOperator() == OR_OPERATOR) {
+            mInstructions[idx].mOp = OpCode::OR;
+        } else {
+            return false;
+        }
+        if (!CompileNode(binaryNode->GetLeft()) || !CompileNode(binaryNode->GetRight())) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    mInstructions[idx].mEnd = mInstructions.size();
+    return true;
+}
+
+bool FilterProgram::Match(const LogEvent& contents, const PipelineContext& ctx) const {
+    if (mInstructions.empty()) {
+        return true;
+    }
+    return Eval(0, contents, ctx);
+}
+
+bool FilterProgram::Eval(uint32_t idx, const LogEvent& contents, const PipelineContext& ctx) const {
+    const Instruction& inst = mInstructions[idx];
+    switch (inst.mOp) {
+        case OpCode::REGEX: {
+            const auto& content = contents.FindContent(inst.mKey);
+            if (content == contents.end()) {
+                return false;
+            }
+            std::string exception;
+            bool result = mMatchers[inst.mMatcherIdx].Match(content->second, exception);
+            if (!result && !exception.empty() && AppConfig::GetInstance()->IsLogParseAlarmValid()) {
+                LOG_ERROR(ctx.GetLogger(), ("regex_match in Filter fail", exception));
+                if (ctx.GetAlarm().IsLowLevelAlarmValid()) {
+                    ctx.GetAlarm().SendAlarm(REGEX_MATCH_ALARM,
+                                             "regex_match in Filter fail:" + exception,
+                                             ctx.GetProjectName(),
+                                             ctx.GetLogstoreName(),
+                                             ctx.GetRegion());
+                }
+            }
+            return result;
+        }
+        case OpCode::NOT:
+            return !Eval(idx + 1, contents, ctx);
+        case OpCode::AND:
+            return Eval(idx + 1, contents, ctx) && Eval(mInstructions[idx + 1].mEnd, contents, ctx);
+        case OpCode::OR:
+            return Eval(idx + 1, contents, ctx) || Eval(mInstructions[idx + 1].mEnd, contents, ctx);
+    }
+    return false;
+}
+
 } // namespace logtail
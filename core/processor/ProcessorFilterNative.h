@@ -16,6 +16,13 @@
 
 #pragma once
 
+#include <re2/re2.h>
+#include <re2/set.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "app_config/AppConfig.h"
 #include "common/LogGroupContext.h"
 #include "models/LogEvent.h"
@@ -59,6 +66,10 @@ public:
     virtual bool Match(const sls_logs::Log& log, const LogGroupContext& context);
     virtual bool Match(const LogEvent& contents, const PipelineContext& mContext);
 
+    FilterOperator GetOperator() const { return op; }
+    const BaseFilterNodePtr& GetLeft() const { return left; }
+    const BaseFilterNodePtr& GetRight() const { return right; }
+
 private:
     FilterOperator op;
     BaseFilterNodePtr left;
@@ -78,6 +89,9 @@ public:
 
     virtual bool Match(const LogEvent& contents, const PipelineContext& mContext);
 
+    const std::string& GetKey() const { return key; }
+    std::string GetExp() const { return reg.str(); }
+
 private:
     std::string key;
     boost::regex reg;
@@ -96,6 +110,8 @@ public:
 
     virtual bool Match(const LogEvent& contents, const PipelineContext& mContext);
 
+    const BaseFilterNodePtr& GetChild() const { return child; }
+
 private:
     BaseFilterNodePtr child;
 };
@@ -104,6 +120,58 @@ BaseFilterNodePtr ParseExpressionFromJSON(const Json::Value& value);
 bool GetOperatorType(const std::string& type, FilterOperator& op);
 bool GetNodeFuncType(const std::string& type, FilterNodeFunctionType& func);
 
+// FilterRegexMatcher fully matches a value against one or more regexes, and succeeds only when all of them match.
+// Regexes are compiled by RE2 with byte-wise, multi-line and dot-all options, which is consistent with the semantics
+// of boost::regex_match. Several RE2 regexes are merged into one RE2::Set, so that the value is scanned only once.
+// Regexes not supported by RE2 (e.g., backreference and lookaround) fall back to boost::regex.
+class FilterRegexMatcher {
+public:
+    bool Init(const std::vector<std::string>& exps);
+    bool Match(const StringView& value, std::string& exception) const;
+    size_t Size() const { return mRE2Cnt + mBoostRegs.size(); }
+
+private:
+    std::unique_ptr<re2::RE2> mRE2;
+    std::unique_ptr<re2::RE2::Set> mRE2Set;
+    size_t mRE2Cnt = 0;
+    std::vector<boost::regex> mBoostRegs;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcessorFilterNativeUnittest;
+#endif
+};
+
+// FilterProgram is the compiled form of the ConditionExp tree. Nodes are flattened into an array in pre-order, and
+// each node records the index right after its subtree, so the expression can be evaluated with short circuit and
+// without virtual calls.
+class FilterProgram {
+public:
+    bool Compile(const BaseFilterNodePtr& root);
+    bool Match(const LogEvent& contents, const PipelineContext& ctx) const;
+
+private:
+    enum class OpCode : uint8_t { REGEX, NOT, AND, OR };
+
+    struct Instruction {
+        OpCode mOp = OpCode::REGEX;
+        // index of the next instruction after the subtree
+        uint32_t mEnd = 0;
+        // valid for REGEX only
+        std::string mKey;
+        uint32_t mMatcherIdx = 0;
+    };
+
+    bool CompileNode(const BaseFilterNodePtr& node);
+    bool Eval(uint32_t idx, const LogEvent& contents, const PipelineContext& ctx) const;
+
+    std::vector<Instruction> mInstructions;
+    std::vector<FilterRegexMatcher> mMatchers;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcessorFilterNativeUnittest;
+#endif
+};
+
 class ProcessorFilterNative : public Processor {
 public:
     static const std::string sName;
@@ -126,13 +194,17 @@ private:
 
     struct LogFilterRule {
         std::vector<std::string> FilterKeys;
-        std::vector<boost::regex> FilterRegs;
+        std::vector<std::string> FilterRegs;
+        // regexes on the same key are merged into one matcher
+        std::vector<std::pair<std::string, FilterRegexMatcher>> Matchers;
+
+        bool Compile();
     };
 
     bool ProcessEvent(PipelineEventPtr& e);
 
     // Filter logs through ConditionExp
-    bool FilterExpressionRoot(LogEvent& sourceEvent, const BaseFilterNodePtr& node);
+    bool FilterExpressionRoot(LogEvent& sourceEvent, const FilterProgram& program);
 
     // Filter logs through FilterRule
     bool FilterFilterRule(LogEvent& sourceEvent, const LogFilterRule* filterRule);
@@ -145,6 +217,7 @@ private:
     Mode mFilterMode = Mode::BYPASS_MODE;
 
     std::shared_ptr<LogFilterRule> mFilterRule;
+    FilterProgram mConditionProgram;
 
     CounterPtr mProcFilterErrorTotal;
     CounterPtr mProcFilterRecordsTotal;
@@ -106,7 +106,7 @@ bool ProcessorParseDelimiterNative::Init(const Json::Value& config) {
                              mContext->GetRegion());
     }
 
-    mDelimiterModeFsmParserPtr.reset(new DelimiterModeFsmParser(mQuote, mSeparatorChar));
+    mTokenizerPtr.reset(new DelimiterTokenizer(mSeparatorChar, mQuote != mSeparatorChar, mQuote));
 
     // Keys
     if (!GetMandatoryListParam(config, "Keys", mKeys, errorMsg)) {
@@ -243,12 +243,22 @@ bool ProcessorParseDelimiterNative::ProcessEvent(const StringView& logPath, Pipe
     bool parseSuccess = false;
     size_t parsedColCount = 0;
     bool useQuote = (mSeparator.size() == 1) && (mQuote != mSeparatorChar);
+    // single char separators are tokenized with SIMD, while multi char separators are searched by SplitString
+    bool useTokenizer = mSeparator.size() == 1;
     if (mKeys.size() > 0) {
-        if (useQuote) {
+        if (useTokenizer) {
             columnValues.reserve(reserveSize);
-            parseSuccess = mDelimiterModeFsmParserPtr->ParseDelimiterLine(buffer, begIdx, endIdx, columnValues);
+            parseSuccess
+                = TokenizeLine(sourceEvent, StringView(buffer.data() + begIdx, endIdx - begIdx), columnValues);
+            if (parseSuccess && !useQuote && !(mOverflowedFieldsTreatment == OverflowedFieldsTreatment::EXTEND)
+                && columnValues.size() > mKeys.size()) {
+                // same as SplitString, the overflowed fields are kept as a whole, starting from the separator
+                const char* extraFields = columnValues[mKeys.size()].data() - 1;
+                columnValues.resize(mKeys.size());
+                columnValues.emplace_back(extraFields, buffer.data() + endIdx - extraFields);
+            }
             // handle auto extend
-            if (!(mOverflowedFieldsTreatment == OverflowedFieldsTreatment::EXTEND)
+            if (useQuote && !(mOverflowedFieldsTreatment == OverflowedFieldsTreatment::EXTEND)
                 && columnValues.size() > mKeys.size()) {
                 int requiredLen = 0;
                 for (size_t i = mKeys.size(); i < columnValues.size(); ++i) {
@@ -325,7 +335,8 @@ bool ProcessorParseDelimiterNative::ProcessEvent(const StringView& logPath, Pipe
                     continue;
                 }
                 AddLog(mKeys[idx],
-                       useQuote ? columnValues[idx] : StringView(buffer.data() + colBegIdxs[idx], colLens[idx]),
+                       useTokenizer ? columnValues[idx]
+                                    : StringView(buffer.data() + colBegIdxs[idx], colLens[idx]),
                        sourceEvent);
             } else {
                 if (mExtractingPartialFields) {
@@ -334,7 +345,8 @@ bool ProcessorParseDelimiterNative::ProcessEvent(const StringView& logPath, Pipe
                 std::string key = "__column" + ToString(idx) + "__";
                 StringBuffer sb = sourceEvent.GetSourceBuffer()->CopyString(key);
                 AddLog(StringView(sb.data, sb.size),
-                       useQuote ? columnValues[idx] : StringView(buffer.data() + colBegIdxs[idx], colLens[idx]),
+                       useTokenizer ? columnValues[idx]
+                                    : StringView(buffer.data() + colBegIdxs[idx], colLens[idx]),
                        sourceEvent);
             }
         }
@@ -400,6 +412,22 @@ bool ProcessorParseDelimiterNative::SplitString(
     return true;
 }
 
+bool ProcessorParseDelimiterNative::TokenizeLine(LogEvent& sourceEvent,
+                                                 StringView line,
+                                                 std::vector<StringView>& columnValues) {
+    static thread_local std::vector<size_t> sEscapedColumns;
+    if (!mTokenizerPtr->Tokenize(line, columnValues, sEscapedColumns)) {
+        return false;
+    }
+    for (size_t idx : sEscapedColumns) {
+        StringView& value = columnValues[idx];
+        StringBuffer sb = sourceEvent.GetSourceBuffer()->AllocateStringBuffer(value.size());
+        sb.size = mTokenizerPtr->Unescape(value, sb.data);
+        value = StringView(sb.data, sb.size);
+    }
+    return true;
+}
+
 void ProcessorParseDelimiterNative::AddLog(const StringView& key,
                                            const StringView& value,
                                            LogEvent& targetEvent,
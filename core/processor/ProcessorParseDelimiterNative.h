@@ -19,7 +19,7 @@
 #include <memory>
 
 #include "models/LogEvent.h"
-#include "parser/DelimiterModeFsmParser.h"
+#include "parser/DelimiterTokenizer.h"
 #include "plugin/interface/Processor.h"
 #include "processor/CommonParserOptions.h"
 
@@ -68,11 +68,12 @@ private:
                      int32_t endIdx,
                      std::vector<size_t>& colBegIdxs,
                      std::vector<size_t>& colLens);
+    bool TokenizeLine(LogEvent& sourceEvent, StringView line, std::vector<StringView>& columnValues);
     void AddLog(const StringView& key, const StringView& value, LogEvent& targetEvent, bool overwritten = true);
 
     char mSeparatorChar;
     bool mSourceKeyOverwritten = false;
-    std::unique_ptr<DelimiterModeFsmParser> mDelimiterModeFsmParserPtr;
+    std::unique_ptr<DelimiterTokenizer> mTokenizerPtr;
 
     int* mLogGroupSize = nullptr;
     int* mParseFailures = nullptr;
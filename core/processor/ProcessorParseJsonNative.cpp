@@ -19,6 +19,8 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include "common/JsonScanner.h"
+#include "common/LogtailCommonFlags.h"
 #include "common/ParamExtractor.h"
 #include "models/LogEvent.h"
 #include "monitor/MetricConstants.h"
@@ -119,6 +121,10 @@ bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
 
     mProcParseInSizeBytes->Add(buffer.size());
 
+    if (BOOL_FLAG(enable_json_scanner) && ScanJsonLogLine(sourceEvent, buffer, sourceKeyOverwritten)) {
+        return true;
+    }
+
     bool parseSuccess = true;
     rapidjson::Document doc;
     doc.Parse(buffer.data(), buffer.size());
@@ -174,6 +180,42 @@ bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
     return true;
 }
 
+bool ProcessorParseJsonNative::ScanJsonLogLine(LogEvent& sourceEvent,
+                                               const StringView& buffer,
+                                               bool& sourceKeyOverwritten) {
+    static thread_local JsonScanner sScanner;
+    static thread_local std::vector<JsonScanner::Field> sFields;
+    if (!sScanner.Scan(buffer, sFields)) {
+        return false;
+    }
+    // unescape all strings before adding any of them, so that the event is untouched when falling back
+    for (auto& field : sFields) {
+        if (!UnescapeToSourceBuffer(sourceEvent, field.mKeyEscaped, field.mKey)
+            || !UnescapeToSourceBuffer(sourceEvent, field.mValueEscaped, field.mValue)) {
+            return false;
+        }
+    }
+    for (const auto& field : sFields) {
+        if (field.mKey == mSourceKey) {
+            sourceKeyOverwritten = true;
+        }
+        AddLog(field.mKey, field.mValue, sourceEvent);
+    }
+    return true;
+}
+
+bool ProcessorParseJsonNative::UnescapeToSourceBuffer(LogEvent& sourceEvent, bool escaped, StringView& value) {
+    if (!escaped) {
+        return true;
+    }
+    StringBuffer sb = sourceEvent.GetSourceBuffer()->AllocateStringBuffer(value.size());
+    if (!JsonScanner::Unescape(value, sb.data, sb.size)) {
+        return false;
+    }
+    value = StringView(sb.data, sb.size);
+    return true;
+}
+
 std::string ProcessorParseJsonNative::RapidjsonValueToString(const rapidjson::Value& value) {
     if (value.IsString())
         return value.GetString();
@@ -40,6 +40,9 @@ protected:
 
 private:
     bool JsonLogLineParser(LogEvent& sourceEvent, const StringView& logPath, PipelineEventPtr& e, bool& sourceKeyOverwritten);
+    // fast path of JsonLogLineParser, which returns false if the line should be parsed by rapidjson instead
+    bool ScanJsonLogLine(LogEvent& sourceEvent, const StringView& buffer, bool& sourceKeyOverwritten);
+    static bool UnescapeToSourceBuffer(LogEvent& sourceEvent, bool escaped, StringView& value);
     void AddLog(const StringView& key, const StringView& value, LogEvent& targetEvent, bool overwritten = true);
     bool ProcessEvent(const StringView& logPath, PipelineEventPtr& e);
     static std::string RapidjsonValueToString(const rapidjson::Value& value);
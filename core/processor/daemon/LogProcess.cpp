@@ -14,7 +14,6 @@
 
 #include "processor/daemon/LogProcess.h"
 
-#include "batch/TimeoutFlushManager.h"
 #include "app_config/AppConfig.h"
 #include "common/Flags.h"
 #include "go_pipeline/LogtailPlugin.h"
@@ -26,6 +25,8 @@
 #include "queue/ProcessQueueManager.h"
 #include "queue/QueueKeyManager.h"
 #include "sender/Sender.h"
+#include "serializer/FlatLogGroupWriter.h"
+#include "serializer/LogGroupWriter.h"
 
 DECLARE_FLAG_INT32(max_send_log_group_size);
 
@@ -37,7 +38,6 @@ using namespace std;
 // Note: enable this will spend CPU to do transformation.
 DEFINE_FLAG_BOOL(enable_chinese_tag_path, "Enable Chinese __tag__.__path__", true);
 #endif
-DEFINE_FLAG_INT32(default_flush_merged_buffer_interval, "default flush merged buffer, seconds", 1);
 
 namespace logtail {
 
@@ -52,6 +52,7 @@ LogProcess::~LogProcess() {
         }
     }
     delete[] mThreadFlags;
+    delete[] mThreadRounds;
     delete[] mProcessThreads;
 }
 
@@ -63,8 +64,10 @@ void LogProcess::Start() {
     mThreadCount = AppConfig::GetInstance()->GetProcessThreadCount();
     mProcessThreads = new ThreadPtr[mThreadCount];
     mThreadFlags = new std::atomic_bool[mThreadCount];
+    mThreadRounds = new std::atomic_uint64_t[mThreadCount];
     for (int32_t threadNo = 0; threadNo < mThreadCount; ++threadNo) {
         mThreadFlags[threadNo] = false;
+        mThreadRounds[threadNo] = 0;
         mProcessThreads[threadNo] = CreateThread([this, threadNo]() { ProcessLoop(threadNo); });
     }
     LOG_INFO(sLogger, ("process daemon", "started"));
@@ -113,6 +116,23 @@ void LogProcess::Resume() {
     LOG_INFO(sLogger, ("process daemon resume", "succeeded"));
 }
 
+void LogProcess::WaitForPoppedItems() {
+    if (!mInitialized) {
+        return;
+    }
+    // the flag of a thread is set before popping and cleared only after the popped item has been processed, so the
+    // item is done once the flag is cleared or the thread has moved on to the next round
+    for (int32_t threadNo = 0; threadNo < mThreadCount; ++threadNo) {
+        if (!mThreadFlags[threadNo]) {
+            continue;
+        }
+        uint64_t round = mThreadRounds[threadNo];
+        while (mThreadFlags[threadNo] && mThreadRounds[threadNo] == round) {
+            usleep(1000);
+        }
+    }
+}
+
 bool LogProcess::FlushOut(int32_t waitMs) {
     ProcessQueueManager::GetInstance()->Trigger();
     if (ProcessQueueManager::GetInstance()->IsAllQueueEmpty()) {
@@ -139,7 +159,6 @@ bool LogProcess::FlushOut(int32_t waitMs) {
 
 void* LogProcess::ProcessLoop(int32_t threadNo) {
     LOG_DEBUG(sLogger, ("LogProcessThread", "Start")("threadNo", threadNo));
-    static int32_t lastMergeTime = 0;
     static atomic_int s_processCount{0};
     static atomic_long s_processBytes{0};
     static atomic_int s_processLines{0};
@@ -147,13 +166,9 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
     int32_t lastUpdateMetricTime = time(NULL);
     while (true) {
         mThreadFlags[threadNo] = false;
+        ++mThreadRounds[threadNo];
 
         int32_t curTime = time(NULL);
-        if (threadNo == 0 && curTime - lastMergeTime >= INT32_FLAG(default_flush_merged_buffer_interval)) {
-            TimeoutFlushManager::GetInstance()->FlushTimeoutBatch();
-            lastMergeTime = curTime;
-        }
-
         if (threadNo == 0 && curTime - lastUpdateMetricTime >= 40) {
             static auto sMonitor = LogtailMonitor::GetInstance();
 
@@ -182,12 +197,14 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
 
             std::unique_ptr<ProcessQueueItem> item;
             std::string configName;
+            // set before popping, so that the popped item is always covered by the flag, see WaitForPoppedItems
+            mThreadFlags[threadNo] = true;
             if (!ProcessQueueManager::GetInstance()->PopItem(threadNo, item, configName)) {
+                mThreadFlags[threadNo] = false;
                 ProcessQueueManager::GetInstance()->Wait(100);
                 continue;
             }
 
-            mThreadFlags[threadNo] = true;
             auto pipeline = PipelineManager::GetInstance()->FindPipelineByName(configName);
             if (!pipeline) {
                 LOG_INFO(sLogger,
@@ -232,12 +249,15 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
 
             if (pipeline->IsFlushingThroughGoPipeline()) {
                 if (isLog) {
+                    // the flat format is preferred, unless the Go plugin system is too old to support it
+                    bool useFlatLogGroup = LogtailPlugin::GetInstance()->IsFlatLogGroupSupported();
+                    bool enableNanosecond = pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond;
                     for (auto& group : eventGroupList) {
                         string res, errorMsg;
-                        if (!Serialize(group,
-                                       pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
-                                       res,
-                                       errorMsg)) {
+                        bool succeeded = useFlatLogGroup
+                            ? SerializeToFlatLogGroup(group, enableNanosecond, res, errorMsg)
+                            : Serialize(group, enableNanosecond, res, errorMsg);
+                        if (!succeeded) {
                             LOG_WARNING(pipeline->GetContext().GetLogger(),
                                         ("failed to serialize event group",
                                          errorMsg)("action", "discard data")("config", configName));
@@ -250,10 +270,17 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
                                                                         pipeline->GetContext().GetRegion());
                             continue;
                         }
-                        LogtailPlugin::GetInstance()->ProcessLogGroup(
-                            pipeline->GetContext().GetConfigName(),
-                            res,
-                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                        if (useFlatLogGroup) {
+                            LogtailPlugin::GetInstance()->ProcessFlatLogGroup(
+                                pipeline->GetContext().GetConfigName(),
+                                res,
+                                group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                        } else {
+                            LogtailPlugin::GetInstance()->ProcessLogGroup(
+                                pipeline->GetContext().GetConfigName(),
+                                res,
+                                group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                        }
                     }
                 }
             } else {
@@ -332,4 +359,67 @@ bool LogProcess::Serialize(const PipelineEventGroup& group, bool enableNanosecon
     return true;
 }
 
+bool LogProcess::SerializeToFlatLogGroup(const PipelineEventGroup& group,
+                                         bool enableNanosecond,
+                                         string& res,
+                                         string& errorMsg) {
+    uint32_t contentCnt = 0, tagCnt = 0;
+    size_t stringsSize = 0;
+    // the size limit is defined on the protobuf LogGroup, which the Go side decodes the flat layout into, so the size
+    // of the equivalent protobuf is checked, since the flat layout is much larger for small fields
+    size_t size = 0;
+    for (const auto& e : group.GetEvents()) {
+        if (!e.Is<LogEvent>()) {
+            errorMsg = "unsupported event type in event group";
+            return false;
+        }
+        const auto& logEvent = e.Cast<LogEvent>();
+        size_t contentsSize = 0;
+        for (const auto& kv : logEvent) {
+            ++contentCnt;
+            stringsSize += kv.first.size() + kv.second.size();
+            contentsSize += GetLogContentSize(kv.first.size(), kv.second.size());
+        }
+        size += GetLengthDelimitedFieldSize(
+            GetLogBodySize(contentsSize,
+                           static_cast<uint32_t>(logEvent.GetTimestamp()),
+                           enableNanosecond && logEvent.GetTimestampNanosecond()));
+    }
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first != LOG_RESERVED_KEY_TOPIC) {
+            ++tagCnt;
+            stringsSize += tag.first.size();
+            size += GetLogTagSize(tag.first.size(), tag.second.size());
+        } else {
+            size += GetLengthDelimitedFieldSize(tag.second.size());
+        }
+        stringsSize += tag.second.size();
+    }
+    if (static_cast<int32_t>(size) > INT32_FLAG(max_send_log_group_size)) {
+        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(size)
+            + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
+        return false;
+    }
+
+    FlatLogGroupWriter writer;
+    writer.Prepare(group.GetEvents().size(), contentCnt, tagCnt, stringsSize);
+    for (const auto& e : group.GetEvents()) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        const auto& timeNs = logEvent.GetTimestampNanosecond();
+        writer.AddLog(logEvent.GetTimestamp(), timeNs ? timeNs.value() : 0, enableNanosecond && timeNs);
+        for (const auto& kv : logEvent) {
+            writer.AddLogContent(kv.first, kv.second);
+        }
+    }
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            writer.SetTopic(tag.second);
+        } else {
+            writer.AddLogTag(tag.first, tag.second);
+        }
+    }
+    res = std::move(writer.GetResult());
+    return true;
+}
+
 } // namespace logtail
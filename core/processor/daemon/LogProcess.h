@@ -38,6 +38,9 @@ public:
     void HoldOn();
     void Resume();
     bool FlushOut(int32_t waitMs);
+    // Wait until the items popped by all threads before the call have been processed. Unlike HoldOn, other items
+    // are still processed meanwhile.
+    void WaitForPoppedItems();
 
     void* ProcessLoop(int32_t threadNo);
     // TODO: replace key with configName
@@ -48,12 +51,21 @@ private:
     ~LogProcess();
 
     bool Serialize(const PipelineEventGroup& group, bool enableNanosecond, std::string& res, std::string& errorMsg);
+    bool SerializeToFlatLogGroup(const PipelineEventGroup& group,
+                                 bool enableNanosecond,
+                                 std::string& res,
+                                 std::string& errorMsg);
 
     bool mInitialized = false;
     ThreadPtr* mProcessThreads;
     int32_t mThreadCount = 1;
     std::atomic_bool* mThreadFlags;
+    std::atomic_uint64_t* mThreadRounds;
     ReadWriteLock mAccessProcessThreadRWL;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class PipelineManagerUnittest;
+#endif
 };
 
 } // namespace logtail
\ No newline at end of file
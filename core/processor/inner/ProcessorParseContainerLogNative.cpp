@@ -23,7 +23,9 @@
 #include <codecvt>
 #include <locale>
 
+#include "common/JsonScanner.h"
 #include "common/JsonUtil.h"
+#include "common/LogtailCommonFlags.h"
 #include "common/ParamExtractor.h"
 #include "models/LogEvent.h"
 #include "monitor/MetricConstants.h"
@@ -463,6 +465,49 @@ bool ProcessorParseContainerLogNative::ParseDockerLog(char* buffer, int32_t size
     return true;
 }
 
+bool ProcessorParseContainerLogNative::ScanDockerLog(LogEvent& sourceEvent, StringView buffer, DockerLog& dockerLog) {
+    static thread_local JsonScanner sScanner;
+    static thread_local std::vector<JsonScanner::Field> sFields;
+    if (buffer.empty() || buffer.front() != '{' || buffer.back() != '}' || !sScanner.Scan(buffer, sFields)
+        || sFields.size() != 3) {
+        return false;
+    }
+    DockerLog entry;
+    bool logEscaped = false;
+    for (size_t i = 0; i < sFields.size(); ++i) {
+        const auto& field = sFields[i];
+        // only compact lines like {"log":"xxx","stream":"stdout","time":"xxx"} are accepted, which is what docker
+        // writes, since ParseDockerLog does not accept blanks other than spaces
+        const char* keyEnd = field.mKey.data() + field.mKey.size();
+        const char* valueEnd = field.mValue.data() + field.mValue.size();
+        if (field.mKeyEscaped || field.mKey.data()[-2] != (i == 0 ? '{' : ',') || keyEnd[1] != ':'
+            || field.mValue.data() != keyEnd + 3 || keyEnd[2] != '"' || *valueEnd != '"') {
+            return false;
+        }
+        if (field.mKey == DOCKER_JSON_LOG) {
+            entry.log = field.mValue;
+            logEscaped = field.mValueEscaped;
+        } else if (field.mValueEscaped) {
+            return false;
+        } else if (field.mKey == DOCKER_JSON_STREAM_TYPE) {
+            entry.stream = field.mValue;
+        } else if (field.mKey == DOCKER_JSON_TIME) {
+            entry.time = field.mValue;
+        } else {
+            return false;
+        }
+    }
+    if (logEscaped) {
+        StringBuffer sb = sourceEvent.GetSourceBuffer()->AllocateStringBuffer(entry.log.size());
+        if (!JsonScanner::Unescape(entry.log, sb.data, sb.size)) {
+            return false;
+        }
+        entry.log = StringView(sb.data, sb.size);
+    }
+    dockerLog = entry;
+    return true;
+}
+
 bool ProcessorParseContainerLogNative::ParseDockerJsonLogLine(LogEvent& sourceEvent, std::string& errorMsg) {
     StringView buffer = sourceEvent.GetContent(mSourceKey);
 
@@ -471,7 +516,8 @@ bool ProcessorParseContainerLogNative::ParseDockerJsonLogLine(LogEvent& sourceEv
 
     char* data = const_cast<char*>(buffer.data());
 
-    if (ParseDockerLog(data, buffer.size(), entry)) {
+    if ((BOOL_FLAG(enable_json_scanner) && ScanDockerLog(sourceEvent, buffer, entry))
+        || ParseDockerLog(data, buffer.size(), entry)) {
         timeValue = entry.time;
         content = entry.log;
         sourceValue = entry.stream;
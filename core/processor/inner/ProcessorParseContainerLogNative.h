@@ -66,6 +66,9 @@ protected:
 
 private:
     static bool ParseDockerLog(char* buffer, int32_t size, DockerLog& dockerLog);
+    // fast path of ParseDockerLog for compact lines, which returns false if the line should be parsed by
+    // ParseDockerLog instead. Unlike ParseDockerLog, escaped log is unescaped to the source buffer of the event.
+    static bool ScanDockerLog(LogEvent& sourceEvent, StringView buffer, DockerLog& dockerLog);
     bool ProcessEvent(StringView containerType, PipelineEventPtr& e, PipelineEventGroup& logGroup);
     bool ProcessEvent(StringView containerType, PipelineEventPtr& e);
     void ResetDockerJsonLogField(char* data, StringView key, StringView value, LogEvent& targetEvent);
@@ -17,6 +17,7 @@
 #include "processor/inner/ProcessorSplitLogStringNative.h"
 
 #include "common/ParamExtractor.h"
+#include "common/SimdUtil.h"
 #include "models/LogEvent.h"
 
 namespace logtail {
@@ -131,18 +132,27 @@ void ProcessorSplitLogStringNative::ProcessEvent(PipelineEventGroup& logGroup,
     StringView sourceVal = sourceEvent.GetContent(mSourceKey);
     StringBuffer sourceKey = logGroup.GetSourceBuffer()->CopyString(mSourceKey);
 
+    // find all split positions in one pass, and the end of the last line is appended if it is not empty
+    static thread_local std::vector<size_t> sSplitPositions;
+    sSplitPositions.clear();
+    FindAllCharPositions(sourceVal.data(), sourceVal.size(), mSplitChar, sSplitPositions);
+    if (sSplitPositions.empty() ? !sourceVal.empty() : sSplitPositions.back() + 1 < sourceVal.size()) {
+        sSplitPositions.push_back(sourceVal.size());
+    }
+    if (newEvents.empty()) {
+        newEvents.reserve(sSplitPositions.size());
+    }
+
     size_t begin = 0;
-    while (begin < sourceVal.size()) {
+    for (size_t end : sSplitPositions) {
         std::unique_ptr<LogEvent> targetEvent = logGroup.CreateLogEvent();
-        StringView content = GetNextLine(sourceVal, begin);
+        StringView content(sourceVal.data() + begin, end - begin);
         targetEvent->SetContentNoCopy(StringView(sourceKey.data, sourceKey.size), content);
         targetEvent->SetTimestamp(
             sourceEvent.GetTimestamp(),
             sourceEvent.GetTimestampNanosecond()); // it is easy to forget other fields, better solution?
-        auto const offset = sourceEvent.GetPosition().first + (content.data() - sourceVal.data());
-        auto const length = begin + content.size() == sourceVal.size()
-            ? sourceEvent.GetPosition().second - (content.data() - sourceVal.data())
-            : content.size() + 1;
+        auto const offset = sourceEvent.GetPosition().first + begin;
+        auto const length = end == sourceVal.size() ? sourceEvent.GetPosition().second - begin : content.size() + 1;
         targetEvent->SetPosition(offset, length);
         if (mAppendingLogPositionMeta) {
             StringBuffer offsetStr = logGroup.GetSourceBuffer()->CopyString(ToString(offset));
@@ -153,21 +163,8 @@ void ProcessorSplitLogStringNative::ProcessEvent(PipelineEventGroup& logGroup,
             logGroup.GetExactlyOnceCheckpoint()->positions.emplace_back(offset, content.size());
         }
         newEvents.emplace_back(std::move(targetEvent));
-        begin += content.size() + 1;
-    }
-}
-
-StringView ProcessorSplitLogStringNative::GetNextLine(StringView log, size_t begin) {
-    if (begin >= log.size()) {
-        return StringView();
-    }
-
-    for (size_t end = begin; end < log.size(); ++end) {
-        if (log[end] == mSplitChar) {
-            return StringView(log.data() + begin, end - begin);
-        }
+        begin = end + 1;
     }
-    return StringView(log.data() + begin, log.size() - begin);
 }
 
 } // namespace logtail
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace logtail {
+
+// Bounded multi-producer multi-consumer ring buffer without lock. Each cell carries a sequence number telling whether
+// it is ready to be written or read at a given position, so that producers and consumers only contend on the position
+// counters. The capacity is rounded up to a power of 2.
+template <typename T>
+class BoundedMPMCQueue {
+public:
+    explicit BoundedMPMCQueue(size_t cap) {
+        size_t size = 2;
+        while (size < cap) {
+            size <<= 1;
+        }
+        mMask = size - 1;
+        mCells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+    BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+
+    bool TryPush(T&& item) {
+        Cell* cell = nullptr;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // full
+                return false;
+            } else {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->mData = std::move(item);
+        cell->mSequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& item) {
+        Cell* cell = nullptr;
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // empty, or the producer of the cell has not finished writing yet
+                return false;
+            } else {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        item = std::move(cell->mData);
+        cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t Capacity() const { return mMask + 1; }
+
+private:
+    struct Cell {
+        std::atomic_size_t mSequence;
+        T mData;
+    };
+
+    std::unique_ptr<Cell[]> mCells;
+    size_t mMask = 0;
+    // producers and consumers are kept on different cache lines
+    alignas(64) std::atomic_size_t mEnqueuePos{0};
+    alignas(64) std::atomic_size_t mDequeuePos{0};
+};
+
+} // namespace logtail
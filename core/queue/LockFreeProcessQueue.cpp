@@ -0,0 +1,101 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "queue/LockFreeProcessQueue.h"
+
+using namespace std;
+
+namespace logtail {
+
+LockFreeProcessQueue::LockFreeProcessQueue(size_t cap, size_t low, size_t high, QueueKey key, const string& config)
+    : mKey(key), mCapacity(cap), mLowWatermark(low), mHighWatermark(high), mConfigName(config), mQueue(cap) {
+}
+
+bool LockFreeProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
+    if (!mValidToPush) {
+        return false;
+    }
+    size_t size = ++mSize;
+    if (size > mCapacity || !mQueue.TryPush(std::move(item))) {
+        --mSize;
+        return false;
+    }
+    if (size >= mHighWatermark) {
+        mValidToPush = false;
+        // items may have been popped concurrently before the state is changed, in which case no popper would bring
+        // the state back
+        if (mSize <= mLowWatermark) {
+            TryValidatePush();
+        }
+    }
+    return true;
+}
+
+bool LockFreeProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
+    if (!mValidToPop || mSize == 0 || !IsDownStreamQueuesValidToPush()) {
+        return false;
+    }
+    // the item may not be visible yet even if the size is not 0, since the size is increased before pushing
+    if (!mQueue.TryPop(item)) {
+        return false;
+    }
+    size_t size = --mSize;
+    if (size <= mLowWatermark && !mValidToPush) {
+        TryValidatePush();
+    }
+    return true;
+}
+
+void LockFreeProcessQueue::SetDownStreamQueues(DownStreamQueues& ques) {
+    mDownStreamQueuesHolder.emplace_back(new DownStreamQueues());
+    mDownStreamQueuesHolder.back()->swap(ques);
+    mDownStreamQueues = mDownStreamQueuesHolder.back().get();
+}
+
+void LockFreeProcessQueue::SetUpStreamFeedbacks(UpStreamFeedbacks& feedbacks) {
+    mUpStreamFeedbacksHolder.emplace_back(new UpStreamFeedbacks());
+    mUpStreamFeedbacksHolder.back()->swap(feedbacks);
+    mUpStreamFeedbacks = mUpStreamFeedbacksHolder.back().get();
+}
+
+bool LockFreeProcessQueue::IsDownStreamQueuesValidToPush() const {
+    const DownStreamQueues* ques = mDownStreamQueues;
+    if (ques == nullptr) {
+        return true;
+    }
+    // items are popped only when all sender queues can take the result
+    for (const auto& q : *ques) {
+        if (!q->IsValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LockFreeProcessQueue::TryValidatePush() {
+    // only one thread can change the state and give feedback
+    bool expected = false;
+    if (!mValidToPush.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    const UpStreamFeedbacks* feedbacks = mUpStreamFeedbacks;
+    if (feedbacks == nullptr) {
+        return;
+    }
+    for (auto& item : *feedbacks) {
+        item->Feedback(mKey);
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/FeedbackInterface.h"
+#include "common/LogstoreSenderQueue.h"
+#include "queue/BoundedMPMCQueue.h"
+#include "queue/FeedbackQueueKey.h"
+#include "queue/ProcessQueueItem.h"
+#include "sender/SenderQueueParam.h"
+
+namespace logtail {
+
+// Thread-safe counterpart of ProcessQueue, which can be pushed and popped by multiple threads at the same time
+// without lock. The queue becomes invalid to push once its size reaches the high watermark, and becomes valid again
+// with upstream feedback once its size drops to the low watermark, the same as FeedbackQueue does.
+class LockFreeProcessQueue {
+public:
+    using DownStreamQueues = std::vector<SingleLogstoreSenderManager<SenderQueueParam>*>;
+    using UpStreamFeedbacks = std::vector<FeedbackInterface*>;
+
+    LockFreeProcessQueue(size_t cap, size_t low, size_t high, QueueKey key, const std::string& config);
+
+    LockFreeProcessQueue(const LockFreeProcessQueue&) = delete;
+    LockFreeProcessQueue& operator=(const LockFreeProcessQueue&) = delete;
+
+    bool Push(std::unique_ptr<ProcessQueueItem>&& item);
+    bool Pop(std::unique_ptr<ProcessQueueItem>& item);
+
+    bool IsValidToPush() const { return mValidToPush.load(); }
+    bool Empty() const { return mSize.load() == 0; }
+    QueueKey GetKey() const { return mKey; }
+    const std::string& GetConfigName() const { return mConfigName; }
+
+    void InvalidatePop() { mValidToPop = false; }
+    void ValidatePop() { mValidToPop = true; }
+
+    // not thread-safe with each other, should be protected explicitly by queue manager
+    void SetDownStreamQueues(DownStreamQueues& ques);
+    void SetUpStreamFeedbacks(UpStreamFeedbacks& feedbacks);
+
+private:
+    bool IsDownStreamQueuesValidToPush() const;
+    void TryValidatePush();
+
+    const QueueKey mKey;
+    const size_t mCapacity;
+    const size_t mLowWatermark;
+    const size_t mHighWatermark;
+    const std::string mConfigName;
+
+    BoundedMPMCQueue<std::unique_ptr<ProcessQueueItem>> mQueue;
+    // number of items pushed or being pushed, which is used to guarantee the capacity
+    std::atomic_size_t mSize{0};
+    std::atomic_bool mValidToPush{true};
+    std::atomic_bool mValidToPop{true};
+
+    // old lists are kept alive until the queue is destructed, since they may still be read by other threads
+    std::atomic<const DownStreamQueues*> mDownStreamQueues{nullptr};
+    std::atomic<const UpStreamFeedbacks*> mUpStreamFeedbacks{nullptr};
+    std::list<std::unique_ptr<DownStreamQueues>> mDownStreamQueuesHolder;
+    std::list<std::unique_ptr<UpStreamFeedbacks>> mUpStreamFeedbacksHolder;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcessQueueUnittest;
+    friend class ProcessQueueManagerUnittest;
+#endif
+};
+
+} // namespace logtail
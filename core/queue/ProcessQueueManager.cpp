@@ -14,22 +14,35 @@
 
 #include "queue/ProcessQueueManager.h"
 
+#include <algorithm>
+
 #include "common/Flags.h"
 #include "queue/ExactlyOnceQueueManager.h"
 #include "queue/QueueKeyManager.h"
 #include "queue/QueueParam.h"
 
+DEFINE_FLAG_BOOL(enable_lock_free_process_queue,
+                 "push and pop process queues without global lock, which scales better with many process threads",
+                 false);
 DECLARE_FLAG_INT32(process_thread_count);
 
 using namespace std;
 
 namespace logtail {
 
-ProcessQueueManager::ProcessQueueManager() {
+thread_local uint64_t ProcessQueueManager::sLockFreeSnapshotVersion = 0;
+thread_local shared_ptr<const ProcessQueueManager::LockFreeQueueSnapshot> ProcessQueueManager::sLockFreeSnapshot;
+
+ProcessQueueManager::ProcessQueueManager()
+    : mLockFree(BOOL_FLAG(enable_lock_free_process_queue)),
+      mLockFreeSnapshot(make_shared<LockFreeQueueSnapshot>()) {
     ResetCurrentQueueIndex();
 }
 
 bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
+    if (mLockFree) {
+        return CreateOrUpdateLockFreeQueue(key, priority);
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
@@ -64,6 +77,9 @@ bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
 }
 
 bool ProcessQueueManager::DeleteQueue(QueueKey key) {
+    if (mLockFree) {
+        return DeleteLockFreeQueue(key);
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
@@ -84,6 +100,14 @@ bool ProcessQueueManager::DeleteQueue(QueueKey key) {
 }
 
 bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
+    if (mLockFree) {
+        const auto& queues = GetLockFreeSnapshot().mQueues;
+        auto iter = queues.find(key);
+        if (iter != queues.end()) {
+            return iter->second->IsValidToPush();
+        }
+        return ExactlyOnceQueueManager::GetInstance()->IsValidToPushProcessQueue(key);
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
@@ -93,6 +117,22 @@ bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
 }
 
 int ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
+    if (mLockFree) {
+        const auto& queues = GetLockFreeSnapshot().mQueues;
+        auto iter = queues.find(key);
+        if (iter != queues.end()) {
+            if (!iter->second->Push(std::move(item))) {
+                return 1;
+            }
+        } else {
+            int res = ExactlyOnceQueueManager::GetInstance()->PushProcessQueue(key, std::move(item));
+            if (res != 0) {
+                return res;
+            }
+        }
+        Trigger();
+        return 0;
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
@@ -112,6 +152,9 @@ int ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&&
 }
 
 bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>& item, string& configName) {
+    if (mLockFree) {
+        return PopLockFreeItem(threadNo, item, configName);
+    }
     configName.clear();
     lock_guard<mutex> lock(mQueueMux);
     for (size_t i = 0; i <= sMaxPriority; ++i) {
@@ -151,29 +194,45 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             return true;
         }
         // find exactly once queues next
-        {
-            lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
-            for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].begin();
-                 iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].end();
-                 ++iter) {
-                // process queue for exactly once can only be assgined to one specific thread
-                if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
-                    continue;
-                }
-                if (!iter->Pop(item)) {
-                    continue;
-                }
-                configName = iter->GetConfigName();
-                ResetCurrentQueueIndex();
-                return true;
-            }
+        if (PopExactlyOnceItem(threadNo, i, item, configName)) {
+            ResetCurrentQueueIndex();
+            return true;
         }
     }
     ResetCurrentQueueIndex();
     return false;
 }
 
+bool ProcessQueueManager::PopExactlyOnceItem(int64_t threadNo,
+                                             uint32_t priority,
+                                             unique_ptr<ProcessQueueItem>& item,
+                                             string& configName) {
+    lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
+    for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].begin();
+         iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].end();
+         ++iter) {
+        // process queue for exactly once can only be assgined to one specific thread
+        if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
+            continue;
+        }
+        if (!iter->Pop(item)) {
+            continue;
+        }
+        configName = iter->GetConfigName();
+        return true;
+    }
+    return false;
+}
+
 bool ProcessQueueManager::IsAllQueueEmpty() const {
+    if (mLockFree) {
+        for (const auto& q : GetLockFreeSnapshot().mQueues) {
+            if (!q.second->Empty()) {
+                return false;
+            }
+        }
+        return ExactlyOnceQueueManager::GetInstance()->IsAllProcessQueueEmpty();
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         for (const auto& q : mQueues) {
@@ -188,6 +247,14 @@ bool ProcessQueueManager::IsAllQueueEmpty() const {
 bool ProcessQueueManager::SetDownStreamQueues(QueueKey key,
                                               vector<SingleLogstoreSenderManager<SenderQueueParam>*>& ques) {
     lock_guard<mutex> lock(mQueueMux);
+    if (mLockFree) {
+        auto que = FindLockFreeQueue(key);
+        if (!que) {
+            return false;
+        }
+        que->SetDownStreamQueues(ques);
+        return true;
+    }
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
@@ -198,6 +265,14 @@ bool ProcessQueueManager::SetDownStreamQueues(QueueKey key,
 
 bool ProcessQueueManager::SetFeedbackInterface(QueueKey key, vector<FeedbackInterface*>& feedback) {
     lock_guard<mutex> lock(mQueueMux);
+    if (mLockFree) {
+        auto que = FindLockFreeQueue(key);
+        if (!que) {
+            return false;
+        }
+        que->SetUpStreamFeedbacks(feedback);
+        return true;
+    }
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
@@ -210,6 +285,13 @@ void ProcessQueueManager::InvalidatePop(const string& configName) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
         lock_guard<mutex> lock(mQueueMux);
+        if (mLockFree) {
+            auto que = FindLockFreeQueue(key);
+            if (que) {
+                que->InvalidatePop();
+            }
+            return;
+        }
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
             iter->second->InvalidatePop();
@@ -223,6 +305,13 @@ void ProcessQueueManager::ValidatePop(const string& configName) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
         lock_guard<mutex> lock(mQueueMux);
+        if (mLockFree) {
+            auto que = FindLockFreeQueue(key);
+            if (que) {
+                que->ValidatePop();
+            }
+            return;
+        }
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
             iter->second->ValidatePop();
@@ -233,6 +322,25 @@ void ProcessQueueManager::ValidatePop(const string& configName) {
 }
 
 bool ProcessQueueManager::Wait(uint64_t ms) {
+    if (mLockFree) {
+        // an idle thread would otherwise keep deleted queues and their items alive until its next pop
+        ReleaseOutdatedLockFreeSnapshot();
+        ++mWaitingThreadCnt;
+        {
+            unique_lock<mutex> lock(mStateMux);
+            mCond.wait_for(lock, chrono::milliseconds(ms), [this] {
+                int cnt = mPendingTriggerCnt;
+                while (cnt > 0) {
+                    if (mPendingTriggerCnt.compare_exchange_weak(cnt, cnt - 1)) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+        }
+        --mWaitingThreadCnt;
+        return true;
+    }
     unique_lock<mutex> lock(mStateMux);
     mCond.wait_for(lock, chrono::milliseconds(ms), [this] { return mValidToPop; });
     mValidToPop = false;
@@ -240,6 +348,24 @@ bool ProcessQueueManager::Wait(uint64_t ms) {
 }
 
 void ProcessQueueManager::Trigger() {
+    if (mLockFree) {
+        // each trigger wakes up at most one thread, and pending triggers are limited so that threads waiting later
+        // would not spin for nothing
+        int cnt = mPendingTriggerCnt;
+        while (cnt < INT32_FLAG(process_thread_count)) {
+            if (mPendingTriggerCnt.compare_exchange_weak(cnt, cnt + 1)) {
+                break;
+            }
+        }
+        // the lock is only needed when some thread is waiting, in case it misses the notification
+        if (mWaitingThreadCnt > 0) {
+            {
+                lock_guard<mutex> lock(mStateMux);
+            }
+            mCond.notify_one();
+        }
+        return;
+    }
     {
         lock_guard<mutex> lock(mStateMux);
         mValidToPop = true;
@@ -254,6 +380,14 @@ void ProcessQueueManager::ResetCurrentQueueIndex() {
 
 uint32_t ProcessQueueManager::GetInvalidCnt() const {
     uint32_t res = 0;
+    if (mLockFree) {
+        for (const auto& q : GetLockFreeSnapshot().mQueues) {
+            if (q.second->IsValidToPush()) {
+                ++res;
+            }
+        }
+        return res;
+    }
     lock_guard<mutex> lock(mQueueMux);
     for (const auto& q : mQueues) {
         if (q.second->IsValidToPush()) {
@@ -265,9 +399,119 @@ uint32_t ProcessQueueManager::GetInvalidCnt() const {
 
 uint32_t ProcessQueueManager::GetCnt() const {
     lock_guard<mutex> lock(mQueueMux);
+    if (mLockFree) {
+        return mLockFreeSnapshot->mQueues.size();
+    }
     return mQueues.size();
 }
 
+bool ProcessQueueManager::CreateOrUpdateLockFreeQueue(QueueKey key, uint32_t priority) {
+    lock_guard<mutex> lock(mQueueMux);
+    auto snapshot = make_shared<LockFreeQueueSnapshot>(*mLockFreeSnapshot);
+    auto iter = snapshot->mQueues.find(key);
+    if (iter != snapshot->mQueues.end()) {
+        for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+            auto& queues = snapshot->mPriorityQueue[i];
+            auto it = find(queues.begin(), queues.end(), iter->second);
+            if (it == queues.end()) {
+                continue;
+            }
+            if (i == priority) {
+                return false;
+            }
+            queues.erase(it);
+            break;
+        }
+        snapshot->mPriorityQueue[priority].push_back(iter->second);
+    } else {
+        auto que = make_shared<LockFreeProcessQueue>(ProcessQueueParam::GetInstance()->mCapacity,
+                                                     ProcessQueueParam::GetInstance()->mLowWatermark,
+                                                     ProcessQueueParam::GetInstance()->mHighWatermark,
+                                                     key,
+                                                     QueueKeyManager::GetInstance()->GetName(key));
+        snapshot->mQueues[key] = que;
+        snapshot->mPriorityQueue[priority].push_back(que);
+    }
+    PublishLockFreeSnapshot(std::move(snapshot));
+    return true;
+}
+
+bool ProcessQueueManager::DeleteLockFreeQueue(QueueKey key) {
+    lock_guard<mutex> lock(mQueueMux);
+    auto iter = mLockFreeSnapshot->mQueues.find(key);
+    if (iter == mLockFreeSnapshot->mQueues.end()) {
+        return false;
+    }
+    // items left in the queue are released once no thread holds the old snapshot
+    auto que = iter->second;
+    auto snapshot = make_shared<LockFreeQueueSnapshot>(*mLockFreeSnapshot);
+    snapshot->mQueues.erase(key);
+    for (auto& queues : snapshot->mPriorityQueue) {
+        queues.erase(remove(queues.begin(), queues.end(), que), queues.end());
+    }
+    PublishLockFreeSnapshot(std::move(snapshot));
+    return true;
+}
+
+bool ProcessQueueManager::PopLockFreeItem(int64_t threadNo, unique_ptr<ProcessQueueItem>& item, string& configName) {
+    // Each thread scans queues of the same priority round robin from its own position, so that threads spread over
+    // different queues instead of contending on the same one, while an idle thread still takes items from any queue
+    // with items left.
+    static thread_local vector<size_t> sNextQueueIndex;
+    if (sNextQueueIndex.empty()) {
+        sNextQueueIndex.assign(sMaxPriority + 1, static_cast<size_t>(threadNo));
+    }
+    configName.clear();
+    const auto& snapshot = GetLockFreeSnapshot();
+    for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+        const auto& queues = snapshot.mPriorityQueue[i];
+        size_t cnt = queues.size();
+        for (size_t j = 0; j < cnt; ++j) {
+            size_t idx = (sNextQueueIndex[i] + j) % cnt;
+            if (!queues[idx]->Pop(item)) {
+                continue;
+            }
+            configName = queues[idx]->GetConfigName();
+            sNextQueueIndex[i] = idx + 1;
+            return true;
+        }
+        if (PopExactlyOnceItem(threadNo, i, item, configName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+shared_ptr<LockFreeProcessQueue> ProcessQueueManager::FindLockFreeQueue(QueueKey key) const {
+    auto iter = mLockFreeSnapshot->mQueues.find(key);
+    if (iter == mLockFreeSnapshot->mQueues.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+const ProcessQueueManager::LockFreeQueueSnapshot& ProcessQueueManager::GetLockFreeSnapshot() const {
+    // the snapshot is only reloaded when it has been replaced, so the lock is seldom taken
+    if (sLockFreeSnapshotVersion != mLockFreeSnapshotVersion.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(mQueueMux);
+        sLockFreeSnapshot = mLockFreeSnapshot;
+        sLockFreeSnapshotVersion = mLockFreeSnapshotVersion.load(memory_order_relaxed);
+    }
+    return *sLockFreeSnapshot;
+}
+
+void ProcessQueueManager::ReleaseOutdatedLockFreeSnapshot() const {
+    if (sLockFreeSnapshot && sLockFreeSnapshotVersion != mLockFreeSnapshotVersion.load(memory_order_acquire)) {
+        sLockFreeSnapshot.reset();
+        sLockFreeSnapshotVersion = 0;
+    }
+}
+
+void ProcessQueueManager::PublishLockFreeSnapshot(shared_ptr<LockFreeQueueSnapshot>&& snapshot) {
+    mLockFreeSnapshot = std::move(snapshot);
+    mLockFreeSnapshotVersion.fetch_add(1, memory_order_release);
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 void ProcessQueueManager::Clear() {
     lock_guard<mutex> lock(mQueueMux);
@@ -276,6 +520,7 @@ void ProcessQueueManager::Clear() {
         mPriorityQueue[i].clear();
     }
     ResetCurrentQueueIndex();
+    PublishLockFreeSnapshot(make_shared<LockFreeQueueSnapshot>());
 }
 #endif
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <memory>
@@ -24,6 +25,7 @@
 #include <vector>
 
 #include "common/FeedbackInterface.h"
+#include "queue/LockFreeProcessQueue.h"
 #include "queue/ProcessQueue.h"
 #include "queue/ProcessQueueItem.h"
 
@@ -63,10 +65,28 @@ public:
     static constexpr uint32_t sMaxPriority = 3;
 
 private:
+    // queues used in lock free mode, which are immutable once published
+    struct LockFreeQueueSnapshot {
+        std::unordered_map<QueueKey, std::shared_ptr<LockFreeProcessQueue>> mQueues;
+        std::vector<std::shared_ptr<LockFreeProcessQueue>> mPriorityQueue[sMaxPriority + 1];
+    };
+
     ProcessQueueManager();
     ~ProcessQueueManager() = default;
 
     void ResetCurrentQueueIndex();
+    bool PopExactlyOnceItem(int64_t threadNo,
+                            uint32_t priority,
+                            std::unique_ptr<ProcessQueueItem>& item,
+                            std::string& configName);
+
+    bool CreateOrUpdateLockFreeQueue(QueueKey key, uint32_t priority);
+    bool DeleteLockFreeQueue(QueueKey key);
+    bool PopLockFreeItem(int64_t threadNo, std::unique_ptr<ProcessQueueItem>& item, std::string& configName);
+    std::shared_ptr<LockFreeProcessQueue> FindLockFreeQueue(QueueKey key) const;
+    const LockFreeQueueSnapshot& GetLockFreeSnapshot() const;
+    void ReleaseOutdatedLockFreeSnapshot() const;
+    void PublishLockFreeSnapshot(std::shared_ptr<LockFreeQueueSnapshot>&& snapshot);
 
     mutable std::mutex mQueueMux;
     std::unordered_map<QueueKey, std::list<ProcessQueue>::iterator> mQueues;
@@ -77,6 +97,18 @@ private:
     mutable std::condition_variable mCond;
     bool mValidToPop = false;
 
+    // In lock free mode, queues are looked up in a snapshot cached by each thread, which is replaced (under
+    // mQueueMux) only when queues are created, updated or deleted. Items are pushed and popped without any lock, and
+    // idle threads are only notified when there are any.
+    bool mLockFree = false;
+    std::shared_ptr<const LockFreeQueueSnapshot> mLockFreeSnapshot;
+    std::atomic_uint64_t mLockFreeSnapshotVersion{1};
+    std::atomic_int mWaitingThreadCnt{0};
+    std::atomic_int mPendingTriggerCnt{0};
+    // the snapshot cached by each thread
+    static thread_local uint64_t sLockFreeSnapshotVersion;
+    static thread_local std::shared_ptr<const LockFreeQueueSnapshot> sLockFreeSnapshot;
+
 #ifdef APSARA_UNIT_TEST_MAIN
     void Clear();
     friend class ProcessQueueManagerUnittest;
@@ -228,6 +228,19 @@ void LogFileReader::DumpMetaToMem(bool checkConfigFlag) {
                      "file size", mLastFileSize)("last file position", mLastFilePos)("is file opened",
                                                                                      ToString(mLogFileOp.IsOpen())));
     }
+    // the checkpoint is renewed only if the reader has changed, so that unchanged ones need not be dumped again
+    CheckPointPtr checkPointSharePtr;
+    if (CheckPointManager::Instance()->GetCheckPoint(mDevInode, GetConfigName(), checkPointSharePtr)) {
+        CheckPoint* cpt = checkPointSharePtr.get();
+        if (cpt->mOffset == mLastFilePos && cpt->mSignatureSize == mLastFileSignatureSize
+            && cpt->mSignatureHash == mLastFileSignatureHash && cpt->mLastUpdateTime == mLastEventTime
+            && cpt->mFileOpenFlag == mLogFileOp.IsOpen() && cpt->mContainerStopped == mContainerStopped
+            && cpt->mLastForceRead == mLastForceRead && cpt->mFileName == mHostLogPath
+            && cpt->mRealFileName == mRealLogPath && cpt->mCache == mCache) {
+            cpt->mRefreshTime = time(NULL);
+            return;
+        }
+    }
     CheckPoint* checkPointPtr = new CheckPoint(mHostLogPath,
                                                mLastFilePos,
                                                mLastFileSignatureSize,
@@ -39,6 +39,7 @@ namespace sdk {
                    const string& intf)
         : mAccessKeyId(accessKeyId),
           mAccessKey(accessKey),
+          mAuthorizationPrefix(LOG_HEADSIGNATURE_PREFIX + accessKeyId + ':'),
           mSource(source),
           mTimeout(timeout),
           mUserAgent(LOG_SDK_IDENTIFICATION),
@@ -68,6 +69,7 @@ namespace sdk {
                    const string& intf)
         : mAccessKeyId(accessKeyId),
           mAccessKey(accessKey),
+          mAuthorizationPrefix(LOG_HEADSIGNATURE_PREFIX + accessKeyId + ':'),
           mSecurityToken(securityToken),
           mSource(source),
           mTimeout(timeout),
@@ -118,6 +120,7 @@ namespace sdk {
     void Client::SetAccessKeyId(const string& accessKeyId) {
         mSpinLock.lock();
         mAccessKeyId = accessKeyId;
+        mAuthorizationPrefix = LOG_HEADSIGNATURE_PREFIX + accessKeyId + ':';
         mSpinLock.unlock();
     }
 
@@ -128,6 +131,13 @@ namespace sdk {
         return accessKeyId;
     }
 
+    string Client::GetAuthorizationPrefix() {
+        mSpinLock.lock();
+        string prefix = mAuthorizationPrefix;
+        mSpinLock.unlock();
+        return prefix;
+    }
+
     string Client::GetSlsHost() {
         mSpinLock.lock();
         string slsHost = mSlsHost;
@@ -291,7 +301,7 @@ namespace sdk {
         string host = GetHost(project);
         SetCommonHeader(header, (int32_t)(body.length()), project);
         string signature = GetUrlSignature(httpMethod, url, header, parameterList, body, GetAccessKey());
-        header[AUTHORIZATION] = LOG_HEADSIGNATURE_PREFIX + GetAccessKeyId() + ':' + signature;
+        header[AUTHORIZATION] = GetAuthorizationPrefix() + signature;
 
         string queryString;
         GetQueryString(parameterList, queryString);
@@ -338,7 +348,7 @@ namespace sdk {
         string host = GetHost(project);
         SetCommonHeader(httpHeader, (int32_t)(body.length()), project);
         string signature = GetUrlSignature(HTTP_POST, operation, httpHeader, parameterList, body, GetAccessKey());
-        httpHeader[AUTHORIZATION] = LOG_HEADSIGNATURE_PREFIX + GetAccessKeyId() + ':' + signature;
+        httpHeader[AUTHORIZATION] = GetAuthorizationPrefix() + signature;
 
         string queryString;
         GetQueryString(parameterList, queryString);
@@ -65,6 +65,8 @@ namespace sdk {
         std::string GetAccessKey();
         void SetAccessKeyId(const std::string& accessKeyId);
         std::string GetAccessKeyId();
+        // "LOG <access key id>:", which is cached since it is the same for all requests
+        std::string GetAuthorizationPrefix();
         void SetSlsHost(const std::string& slsHost);
         std::string GetSlsHost();
         std::string GetRawSlsHost();
@@ -190,6 +192,7 @@ namespace sdk {
         std::string mSlsHost;
         std::string mAccessKeyId;
         std::string mAccessKey;
+        std::string mAuthorizationPrefix;
         std::string mSecurityToken;
         std::string mSource;
         int32_t mTimeout;
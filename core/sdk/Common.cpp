@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "Common.h"
+#include "Digest.h"
 #include "app_config/AppConfig.h"
 #include "common/TimeUtil.h"
 #include "common/StringTools.h"
@@ -223,14 +224,14 @@ namespace sdk {
 
     std::string CalcMD5(const std::string& message) {
         uint8_t md5[MD5_BYTES];
-        DoMd5((const uint8_t*)message.data(), message.length(), md5);
+        CalcMD5Digest(message.data(), message.length(), md5);
         return HexToString(md5);
     }
 
     std::string CalcSHA1(const std::string& message, const std::string& key) {
-        HMAC hmac(reinterpret_cast<const uint8_t*>(key.data()), key.size());
-        hmac.add(reinterpret_cast<const uint8_t*>(message.data()), message.size());
-        return string(reinterpret_cast<const char*>(hmac.result()), SHA1_DIGEST_BYTES);
+        uint8_t digest[SHA1_DIGEST_BYTES];
+        CalcHmacSHA1Digest(key, message.data(), message.size(), digest);
+        return string(reinterpret_cast<const char*>(digest), SHA1_DIGEST_BYTES);
     }
 
 
@@ -281,10 +282,9 @@ namespace sdk {
 
 
     std::string Base64Enconde(const std::string& message) {
-        std::istringstream iss(message);
-        std::ostringstream oss;
-        Base64Encoding(iss, oss);
-        return oss.str();
+        std::string res;
+        Base64Encode(message.data(), message.size(), res);
+        return res;
     }
 
 
@@ -397,14 +397,16 @@ namespace sdk {
         string signature;
         string osstream;
         if (!content.empty()) {
-            contentMd5 = CalcMD5(content);
+            // content md5 has usually been set by the caller, which is expensive to calculate again for large body
+            map<string, string>::const_iterator iter = httpHeader.find(CONTENT_MD5);
+            contentMd5 = iter != httpHeader.end() ? iter->second : CalcMD5(content);
         }
         string contentType;
         map<string, string>::iterator iter = httpHeader.find(CONTENT_TYPE);
         if (iter != httpHeader.end()) {
             contentType = iter->second;
         }
-        std::map<string, string> endingMap;
+        osstream.reserve(256);
         osstream.append(httpMethod);
         osstream.append("\n");
         osstream.append(contentMd5);
@@ -413,20 +415,40 @@ namespace sdk {
         osstream.append("\n");
         osstream.append(httpHeader[DATE]);
         osstream.append("\n");
+        bool hasOldHeader = false;
         for (map<string, string>::const_iterator iter = httpHeader.begin(); iter != httpHeader.end(); ++iter) {
             if (StartWith(iter->first, LOG_OLD_HEADER_PREFIX)) {
-                std::string key = iter->first;
-                endingMap.insert(std::make_pair(key.replace(0, std::strlen(LOG_OLD_HEADER_PREFIX), LOG_HEADER_PREFIX),
-                                                iter->second));
-            } else if (StartWith(iter->first, LOG_HEADER_PREFIX) || StartWith(iter->first, ACS_HEADER_PREFIX)) {
-                endingMap.insert(std::make_pair(iter->first, iter->second));
+                hasOldHeader = true;
+                break;
             }
         }
-        for (map<string, string>::const_iterator it = endingMap.begin(); it != endingMap.end(); ++it) {
-            osstream.append(it->first);
-            osstream.append(":");
-            osstream.append(it->second);
-            osstream.append("\n");
+        if (!hasOldHeader) {
+            // headers are already sorted by key, so they can be appended directly
+            for (map<string, string>::const_iterator iter = httpHeader.begin(); iter != httpHeader.end(); ++iter) {
+                if (StartWith(iter->first, LOG_HEADER_PREFIX) || StartWith(iter->first, ACS_HEADER_PREFIX)) {
+                    osstream.append(iter->first);
+                    osstream.append(":");
+                    osstream.append(iter->second);
+                    osstream.append("\n");
+                }
+            }
+        } else {
+            std::map<string, string> endingMap;
+            for (map<string, string>::const_iterator iter = httpHeader.begin(); iter != httpHeader.end(); ++iter) {
+                if (StartWith(iter->first, LOG_OLD_HEADER_PREFIX)) {
+                    std::string key = iter->first;
+                    endingMap.insert(std::make_pair(
+                        key.replace(0, std::strlen(LOG_OLD_HEADER_PREFIX), LOG_HEADER_PREFIX), iter->second));
+                } else if (StartWith(iter->first, LOG_HEADER_PREFIX) || StartWith(iter->first, ACS_HEADER_PREFIX)) {
+                    endingMap.insert(std::make_pair(iter->first, iter->second));
+                }
+            }
+            for (map<string, string>::const_iterator it = endingMap.begin(); it != endingMap.end(); ++it) {
+                osstream.append(it->first);
+                osstream.append(":");
+                osstream.append(it->second);
+                osstream.append("\n");
+            }
         }
         osstream.append(operationType);
         if (parameterList.size() > 0) {
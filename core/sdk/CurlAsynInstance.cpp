@@ -18,10 +18,20 @@
 #include "Result.h"
 #include <curl/curl.h>
 #include <curl/multi.h>
+#include <atomic>
 #include "logger/Logger.h"
 #include "app_config/AppConfig.h"
+#include "common/Flags.h"
 #include "common/TimeUtil.h"
 
+DEFINE_FLAG_INT32(sls_client_event_loop_thread_count,
+                  "number of threads sending asynchronous requests by curl_multi_socket_action with epoll, 0 means "
+                  "the select based loop is used instead",
+                  0);
+DEFINE_FLAG_INT32(sls_client_max_idle_curl_handles_per_endpoint,
+                  "max number of finished curl easy handles kept for reuse by each event loop thread per endpoint",
+                  32);
+
 using namespace std;
 
 namespace logtail {
@@ -42,19 +52,44 @@ namespace sdk {
                           curl_slist*& headers);
 
 
+    static void on_handle_done(CURL* curl, curl_slist* headers, AsynRequest* request, CURLcode res);
+
     CurlAsynInstance::CurlAsynInstance() {
+#if defined(__linux__)
+        if (INT32_FLAG(sls_client_event_loop_thread_count) > 0) {
+            mEventLoopPool.reset(new CurlEventLoopPool(
+                INT32_FLAG(sls_client_event_loop_thread_count),
+                INT32_FLAG(sls_client_max_idle_curl_handles_per_endpoint),
+                [](CURL* curl, AsynRequest* request, CURLcode res) { on_handle_done(curl, NULL, request, res); }));
+            if (mEventLoopPool->Start()) {
+                return;
+            }
+            LOG_ERROR(sLogger, ("failed to start curl event loops", "use select based loop instead"));
+            mEventLoopPool.reset();
+        }
+#endif
         for (int i = 0; i < LOGTAIL_SDK_CURL_THREAD_POOL_SIZE; ++i) {
             mMainThreads.push_back(new boost::thread(boost::bind(&CurlAsynInstance::Run, this)));
         }
     }
 
     CurlAsynInstance::~CurlAsynInstance() {
-        for (int i = 0; i < LOGTAIL_SDK_CURL_THREAD_POOL_SIZE; ++i) {
+        for (size_t i = 0; i < mMainThreads.size(); ++i) {
             mMainThreads[i]->join();
             delete mMainThreads[i];
         }
     }
 
+    void CurlAsynInstance::AddRequest(AsynRequest* request) {
+#if defined(__linux__)
+        if (mEventLoopPool) {
+            mEventLoopPool->AddRequest(request);
+            return;
+        }
+#endif
+        mRequestQueue.push(request);
+    }
+
     static bool AddRequestToMultiHandler(CURLM* multi_handle, AsynRequest* request) {
         curl_slist* headers = NULL;
         CURL* curl = PackCurlRequest(request->mHTTPMethod,
@@ -87,6 +122,7 @@ namespace sdk {
         return true;
     }
 
+    // the easy handle is not cleaned up here, since it may be reused
     static void on_handle_done(CURL* curl, curl_slist* headers, AsynRequest* request, CURLcode res) {
         if (headers != NULL) {
             curl_slist_free_all(headers);
@@ -96,15 +132,12 @@ namespace sdk {
             case CURLE_OK:
                 break;
             case CURLE_OPERATION_TIMEDOUT:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_TIMEOUT, "Request operation timeout.");
                 return;
             case CURLE_COULDNT_CONNECT:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_ERROR, "Can not connect to server.");
                 return;
             default:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse,
                                            LOGE_REQUEST_ERROR,
                                            string("Request operation failed, curl error code : ")
@@ -114,7 +147,6 @@ namespace sdk {
 
         long http_code = 0;
         if ((res = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code)) != CURLE_OK) {
-            curl_easy_cleanup(curl);
             request->mCallBack->OnFail(request->mResponse,
                                        LOGE_UNKNOWN_ERROR,
                                        string("Get curl response code error, curl error code : ")
@@ -122,7 +154,6 @@ namespace sdk {
             return;
         }
         request->mCallBack->mHTTPMessage.statusCode = (int32_t)http_code;
-        curl_easy_cleanup(curl);
         if (!request->mCallBack->mHTTPMessage.IsLogServiceResponse()) {
             request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_ERROR, "Get invalid response");
             return;
@@ -132,7 +163,8 @@ namespace sdk {
 
         // Update every 10000 requests.
         if (AppConfig::GetInstance()->EnableLogTimeAutoAdjust()) {
-            static uint32_t sCount = 0;
+            // requests may be done by multiple event loop threads
+            static std::atomic_uint32_t sCount{0};
             if (sCount++ % 10000 == 0) {
                 time_t serverTime = httpMsg.GetServerTimeFromHeader();
                 if (serverTime > 0) {
@@ -179,6 +211,7 @@ namespace sdk {
                 LOG_DEBUG(sLogger, ("DONE: ", res)(request->mHost + request->mUrl, curl_easy_strerror(res)));
                 curl_multi_remove_handle(multi_handle, easy);
                 on_handle_done(easy, (curl_slist*)request->mPrivateData, request, res);
+                curl_easy_cleanup(easy);
                 delete request;
             }
             msg = curl_multi_info_read(multi_handle, &msgs_left);
@@ -16,6 +16,8 @@
 
 #pragma once
 #include "Common.h"
+#include "CurlEventLoop.h"
+#include <memory>
 #include <queue>
 #include <boost/thread.hpp>
 #include <curl/curl.h>
@@ -82,7 +84,7 @@ namespace sdk {
             }
         };
 
-        void AddRequest(AsynRequest* request) { mRequestQueue.push(request); }
+        void AddRequest(AsynRequest* request);
 
         void Run();
 
@@ -91,6 +93,10 @@ namespace sdk {
     private:
         RequestQueue<AsynRequest*> mRequestQueue;
         std::vector<boost::thread*> mMainThreads;
+#if defined(__linux__)
+        // used instead of the select based loop above if sls_client_event_loop_thread_count is set
+        std::unique_ptr<CurlEventLoopPool> mEventLoopPool;
+#endif
     };
 
 } // namespace sdk
@@ -0,0 +1,399 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CurlEventLoop.h"
+
+#if defined(__linux__)
+
+#include <curl/multi.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+
+#include "Closure.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+namespace sdk {
+
+    void SetCurlRequestOptions(CURL* curl,
+                               const std::string& httpMethod,
+                               const std::string& host,
+                               const int32_t port,
+                               const std::string& url,
+                               const std::string& queryString,
+                               const std::map<std::string, std::string>& header,
+                               const std::string& body,
+                               const int32_t timeout,
+                               HttpMessage& httpMessage,
+                               const std::string& intf,
+                               const bool httpsFlag,
+                               curl_slist*& headers);
+
+    static int64_t GetSteadyTimeInMilliSeconds() {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    CurlEventLoop::CurlEventLoop(CURLSH* share,
+                                 const AsynRequestDoneCallback& callback,
+                                 size_t maxIdleHandlesPerEndpoint)
+        : mShare(share), mCallback(callback), mMaxIdleHandlesPerEndpoint(maxIdleHandlesPerEndpoint) {
+    }
+
+    CurlEventLoop::~CurlEventLoop() {
+        Stop();
+    }
+
+    bool CurlEventLoop::Start() {
+        if (mIsRunning) {
+            return true;
+        }
+        mMulti = curl_multi_init();
+        if (mMulti == NULL) {
+            LOG_ERROR(sLogger, ("failed to init curl multi handle", ""));
+            return false;
+        }
+        mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mEpollFd < 0 || mEventFd < 0) {
+            LOG_ERROR(sLogger, ("failed to create epoll or eventfd", "")("errno", errno));
+            Stop();
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = mEventFd;
+        if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mEventFd, &ev) != 0) {
+            LOG_ERROR(sLogger, ("failed to add eventfd to epoll", "")("errno", errno));
+            Stop();
+            return false;
+        }
+        curl_multi_setopt(mMulti, CURLMOPT_SOCKETFUNCTION, SocketCallback);
+        curl_multi_setopt(mMulti, CURLMOPT_SOCKETDATA, this);
+        curl_multi_setopt(mMulti, CURLMOPT_TIMERFUNCTION, TimerCallback);
+        curl_multi_setopt(mMulti, CURLMOPT_TIMERDATA, this);
+
+        mIsRunning = true;
+        mThread = thread([this]() { Run(); });
+        return true;
+    }
+
+    void CurlEventLoop::Stop() {
+        if (mIsRunning) {
+            mIsRunning = false;
+            uint64_t one = 1;
+            if (write(mEventFd, &one, sizeof(one)) < 0) {
+                LOG_WARNING(sLogger, ("failed to wake up curl event loop", "")("errno", errno));
+            }
+            if (mThread.joinable()) {
+                mThread.join();
+            }
+        }
+        for (auto& item : mIdleHandles) {
+            for (CURL* curl : item.second) {
+                curl_easy_cleanup(curl);
+            }
+        }
+        mIdleHandles.clear();
+        if (mMulti != NULL) {
+            curl_multi_cleanup(mMulti);
+            mMulti = NULL;
+        }
+        if (mEventFd >= 0) {
+            close(mEventFd);
+            mEventFd = -1;
+        }
+        if (mEpollFd >= 0) {
+            close(mEpollFd);
+            mEpollFd = -1;
+        }
+    }
+
+    void CurlEventLoop::AddRequest(AsynRequest* request) {
+        ++mRunningRequestCnt;
+        {
+            lock_guard<mutex> lock(mPendingRequestsMux);
+            mPendingRequests.push_back(request);
+            // the loop has been notified already if there are other pending requests
+            if (mPendingRequests.size() > 1) {
+                return;
+            }
+        }
+        uint64_t one = 1;
+        if (write(mEventFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG_WARNING(sLogger, ("failed to wake up curl event loop", "")("errno", errno));
+        }
+    }
+
+    void CurlEventLoop::Run() {
+        static const int sMaxEventCnt = 256;
+        epoll_event events[sMaxEventCnt];
+        while (mIsRunning) {
+            int waitMs = 1000;
+            if (mTimerDeadline >= 0) {
+                int64_t remaining = mTimerDeadline - GetSteadyTimeInMilliSeconds();
+                waitMs = static_cast<int>(max<int64_t>(0, min<int64_t>(remaining, waitMs)));
+            }
+            int cnt = epoll_wait(mEpollFd, events, sMaxEventCnt, waitMs);
+            if (cnt < 0 && errno != EINTR) {
+                LOG_ERROR(sLogger, ("curl event loop epoll_wait failed", "")("errno", errno));
+            }
+            for (int i = 0; i < cnt; ++i) {
+                if (events[i].data.fd == mEventFd) {
+                    uint64_t value = 0;
+                    while (read(mEventFd, &value, sizeof(value)) > 0) {
+                    }
+                    AddPendingRequests();
+                    continue;
+                }
+                int mask = 0;
+                if (events[i].events & EPOLLIN) {
+                    mask |= CURL_CSELECT_IN;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    mask |= CURL_CSELECT_OUT;
+                }
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    mask |= CURL_CSELECT_ERR;
+                }
+                SocketAction(events[i].data.fd, mask);
+            }
+            if (mTimerDeadline >= 0 && GetSteadyTimeInMilliSeconds() >= mTimerDeadline) {
+                // the timer may be set again during the action
+                mTimerDeadline = -1;
+                SocketAction(CURL_SOCKET_TIMEOUT, 0);
+            }
+            CheckMultiInfo();
+        }
+    }
+
+    void CurlEventLoop::AddPendingRequests() {
+        deque<AsynRequest*> requests;
+        {
+            lock_guard<mutex> lock(mPendingRequestsMux);
+            requests.swap(mPendingRequests);
+        }
+        for (AsynRequest* request : requests) {
+            string endpoint = GetEndpoint(request);
+            CURL* curl = AcquireHandle(endpoint);
+            if (curl == NULL) {
+                request->mCallBack->OnFail(request->mResponse, LOGE_UNKNOWN_ERROR, "Init curl fail.");
+                delete request;
+                --mRunningRequestCnt;
+                continue;
+            }
+            curl_slist* headers = NULL;
+            SetCurlRequestOptions(curl,
+                                  request->mHTTPMethod,
+                                  request->mHost,
+                                  request->mPort,
+                                  request->mUrl,
+                                  request->mQueryString,
+                                  request->mHeader,
+                                  request->mBody,
+                                  request->mTimeout,
+                                  request->mCallBack->mHTTPMessage,
+                                  request->mInterface,
+                                  request->mHTTPSFlag,
+                                  headers);
+            request->mPrivateData = headers;
+            curl_easy_setopt(curl, CURLOPT_PRIVATE, request);
+            auto addRst = curl_multi_add_handle(mMulti, curl);
+            if (addRst != CURLM_OK) {
+                request->mCallBack->OnFail(
+                    request->mResponse, LOGE_UNKNOWN_ERROR, "curl_multi_add_handle failed: " + std::to_string(addRst));
+                if (headers != NULL) {
+                    curl_slist_free_all(headers);
+                }
+                curl_easy_cleanup(curl);
+                delete request;
+                --mRunningRequestCnt;
+            }
+        }
+    }
+
+    void CurlEventLoop::SocketAction(curl_socket_t s, int mask) {
+        int runningHandles = 0;
+        CURLMcode res = curl_multi_socket_action(mMulti, s, mask, &runningHandles);
+        if (res != CURLM_OK) {
+            LOG_WARNING(sLogger, ("curl_multi_socket_action failed", curl_multi_strerror(res)));
+        }
+    }
+
+    void CurlEventLoop::CheckMultiInfo() {
+        int msgsLeft = 0;
+        CURLMsg* msg = NULL;
+        while ((msg = curl_multi_info_read(mMulti, &msgsLeft)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* curl = msg->easy_handle;
+            CURLcode res = msg->data.result;
+            AsynRequest* request = NULL;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &request);
+            LOG_DEBUG(sLogger, ("DONE: ", res)(request->mHost + request->mUrl, curl_easy_strerror(res)));
+            curl_multi_remove_handle(mMulti, curl);
+            mCallback(curl, request, res);
+            if (request->mPrivateData != NULL) {
+                curl_slist_free_all(static_cast<curl_slist*>(request->mPrivateData));
+            }
+            ReleaseHandle(GetEndpoint(request), curl);
+            delete request;
+            --mRunningRequestCnt;
+        }
+    }
+
+    CURL* CurlEventLoop::AcquireHandle(const string& endpoint) {
+        CURL* curl = NULL;
+        auto iter = mIdleHandles.find(endpoint);
+        if (iter != mIdleHandles.end() && !iter->second.empty()) {
+            curl = iter->second.back();
+            iter->second.pop_back();
+            // options are cleared, while dns cache and tls sessions are kept
+            curl_easy_reset(curl);
+        } else {
+            curl = curl_easy_init();
+            if (curl == NULL) {
+                return NULL;
+            }
+        }
+        if (mShare != NULL) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, mShare);
+        }
+        return curl;
+    }
+
+    void CurlEventLoop::ReleaseHandle(const string& endpoint, CURL* curl) {
+        auto& handles = mIdleHandles[endpoint];
+        if (handles.size() >= mMaxIdleHandlesPerEndpoint) {
+            curl_easy_cleanup(curl);
+            return;
+        }
+        handles.push_back(curl);
+    }
+
+    int CurlEventLoop::SocketCallback(CURL* curl, curl_socket_t s, int what, void* userp, void* socketp) {
+        CurlEventLoop* loop = static_cast<CurlEventLoop*>(userp);
+        if (what == CURL_POLL_REMOVE) {
+            // the socket may have been closed already
+            epoll_ctl(loop->mEpollFd, EPOLL_CTL_DEL, s, NULL);
+            curl_multi_assign(loop->mMulti, s, NULL);
+            return 0;
+        }
+        epoll_event ev{};
+        ev.data.fd = s;
+        if (what & CURL_POLL_IN) {
+            ev.events |= EPOLLIN;
+        }
+        if (what & CURL_POLL_OUT) {
+            ev.events |= EPOLLOUT;
+        }
+        if (socketp == NULL) {
+            if (epoll_ctl(loop->mEpollFd, EPOLL_CTL_ADD, s, &ev) != 0 && errno == EEXIST) {
+                epoll_ctl(loop->mEpollFd, EPOLL_CTL_MOD, s, &ev);
+            }
+            // mark the socket as registered
+            curl_multi_assign(loop->mMulti, s, loop);
+        } else if (epoll_ctl(loop->mEpollFd, EPOLL_CTL_MOD, s, &ev) != 0) {
+            LOG_WARNING(sLogger, ("failed to modify socket in epoll", s)("errno", errno));
+        }
+        return 0;
+    }
+
+    int CurlEventLoop::TimerCallback(CURLM* multi, long timeoutMs, void* userp) {
+        CurlEventLoop* loop = static_cast<CurlEventLoop*>(userp);
+        loop->mTimerDeadline = timeoutMs < 0 ? -1 : GetSteadyTimeInMilliSeconds() + timeoutMs;
+        return 0;
+    }
+
+    string CurlEventLoop::GetEndpoint(const AsynRequest* request) {
+        string endpoint = request->mHTTPSFlag ? "https://" : "http://";
+        endpoint.append(request->mHost).append(":").append(to_string(request->mPort));
+        if (!request->mInterface.empty()) {
+            endpoint.append("@").append(request->mInterface);
+        }
+        return endpoint;
+    }
+
+    CurlEventLoopPool::CurlEventLoopPool(size_t loopCnt,
+                                         size_t maxIdleHandlesPerEndpoint,
+                                         const AsynRequestDoneCallback& callback) {
+        mShare = curl_share_init();
+        if (mShare != NULL) {
+            curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(mShare, CURLSHOPT_LOCKFUNC, LockShare);
+            curl_share_setopt(mShare, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+            curl_share_setopt(mShare, CURLSHOPT_USERDATA, this);
+        } else {
+            LOG_WARNING(sLogger, ("failed to init curl share handle", "dns cache and tls sessions are not shared"));
+        }
+        for (size_t i = 0; i < loopCnt; ++i) {
+            mLoops.emplace_back(new CurlEventLoop(mShare, callback, maxIdleHandlesPerEndpoint));
+        }
+    }
+
+    CurlEventLoopPool::~CurlEventLoopPool() {
+        Stop();
+        mLoops.clear();
+        if (mShare != NULL) {
+            curl_share_cleanup(mShare);
+        }
+    }
+
+    bool CurlEventLoopPool::Start() {
+        for (auto& loop : mLoops) {
+            if (!loop->Start()) {
+                return false;
+            }
+        }
+        LOG_INFO(sLogger, ("curl event loops", "started")("loop count", mLoops.size()));
+        return true;
+    }
+
+    void CurlEventLoopPool::Stop() {
+        for (auto& loop : mLoops) {
+            loop->Stop();
+        }
+    }
+
+    void CurlEventLoopPool::AddRequest(AsynRequest* request) {
+        mLoops[mNextLoop++ % mLoops.size()]->AddRequest(request);
+    }
+
+    size_t CurlEventLoopPool::GetRunningRequestCnt() const {
+        size_t cnt = 0;
+        for (const auto& loop : mLoops) {
+            cnt += loop->GetRunningRequestCnt();
+        }
+        return cnt;
+    }
+
+    void CurlEventLoopPool::LockShare(CURL* curl, curl_lock_data data, curl_lock_access access, void* userp) {
+        static_cast<CurlEventLoopPool*>(userp)->mShareMux[data].lock();
+    }
+
+    void CurlEventLoopPool::UnlockShare(CURL* curl, curl_lock_data data, void* userp) {
+        static_cast<CurlEventLoopPool*>(userp)->mShareMux[data].unlock();
+    }
+
+} // namespace sdk
+} // namespace logtail
+
+#endif
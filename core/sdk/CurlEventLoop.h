@@ -0,0 +1,124 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+
+namespace logtail {
+namespace sdk {
+
+    // Called in the event loop thread once the request is finished, before the easy handle is recycled.
+    using AsynRequestDoneCallback = std::function<void(CURL* curl, AsynRequest* request, CURLcode res)>;
+
+    // A thread driving asynchronous requests by curl_multi_socket_action with epoll, so that the number of requests in
+    // flight is not limited by select(). Finished easy handles are kept per endpoint and reused by later requests to
+    // the same endpoint, while connections are kept alive in the multi handle.
+    class CurlEventLoop {
+    public:
+        CurlEventLoop(CURLSH* share, const AsynRequestDoneCallback& callback, size_t maxIdleHandlesPerEndpoint);
+        ~CurlEventLoop();
+
+        CurlEventLoop(const CurlEventLoop&) = delete;
+        CurlEventLoop& operator=(const CurlEventLoop&) = delete;
+
+        bool Start();
+        // requests in flight are abandoned without callback, so it should only be called when all requests are done
+        void Stop();
+
+        void AddRequest(AsynRequest* request);
+
+        size_t GetRunningRequestCnt() const { return mRunningRequestCnt; }
+
+    private:
+        static int SocketCallback(CURL* curl, curl_socket_t s, int what, void* userp, void* socketp);
+        static int TimerCallback(CURLM* multi, long timeoutMs, void* userp);
+        static std::string GetEndpoint(const AsynRequest* request);
+
+        void Run();
+        void AddPendingRequests();
+        void SocketAction(curl_socket_t s, int mask);
+        void CheckMultiInfo();
+        CURL* AcquireHandle(const std::string& endpoint);
+        void ReleaseHandle(const std::string& endpoint, CURL* curl);
+
+        CURLSH* mShare = nullptr;
+        AsynRequestDoneCallback mCallback;
+        size_t mMaxIdleHandlesPerEndpoint = 0;
+
+        CURLM* mMulti = nullptr;
+        int mEpollFd = -1;
+        int mEventFd = -1;
+        // steady clock time in ms when curl wants to be called for timeout, -1 if no timer is set
+        int64_t mTimerDeadline = -1;
+
+        std::mutex mPendingRequestsMux;
+        std::deque<AsynRequest*> mPendingRequests;
+
+        std::unordered_map<std::string, std::vector<CURL*>> mIdleHandles;
+        std::atomic_size_t mRunningRequestCnt{0};
+
+        std::thread mThread;
+        std::atomic_bool mIsRunning{false};
+    };
+
+    // Requests are distributed to the event loops round robin. Dns cache and tls sessions are shared among all loops
+    // by a curl share handle, while connections are pooled by each loop, since sharing connection cache among threads
+    // is not supported by libcurl.
+    class CurlEventLoopPool {
+    public:
+        CurlEventLoopPool(size_t loopCnt, size_t maxIdleHandlesPerEndpoint, const AsynRequestDoneCallback& callback);
+        ~CurlEventLoopPool();
+
+        CurlEventLoopPool(const CurlEventLoopPool&) = delete;
+        CurlEventLoopPool& operator=(const CurlEventLoopPool&) = delete;
+
+        bool Start();
+        void Stop();
+
+        void AddRequest(AsynRequest* request);
+
+        size_t GetRunningRequestCnt() const;
+
+    private:
+        static void LockShare(CURL* curl, curl_lock_data data, curl_lock_access access, void* userp);
+        static void UnlockShare(CURL* curl, curl_lock_data data, void* userp);
+
+        CURLSH* mShare = nullptr;
+        std::mutex mShareMux[CURL_LOCK_DATA_LAST];
+        std::vector<std::unique_ptr<CurlEventLoop>> mLoops;
+        std::atomic_size_t mNextLoop{0};
+    };
+
+} // namespace sdk
+} // namespace logtail
+
+#endif
@@ -73,24 +73,21 @@ namespace sdk {
         return sizes;
     }
 
-    CURL* PackCurlRequest(const std::string& httpMethod,
-                          const std::string& host,
-                          const int32_t port,
-                          const std::string& url,
-                          const std::string& queryString,
-                          const std::map<std::string, std::string>& header,
-                          const std::string& body,
-                          const int32_t timeout,
-                          HttpMessage& httpMessage,
-                          const std::string& intf,
-                          const bool httpsFlag,
-                          curl_slist*& headers) {
+    void SetCurlRequestOptions(CURL* curl,
+                               const std::string& httpMethod,
+                               const std::string& host,
+                               const int32_t port,
+                               const std::string& url,
+                               const std::string& queryString,
+                               const std::map<std::string, std::string>& header,
+                               const std::string& body,
+                               const int32_t timeout,
+                               HttpMessage& httpMessage,
+                               const std::string& intf,
+                               const bool httpsFlag,
+                               curl_slist*& headers) {
         static DnsCache* dnsCache = DnsCache::GetInstance();
 
-        CURL* curl = curl_easy_init();
-        if (curl == NULL)
-            return NULL;
-
         string totalUrl = httpsFlag ? "https://" : "http://";
         std::string hostIP;
         if (AppConfig::GetInstance()->IsHostIPReplacePolicyEnabled() && dnsCache->GetIPFromDnsCache(host, hostIP)) {
@@ -134,6 +131,26 @@ namespace sdk {
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, data_write_callback);
         curl_easy_setopt(curl, CURLOPT_HEADERDATA, &(httpMessage.header));
         curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_write_callback);
+    }
+
+    CURL* PackCurlRequest(const std::string& httpMethod,
+                          const std::string& host,
+                          const int32_t port,
+                          const std::string& url,
+                          const std::string& queryString,
+                          const std::map<std::string, std::string>& header,
+                          const std::string& body,
+                          const int32_t timeout,
+                          HttpMessage& httpMessage,
+                          const std::string& intf,
+                          const bool httpsFlag,
+                          curl_slist*& headers) {
+        CURL* curl = curl_easy_init();
+        if (curl == NULL)
+            return NULL;
+
+        SetCurlRequestOptions(
+            curl, httpMethod, host, port, url, queryString, header, body, timeout, httpMessage, intf, httpsFlag, headers);
         return curl;
     }
 
@@ -0,0 +1,149 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Digest.h"
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+namespace sdk {
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    // algorithms are fetched once, otherwise they are fetched implicitly on each call
+    static const EVP_MD* GetMD5() {
+        static EVP_MD* sMD = EVP_MD_fetch(nullptr, "MD5", nullptr);
+        return sMD;
+    }
+
+    static const EVP_MD* GetSHA1() {
+        static EVP_MD* sMD = EVP_MD_fetch(nullptr, "SHA1", nullptr);
+        return sMD;
+    }
+#else
+    static const EVP_MD* GetMD5() {
+        return EVP_md5();
+    }
+
+    static const EVP_MD* GetSHA1() {
+        return EVP_sha1();
+    }
+#endif
+
+    static bool OpenSSLMD5(const char* data, size_t size, uint8_t md5[MD5_BYTES]) {
+        const EVP_MD* md = GetMD5();
+        unsigned int len = 0;
+        return md != nullptr && EVP_Digest(data, size, md5, &len, md, nullptr) == 1 && len == MD5_BYTES;
+    }
+
+    static bool OpenSSLHmacSHA1(const string& key, const char* data, size_t size, uint8_t digest[SHA1_DIGEST_BYTES]) {
+        const EVP_MD* md = GetSHA1();
+        if (md == nullptr) {
+            return false;
+        }
+        unsigned int len = 0;
+        // the one from openssl, not sdk::HMAC
+        const unsigned char* res = ::HMAC(md,
+                                          key.data(),
+                                          static_cast<int>(key.size()),
+                                          reinterpret_cast<const unsigned char*>(data),
+                                          size,
+                                          digest,
+                                          &len);
+        return res != nullptr && len == SHA1_DIGEST_BYTES;
+    }
+
+    static DigestBackend DetectDigestBackend() {
+        // test vectors from RFC 1321 and RFC 2202
+        static const uint8_t kMD5[MD5_BYTES] = {
+            0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0, 0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72};
+        static const uint8_t kHmacSHA1[SHA1_DIGEST_BYTES] = {0xef, 0xfc, 0xdf, 0x6a, 0xe5, 0xeb, 0x2f,
+                                                              0xa2, 0xd2, 0x74, 0x16, 0xd5, 0xf1, 0x84,
+                                                              0xdf, 0x9c, 0x25, 0x9a, 0x7c, 0x79};
+        uint8_t md5[MD5_BYTES];
+        uint8_t sha1[SHA1_DIGEST_BYTES];
+        if (OpenSSLMD5("abc", 3, md5) && memcmp(md5, kMD5, MD5_BYTES) == 0
+            && OpenSSLHmacSHA1("Jefe", "what do ya want for nothing?", 28, sha1)
+            && memcmp(sha1, kHmacSHA1, SHA1_DIGEST_BYTES) == 0) {
+            LOG_INFO(sLogger, ("digest backend", "openssl"));
+            return DigestBackend::OPENSSL;
+        }
+        LOG_WARNING(sLogger, ("digest backend", "builtin")("reason", "openssl digest is not available"));
+        return DigestBackend::BUILTIN;
+    }
+
+    static DigestBackend& Backend() {
+        static DigestBackend sBackend = DetectDigestBackend();
+        return sBackend;
+    }
+
+    DigestBackend GetDigestBackend() {
+        return Backend();
+    }
+
+    void SetDigestBackend(DigestBackend backend) {
+        Backend() = backend;
+    }
+
+    void CalcMD5Digest(const char* data, size_t size, uint8_t md5[MD5_BYTES]) {
+        if (Backend() == DigestBackend::OPENSSL && OpenSSLMD5(data, size, md5)) {
+            return;
+        }
+        DoMd5(reinterpret_cast<const uint8_t*>(data), size, md5);
+    }
+
+    void CalcHmacSHA1Digest(const string& key, const char* data, size_t size, uint8_t digest[SHA1_DIGEST_BYTES]) {
+        if (Backend() == DigestBackend::OPENSSL && OpenSSLHmacSHA1(key, data, size, digest)) {
+            return;
+        }
+        HMAC hmac(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+        hmac.add(reinterpret_cast<const uint8_t*>(data), size);
+        memcpy(digest, hmac.result(), SHA1_DIGEST_BYTES);
+    }
+
+    void Base64Encode(const char* data, size_t size, string& out) {
+        static const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+        size_t pos = out.size();
+        out.resize(pos + (size + 2) / 3 * 4);
+        char* dst = &out[pos];
+        size_t i = 0;
+        for (; i + 3 <= size; i += 3) {
+            uint32_t v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+            *dst++ = kAlphabet[v >> 18];
+            *dst++ = kAlphabet[(v >> 12) & 0x3F];
+            *dst++ = kAlphabet[(v >> 6) & 0x3F];
+            *dst++ = kAlphabet[v & 0x3F];
+        }
+        if (i + 1 == size) {
+            uint32_t v = in[i] << 16;
+            *dst++ = kAlphabet[v >> 18];
+            *dst++ = kAlphabet[(v >> 12) & 0x3F];
+            *dst++ = '=';
+            *dst++ = '=';
+        } else if (i + 2 == size) {
+            uint32_t v = (in[i] << 16) | (in[i + 1] << 8);
+            *dst++ = kAlphabet[v >> 18];
+            *dst++ = kAlphabet[(v >> 12) & 0x3F];
+            *dst++ = kAlphabet[(v >> 6) & 0x3F];
+            *dst++ = '=';
+        }
+    }
+
+} // namespace sdk
+} // namespace logtail
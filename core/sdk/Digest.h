@@ -0,0 +1,44 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Common.h"
+
+namespace logtail {
+namespace sdk {
+
+    enum class DigestBackend { BUILTIN, OPENSSL };
+
+    // The backend is chosen once on first use. OpenSSL is preferred, since it picks the fastest instructions available
+    // on the cpu at runtime, e.g. SHA extensions. The builtin implementation is used instead if OpenSSL does not work
+    // as expected, e.g. md5 is disabled in FIPS mode.
+    DigestBackend GetDigestBackend();
+    // for test and benchmark only, not thread-safe with digest calculation
+    void SetDigestBackend(DigestBackend backend);
+
+    void CalcMD5Digest(const char* data, size_t size, uint8_t md5[MD5_BYTES]);
+    void CalcHmacSHA1Digest(const std::string& key, const char* data, size_t size, uint8_t digest[SHA1_DIGEST_BYTES]);
+
+    // result is appended to out
+    void Base64Encode(const char* data, size_t size, std::string& out);
+
+} // namespace sdk
+} // namespace logtail
@@ -0,0 +1,181 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sender/BufferFileSpool.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(_MSC_VER)
+#include <io.h>
+#endif
+
+#include <cerrno>
+
+#include "common/FileSystemUtil.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kReadBufferSize = 1024 * 1024;
+
+bool BufferFileWriter::Open(const string& fileName, const string& header, int64_t preallocateSize) {
+    Close();
+    mFile = FileAppendOpen(fileName.c_str(), "ab");
+    if (!mFile) {
+        return false;
+    }
+    // records are batched by the writer itself
+    setvbuf(mFile, nullptr, _IONBF, 0);
+    fseek(mFile, 0, SEEK_END);
+    mCommittedSize = ftell(mFile);
+    mFileName = fileName;
+    if (mCommittedSize == 0) {
+        Append(header.data(), header.size());
+        if (!Commit(false)) {
+            int err = errno;
+            Close();
+            errno = err;
+            return false;
+        }
+    }
+#if defined(__linux__)
+    if (preallocateSize > mCommittedSize) {
+        // failure is ignored, since the file system may not support it
+        mPreallocated
+            = fallocate(fileno(mFile), FALLOC_FL_KEEP_SIZE, mCommittedSize, preallocateSize - mCommittedSize) == 0;
+    }
+#endif
+    return true;
+}
+
+void BufferFileWriter::Close() {
+    if (!mFile) {
+        return;
+    }
+#if defined(__linux__)
+    if (mPreallocated && ftruncate(fileno(mFile), mCommittedSize) != 0) {
+        // the space reserved but not used is released when the file is removed after replay
+        LOG_WARNING(sLogger, ("failed to release preallocated buffer file space", mFileName)("errno", errno));
+    }
+#endif
+    fclose(mFile);
+    mFile = nullptr;
+    mFileName.clear();
+    mPendingData.clear();
+    mCommittedSize = 0;
+    mPreallocated = false;
+}
+
+bool BufferFileWriter::Commit(bool sync) {
+    if (mPendingData.empty()) {
+        return true;
+    }
+    size_t size = mPendingData.size();
+    size_t nbytes = fwrite(mPendingData.data(), 1, size, mFile);
+    // the buffer is cleared without releasing memory, so that it can be reused by the next batch
+    mPendingData.clear();
+    if (nbytes != size) {
+#if defined(__linux__)
+        int err = errno;
+        if (ftruncate(fileno(mFile), mCommittedSize) != 0) {
+            // the torn record is left in the file, and will be reported as invalid on replay
+            LOG_ERROR(sLogger,
+                      ("failed to truncate torn record in buffer file", mFileName)("errno", errno)("write errno", err));
+        }
+        errno = err;
+#endif
+        return false;
+    }
+    mCommittedSize += nbytes;
+    if (sync) {
+#if defined(__linux__)
+        return fdatasync(fileno(mFile)) == 0;
+#elif defined(_MSC_VER)
+        return _commit(_fileno(mFile)) == 0;
+#endif
+    }
+    return true;
+}
+
+bool BufferFileReader::Open(const string& fileName) {
+    Close();
+    mFile = FileReadOnlyOpen(fileName.c_str(), "rb");
+    if (!mFile) {
+        return false;
+    }
+    mReadBuffer.resize(kReadBufferSize);
+    setvbuf(mFile, mReadBuffer.data(), _IOFBF, mReadBuffer.size());
+    fseek(mFile, 0, SEEK_END);
+    mFileSize = ftell(mFile);
+    fseek(mFile, 0, SEEK_SET);
+    mReadPos = 0;
+    mFileName = fileName;
+    return true;
+}
+
+void BufferFileReader::Close() {
+    if (mFile) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+#if defined(__linux__)
+    if (mWriteFd >= 0) {
+        close(mWriteFd);
+        mWriteFd = -1;
+    }
+#elif defined(_MSC_VER)
+    if (mWriteFile) {
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+    }
+#endif
+    mFileName.clear();
+    mFileSize = 0;
+    mReadPos = 0;
+}
+
+size_t BufferFileReader::Read(int64_t pos, void* buf, size_t size) {
+    if (pos != mReadPos) {
+        // seeking within the buffer does not cause any read, which is the case when handled records are skipped
+        if (fseek(mFile, pos, SEEK_SET) != 0) {
+            return 0;
+        }
+        mReadPos = pos;
+    }
+    size_t nbytes = fread(buf, 1, size, mFile);
+    mReadPos += nbytes;
+    return nbytes;
+}
+
+bool BufferFileReader::Write(int64_t pos, const void* buf, size_t size) {
+#if defined(__linux__)
+    if (mWriteFd < 0 && (mWriteFd = open(mFileName.c_str(), O_WRONLY)) < 0) {
+        return false;
+    }
+    return pwrite(mWriteFd, buf, size, pos) == static_cast<ssize_t>(size);
+#elif defined(_MSC_VER)
+    if (!mWriteFile && (mWriteFile = FileWriteOnlyOpen(mFileName.c_str(), "wb")) == nullptr) {
+        return false;
+    }
+    if (fseek(mWriteFile, pos, SEEK_SET) != 0 || fwrite(buf, 1, size, mWriteFile) != size) {
+        return false;
+    }
+    return fflush(mWriteFile) == 0;
+#endif
+}
+
+} // namespace logtail
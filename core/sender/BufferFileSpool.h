@@ -0,0 +1,94 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace logtail {
+
+// Appender of a buffer file segment, which is kept open until the segment is divided. Records appended are kept in
+// memory and written to the file together on commit, so that a batch of records costs one write and at most one sync.
+// Not thread-safe.
+class BufferFileWriter {
+public:
+    BufferFileWriter() = default;
+    ~BufferFileWriter() { Close(); }
+
+    BufferFileWriter(const BufferFileWriter&) = delete;
+    BufferFileWriter& operator=(const BufferFileWriter&) = delete;
+
+    // header is written if the file is empty. If preallocateSize is positive, disk space is reserved for the segment
+    // without changing the file size, so that readers still take the file size as the end of records.
+    bool Open(const std::string& fileName, const std::string& header, int64_t preallocateSize);
+    // uncommitted records are discarded
+    void Close();
+    bool IsOpen() const { return mFile != nullptr; }
+    const std::string& GetFileName() const { return mFileName; }
+
+    void Append(const void* data, size_t size) { mPendingData.append(static_cast<const char*>(data), size); }
+    bool Commit(bool sync);
+
+    // size of the file including uncommitted records
+    int64_t GetSize() const { return mCommittedSize + static_cast<int64_t>(mPendingData.size()); }
+    size_t GetPendingSize() const { return mPendingData.size(); }
+
+private:
+    FILE* mFile = nullptr;
+    std::string mFileName;
+    std::string mPendingData;
+    int64_t mCommittedSize = 0;
+    bool mPreallocated = false;
+};
+
+// Reader of a buffer file segment, which reads records sequentially through a large buffer and keeps the file open
+// for writing back record states in place. Not thread-safe.
+class BufferFileReader {
+public:
+    BufferFileReader() = default;
+    ~BufferFileReader() { Close(); }
+
+    BufferFileReader(const BufferFileReader&) = delete;
+    BufferFileReader& operator=(const BufferFileReader&) = delete;
+
+    bool Open(const std::string& fileName);
+    void Close();
+    const std::string& GetFileName() const { return mFileName; }
+    // size when the file is opened, since the segment is not appended any more once it is ready for read
+    int64_t GetFileSize() const { return mFileSize; }
+
+    // return the number of bytes read; the file is seeked only if pos is not where the last read ends
+    size_t Read(int64_t pos, void* buf, size_t size);
+    bool Write(int64_t pos, const void* buf, size_t size);
+
+private:
+    FILE* mFile = nullptr;
+    // states are written without buffer, since each of them should be persisted once the record is handled
+#if defined(__linux__)
+    int mWriteFd = -1;
+#elif defined(_MSC_VER)
+    FILE* mWriteFile = nullptr;
+#endif
+    std::string mFileName;
+    std::vector<char> mReadBuffer;
+    int64_t mFileSize = 0;
+    int64_t mReadPos = 0;
+};
+
+} // namespace logtail
@@ -0,0 +1,49 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sender/SendConcurrencyGate.h"
+
+#include <chrono>
+
+using namespace std;
+
+namespace logtail {
+
+void SendConcurrencyGate::Sub() {
+    {
+        // the lock prevents the wakeup from being lost between the check and the wait in WaitForSlot
+        lock_guard<mutex> lock(mMux);
+        --mCount;
+    }
+    mCond.notify_one();
+}
+
+void SendConcurrencyGate::Set(int32_t count) {
+    {
+        lock_guard<mutex> lock(mMux);
+        mCount = count;
+    }
+    mCond.notify_all();
+}
+
+bool SendConcurrencyGate::WaitForSlot(int32_t limit, int32_t timeoutMs) {
+    if (mCount < limit) {
+        return true;
+    }
+    unique_lock<mutex> lock(mMux);
+    return mCond.wait_for(lock, chrono::milliseconds(timeoutMs), [&]() { return mCount < limit; });
+}
+
+} // namespace logtail
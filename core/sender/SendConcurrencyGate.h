@@ -0,0 +1,48 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace logtail {
+
+// Counter of requests in flight, which lets the sender thread sleep until a request is done instead of polling the
+// counter periodically.
+class SendConcurrencyGate {
+public:
+    SendConcurrencyGate() = default;
+    SendConcurrencyGate(const SendConcurrencyGate&) = delete;
+    SendConcurrencyGate& operator=(const SendConcurrencyGate&) = delete;
+
+    void Add() { ++mCount; }
+    void Sub();
+    void Set(int32_t count);
+    int32_t Get() const { return mCount.load(); }
+
+    // return true if the count is less than the limit before timeout
+    bool WaitForSlot(int32_t limit, int32_t timeoutMs);
+
+private:
+    std::atomic_int mCount{0};
+    std::mutex mMux;
+    std::condition_variable mCond;
+};
+
+} // namespace logtail
@@ -63,6 +63,11 @@ DEFINE_FLAG_INT32(secondary_buffer_count_limit, "data ready for write buffer fil
 DEFINE_FLAG_BOOL(enable_mock_send, "if enable mock send in ut", false);
 DEFINE_FLAG_INT32(buffer_file_alive_interval, "the max alive time of a bufferfile, 5 minutes", 300);
 DEFINE_FLAG_INT32(write_secondary_wait_timeout, "interval of dump seconary buffer from memory to file, seconds", 2);
+DEFINE_FLAG_INT32(buffer_file_group_commit_size,
+                  "max bytes of records written to buffer file at a time",
+                  4 * 1024 * 1024);
+DEFINE_FLAG_BOOL(buffer_file_sync, "sync buffer file to disk each time records are written", false);
+DEFINE_FLAG_BOOL(buffer_file_preallocate, "reserve disk space of local file size for a new buffer file", true);
 DEFINE_FLAG_BOOL(e2e_send_throughput_test, "dump file for e2e throughpt test", false);
 DEFINE_FLAG_INT32(send_client_timeout_interval, "recycle clients avoid memory increment", 12 * 3600);
 DEFINE_FLAG_INT32(check_send_client_timeout_interval, "", 600);
@@ -106,6 +111,7 @@ DEFINE_FLAG_INT32(log_expire_time, "log expire time", 24 * 3600);
 DECLARE_FLAG_STRING(default_access_key_id);
 DECLARE_FLAG_STRING(default_access_key);
 DECLARE_FLAG_INT32(max_send_log_group_size);
+DECLARE_FLAG_BOOL(enable_adaptive_send_concurrency);
 
 namespace logtail {
 const string Sender::BUFFER_FILE_NAME_PREFIX = "logtail_buffer_file_";
@@ -149,6 +155,7 @@ void SendClosure::OnSuccess(sdk::Response* response) {
     }
 
     Sender::Instance()->IncreaseRegionConcurrency(mDataPtr->mRegion);
+    Sender::Instance()->OnRegionSendDone(mDataPtr, true);
     Sender::Instance()->IncTotalSendStatistic(mDataPtr->mProjectName, mDataPtr->mLogstore, time(NULL));
     Sender::Instance()->OnSendDone(mDataPtr, LogstoreSenderInfo::SendResult_OK); // mDataPtr is released here
 
@@ -382,6 +389,7 @@ void SendClosure::OnFail(sdk::Response* response, const string& errorCode, const
             }
             // Sender::Instance()->PutIntoSecondaryBuffer(mDataPtr, 10);
             Sender::Instance()->SubSendingBufferCount();
+            Sender::Instance()->OnRegionSendDone(mDataPtr, false);
             // record error
             Sender::Instance()->OnSendDone(mDataPtr, recordRst);
             Sender::Instance()->DescSendingCount();
@@ -399,6 +407,7 @@ void SendClosure::OnFail(sdk::Response* response, const string& errorCode, const
                     mDataPtr->mRegion);
             }
             Sender::Instance()->SubSendingBufferCount();
+            Sender::Instance()->OnRegionSendDone(mDataPtr, false);
             // set ok to delete data
             Sender::Instance()->OnSendDone(mDataPtr, LogstoreSenderInfo::SendResult_DiscardFail);
             Sender::Instance()->DescSendingCount();
@@ -684,10 +693,6 @@ bool Sender::Init(void) {
     mBufferDivideTime = time(NULL);
     mCheckPeriod = INT32_FLAG(buffer_check_period);
     mSendBufferThreadId = CreateThread([this]() { DaemonBufferSender(); });
-    mSendLastTime[0] = 0;
-    mSendLastTime[1] = 0;
-    mSendLastByte[0] = 0;
-    mSendLastByte[1] = 0;
     ResetSendingCount();
     SetSendingBufferCount(0);
     mLastCheckSendClientTime = time(NULL);
@@ -930,7 +935,7 @@ bool Sender::LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSe
     return true;
 }
 bool Sender::ReadNextEncryption(int32_t& pos,
-                                const std::string& filename,
+                                BufferFileReader& reader,
                                 std::string& encryption,
                                 EncryptionStateMeta& meta,
                                 bool& readResult,
@@ -938,31 +943,13 @@ bool Sender::ReadNextEncryption(int32_t& pos,
     bufferMeta.Clear();
     readResult = false;
     encryption.clear();
-    int retryTimes = 0;
 
-    FILE* fin = NULL;
-    while (true) {
-        retryTimes++;
-        fin = FileReadOnlyOpen(filename.c_str(), "rb");
-        if (fin)
-            break;
-        if (retryTimes >= 3) {
-            string errorStr = ErrnoToString(GetErrno());
-            LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                                   string("open file error:") + filename + ",error:" + errorStr);
-            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
-            return false;
-        }
-        usleep(5000);
-    }
-    fseek(fin, 0, SEEK_END);
-    auto const currentSize = ftell(fin);
+    const string& filename = reader.GetFileName();
+    auto const currentSize = reader.GetFileSize();
     if (currentSize == pos) {
-        fclose(fin);
         return false;
     }
-    fseek(fin, pos, SEEK_SET);
-    auto nbytes = fread(static_cast<void*>(&meta), sizeof(char), sizeof(meta), fin);
+    auto nbytes = reader.Read(pos, &meta, sizeof(meta));
     if (nbytes != sizeof(meta)) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
@@ -973,7 +960,6 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         LOG_ERROR(sLogger,
                   ("read encryption file meta error",
                    filename)("error", errorStr)("nbytes", nbytes)("pos", pos)("ftell", currentSize));
-        fclose(fin);
         return false;
     }
 
@@ -992,13 +978,12 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         LOG_ERROR(sLogger,
                   ("meta of encryption file invalid", filename)("meta.mEncryptionSize", meta.mEncryptionSize)(
                       "meta.mEncodedInfoSize", meta.mEncodedInfoSize));
-        fclose(fin);
         return false;
     }
 
+    int32_t infoPos = pos + sizeof(meta);
     pos += sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
     if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time) || meta.mHandled == 1) {
-        fclose(fin);
         if (meta.mHandled != 1) {
             LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
             LogtailAlarm::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
@@ -1007,10 +992,9 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         return true;
     }
 
-    char* buffer = new char[encodedInfoSize + 1];
-    nbytes = fread(buffer, sizeof(char), encodedInfoSize, fin);
+    string encodedInfo(encodedInfoSize, '\0');
+    nbytes = reader.Read(infoPos, &encodedInfo[0], encodedInfoSize);
     if (nbytes != static_cast<size_t>(encodedInfoSize)) {
-        fclose(fin);
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("read projectname from file error:") + filename
@@ -1019,14 +1003,10 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         LOG_ERROR(sLogger,
                   ("read encodedInfo from file error",
                    filename)("error", errorStr)("meta.mEncodedInfoSize", meta.mEncodedInfoSize)("nbytes", nbytes));
-        delete[] buffer;
         return true;
     }
-    string encodedInfo = string(buffer, encodedInfoSize);
-    delete[] buffer;
     if (pbMeta) {
         if (!bufferMeta.ParseFromString(encodedInfo)) {
-            fclose(fin);
             LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                    string("parse buffer meta from file error:") + filename);
             LOG_ERROR(sLogger, ("parse buffer meta from file error", filename)("buffer meta", encodedInfo));
@@ -1042,10 +1022,9 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         bufferMeta.set_compresstype(SlsCompressType::SLS_CMP_LZ4);
     }
 
-    buffer = new char[meta.mEncryptionSize + 1];
-    nbytes = fread(buffer, sizeof(char), meta.mEncryptionSize, fin);
+    encryption.resize(meta.mEncryptionSize);
+    nbytes = reader.Read(infoPos + encodedInfoSize, &encryption[0], meta.mEncryptionSize);
     if (nbytes != static_cast<size_t>(meta.mEncryptionSize)) {
-        fclose(fin);
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("read encryption from file error:") + filename
@@ -1054,13 +1033,10 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         LOG_ERROR(sLogger,
                   ("read encryption from file error",
                    filename)("error", errorStr)("meta.mEncryptionSize", meta.mEncryptionSize)("nbytes", nbytes));
-        delete[] buffer;
+        encryption.clear();
         return true;
     }
-    encryption = string(buffer, meta.mEncryptionSize);
     readResult = true;
-    delete[] buffer;
-    fclose(fin);
     return true;
 }
 
@@ -1139,7 +1115,20 @@ void Sender::SendEncryptionBuffer(const std::string& filename, int32_t keyVersio
     int32_t pos = INT32_FLAG(file_encryption_header_length);
     LogtailBufferMeta bufferMeta;
     int32_t discardCount = 0;
-    while (ReadNextEncryption(pos, filename, encryption, meta, readResult, bufferMeta)) {
+    // the file is kept open while records are sent one by one, so that it is read sequentially
+    BufferFileReader reader;
+    int retryTimes = 0;
+    while (!reader.Open(filename)) {
+        if (++retryTimes >= 3) {
+            string errorStr = ErrnoToString(GetErrno());
+            LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
+                                                   string("open file error:") + filename + ",error:" + errorStr);
+            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
+            return;
+        }
+        usleep(5000);
+    }
+    while (ReadNextEncryption(pos, reader, encryption, meta, readResult, bufferMeta)) {
         logData.clear();
         bool sendResult = false;
         if (!readResult || bufferMeta.project().empty()) {
@@ -1211,21 +1200,24 @@ void Sender::SendEncryptionBuffer(const std::string& filename, int32_t keyVersio
             }
             delete[] des;
         }
-        if (sendResult)
-            meta.mHandled = 1;
         LOG_DEBUG(sLogger,
                   ("send LogGroup from local buffer file", filename)("rawsize", bufferMeta.rawsize())("sendResult",
                                                                                                       sendResult));
-        WriteBackMeta(pos - meta.mEncryptionSize - sizeof(meta)
-                          - (meta.mEncodedInfoSize > BUFFER_META_BASE_SIZE
-                                 ? (meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE)
-                                 : meta.mEncodedInfoSize),
-                      (char*)&meta,
-                      sizeof(meta),
-                      filename);
-        if (!sendResult)
+        // meta is written back only when the state of the record changes
+        if (sendResult) {
+            meta.mHandled = 1;
+            WriteBackMeta(pos - meta.mEncryptionSize - sizeof(meta)
+                              - (meta.mEncodedInfoSize > BUFFER_META_BASE_SIZE
+                                     ? (meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE)
+                                     : meta.mEncodedInfoSize),
+                          (char*)&meta,
+                          sizeof(meta),
+                          reader);
+        } else
             writeBack = true;
     }
+    reader.Close();
+    // the segment is released once all its records are handled
     if (!writeBack) {
         remove(filename.c_str());
         if (discardCount > 0) {
@@ -1262,51 +1254,16 @@ bool Sender::CreateNewFile() {
     return true;
 }
 
-bool Sender::WriteBackMeta(int32_t pos, const void* buf, int32_t length, const string& filename) {
-    // TODO: Why not use fopen or fstream???
-    // TODO: Make sure and merge them.
-#if defined(__linux__)
-    int fd = open(filename.c_str(), O_WRONLY);
-    if (fd < 0) {
+bool Sender::WriteBackMeta(int32_t pos, const void* buf, int32_t length, BufferFileReader& reader) {
+    if (!reader.Write(pos, buf, length)) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
+                                               string("write secondary file for write meta fail:")
+                                                   + reader.GetFileName() + ",reason:" + errorStr);
+        LOG_ERROR(sLogger, ("can not write back meta", reader.GetFileName()));
         return false;
     }
-    lseek(fd, pos, SEEK_SET);
-    if (write(fd, buf, length) < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    close(fd);
     return true;
-#elif defined(_MSC_VER)
-    FILE* f = FileWriteOnlyOpen(filename.c_str(), "wb");
-    if (!f) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    fseek(f, pos, SEEK_SET);
-    auto nbytes = fwrite(buf, 1, length, f);
-    if (nbytes != length) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    fclose(f);
-    return true;
-#endif
 }
 bool Sender::RemoveSender() {
     mBufferSenderThreadIsRunning = false;
@@ -1348,6 +1305,9 @@ void Sender::WriteSecondary() {
         // update bufferDiveideTime to flush data; buffer file before bufferDiveideTime will be ready for read
         if (time(NULL) - mBufferDivideTime > INT32_FLAG(buffer_file_alive_interval))
             CreateNewFile();
+        // close the divided file as soon as possible, all its records have been committed in the last round
+        if (mBufferFileWriter.IsOpen() && mBufferFileWriter.GetFileName() != GetBufferFileName())
+            mBufferFileWriter.Close();
 
         {
             PTScopedLock lock(mSecondaryMutexLock);
@@ -1363,6 +1323,8 @@ void Sender::WriteSecondary() {
                 SendToBufferFile(*itr);
                 delete *itr;
             }
+            // records dumped in one round are written together
+            CommitBufferFile();
             logGroupToDump.clear();
         }
     }
@@ -1392,7 +1354,6 @@ void Sender::DaemonSender() {
         vector<LoggroupTimeValue*> logGroupToSend;
         mSenderQueue.Wait(1000);
 
-        uint32_t bufferPackageCount = 0;
         bool singleBatchMapFull = false;
         int32_t curTime = time(NULL);
         if (Application::GetInstance()->IsExiting()) {
@@ -1402,11 +1363,26 @@ void Sender::DaemonSender() {
             {
                 PTScopedLock lock(mRegionEndpointEntryMapLock);
                 for (auto iter = mRegionEndpointEntryMap.begin(); iter != mRegionEndpointEntryMap.end(); ++iter) {
-                    regionConcurrencyLimits.insert(std::make_pair(iter->first, iter->second->mConcurrency));
+                    if (BOOL_FLAG(enable_adaptive_send_concurrency)) {
+                        auto& limiter = iter->second->mConcurrencyLimiter;
+                        limiter.SetLimitRange(1, AppConfig::GetInstance()->GetSendRequestConcurrency());
+                        regionConcurrencyLimits.insert(std::make_pair(iter->first, limiter.GetAvailable()));
+                    } else {
+                        regionConcurrencyLimits.insert(std::make_pair(iter->first, iter->second->mConcurrency));
+                    }
                 }
             }
 
             mSenderQueue.CheckAndPopAllItem(logGroupToSend, curTime, singleBatchMapFull, regionConcurrencyLimits);
+            if (BOOL_FLAG(enable_adaptive_send_concurrency) && !logGroupToSend.empty()) {
+                PTScopedLock lock(mRegionEndpointEntryMapLock);
+                for (auto data : logGroupToSend) {
+                    auto iter = mRegionEndpointEntryMap.find(data->mRegion);
+                    if (iter != mRegionEndpointEntryMap.end()) {
+                        iter->second->mConcurrencyLimiter.OnSendStart();
+                    }
+                }
+            }
 
 #ifdef LOGTAIL_DEBUG_FLAG
             if (logGroupToSend.size() > 0) {
@@ -1425,7 +1401,6 @@ void Sender::DaemonSender() {
         }
         mLastDaemonRunTime = curTime;
         IncSendingCount((int32_t)logGroupToSend.size());
-        bufferPackageCount = logGroupToSend.size();
 
         sendBufferCount += logGroupToSend.size();
         if (curTime - lastUpdateMetricTime >= 40) {
@@ -1462,25 +1437,6 @@ void Sender::DaemonSender() {
             sMonitor->UpdateMetric("net_err_stat", sNetErrCounter.Add(gNetworkErrorCount.exchange(0)));
         }
 
-        ///////////////////////////////////////
-        // smoothing send tps, walk around webserver load burst
-        if (!Application::GetInstance()->IsExiting() && AppConfig::GetInstance()->IsSendRandomSleep()) {
-            int64_t sleepMicroseconds = 0;
-            if (bufferPackageCount < 10)
-                sleepMicroseconds = (rand() % 40) * 10000; // 0ms ~ 400ms
-            else if (!singleBatchMapFull) {
-                if (bufferPackageCount < 20)
-                    sleepMicroseconds = (rand() % 30) * 10000; // 0ms ~ 300ms
-                else if (bufferPackageCount < 30)
-                    sleepMicroseconds = (rand() % 20) * 10000; // 0ms ~ 200ms
-                else if (bufferPackageCount < 40)
-                    sleepMicroseconds = (rand() % 10) * 10000; // 0ms ~ 100ms
-            }
-            if (sleepMicroseconds > 0)
-                usleep(sleepMicroseconds);
-        }
-        ///////////////////////////////////////
-
         for (vector<LoggroupTimeValue*>::iterator itr = logGroupToSend.begin(); itr != logGroupToSend.end(); ++itr) {
             LoggroupTimeValue* data = *itr;
             int32_t logGroupWaitTime = curTime - data->mEnqueueTime;
@@ -1511,9 +1467,9 @@ void Sender::DaemonSender() {
                 }
 
                 int32_t beforeSleepTime = time(NULL);
+                // woken up as soon as any request is done, the timeout is only for checking exit
                 while (!Application::GetInstance()->IsExiting()
-                       && GetSendingBufferCount() >= AppConfig::GetInstance()->GetSendRequestConcurrency()) {
-                    usleep(10 * 1000);
+                       && !mSendingBufferGate.WaitForSlot(AppConfig::GetInstance()->GetSendRequestConcurrency(), 100)) {
                 }
                 int32_t afterSleepTime = time(NULL);
                 int32_t blockCostTime = afterSleepTime - beforeSleepTime;
@@ -1605,32 +1561,23 @@ string Sender::GetBufferFileHeader() {
     return (STRING_FLAG(file_encryption_magic_number) + reserve + nullHeader);
 }
 
+// records are appended to the buffer file kept open, and are written to disk by CommitBufferFile()
 bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
     string bufferFileName = GetBufferFileName();
     if (bufferFileName.empty()) {
         CreateNewFile();
         bufferFileName = GetBufferFileName();
     }
-    // if file not exist, create it new
-    FILE* fout = FileAppendOpen(bufferFileName.c_str(), "ab");
-    if (!fout) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open file error:") + bufferFileName + ",error:" + errorStr);
-        LOG_ERROR(sLogger, ("open buffer file error", bufferFileName));
-        return false;
-    }
-
-    if (ftell(fout) == (streampos)0) {
-        string header = GetBufferFileHeader();
-        auto nbytes = fwrite(header.c_str(), 1, header.size(), fout);
-        if (header.size() != nbytes) {
+    if (mBufferFileWriter.GetFileName() != bufferFileName) {
+        // if file not exist, create it new
+        if (!mBufferFileWriter.Open(bufferFileName,
+                                    GetBufferFileHeader(),
+                                    BOOL_FLAG(buffer_file_preallocate) ? AppConfig::GetInstance()->GetLocalFileSize()
+                                                                        : 0)) {
             string errorStr = ErrnoToString(GetErrno());
             LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                                   string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                       + ", nbytes:" + ToString(nbytes));
-            LOG_ERROR(sLogger, ("error write encryption header", bufferFileName)("error", errorStr)("nbytes", nbytes));
-            fclose(fout);
+                                                   string("open file error:") + bufferFileName + ",error:" + errorStr);
+            LOG_ERROR(sLogger, ("open buffer file error", bufferFileName)("error", errorStr));
             return false;
         }
     }
@@ -1638,7 +1585,6 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(dataPtr->mLogData.c_str(), dataPtr->mLogData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", dataPtr->mProjectName));
         LogtailAlarm::GetInstance()->SendAlarm(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                string("encrypt error, project_name:" + dataPtr->mProjectName));
@@ -1665,51 +1611,54 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
     meta.mHandled = 0;
     meta.mRetryTime = 0;
     meta.mEncryptionSize = desLength;
-    char* buffer = new char[sizeof(meta) + encodedInfoSize + meta.mEncryptionSize];
-    memcpy(buffer, (char*)&meta, sizeof(meta));
-    memcpy(buffer + sizeof(meta), encodedInfo.c_str(), encodedInfoSize);
-    memcpy(buffer + sizeof(meta) + encodedInfoSize, des, desLength);
+    mBufferFileWriter.Append(&meta, sizeof(meta));
+    mBufferFileWriter.Append(encodedInfo.data(), encodedInfoSize);
+    mBufferFileWriter.Append(des, desLength);
     delete[] des;
-    const auto bytesToWrite = sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    auto nbytes = fwrite(buffer, 1, bytesToWrite, fout);
-    if (nbytes != bytesToWrite) {
+
+    if (mBufferFileWriter.GetSize() > AppConfig::GetInstance()->GetLocalFileSize()) {
+        bool res = CommitBufferFile();
+        CreateNewFile();
+        mBufferFileWriter.Close();
+        return res;
+    }
+    if (mBufferFileWriter.GetPendingSize() >= static_cast<size_t>(INT32_FLAG(buffer_file_group_commit_size))
+        || BOOL_FLAG(enable_mock_send))
+        return CommitBufferFile();
+    return true;
+}
+
+bool Sender::CommitBufferFile() {
+    size_t bytesToWrite = mBufferFileWriter.GetPendingSize();
+    if (bytesToWrite == 0)
+        return true;
+    if (!mBufferFileWriter.Commit(BOOL_FLAG(buffer_file_sync))) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                   + ", nbytes:" + ToString(nbytes));
-        LOG_ERROR(
-            sLogger,
-            ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
-        delete[] buffer;
-        fclose(fout);
+                                               string("write file error:") + mBufferFileWriter.GetFileName()
+                                                   + ", error:" + errorStr + ", bytes:" + ToString(bytesToWrite));
+        LOG_ERROR(sLogger,
+                  ("write buffer file", "fail")("filename", mBufferFileWriter.GetFileName())("errorStr", errorStr)(
+                      "bytes", bytesToWrite));
+        // reopen the file on next write in case the file is broken
+        mBufferFileWriter.Close();
         return false;
     }
-    delete[] buffer;
-    if (BOOL_FLAG(enable_mock_send))
-        fflush(fout);
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
-        CreateNewFile();
-    fclose(fout);
-    LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
+    LOG_DEBUG(sLogger, ("write buffer file", mBufferFileWriter.GetFileName())("bytes", bytesToWrite));
     return true;
 }
 
 void Sender::FlowControl(int32_t dataSize, SEND_THREAD_TYPE type) {
-    int64_t curTime = GetCurrentTimeInMicroSeconds();
-    int32_t idx = int32_t(type);
-    int32_t bps = (type == REALTIME_SEND_THREAD) ? AppConfig::GetInstance()->GetMaxBytePerSec()
+    TokenBucket& bucket = mSendBuckets[type];
+    int64_t bps = (type == REALTIME_SEND_THREAD) ? AppConfig::GetInstance()->GetMaxBytePerSec()
                                                  : AppConfig::GetInstance()->GetBytePerSec();
-    if (curTime < mSendLastTime[idx] || curTime - mSendLastTime[idx] >= 1000 * 1000) {
-        mSendLastTime[idx] = curTime;
-        mSendLastByte[idx] = dataSize;
-    } else {
-        if (mSendLastByte[idx] > bps) {
-            usleep(1000 * 1000 - (curTime - mSendLastTime[idx]));
-            mSendLastTime[idx] = GetCurrentTimeInMicroSeconds();
-            mSendLastByte[idx] = dataSize;
-        } else {
-            mSendLastByte[idx] += dataSize;
-        }
+    if (bps != bucket.GetRate()) {
+        // with tps smoothing, bursts are limited to 1/10 second of traffic so that requests are spread over time
+        bucket.SetRate(bps, AppConfig::GetInstance()->IsSendRandomSleep() ? max<int64_t>(bps / 10, 1) : bps);
+    }
+    int64_t waitTime = bucket.Consume(dataSize, GetCurrentTimeInMicroSeconds());
+    if (waitTime > 0) {
+        usleep(waitTime);
     }
 }
 
@@ -2026,6 +1975,7 @@ void Sender::SendToNetAsync(LoggroupTimeValue* dataPtr) {
         && Application::GetInstance()->IsExiting()) // write local file avoid binary update fail
     {
         SubSendingBufferCount();
+        OnRegionSendDone(dataPtr, false);
         if (!exactlyOnceCpt) {
             PutIntoSecondaryBuffer(dataPtr, 3);
         } else {
@@ -2059,6 +2009,7 @@ void Sender::SendToNetAsync(LoggroupTimeValue* dataPtr) {
 
     SendClosure* sendClosure = new SendClosure;
     dataPtr->mLastSendTime = curTime;
+    dataPtr->mLastSendTimeInUs = GetCurrentTimeInMicroSeconds();
     sendClosure->mDataPtr = dataPtr;
     LOG_DEBUG(sLogger,
               ("region", dataPtr->mRegion)("endpoint", dataPtr->mCurrentEndpoint)("project", dataPtr->mProjectName)(
@@ -2077,6 +2028,7 @@ void Sender::SendToNetAsync(LoggroupTimeValue* dataPtr) {
         else {
             LOG_ERROR(sLogger, ("MockAsyncSend", "uninitialized"));
             SubSendingBufferCount();
+            OnRegionSendDone(dataPtr, false);
             DescSendingCount();
             delete sendClosure;
         }
@@ -2206,19 +2158,19 @@ int32_t Sender::GetSendingCount() {
 }
 
 void Sender::SetSendingBufferCount(int32_t count) {
-    mSendingBufferCount = count;
+    mSendingBufferGate.Set(count);
 }
 
 void Sender::AddSendingBufferCount() {
-    mSendingBufferCount++;
+    mSendingBufferGate.Add();
 }
 
 void Sender::SubSendingBufferCount() {
-    mSendingBufferCount--;
+    mSendingBufferGate.Sub();
 }
 
 int32_t Sender::GetSendingBufferCount() {
-    return mSendingBufferCount;
+    return mSendingBufferGate.Get();
 }
 
 bool Sender::IsFlush() {
@@ -2269,6 +2221,10 @@ void Sender::ResetRegionConcurrency(const std::string& region) {
         return;
 
     auto regionInfo = iter->second;
+    if (BOOL_FLAG(enable_adaptive_send_concurrency)) {
+        regionInfo->mConcurrencyLimiter.OnOverload(GetCurrentTimeInMicroSeconds());
+        return;
+    }
     if (++regionInfo->mContinuousErrorCount >= INT32_FLAG(reset_region_concurrency_error_count)) {
         auto oldConcurrency = regionInfo->mConcurrency;
         regionInfo->mConcurrency
@@ -2283,6 +2239,24 @@ void Sender::ResetRegionConcurrency(const std::string& region) {
     }
 }
 
+void Sender::OnRegionSendDone(const LoggroupTimeValue* dataPtr, bool success) {
+    if (!BOOL_FLAG(enable_adaptive_send_concurrency)) {
+        return;
+    }
+    PTScopedLock lock(mRegionEndpointEntryMapLock);
+    auto iter = mRegionEndpointEntryMap.find(dataPtr->mRegion);
+    if (mRegionEndpointEntryMap.end() == iter)
+        return;
+
+    auto& limiter = iter->second->mConcurrencyLimiter;
+    int32_t oldLimit = limiter.GetLimit();
+    limiter.OnSendDone(success, GetCurrentTimeInMicroSeconds() - dataPtr->mLastSendTimeInUs);
+    if (oldLimit != limiter.GetLimit()) {
+        LOG_DEBUG(sLogger,
+                  ("region send concurrency changed", dataPtr->mRegion)("from", oldLimit)("to", limiter.GetLimit()));
+    }
+}
+
 bool Sender::FlushOut(int32_t time_interval_in_mili_seconds) {
     SetFlush();
     for (int i = 0; i < time_interval_in_mili_seconds / 100; ++i) {
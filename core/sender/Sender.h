@@ -21,7 +21,10 @@
 #include <unordered_map>
 #include <vector>
 
+#include "BufferFileSpool.h"
+#include "SendConcurrencyGate.h"
 #include "SenderQueueParam.h"
+#include "TokenBucket.h"
 #include "common/Lock.h"
 #include "common/LogstoreFeedbackQueue.h"
 #include "common/LogstoreSenderQueue.h"
@@ -72,6 +75,8 @@ struct RegionEndpointEntry {
     int32_t mConcurrency = -1;
     // To avoid occasional error.
     int32_t mContinuousErrorCount = 0;
+    // Used instead of mConcurrency when enable_adaptive_send_concurrency is set, which counts requests in flight.
+    AdaptiveConcurrencyLimiter mConcurrencyLimiter{1, INT32_MAX};
 
     RegionEndpointEntry() {
         mDefaultEndpoint.clear();
@@ -182,6 +187,7 @@ private:
                                   const std::string& logData,
                                   std::string& errorCode);
     bool SendToBufferFile(LoggroupTimeValue* dataPtr);
+    bool CommitBufferFile();
     void FlowControl(int32_t dataSize, SEND_THREAD_TYPE type);
 
     bool IsValidToSend(const LogstoreFeedBackKey& logstoreKey);
@@ -192,10 +198,10 @@ private:
     WaitObject mWriteSecondaryWait; // semaphore between SendThreads & DumpSecondaryThread
     PTMutex mSecondaryMutexLock; // lock for mSecondaryBuffer
     std::vector<LoggroupTimeValue*> mSecondaryBuffer;
+    BufferFileWriter mBufferFileWriter; // only used by DumpSecondaryThread
 
     // for flow control: value[0] for realtime thread, value[1] for replay thread
-    int64_t mSendLastTime[SEND_THREAD_TYPE_COUNT];
-    int32_t mSendLastByte[SEND_THREAD_TYPE_COUNT];
+    TokenBucket mSendBuckets[SEND_THREAD_TYPE_COUNT];
 
     LogstoreSenderQueue<SenderQueueParam> mSenderQueue;
 
@@ -212,7 +218,7 @@ private:
     volatile bool mFlushLog;
     std::string mBufferFilePath;
     std::atomic_int mSendingLogGroupCount{0};
-    std::atomic_int mSendingBufferCount{0};
+    SendConcurrencyGate mSendingBufferGate;
     // buffer file named before this unixtime can be read by daemon buffer sender thread
     // buffer file named after this unixtime maybe occupied by daemon sender thread at the moment
     volatile time_t mBufferDivideTime;
@@ -301,9 +307,9 @@ private:
     void WriteSecondary();
     bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
     bool CreateNewFile();
-    bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
+    bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, BufferFileReader& reader);
     bool ReadNextEncryption(int32_t& pos,
-                            const std::string& filename,
+                            BufferFileReader& reader,
                             std::string& encryption,
                             EncryptionStateMeta& meta,
                             bool& readResult,
@@ -437,6 +443,8 @@ public:
 
     void IncreaseRegionConcurrency(const std::string& region);
     void ResetRegionConcurrency(const std::string& region);
+    // called once the request finishes, no matter how many times it is retried
+    void OnRegionSendDone(const LoggroupTimeValue* dataPtr, bool success);
 
     int32_t GetSendingBufferCount();
 
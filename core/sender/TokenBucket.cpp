@@ -0,0 +1,57 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sender/TokenBucket.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace logtail {
+
+void TokenBucket::SetRate(int64_t rate, int64_t burst) {
+    if (mRate == 0) {
+        // start with a full bucket
+        mTokens = static_cast<double>(burst);
+    }
+    mRate = rate;
+    mBurst = burst;
+    mTokens = min(mTokens, static_cast<double>(mBurst));
+}
+
+int64_t TokenBucket::Consume(int64_t tokens, int64_t curTimeInUs) {
+    if (mRate <= 0) {
+        return 0;
+    }
+    Refill(curTimeInUs);
+    mTokens -= tokens;
+    if (mTokens >= 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(-mTokens * 1000000 / mRate);
+}
+
+void TokenBucket::Refill(int64_t curTimeInUs) {
+    if (mLastRefillTime == 0 || curTimeInUs < mLastRefillTime) {
+        // first consumption or clock jumped back
+        mLastRefillTime = curTimeInUs;
+        return;
+    }
+    mTokens = min(mTokens + static_cast<double>(curTimeInUs - mLastRefillTime) * mRate / 1000000,
+                  static_cast<double>(mBurst));
+    mLastRefillTime = curTimeInUs;
+}
+
+} // namespace logtail
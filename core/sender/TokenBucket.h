@@ -0,0 +1,43 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace logtail {
+
+// Byte rate limiter refilled continuously. Consumption is always admitted and may leave the bucket in debt, and the
+// caller is told how long to wait so that the average rate does not exceed the limit. Not thread-safe.
+class TokenBucket {
+public:
+    // burst is the max number of tokens accumulated while idle
+    void SetRate(int64_t rate, int64_t burst);
+    int64_t GetRate() const { return mRate; }
+
+    // return the time in microseconds to wait before the consumed tokens are actually available
+    int64_t Consume(int64_t tokens, int64_t curTimeInUs);
+
+private:
+    void Refill(int64_t curTimeInUs);
+
+    int64_t mRate = 0;
+    int64_t mBurst = 0;
+    double mTokens = 0;
+    int64_t mLastRefillTime = 0;
+};
+
+} // namespace logtail
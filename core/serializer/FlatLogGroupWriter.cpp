@@ -0,0 +1,88 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serializer/FlatLogGroupWriter.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace logtail {
+
+void FlatLogGroupWriter::Prepare(uint32_t logCnt, uint32_t contentCnt, uint32_t tagCnt, size_t stringsSize) {
+    mRes.resize(GetSize(logCnt, contentCnt, tagCnt, stringsSize));
+    char* base = &mRes[0];
+    WriteUint32(base, kMagic);
+    WriteUint32(base + 4, logCnt);
+    WriteUint32(base + 8, contentCnt);
+    WriteUint32(base + 12, tagCnt);
+    WriteUint32(base + 16, 0);
+    WriteUint32(base + 20, 0);
+    mLogPtr = base + kHeaderSize;
+    mContentPtr = mLogPtr + logCnt * kLogSize;
+    mTagPtr = mContentPtr + contentCnt * kFieldSize;
+    mStringPtr = mTagPtr + tagCnt * kFieldSize;
+    mContentCnt = 0;
+}
+
+void FlatLogGroupWriter::AddLog(uint32_t logTime, uint32_t logTimeNs, bool hasTimeNs) {
+    WriteUint32(mLogPtr, logTime);
+    WriteUint32(mLogPtr + 4, hasTimeNs ? logTimeNs : 0);
+    WriteUint32(mLogPtr + 8, hasTimeNs ? 1 : 0);
+    WriteUint32(mLogPtr + 12, mContentCnt);
+    mLogPtr += kLogSize;
+}
+
+void FlatLogGroupWriter::AddLogContent(StringView key, StringView value) {
+    WriteField(mContentPtr, key, value);
+    mContentPtr += kFieldSize;
+    // the end index of the current log is updated for each content
+    WriteUint32(mLogPtr - kLogSize + 12, ++mContentCnt);
+}
+
+void FlatLogGroupWriter::SetTopic(StringView topic) {
+    char* base = &mRes[0];
+    WriteUint32(base + 16, WriteString(topic));
+    WriteUint32(base + 20, topic.size());
+}
+
+void FlatLogGroupWriter::AddLogTag(StringView key, StringView value) {
+    WriteField(mTagPtr, key, value);
+    mTagPtr += kFieldSize;
+}
+
+void FlatLogGroupWriter::WriteUint32(char* p, uint32_t value) {
+    p[0] = static_cast<char>(value);
+    p[1] = static_cast<char>(value >> 8);
+    p[2] = static_cast<char>(value >> 16);
+    p[3] = static_cast<char>(value >> 24);
+}
+
+void FlatLogGroupWriter::WriteField(char* p, StringView key, StringView value) {
+    WriteUint32(p, WriteString(key));
+    WriteUint32(p + 4, key.size());
+    WriteUint32(p + 8, WriteString(value));
+    WriteUint32(p + 12, value.size());
+}
+
+uint32_t FlatLogGroupWriter::WriteString(StringView value) {
+    uint32_t offset = mStringPtr - mRes.data();
+    if (!value.empty()) {
+        memcpy(mStringPtr, value.data(), value.size());
+        mStringPtr += value.size();
+    }
+    return offset;
+}
+
+} // namespace logtail
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Flat log group is the format in which log groups are handed over from the native pipeline to the Go plugin system.
+// Unlike sls_logs::LogGroup in protobuf wire format, every field is located by fixed-size offsets, so that the reader
+// can refer to keys and values in place, instead of decoding varints and copying strings one by one.
+//
+// All integers are uint32 in little endian, and all offsets are relative to the beginning of the buffer.
+//   header:   magic, log count, content count, tag count, topic offset, topic size
+//   logs:     log count * {time, time ns, has time ns, end index of its contents}
+//   contents: content count * {key offset, key size, value offset, value size}
+//   tags:     tag count * {key offset, key size, value offset, value size}
+//   strings:  keys, values and topic referred by the offsets above
+class FlatLogGroupWriter {
+public:
+    static constexpr uint32_t kMagic = 0x31474C46; // "FLG1"
+    static constexpr size_t kHeaderSize = 24;
+    static constexpr size_t kLogSize = 16;
+    static constexpr size_t kFieldSize = 16;
+
+    static size_t GetSize(uint32_t logCnt, uint32_t contentCnt, uint32_t tagCnt, size_t stringsSize) {
+        return kHeaderSize + logCnt * kLogSize + (contentCnt + tagCnt) * kFieldSize + stringsSize;
+    }
+
+    // stringsSize should be the total size of all keys, values and topic to be added.
+    void Prepare(uint32_t logCnt, uint32_t contentCnt, uint32_t tagCnt, size_t stringsSize);
+
+    // contents of the log should be added right after the log
+    void AddLog(uint32_t logTime, uint32_t logTimeNs, bool hasTimeNs);
+    void AddLogContent(StringView key, StringView value);
+    void SetTopic(StringView topic);
+    void AddLogTag(StringView key, StringView value);
+
+    std::string& GetResult() { return mRes; }
+
+private:
+    static void WriteUint32(char* p, uint32_t value);
+    void WriteField(char* p, StringView key, StringView value);
+    uint32_t WriteString(StringView value);
+
+    std::string mRes;
+    char* mLogPtr = nullptr;
+    char* mContentPtr = nullptr;
+    char* mTagPtr = nullptr;
+    char* mStringPtr = nullptr;
+    uint32_t mContentCnt = 0;
+};
+
+} // namespace logtail
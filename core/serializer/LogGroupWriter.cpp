@@ -0,0 +1,169 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serializer/LogGroupWriter.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace logtail {
+
+// field tags, i.e., (field_number << 3) | wire_type
+// LogGroup
+static const uint8_t kLogsTag = 0x0A;
+static const uint8_t kCategoryTag = 0x12;
+static const uint8_t kTopicTag = 0x1A;
+static const uint8_t kSourceTag = 0x22;
+static const uint8_t kMachineUUIDTag = 0x2A;
+static const uint8_t kLogTagsTag = 0x32;
+// Log
+static const uint8_t kLogTimeTag = 0x08;
+static const uint8_t kLogContentsTag = 0x12;
+static const uint8_t kLogTimeNsTag = 0x25;
+// Log.Content & LogTag
+static const uint8_t kKeyTag = 0x0A;
+static const uint8_t kValueTag = 0x12;
+
+size_t GetVarint32Size(uint32_t value) {
+    if (value < (1UL << 7)) {
+        return 1;
+    } else if (value < (1UL << 14)) {
+        return 2;
+    } else if (value < (1UL << 21)) {
+        return 3;
+    } else if (value < (1UL << 28)) {
+        return 4;
+    } else {
+        return 5;
+    }
+}
+
+size_t GetLengthDelimitedFieldSize(size_t size) {
+    return 1 + GetVarint32Size(static_cast<uint32_t>(size)) + size;
+}
+
+size_t GetLogContentSize(size_t keySize, size_t valueSize) {
+    return GetLengthDelimitedFieldSize(GetLengthDelimitedFieldSize(keySize) + GetLengthDelimitedFieldSize(valueSize));
+}
+
+size_t GetLogTagSize(size_t keySize, size_t valueSize) {
+    return GetLogContentSize(keySize, valueSize);
+}
+
+size_t GetLogBodySize(size_t contentsSize, uint32_t logTime, bool hasNs) {
+    // Time_ns is fixed32
+    return 1 + GetVarint32Size(logTime) + contentsSize + (hasNs ? 5 : 0);
+}
+
+void LogGroupWriter::Prepare(size_t size) {
+    mRes.clear();
+    mRes.resize(size);
+    mPtr = &mRes[0];
+    mEnd = mPtr + size;
+}
+
+void LogGroupWriter::StartToAddLog(size_t size) {
+    WriteVarint(kLogsTag);
+    WriteVarint(static_cast<uint32_t>(size));
+}
+
+void LogGroupWriter::AddLogTime(uint32_t logTime) {
+    WriteVarint(kLogTimeTag);
+    WriteVarint(logTime);
+}
+
+void LogGroupWriter::AddLogContent(StringView key, StringView value) {
+    WriteVarint(kLogContentsTag);
+    WriteVarint(
+        static_cast<uint32_t>(GetLengthDelimitedFieldSize(key.size()) + GetLengthDelimitedFieldSize(value.size())));
+    AddString(kKeyTag, key);
+    AddString(kValueTag, value);
+}
+
+void LogGroupWriter::AddLogTimeNs(uint32_t logTimeNs) {
+    WriteVarint(kLogTimeNsTag);
+    // fixed32 is always little endian
+    char buf[4];
+    buf[0] = static_cast<char>(logTimeNs & 0xFF);
+    buf[1] = static_cast<char>((logTimeNs >> 8) & 0xFF);
+    buf[2] = static_cast<char>((logTimeNs >> 16) & 0xFF);
+    buf[3] = static_cast<char>((logTimeNs >> 24) & 0xFF);
+    WriteBytes(buf, 4);
+}
+
+void LogGroupWriter::AddCategory(StringView category) {
+    AddString(kCategoryTag, category);
+}
+
+void LogGroupWriter::AddTopic(StringView topic) {
+    AddString(kTopicTag, topic);
+}
+
+void LogGroupWriter::AddSource(StringView source) {
+    AddString(kSourceTag, source);
+}
+
+void LogGroupWriter::AddMachineUUID(StringView machineUUID) {
+    AddString(kMachineUUIDTag, machineUUID);
+}
+
+void LogGroupWriter::AddLogTag(StringView key, StringView value) {
+    WriteVarint(kLogTagsTag);
+    WriteVarint(
+        static_cast<uint32_t>(GetLengthDelimitedFieldSize(key.size()) + GetLengthDelimitedFieldSize(value.size())));
+    AddString(kKeyTag, key);
+    AddString(kValueTag, value);
+}
+
+string& LogGroupWriter::GetResult() {
+    if (mPtr != nullptr) {
+        mRes.resize(mPtr - mRes.data());
+    }
+    mPtr = mEnd = nullptr;
+    return mRes;
+}
+
+void LogGroupWriter::AddString(uint8_t tag, StringView value) {
+    WriteVarint(tag);
+    WriteVarint(static_cast<uint32_t>(value.size()));
+    WriteBytes(value.data(), value.size());
+}
+
+void LogGroupWriter::WriteVarint(uint32_t value) {
+    char buf[5];
+    size_t len = 0;
+    while (value >= 0x80) {
+        buf[len++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = static_cast<char>(value);
+    WriteBytes(buf, len);
+}
+
+void LogGroupWriter::WriteBytes(const char* data, size_t size) {
+    if (static_cast<size_t>(mEnd - mPtr) < size) {
+        // should not happen if the prepared size is correct, grow the buffer to avoid overflow anyway
+        size_t used = mPtr == nullptr ? 0 : mPtr - mRes.data();
+        mRes.resize(max(mRes.size() * 2, used + size));
+        mPtr = &mRes[0] + used;
+        mEnd = &mRes[0] + mRes.size();
+    }
+    if (size > 0) {
+        memcpy(mPtr, data, size);
+        mPtr += size;
+    }
+}
+
+} // namespace logtail
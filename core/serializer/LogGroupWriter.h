@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// The following functions return the number of bytes occupied in the protobuf wire format of sls_logs::LogGroup.
+size_t GetVarint32Size(uint32_t value);
+// field tag + length prefix + data
+size_t GetLengthDelimitedFieldSize(size_t size);
+size_t GetLogContentSize(size_t keySize, size_t valueSize);
+size_t GetLogTagSize(size_t keySize, size_t valueSize);
+// size of the Log message body, excluding its own field tag and length prefix
+size_t GetLogBodySize(size_t contentsSize, uint32_t logTime, bool hasNs);
+
+// LogGroupWriter writes sls_logs::LogGroup in protobuf wire format directly into a pre-sized buffer, without building
+// the intermediate protobuf message. Fields must be added in field number order, i.e., logs first, then category,
+// topic, source, machine uuid and log tags, so that the output is byte-identical to LogGroup::SerializeAsString().
+class LogGroupWriter {
+public:
+    // size should be the exact size of the log group, calculated by the functions above.
+    void Prepare(size_t size);
+
+    // size should be the value returned by GetLogBodySize.
+    void StartToAddLog(size_t size);
+    void AddLogTime(uint32_t logTime);
+    void AddLogContent(StringView key, StringView value);
+    void AddLogTimeNs(uint32_t logTimeNs);
+
+    void AddCategory(StringView category);
+    void AddTopic(StringView topic);
+    void AddSource(StringView source);
+    void AddMachineUUID(StringView machineUUID);
+    void AddLogTag(StringView key, StringView value);
+
+    // the buffer is shrinked to the actually written size, which equals to the prepared size in normal cases.
+    std::string& GetResult();
+
+private:
+    void AddString(uint8_t tag, StringView value);
+    void WriteVarint(uint32_t value);
+    void WriteBytes(const char* data, size_t size);
+
+    std::string mRes;
+    char* mPtr = nullptr;
+    char* mEnd = nullptr;
+};
+
+} // namespace logtail
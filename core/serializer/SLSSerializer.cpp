@@ -18,6 +18,7 @@
 #include "common/Flags.h"
 #include "compression/CompressType.h"
 #include "flusher/FlusherSLS.h"
+#include "serializer/LogGroupWriter.h"
 
 DEFINE_FLAG_INT32(max_send_log_group_size, "bytes", 10 * 1024 * 1024);
 
@@ -26,47 +27,81 @@ using namespace std;
 namespace logtail {
 
 bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, string& errorMsg) {
-    sls_logs::LogGroup logGroup;
-    for (const auto& e : group.mEvents) {
-        if (e.Is<LogEvent>()) {
-            const auto& logEvent = e.Cast<LogEvent>();
-            auto log = logGroup.add_logs();
-            for (const auto& kv : logEvent) {
-                auto contPtr = log->add_contents();
-                contPtr->set_key(kv.first.to_string());
-                contPtr->set_value(kv.second.to_string());
-            }
-            log->set_time(logEvent.GetTimestamp());
-            if (mFlusher->GetContext().GetGlobalConfig().mEnableTimestampNanosecond
-                && logEvent.GetTimestampNanosecond()) {
-                log->set_time_ns(logEvent.GetTimestampNanosecond().value());
-            }
-        } else {
+    // calculate the size of each log and the whole log group in one pass, so that the output can be written into a
+    // single pre-sized buffer afterwards
+    bool enableNs = mFlusher->GetContext().GetGlobalConfig().mEnableTimestampNanosecond;
+    vector<size_t> logSZ(group.mEvents.size());
+    size_t logGroupSZ = 0;
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        const auto& e = group.mEvents[i];
+        if (!e.Is<LogEvent>()) {
             errorMsg = "unsupported event type in event group";
             return false;
         }
+        const auto& logEvent = e.Cast<LogEvent>();
+        size_t contentSZ = 0;
+        for (const auto& kv : logEvent) {
+            contentSZ += GetLogContentSize(kv.first.size(), kv.second.size());
+        }
+        logSZ[i] = GetLogBodySize(contentSZ,
+                                  static_cast<uint32_t>(logEvent.GetTimestamp()),
+                                  enableNs && logEvent.GetTimestampNanosecond());
+        logGroupSZ += GetLengthDelimitedFieldSize(logSZ[i]);
     }
     for (const auto& tag : group.mTags.mInner) {
-        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
-            logGroup.set_topic(tag.second.to_string());
-        } else if (tag.first == LOG_RESERVED_KEY_SOURCE) {
-            logGroup.set_source(tag.second.to_string());
-        } else if (tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
-            logGroup.set_machineuuid(tag.second.to_string());
+        if (tag.first == LOG_RESERVED_KEY_TOPIC || tag.first == LOG_RESERVED_KEY_SOURCE
+            || tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
+            logGroupSZ += GetLengthDelimitedFieldSize(tag.second.size());
         } else {
-            auto logTag = logGroup.add_logtags();
-            logTag->set_key(tag.first.to_string());
-            logTag->set_value(tag.second.to_string());
+            logGroupSZ += GetLogTagSize(tag.first.size(), tag.second.size());
         }
     }
-    logGroup.set_category(static_cast<const FlusherSLS*>(mFlusher)->mLogstore);
-    size_t size = logGroup.ByteSizeLong();
-    if (static_cast<int32_t>(size) > INT32_FLAG(max_send_log_group_size)) {
-        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(size)
+    const string& logstore = static_cast<const FlusherSLS*>(mFlusher)->mLogstore;
+    logGroupSZ += GetLengthDelimitedFieldSize(logstore.size());
+
+    if (static_cast<int32_t>(logGroupSZ) > INT32_FLAG(max_send_log_group_size)) {
+        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(logGroupSZ)
             + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
         return false;
     }
-    res = logGroup.SerializeAsString();
+
+    // fields must be written in field number order to be identical with the protobuf output
+    LogGroupWriter writer;
+    writer.Prepare(logGroupSZ);
+    const auto& events = group.mEvents;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& logEvent = events[i].Cast<LogEvent>();
+        writer.StartToAddLog(logSZ[i]);
+        writer.AddLogTime(static_cast<uint32_t>(logEvent.GetTimestamp()));
+        for (const auto& kv : logEvent) {
+            writer.AddLogContent(kv.first, kv.second);
+        }
+        if (enableNs && logEvent.GetTimestampNanosecond()) {
+            writer.AddLogTimeNs(logEvent.GetTimestampNanosecond().value());
+        }
+    }
+    writer.AddCategory(logstore);
+    // mTags is ordered by key, so topic, source and machine uuid must be picked out first
+    auto it = group.mTags.mInner.find(LOG_RESERVED_KEY_TOPIC);
+    if (it != group.mTags.mInner.end()) {
+        writer.AddTopic(it->second);
+    }
+    it = group.mTags.mInner.find(LOG_RESERVED_KEY_SOURCE);
+    if (it != group.mTags.mInner.end()) {
+        writer.AddSource(it->second);
+    }
+    it = group.mTags.mInner.find(LOG_RESERVED_KEY_MACHINE_UUID);
+    if (it != group.mTags.mInner.end()) {
+        writer.AddMachineUUID(it->second);
+    }
+    for (const auto& tag : group.mTags.mInner) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC || tag.first == LOG_RESERVED_KEY_SOURCE
+            || tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
+            continue;
+        }
+        writer.AddLogTag(tag.first, tag.second);
+    }
+    res = std::move(writer.GetResult());
     return true;
 }
 
@@ -0,0 +1,100 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "batch/Batcher.h"
+#include "common/StringTools.h"
+#include "common/TimeUtil.h"
+#include "unittest/Unittest.h"
+#include "unittest/plugin/PluginMock.h"
+
+using namespace std;
+using namespace logtail;
+
+static PipelineEventGroup CreateEventGroup(const string& path, size_t eventCnt) {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("__path__"), path);
+    for (size_t i = 0; i < eventCnt; ++i) {
+        auto e = group.AddLogEvent();
+        e->SetTimestamp(i);
+        e->SetContentNoCopy(StringView("content"), StringView("value"));
+    }
+    return group;
+}
+
+// Each processing thread sends groups read from its own files to the same flusher, which is the common case when
+// several files are collected by one config.
+static void BM_Add(Flusher* flusher, size_t threadCnt, size_t fileCntPerThread, bool enableGroupBatch) {
+    static const size_t kGroupCntPerThread = 20000;
+    static const size_t kEventCntPerGroup = 10;
+
+    DefaultFlushStrategyOptions strategy;
+    strategy.mMaxCnt = 1000;
+    strategy.mMaxSizeBytes = 256 * 1024;
+    strategy.mTimeoutSecs = 3;
+    Batcher<> batcher;
+    batcher.Init(Json::Value(), flusher, strategy, enableGroupBatch);
+
+    vector<vector<PipelineEventGroup>> groups(threadCnt);
+    for (size_t i = 0; i < threadCnt; ++i) {
+        for (size_t j = 0; j < kGroupCntPerThread; ++j) {
+            string path = "/var/log/" + ToString(i) + "/" + ToString(j % fileCntPerThread) + ".log";
+            groups[i].emplace_back(CreateEventGroup(path, kEventCntPerGroup));
+        }
+    }
+
+    vector<thread> threads;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < threadCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            vector<BatchedEventsList> res;
+            for (auto& g : groups[i]) {
+                batcher.Add(std::move(g), res);
+                res.clear();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    vector<BatchedEventsList> res;
+    batcher.FlushAll(res);
+    cout << "threads: " << threadCnt << "\tfiles per thread: " << fileCntPerThread
+         << "\tgroup batch: " << enableGroupBatch
+         << "\tthroughput: " << threadCnt * kGroupCntPerThread * kEventCntPerGroup / elapsed << "M events/s" << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    PipelineContext ctx;
+    ctx.SetConfigName("benchmark_config");
+    FlusherMock flusher;
+    flusher.SetContext(ctx);
+    for (bool enableGroupBatch : {false, true}) {
+        for (size_t threadCnt : {1, 2, 4, 8}) {
+            BM_Add(&flusher, threadCnt, 4, enableGroupBatch);
+        }
+    }
+    TimeoutFlushManager::GetInstance()->ClearRecords("benchmark_config");
+    return 0;
+}
@@ -44,7 +44,7 @@ protected:
         sFlusher->SetMetricsRecordRef(FlusherMock::sName, "1");
     }
 
-    void TearDown() override { TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear(); }
+    void TearDown() override { TimeoutFlushManager::GetInstance()->ClearRecords("test_config"); }
 
 private:
     PipelineEventGroup CreateEventGroup(size_t cnt);
@@ -150,25 +150,25 @@ void BatcherUnittest::TestAddWithoutGroupBatch() {
     SourceBuffer* buffer1 = group1.GetSourceBuffer().get();
     RangeCheckpoint* eoo1 = group1.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group1), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(2U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(2U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(0U, res.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].size());
     TimeoutRecord& record = TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].at(make_pair(0, key));
-    time_t updateTime = record.mUpdateTime;
+    uint64_t updateTime = record.mUpdateTime;
     APSARA_TEST_EQUAL(3U, record.mTimeoutSecs);
     APSARA_TEST_EQUAL(sFlusher.get(), record.mFlusher);
     APSARA_TEST_EQUAL(key, record.mKey);
-    APSARA_TEST_GT(updateTime, 0);
+    APSARA_TEST_GT(updateTime, 0U);
 
     // flush by cnt && one batch item contains more than 1 original event group
     PipelineEventGroup group2 = CreateEventGroup(2);
     SourceBuffer* buffer2 = group2.GetSourceBuffer().get();
     RangeCheckpoint* eoo2 = group2.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group2), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(3U, res[0][0].mEvents.size());
@@ -190,8 +190,8 @@ void BatcherUnittest::TestAddWithoutGroupBatch() {
     SourceBuffer* buffer3 = group3.GetSourceBuffer().get();
     RangeCheckpoint* eoo3 = group3.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group3), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(2U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(1U, res[0][0].mEvents.size());
@@ -231,25 +231,25 @@ void BatcherUnittest::TestAddWithGroupBatch() {
     SourceBuffer* buffer1 = group1.GetSourceBuffer().get();
     RangeCheckpoint* eoo1 = group1.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group1), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(2U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(2U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(0U, res.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].size());
     TimeoutRecord& record = TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].at(make_pair(0, key));
-    time_t updateTime = record.mUpdateTime;
+    uint64_t updateTime = record.mUpdateTime;
     APSARA_TEST_EQUAL(2U, record.mTimeoutSecs);
     APSARA_TEST_EQUAL(sFlusher.get(), record.mFlusher);
     APSARA_TEST_EQUAL(key, record.mKey);
-    APSARA_TEST_GT(updateTime, 0);
+    APSARA_TEST_GT(updateTime, 0U);
 
     // flush by cnt && one batch item contains more than 1 original event group
     PipelineEventGroup group2 = CreateEventGroup(2);
     SourceBuffer* buffer2 = group2.GetSourceBuffer().get();
     RangeCheckpoint* eoo2 = group2.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group2), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(3U, res[0][0].mEvents.size());
@@ -271,8 +271,8 @@ void BatcherUnittest::TestAddWithGroupBatch() {
     RangeCheckpoint* eoo3 = group3.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group3), res);
     APSARA_TEST_EQUAL(0U, res.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueue(key).mBatch.mEvents.size());
 
     // flush by time to group batch, and then group flush by time
     batch.mGroupFlushStrategy->SetTimeoutSecs(0);
@@ -280,8 +280,8 @@ void BatcherUnittest::TestAddWithGroupBatch() {
     SourceBuffer* buffer4 = group4.GetSourceBuffer().get();
     RangeCheckpoint* eoo4 = group4.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group4), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(1U, res[0][0].mEvents.size());
@@ -302,8 +302,8 @@ void BatcherUnittest::TestAddWithGroupBatch() {
     SourceBuffer* buffer5 = group5.GetSourceBuffer().get();
     RangeCheckpoint* eoo5 = group5.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group5), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(2U, res[0].size());
     APSARA_TEST_EQUAL(1U, res[0][0].mEvents.size());
@@ -332,8 +332,8 @@ void BatcherUnittest::TestAddWithGroupBatch() {
     PipelineEventGroup group6 = CreateEventGroup(1);
     SourceBuffer* buffer6 = group6.GetSourceBuffer().get();
     batch.Add(std::move(group6), res);
-    APSARA_TEST_EQUAL(1U, batch.mEventQueueMap.size());
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap[key].mBatch.mEvents.size());
+    APSARA_TEST_EQUAL(1U, batch.GetEventQueueCnt());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueue(key).mBatch.mEvents.size());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(2U, res[0][0].mEvents.size());
@@ -371,7 +371,7 @@ void BatcherUnittest::TestFlushEventQueueWithoutGroupBatch() {
 
     // key existed
     batch.FlushQueue(key, res);
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap.size());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueueCnt());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(2U, res[0].mEvents.size());
     APSARA_TEST_EQUAL(1U, res[0].mTags.mInner.size());
@@ -400,16 +400,16 @@ void BatcherUnittest::TestFlushEventQueueWithGroupBatch() {
     RangeCheckpoint* eoo1 = group1.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group1), tmp);
     batch.FlushQueue(key, res);
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap.size());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueueCnt());
     APSARA_TEST_EQUAL(0U, res.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
     APSARA_TEST_EQUAL(2U, TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].size());
     TimeoutRecord& record = TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].at(make_pair(0, 0));
-    time_t updateTime = record.mUpdateTime;
+    uint64_t updateTime = record.mUpdateTime;
     APSARA_TEST_EQUAL(1U, record.mTimeoutSecs);
     APSARA_TEST_EQUAL(sFlusher.get(), record.mFlusher);
     APSARA_TEST_EQUAL(0U, record.mKey);
-    APSARA_TEST_GT(updateTime, 0);
+    APSARA_TEST_GT(updateTime, 0U);
     APSARA_TEST_EQUAL(1U, batch.mGroupQueue->mGroups.size());
 
     // flush to group item, and group is flushed by time then by size
@@ -420,7 +420,7 @@ void BatcherUnittest::TestFlushEventQueueWithGroupBatch() {
     RangeCheckpoint* eoo2 = group2.GetExactlyOnceCheckpoint().get();
     batch.Add(std::move(group2), tmp);
     batch.FlushQueue(key, res);
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap.size());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueueCnt());
     APSARA_TEST_EQUAL(2U, res.size());
     APSARA_TEST_EQUAL(2U, res[0].mEvents.size());
     APSARA_TEST_EQUAL(1U, res[0].mTags.mInner.size());
@@ -494,7 +494,7 @@ void BatcherUnittest::TestFlushAllWithoutGroupBatch() {
 
     vector<BatchedEventsList> res;
     batch.FlushAll(res);
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap.size());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueueCnt());
     APSARA_TEST_EQUAL(1U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(2U, res[0][0].mEvents.size());
@@ -539,7 +539,7 @@ void BatcherUnittest::TestFlushAllWithGroupBatch() {
     batch.mGroupFlushStrategy->SetMaxSizeBytes(10);
     vector<BatchedEventsList> res;
     batch.FlushAll(res);
-    APSARA_TEST_EQUAL(0U, batch.mEventQueueMap.size());
+    APSARA_TEST_EQUAL(0U, batch.GetEventQueueCnt());
     APSARA_TEST_EQUAL(2U, res.size());
     APSARA_TEST_EQUAL(1U, res[0].size());
     APSARA_TEST_EQUAL(2U, res[0][0].mEvents.size());
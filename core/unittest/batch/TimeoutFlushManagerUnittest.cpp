@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <map>
+#include <thread>
+
 #include "batch/TimeoutFlushManager.h"
 #include "unittest/Unittest.h"
 #include "unittest/plugin/PluginMock.h"
@@ -20,11 +24,37 @@ using namespace std;
 
 namespace logtail {
 
+static uint64_t GetSteadyTimeInMs() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// records when each queue is flushed by the flush thread
+class TimedFlusherMock : public FlusherMock {
+public:
+    void Flush(size_t key) override {
+        lock_guard<mutex> lock(mMux);
+        mFlushTimes[key] = GetSteadyTimeInMs();
+    }
+
+    map<size_t, uint64_t> GetFlushTimes() {
+        lock_guard<mutex> lock(mMux);
+        return mFlushTimes;
+    }
+
+private:
+    mutex mMux;
+    map<size_t, uint64_t> mFlushTimes;
+};
+
 class TimeoutFlushManagerUnittest : public ::testing::Test {
 public:
     void TestUpdateRecord();
     void TestFlushTimeoutBatch();
     void TestClearRecords();
+    void TestUpdateExistedRecord();
+    void TestFlushLongTimeout();
+    void TestFlushJitter();
+    void TestFlushEarlierRecord();
 
 protected:
     static void SetUpTestCase() {
@@ -34,9 +64,19 @@ protected:
         sFlusher->SetMetricsRecordRef(FlusherMock::sName, "1");
     }
 
-    void TearDown() override { TimeoutFlushManager::GetInstance()->mTimeoutRecords.clear(); }
+    void TearDown() override {
+        TimeoutFlushManager::GetInstance()->Stop();
+        TimeoutFlushManager::GetInstance()->ClearRecords("test_config");
+        sFlusher->mFlushedQueues.clear();
+    }
 
 private:
+    // upper bound of the delay between the expiry of a record and the flush, which should be far less than the
+    // resolution of the old second-level polling even on a loaded machine
+    static const uint64_t kMaxFlushDelayMs = 50;
+
+    void WaitForFlush(TimedFlusherMock& flusher, size_t cnt, uint64_t timeoutMs);
+
     static unique_ptr<FlusherMock> sFlusher;
     static PipelineContext sCtx;
 };
@@ -53,10 +93,10 @@ void TimeoutFlushManagerUnittest::TestUpdateRecord() {
     APSARA_TEST_EQUAL(1U, record1.mKey);
     APSARA_TEST_EQUAL(3U, record1.mTimeoutSecs);
     APSARA_TEST_EQUAL(sFlusher.get(), record1.mFlusher);
-    APSARA_TEST_GT(record1.mUpdateTime, 0);
+    APSARA_TEST_GT(record1.mUpdateTime, 0U);
 
     // existed batch queue
-    time_t lastTime = record1.mUpdateTime;
+    uint64_t lastTime = record1.mUpdateTime;
     TimeoutFlushManager::GetInstance()->UpdateRecord("test_config", 0, 1, 3, sFlusher.get());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].size());
@@ -72,9 +112,12 @@ void TimeoutFlushManagerUnittest::TestFlushTimeoutBatch() {
     TimeoutFlushManager::GetInstance()->UpdateRecord("test_config", 0, 1, 3, sFlusher.get());
     TimeoutFlushManager::GetInstance()->UpdateRecord("test_config", 0, 2, 0, sFlusher.get());
 
+    this_thread::sleep_for(chrono::milliseconds(2));
     TimeoutFlushManager::GetInstance()->FlushTimeoutBatch();
     APSARA_TEST_EQUAL(2U, sFlusher->mFlushedQueues.size()); // key 0 && 2
     APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
+    APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mTimeoutRecords["test_config"].size());
+    APSARA_TEST_EQUAL(1U, TimeoutFlushManager::GetInstance()->mRecordCnt);
 }
 
 void TimeoutFlushManagerUnittest::TestClearRecords() {
@@ -82,11 +125,106 @@ void TimeoutFlushManagerUnittest::TestClearRecords() {
     TimeoutFlushManager::GetInstance()->ClearRecords("test_config");
 
     APSARA_TEST_EQUAL(0U, TimeoutFlushManager::GetInstance()->mTimeoutRecords.size());
+    APSARA_TEST_EQUAL(0U, TimeoutFlushManager::GetInstance()->mRecordCnt);
+    APSARA_TEST_EQUAL(TimeoutFlushManager::kNoFlushTime, TimeoutFlushManager::GetInstance()->GetNextFlushTime());
+}
+
+void TimeoutFlushManagerUnittest::TestUpdateExistedRecord() {
+    auto manager = TimeoutFlushManager::GetInstance();
+    manager->UpdateRecord("test_config", 0, 1, 1, sFlusher.get());
+    uint64_t expireTime1 = manager->mTimeoutRecords["test_config"].at(make_pair(0, 1)).mExpireTime;
+    this_thread::sleep_for(chrono::milliseconds(5));
+    manager->UpdateRecord("test_config", 0, 1, 1, sFlusher.get());
+    uint64_t expireTime2 = manager->mTimeoutRecords["test_config"].at(make_pair(0, 1)).mExpireTime;
+    APSARA_TEST_GT(expireTime2, expireTime1);
+
+    // the record is moved to the new slot instead of being flushed at the old expire time
+    manager->FlushTimeoutBatch(expireTime1);
+    APSARA_TEST_EQUAL(0U, sFlusher->mFlushedQueues.size());
+    APSARA_TEST_EQUAL(1U, manager->mRecordCnt);
+    manager->FlushTimeoutBatch(expireTime2);
+    APSARA_TEST_EQUAL(1U, sFlusher->mFlushedQueues.size());
+    APSARA_TEST_EQUAL(0U, manager->mRecordCnt);
+}
+
+void TimeoutFlushManagerUnittest::TestFlushLongTimeout() {
+    auto manager = TimeoutFlushManager::GetInstance();
+    // each timeout falls into a different level of the wheel, and the last one is beyond the wheel
+    vector<uint32_t> timeouts = {1, 60, 3600, 86400};
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        manager->UpdateRecord("test_config", 0, i, timeouts[i], sFlusher.get());
+    }
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        uint64_t expireTime = manager->mTimeoutRecords["test_config"].at(make_pair(0, i)).mExpireTime;
+        manager->FlushTimeoutBatch(expireTime - 1);
+        APSARA_TEST_EQUAL(i, sFlusher->mFlushedQueues.size());
+        manager->FlushTimeoutBatch(expireTime);
+        APSARA_TEST_EQUAL(i + 1, sFlusher->mFlushedQueues.size());
+        APSARA_TEST_EQUAL(i, sFlusher->mFlushedQueues.back());
+    }
+    APSARA_TEST_EQUAL(0U, manager->mRecordCnt);
+}
+
+void TimeoutFlushManagerUnittest::TestFlushJitter() {
+    static const size_t kRecordCnt = 20;
+    TimedFlusherMock flusher;
+    flusher.SetContext(sCtx);
+    auto manager = TimeoutFlushManager::GetInstance();
+    manager->Init();
+
+    vector<uint64_t> minExpireTimes, maxExpireTimes;
+    for (size_t i = 0; i < kRecordCnt; ++i) {
+        minExpireTimes.push_back(GetSteadyTimeInMs() + 1000);
+        manager->UpdateRecord("test_config", 0, i, 1, &flusher);
+        maxExpireTimes.push_back(GetSteadyTimeInMs() + 1000);
+        this_thread::sleep_for(chrono::milliseconds(23));
+    }
+    WaitForFlush(flusher, kRecordCnt, 3000);
+
+    auto flushTimes = flusher.GetFlushTimes();
+    APSARA_TEST_EQUAL_FATAL(kRecordCnt, flushTimes.size());
+    for (size_t i = 0; i < kRecordCnt; ++i) {
+        APSARA_TEST_TRUE(flushTimes[i] >= minExpireTimes[i]);
+        APSARA_TEST_TRUE(flushTimes[i] <= maxExpireTimes[i] + kMaxFlushDelayMs);
+    }
+    APSARA_TEST_EQUAL(0U, manager->mRecordCnt);
+}
+
+void TimeoutFlushManagerUnittest::TestFlushEarlierRecord() {
+    TimedFlusherMock flusher;
+    flusher.SetContext(sCtx);
+    auto manager = TimeoutFlushManager::GetInstance();
+    manager->Init();
+
+    // the flush thread is sleeping for the first record when the second one comes
+    manager->UpdateRecord("test_config", 0, 1, 3, &flusher);
+    this_thread::sleep_for(chrono::milliseconds(10));
+    uint64_t minExpireTime = GetSteadyTimeInMs() + 1000;
+    manager->UpdateRecord("test_config", 0, 2, 1, &flusher);
+    uint64_t maxExpireTime = GetSteadyTimeInMs() + 1000;
+    WaitForFlush(flusher, 1, 2000);
+
+    auto flushTimes = flusher.GetFlushTimes();
+    APSARA_TEST_EQUAL_FATAL(1U, flushTimes.size());
+    APSARA_TEST_EQUAL(1U, flushTimes.count(2));
+    APSARA_TEST_TRUE(flushTimes[2] >= minExpireTime);
+    APSARA_TEST_TRUE(flushTimes[2] <= maxExpireTime + kMaxFlushDelayMs);
+}
+
+void TimeoutFlushManagerUnittest::WaitForFlush(TimedFlusherMock& flusher, size_t cnt, uint64_t timeoutMs) {
+    uint64_t startTime = GetSteadyTimeInMs();
+    while (flusher.GetFlushTimes().size() < cnt && GetSteadyTimeInMs() - startTime < timeoutMs) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
 }
 
 UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestUpdateRecord)
 UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestFlushTimeoutBatch)
 UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestClearRecords)
+UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestUpdateExistedRecord)
+UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestFlushLongTimeout)
+UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestFlushJitter)
+UNIT_TEST_CASE(TimeoutFlushManagerUnittest, TestFlushEarlierRecord)
 
 } // namespace logtail
 
@@ -16,8 +16,11 @@
 #include "checkpoint/CheckPointManager.h"
 #include "common/FileSystemUtil.h"
 #include "common/Flags.h"
+#include "common/StringTools.h"
 
 DECLARE_FLAG_INT32(checkpoint_find_max_file_count);
+DECLARE_FLAG_INT32(checkpoint_log_min_compact_size);
+DECLARE_FLAG_BOOL(enable_binary_checkpoint);
 
 namespace logtail {
 
@@ -35,9 +38,19 @@ public:
     static void TearDownTestCase() { bfs::remove_all(kTestRootDir); }
 
     void TestSearchFilePathByDevInodeInDirectory();
+    void TestCheckPointLogStore();
+    void TestCheckPointLogStoreCompaction();
+    void TestCheckPointLogStoreBrokenTail();
+    void TestBinaryCheckPoint();
+    void TestMigrateJsonCheckPoint();
 };
 
 UNIT_TEST_CASE(CheckpointManagerUnittest, TestSearchFilePathByDevInodeInDirectory);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestCheckPointLogStore);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestCheckPointLogStoreCompaction);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestCheckPointLogStoreBrokenTail);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestBinaryCheckPoint);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestMigrateJsonCheckPoint);
 
 void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     const std::string kRotateFileName = "test.log.5";
@@ -96,6 +109,314 @@ void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     }
 }
 
+void CheckpointManagerUnittest::TestCheckPointLogStore() {
+    const std::string kFilePath = (bfs::path(kTestRootDir) / "store.bin").string();
+    bfs::remove(kFilePath);
+    {
+        CheckPointLogStore store;
+        store.SetFilePath(kFilePath);
+        std::unordered_map<std::string, std::string> records;
+        int32_t version = 0;
+        APSARA_TEST_FALSE(store.Load(records, version));
+
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_TRUE(store.IsCompacting());
+        // records cannot be kept when the log is rewritten
+        APSARA_TEST_FALSE(store.Keep("key1"));
+        APSARA_TEST_TRUE(store.Put("key1", "value1"));
+        APSARA_TEST_TRUE(store.Put("key2", "value2"));
+        APSARA_TEST_TRUE(store.Put("key3", "value3"));
+        APSARA_TEST_TRUE(store.EndDump());
+        size_t fileSize = store.GetFileSize();
+        APSARA_TEST_EQUAL(fileSize, bfs::file_size(kFilePath));
+
+        // kept records are not appended
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_FALSE(store.IsCompacting());
+        APSARA_TEST_TRUE(store.Keep("key1"));
+        APSARA_TEST_TRUE(store.Keep("key2"));
+        APSARA_TEST_TRUE(store.Keep("key3"));
+        APSARA_TEST_FALSE(store.Keep("key4"));
+        APSARA_TEST_TRUE(store.EndDump());
+        APSARA_TEST_EQUAL(fileSize, store.GetFileSize());
+        APSARA_TEST_EQUAL(fileSize, bfs::file_size(kFilePath));
+
+        // changed records are appended, and records neither put nor kept are deleted
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_TRUE(store.Keep("key1"));
+        APSARA_TEST_TRUE(store.Put("key2", "new_value2"));
+        APSARA_TEST_TRUE(store.Put("key4", "value4"));
+        APSARA_TEST_TRUE(store.EndDump());
+        APSARA_TEST_TRUE(store.GetFileSize() > fileSize);
+        APSARA_TEST_EQUAL(store.GetFileSize(), bfs::file_size(kFilePath));
+    }
+    {
+        CheckPointLogStore store;
+        store.SetFilePath(kFilePath);
+        std::unordered_map<std::string, std::string> records;
+        int32_t version = 0;
+        APSARA_TEST_TRUE(store.Load(records, version));
+        APSARA_TEST_EQUAL(1, version);
+        APSARA_TEST_EQUAL(3U, records.size());
+        APSARA_TEST_EQUAL("value1", records["key1"]);
+        APSARA_TEST_EQUAL("new_value2", records["key2"]);
+        APSARA_TEST_EQUAL("value4", records["key4"]);
+
+        // records loaded are known to the store
+        size_t fileSize = store.GetFileSize();
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_FALSE(store.IsCompacting());
+        APSARA_TEST_TRUE(store.Keep("key1"));
+        APSARA_TEST_TRUE(store.Keep("key2"));
+        APSARA_TEST_TRUE(store.Keep("key4"));
+        APSARA_TEST_TRUE(store.EndDump());
+        APSARA_TEST_EQUAL(fileSize, store.GetFileSize());
+
+        // incremental dumps only append changed records, and leave the others as they are
+        APSARA_TEST_TRUE(store.BeginIncrementalDump(1));
+        APSARA_TEST_TRUE(store.Put("key5", "value5"));
+        APSARA_TEST_TRUE(store.Delete("key2"));
+        APSARA_TEST_TRUE(store.EndDump());
+        APSARA_TEST_TRUE(store.GetFileSize() > fileSize);
+        APSARA_TEST_EQUAL(store.GetFileSize(), bfs::file_size(kFilePath));
+        CheckPointLogStore newStore;
+        newStore.SetFilePath(kFilePath);
+        records.clear();
+        APSARA_TEST_TRUE(newStore.Load(records, version));
+        APSARA_TEST_EQUAL(3U, records.size());
+        APSARA_TEST_EQUAL("value1", records["key1"]);
+        APSARA_TEST_EQUAL("value4", records["key4"]);
+        APSARA_TEST_EQUAL("value5", records["key5"]);
+
+        // the log to be compacted requires a full dump
+        APSARA_TEST_FALSE(store.BeginIncrementalDump(2));
+
+        store.Remove();
+        APSARA_TEST_FALSE(store.Exists());
+    }
+}
+
+void CheckpointManagerUnittest::TestCheckPointLogStoreCompaction() {
+    const std::string kFilePath = (bfs::path(kTestRootDir) / "store.bin").string();
+    bfs::remove(kFilePath);
+    auto bakSize = INT32_FLAG(checkpoint_log_min_compact_size);
+    INT32_FLAG(checkpoint_log_min_compact_size) = 0;
+
+    CheckPointLogStore store;
+    store.SetFilePath(kFilePath);
+    APSARA_TEST_TRUE(store.BeginDump(1));
+    APSARA_TEST_TRUE(store.Put("key", "value0"));
+    APSARA_TEST_TRUE(store.EndDump());
+    size_t fileSize = store.GetFileSize();
+    for (int i = 1; i <= 3; ++i) {
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_TRUE(store.Put("key", "value" + ToString(i)));
+        APSARA_TEST_TRUE(store.EndDump());
+    }
+    // the log is rewritten once it is larger than twice of the live records
+    APSARA_TEST_TRUE(store.GetFileSize() < fileSize * 3);
+    APSARA_TEST_EQUAL(store.GetFileSize(), bfs::file_size(kFilePath));
+    APSARA_TEST_FALSE(bfs::exists(kFilePath + ".tmp"));
+
+    // version change leads to compaction
+    APSARA_TEST_TRUE(store.BeginDump(2));
+    APSARA_TEST_TRUE(store.IsCompacting());
+    APSARA_TEST_TRUE(store.Put("key", "value3"));
+    APSARA_TEST_TRUE(store.EndDump());
+    APSARA_TEST_EQUAL(fileSize, store.GetFileSize());
+
+    std::unordered_map<std::string, std::string> records;
+    int32_t version = 0;
+    CheckPointLogStore newStore;
+    newStore.SetFilePath(kFilePath);
+    APSARA_TEST_TRUE(newStore.Load(records, version));
+    APSARA_TEST_EQUAL(2, version);
+    APSARA_TEST_EQUAL(1U, records.size());
+    APSARA_TEST_EQUAL("value3", records["key"]);
+
+    INT32_FLAG(checkpoint_log_min_compact_size) = bakSize;
+    bfs::remove(kFilePath);
+}
+
+void CheckpointManagerUnittest::TestCheckPointLogStoreBrokenTail() {
+    const std::string kFilePath = (bfs::path(kTestRootDir) / "store.bin").string();
+    bfs::remove(kFilePath);
+    size_t validSize = 0;
+    {
+        CheckPointLogStore store;
+        store.SetFilePath(kFilePath);
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_TRUE(store.Put("key1", "value1"));
+        APSARA_TEST_TRUE(store.EndDump());
+        validSize = store.GetFileSize();
+        APSARA_TEST_TRUE(store.BeginDump(1));
+        APSARA_TEST_TRUE(store.Keep("key1"));
+        APSARA_TEST_TRUE(store.Put("key2", "value2"));
+        APSARA_TEST_TRUE(store.EndDump());
+    }
+    // simulate a partial write
+    bfs::resize_file(kFilePath, bfs::file_size(kFilePath) - 3);
+
+    CheckPointLogStore store;
+    store.SetFilePath(kFilePath);
+    std::unordered_map<std::string, std::string> records;
+    int32_t version = 0;
+    APSARA_TEST_TRUE(store.Load(records, version));
+    APSARA_TEST_EQUAL(1U, records.size());
+    APSARA_TEST_EQUAL("value1", records["key1"]);
+    APSARA_TEST_EQUAL(validSize, store.GetFileSize());
+
+    // the broken log is rewritten on next dump
+    APSARA_TEST_TRUE(store.BeginDump(1));
+    APSARA_TEST_TRUE(store.IsCompacting());
+    APSARA_TEST_TRUE(store.Put("key1", "value1"));
+    APSARA_TEST_TRUE(store.EndDump());
+    APSARA_TEST_EQUAL(validSize, bfs::file_size(kFilePath));
+    bfs::remove(kFilePath);
+}
+
+void CheckpointManagerUnittest::TestBinaryCheckPoint() {
+    auto bakFlag = BOOL_FLAG(enable_binary_checkpoint);
+    BOOL_FLAG(enable_binary_checkpoint) = true;
+    AppConfig::GetInstance()->mCheckPointFilePath = (bfs::path(kTestRootDir) / "logtail_check_point").string();
+    CheckPointManager* manager = CheckPointManager::Instance();
+    manager->RemoveAllCheckPoint();
+
+    // record header, op, key size, key 't' and the dump time
+    const size_t kDumpTimeRecordSize = 4 + 4 + 1 + 4 + 1 + 4;
+
+    DevInode devInode(1, 2);
+    CheckPoint* cpt = new CheckPoint(
+        "/var/log/test.log", 100, 1024, 12345, devInode, "config", "/var/log/real.log", true, false, true);
+    cpt->mLastUpdateTime = 1000;
+    manager->AddCheckPoint(cpt);
+    manager->AddDirCheckPoint("/var/log");
+    // dir checkpoints are not rewritten on each dump, so they are regarded as updated at the dump time
+    manager->mDirNameMap["/var"]->mUpdateTime = 0;
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(manager->GetBinaryCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    size_t fileSize = bfs::file_size(manager->GetBinaryCheckPointFilePath());
+
+    // nothing changed, only the dump time is written
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    fileSize += kDumpTimeRecordSize;
+    APSARA_TEST_EQUAL(fileSize, bfs::file_size(manager->GetBinaryCheckPointFilePath()));
+
+    // dirs added again are not written if their sub dirs are unchanged
+    manager->AddDirCheckPoint("/var/log");
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    fileSize += kDumpTimeRecordSize;
+    APSARA_TEST_EQUAL(fileSize, bfs::file_size(manager->GetBinaryCheckPointFilePath()));
+
+    // checkpoints added again by readers are not written if unchanged
+    CheckPoint* sameCpt = new CheckPoint(
+        "/var/log/test.log", 100, 1024, 12345, devInode, "config", "/var/log/real.log", true, false, true);
+    sameCpt->mLastUpdateTime = 1000;
+    manager->AddCheckPoint(sameCpt);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    fileSize += kDumpTimeRecordSize;
+    APSARA_TEST_EQUAL(fileSize, bfs::file_size(manager->GetBinaryCheckPointFilePath()));
+
+    // while changed ones are
+    CheckPoint* changedCpt = new CheckPoint(
+        "/var/log/test.log", 200, 1024, 12345, devInode, "config", "/var/log/real.log", true, false, true);
+    changedCpt->mLastUpdateTime = 1000;
+    manager->AddCheckPoint(changedCpt);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::file_size(manager->GetBinaryCheckPointFilePath()) > fileSize);
+
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    CheckPointPtr res;
+    APSARA_TEST_TRUE(manager->GetCheckPoint(devInode, "config", res));
+    APSARA_TEST_EQUAL("/var/log/test.log", res->mFileName);
+    APSARA_TEST_EQUAL("/var/log/real.log", res->mRealFileName);
+    APSARA_TEST_EQUAL(200, res->mOffset);
+    APSARA_TEST_EQUAL(1024U, res->mSignatureSize);
+    APSARA_TEST_EQUAL(12345U, res->mSignatureHash);
+    APSARA_TEST_EQUAL(1000, res->mLastUpdateTime);
+    APSARA_TEST_TRUE(res->mFileOpenFlag);
+    APSARA_TEST_FALSE(res->mContainerStopped);
+    APSARA_TEST_TRUE(res->mLastForceRead);
+    DirCheckPointPtr dirRes;
+    APSARA_TEST_TRUE(manager->GetDirCheckPoint("/var", dirRes));
+    APSARA_TEST_EQUAL(1U, dirRes->mSubDir.count("/var/log"));
+
+    // deleted checkpoints are not loaded
+    manager->DeleteCheckPoint(devInode, "config");
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    APSARA_TEST_FALSE(manager->GetCheckPoint(devInode, "config", res));
+    APSARA_TEST_TRUE(manager->GetDirCheckPoint("/var", dirRes));
+
+    // checkpoints not reported for a dump interval and sub dirs no longer watched are removed
+    manager->AddCheckPoint(new CheckPoint(
+        "/var/log/test.log", 300, 1024, 12345, devInode, "config", "/var/log/real.log", true, false, true));
+    DevInode staleDevInode(1, 3);
+    CheckPoint* staleCpt = new CheckPoint(
+        "/var/log/stale.log", 100, 1024, 12345, staleDevInode, "config", "/var/log/stale.log", false, false, false);
+    manager->AddCheckPoint(staleCpt);
+    staleCpt->mRefreshTime = 0;
+    manager->AddDirCheckPoint("/var/tmp");
+    manager->mLastCheckTime = 0;
+    manager->RemoveStaleCheckPoint(time(NULL), [](const std::string& path) { return path == "/var/log"; });
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    APSARA_TEST_TRUE(manager->GetCheckPoint(devInode, "config", res));
+    APSARA_TEST_EQUAL(300, res->mOffset);
+    APSARA_TEST_FALSE(manager->GetCheckPoint(staleDevInode, "config", res));
+    APSARA_TEST_TRUE(manager->GetDirCheckPoint("/var", dirRes));
+    APSARA_TEST_EQUAL(1U, dirRes->mSubDir.size());
+    APSARA_TEST_EQUAL(1U, dirRes->mSubDir.count("/var/log"));
+
+    manager->RemoveAllCheckPoint();
+    manager->mCheckPointLogStore.Remove();
+    BOOL_FLAG(enable_binary_checkpoint) = bakFlag;
+}
+
+void CheckpointManagerUnittest::TestMigrateJsonCheckPoint() {
+    auto bakFlag = BOOL_FLAG(enable_binary_checkpoint);
+    AppConfig::GetInstance()->mCheckPointFilePath = (bfs::path(kTestRootDir) / "logtail_check_point").string();
+    CheckPointManager* manager = CheckPointManager::Instance();
+    manager->RemoveAllCheckPoint();
+
+    DevInode devInode(1, 2);
+    manager->AddCheckPoint(new CheckPoint(
+        "/var/log/test.log", 100, 1024, 12345, devInode, "config", "/var/log/test.log", false, false, false));
+    BOOL_FLAG(enable_binary_checkpoint) = false;
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(manager->GetBinaryCheckPointFilePath()));
+
+    // json checkpoint is loaded when binary checkpoint does not exist, and replaced on next dump
+    BOOL_FLAG(enable_binary_checkpoint) = true;
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    CheckPointPtr res;
+    APSARA_TEST_TRUE(manager->GetCheckPoint(devInode, "config", res));
+    APSARA_TEST_EQUAL(100, res->mOffset);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(manager->GetBinaryCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+
+    // and vice versa
+    BOOL_FLAG(enable_binary_checkpoint) = false;
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    APSARA_TEST_TRUE(manager->GetCheckPoint(devInode, "config", res));
+    APSARA_TEST_EQUAL(100, res->mOffset);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(manager->GetBinaryCheckPointFilePath()));
+
+    manager->RemoveAllCheckPoint();
+    bfs::remove(AppConfig::GetInstance()->GetCheckPointFilePath());
+    BOOL_FLAG(enable_binary_checkpoint) = bakFlag;
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
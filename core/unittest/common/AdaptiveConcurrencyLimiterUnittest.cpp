@@ -0,0 +1,227 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+#include "common/AdaptiveConcurrencyLimiter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Mock server processing at most capacity requests at the same time, and the others queue up. Requests exceeding
+// the quota fail immediately. Time is simulated, so that the result is deterministic.
+class MockServer {
+public:
+    struct Result {
+        int64_t mSendTime;
+        int64_t mDoneTime;
+        bool mQuotaExceed;
+
+        bool operator>(const Result& rhs) const { return mDoneTime > rhs.mDoneTime; }
+    };
+
+    MockServer(int32_t capacity, int64_t latencyInUs, int32_t quota)
+        : mCapacity(capacity), mLatency(latencyInUs), mQuota(quota) {}
+
+    void Send(int64_t curTime) {
+        ++mInFlight;
+        if (mQuota > 0 && mInFlight > mQuota) {
+            mResults.push({curTime, curTime + mLatency, true});
+            return;
+        }
+        int64_t latency = static_cast<int64_t>(mLatency * max(1.0, static_cast<double>(mInFlight) / mCapacity));
+        mResults.push({curTime, curTime + latency, false});
+    }
+
+    Result Receive() {
+        Result res = mResults.top();
+        mResults.pop();
+        --mInFlight;
+        return res;
+    }
+
+    void SetCapacity(int32_t capacity) { mCapacity = capacity; }
+
+private:
+    int32_t mCapacity;
+    const int64_t mLatency;
+    const int32_t mQuota;
+    int32_t mInFlight = 0;
+    priority_queue<Result, vector<Result>, greater<Result>> mResults;
+};
+
+class AdaptiveConcurrencyLimiterUnittest : public ::testing::Test {
+public:
+    void TestInFlight();
+    void TestOverload();
+    void TestLatencyGradient();
+    void TestSimulateCongestion();
+    void TestSimulateThrottling();
+    void TestSimulateRecovery();
+
+private:
+    struct SimulationResult {
+        double mAvgLimit = 0;
+        double mThroughput = 0;
+        size_t mQuotaExceedCnt = 0;
+    };
+
+    // the client always has data to send, and the stats are collected in the second half of the requests
+    SimulationResult Simulate(AdaptiveConcurrencyLimiter& limiter, MockServer& server, size_t requestCnt);
+
+    int64_t mCurTime = 0;
+};
+
+void AdaptiveConcurrencyLimiterUnittest::TestInFlight() {
+    AdaptiveConcurrencyLimiter limiter(1, 4);
+    APSARA_TEST_EQUAL(4, limiter.GetLimit());
+    APSARA_TEST_EQUAL(4, limiter.GetAvailable());
+    limiter.OnSendStart(3);
+    APSARA_TEST_TRUE(limiter.IsValidToSend());
+    APSARA_TEST_EQUAL(1, limiter.GetAvailable());
+    limiter.OnSendStart();
+    APSARA_TEST_FALSE(limiter.IsValidToSend());
+    APSARA_TEST_EQUAL(0, limiter.GetAvailable());
+    limiter.OnSendDone(false, 0);
+    APSARA_TEST_TRUE(limiter.IsValidToSend());
+    APSARA_TEST_EQUAL(3, limiter.GetInFlight());
+
+    // requests not counted
+    for (int i = 0; i < 5; ++i) {
+        limiter.OnSendDone(false, 0);
+    }
+    APSARA_TEST_EQUAL(0, limiter.GetInFlight());
+
+    limiter.SetLimitRange(1, 2);
+    APSARA_TEST_EQUAL(2, limiter.GetLimit());
+    limiter.SetLimitRange(0, 0);
+    APSARA_TEST_EQUAL(1, limiter.GetLimit());
+}
+
+void AdaptiveConcurrencyLimiterUnittest::TestOverload() {
+    AdaptiveConcurrencyLimiter limiter(2, 64);
+    limiter.OnSendStart();
+    limiter.OnSendDone(true, 10000);
+    limiter.OnOverload(1000000);
+    APSARA_TEST_EQUAL(32, limiter.GetLimit());
+    // failures within one round trip are regarded as one
+    limiter.OnOverload(1005000);
+    APSARA_TEST_EQUAL(32, limiter.GetLimit());
+    limiter.OnOverload(1010000);
+    APSARA_TEST_EQUAL(16, limiter.GetLimit());
+    for (int i = 0; i < 10; ++i) {
+        limiter.OnOverload(2000000 + i * 100000);
+    }
+    APSARA_TEST_EQUAL(2, limiter.GetLimit());
+}
+
+void AdaptiveConcurrencyLimiterUnittest::TestLatencyGradient() {
+    AdaptiveConcurrencyLimiter limiter(1, 100);
+    // latency within tolerance, and the limit is not used up
+    for (int i = 0; i < 200; ++i) {
+        limiter.OnSendDone(true, 10000);
+    }
+    APSARA_TEST_EQUAL(100, limiter.GetLimit());
+    // latency doubled, the limit is decreased once per round
+    for (int i = 0; i < 99; ++i) {
+        limiter.OnSendDone(true, 20000);
+    }
+    APSARA_TEST_EQUAL(100, limiter.GetLimit());
+    limiter.OnSendDone(true, 20000);
+    APSARA_TEST_EQUAL(75, limiter.GetLimit());
+    // latency back to normal, and the limit is used up
+    limiter.OnSendStart(75);
+    for (int i = 0; i < 75; ++i) {
+        limiter.OnSendStart();
+        limiter.OnSendDone(true, 10000);
+    }
+    APSARA_TEST_TRUE(limiter.GetLimit() > 75);
+}
+
+AdaptiveConcurrencyLimiterUnittest::SimulationResult AdaptiveConcurrencyLimiterUnittest::Simulate(
+    AdaptiveConcurrencyLimiter& limiter, MockServer& server, size_t requestCnt) {
+    SimulationResult res;
+    int64_t startTime = 0;
+    double limitSum = 0;
+    for (size_t i = 0; i < requestCnt; ++i) {
+        while (limiter.IsValidToSend()) {
+            limiter.OnSendStart();
+            server.Send(mCurTime);
+        }
+        MockServer::Result rst = server.Receive();
+        mCurTime = rst.mDoneTime;
+        if (rst.mQuotaExceed) {
+            limiter.OnOverload(mCurTime);
+        }
+        limiter.OnSendDone(!rst.mQuotaExceed, rst.mDoneTime - rst.mSendTime);
+        if (i == requestCnt / 2) {
+            startTime = mCurTime;
+        } else if (i > requestCnt / 2) {
+            limitSum += limiter.GetLimit();
+            res.mQuotaExceedCnt += rst.mQuotaExceed;
+        }
+    }
+    size_t sampleCnt = requestCnt - requestCnt / 2 - 1;
+    res.mAvgLimit = limitSum / sampleCnt;
+    res.mThroughput = sampleCnt * 1000000.0 / (mCurTime - startTime);
+    return res;
+}
+
+void AdaptiveConcurrencyLimiterUnittest::TestSimulateCongestion() {
+    // the server can serve 3200 requests per second at most
+    AdaptiveConcurrencyLimiter limiter(1, 512);
+    MockServer server(32, 10000, 0);
+    SimulationResult res = Simulate(limiter, server, 50000);
+    APSARA_TEST_TRUE(res.mAvgLimit >= 32);
+    APSARA_TEST_TRUE(res.mAvgLimit <= 64);
+    APSARA_TEST_TRUE(res.mThroughput >= 3000);
+}
+
+void AdaptiveConcurrencyLimiterUnittest::TestSimulateThrottling() {
+    // the server can serve 6400 requests per second at most under the quota
+    AdaptiveConcurrencyLimiter limiter(1, 512);
+    MockServer server(128, 10000, 64);
+    SimulationResult res = Simulate(limiter, server, 50000);
+    APSARA_TEST_TRUE(res.mAvgLimit <= 64);
+    APSARA_TEST_TRUE(res.mThroughput >= 3200);
+    APSARA_TEST_TRUE(res.mQuotaExceedCnt < 25000 / 20);
+}
+
+void AdaptiveConcurrencyLimiterUnittest::TestSimulateRecovery() {
+    AdaptiveConcurrencyLimiter limiter(1, 512);
+    MockServer server(4, 10000, 0);
+    SimulationResult res = Simulate(limiter, server, 10000);
+    APSARA_TEST_TRUE(res.mAvgLimit <= 8);
+    // the server is scaled out
+    server.SetCapacity(64);
+    res = Simulate(limiter, server, 100000);
+    APSARA_TEST_TRUE(res.mAvgLimit >= 64);
+    APSARA_TEST_TRUE(res.mThroughput >= 6000);
+}
+
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestInFlight)
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestOverload)
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestLatencyGradient)
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestSimulateCongestion)
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestSimulateThrottling)
+UNIT_TEST_CASE(AdaptiveConcurrencyLimiterUnittest, TestSimulateRecovery)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
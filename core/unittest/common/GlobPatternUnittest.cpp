@@ -0,0 +1,105 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fnmatch.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/GlobPattern.h"
+#include "common/StringTools.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class GlobPatternUnittest : public testing::Test {
+public:
+    void TestMatch();
+    void TestMatchPathName();
+    void TestFallbackToFnmatch();
+    void TestConsistentWithFnmatch();
+};
+
+void GlobPatternUnittest::TestMatch() {
+    APSARA_TEST_TRUE(GlobPattern("", false).Match(""));
+    APSARA_TEST_FALSE(GlobPattern("", false).Match("a"));
+    APSARA_TEST_TRUE(GlobPattern("a.log", false).Match("a.log"));
+    APSARA_TEST_FALSE(GlobPattern("a.log", false).Match("a.log.1"));
+    APSARA_TEST_TRUE(GlobPattern("*", false).Match(""));
+    APSARA_TEST_TRUE(GlobPattern("*", false).Match("a/b"));
+    APSARA_TEST_TRUE(GlobPattern("*.log", false).Match(".log"));
+    APSARA_TEST_TRUE(GlobPattern("*.log", false).Match("a.log.log"));
+    APSARA_TEST_FALSE(GlobPattern("*.log", false).Match("a.log.1"));
+    APSARA_TEST_TRUE(GlobPattern("a?c*", false).Match("abc"));
+    APSARA_TEST_FALSE(GlobPattern("a?c*", false).Match("ac"));
+    APSARA_TEST_TRUE(GlobPattern("*a*b*", false).Match("xaxxbx"));
+    APSARA_TEST_FALSE(GlobPattern("*a*b*", false).Match("xbxxax"));
+    APSARA_TEST_TRUE(GlobPattern("a*?", false).Match("a*b"));
+    APSARA_TEST_EQUAL("*.log", GlobPattern("*.log", false).GetPattern());
+}
+
+void GlobPatternUnittest::TestMatchPathName() {
+    GlobPattern pattern("/var/*/app?", true);
+    APSARA_TEST_TRUE(pattern.Match("/var/log/app1"));
+    APSARA_TEST_FALSE(pattern.Match("/var/log/sub/app1"));
+    APSARA_TEST_FALSE(pattern.Match("/var/log/app1/"));
+    APSARA_TEST_FALSE(pattern.Match("/var/log/app/"));
+    APSARA_TEST_FALSE(GlobPattern("/var?log", true).Match("/var/log"));
+    APSARA_TEST_TRUE(GlobPattern("/var/log/*", true).Match("/var/log/"));
+    APSARA_TEST_TRUE(GlobPattern("/var/*/", true).Match("/var/log/"));
+    APSARA_TEST_TRUE(GlobPattern("/var/log", true).Match("/var/log"));
+    // ** is the same as * with FNM_PATHNAME
+    APSARA_TEST_FALSE(GlobPattern("/var/**", true).Match("/var/log/app"));
+    APSARA_TEST_TRUE(GlobPattern("/var/**", false).Match("/var/log/app"));
+}
+
+void GlobPatternUnittest::TestFallbackToFnmatch() {
+    APSARA_TEST_TRUE(GlobPattern("a[0-9].log", false).Match("a1.log"));
+    APSARA_TEST_FALSE(GlobPattern("a[!0-9].log", false).Match("a1.log"));
+    APSARA_TEST_TRUE(GlobPattern("a\\*.log", false).Match("a*.log"));
+    APSARA_TEST_FALSE(GlobPattern("a\\*.log", false).Match("ab.log"));
+    APSARA_TEST_FALSE(GlobPattern("/var/[a/]b", true).Match("/var/a/b"));
+}
+
+void GlobPatternUnittest::TestConsistentWithFnmatch() {
+    static const char kPatternChars[] = "ab/*?";
+    static const char kStrChars[] = "ab/*";
+    mt19937 gen(0);
+    for (size_t i = 0; i < 100000; ++i) {
+        string pattern, str;
+        for (size_t len = gen() % 8; len > 0; --len) {
+            pattern += kPatternChars[gen() % (sizeof(kPatternChars) - 1)];
+        }
+        for (size_t len = gen() % 10; len > 0; --len) {
+            str += kStrChars[gen() % (sizeof(kStrChars) - 1)];
+        }
+        for (bool matchPathName : {false, true}) {
+            bool expected = fnmatch(pattern.c_str(), str.c_str(), matchPathName ? FNM_PATHNAME : 0) == 0;
+            APSARA_TEST_TRUE_DESC(expected == GlobPattern(pattern, matchPathName).Match(str),
+                                  pattern + " " + str + " " + ToString(matchPathName));
+        }
+    }
+}
+
+UNIT_TEST_CASE(GlobPatternUnittest, TestMatch)
+UNIT_TEST_CASE(GlobPatternUnittest, TestMatchPathName)
+UNIT_TEST_CASE(GlobPatternUnittest, TestFallbackToFnmatch)
+UNIT_TEST_CASE(GlobPatternUnittest, TestConsistentWithFnmatch)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,290 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/JsonScanner.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+using KeyValues = vector<pair<string, string>>;
+
+static const SimdLevel kAllLevels[] = {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2};
+
+class JsonScannerUnittest : public testing::Test {
+public:
+    void TestScan();
+    void TestScanUnsupported();
+    void TestScanEscaped();
+    void TestUnescape();
+    void TestScanRandom();
+
+private:
+    // returns unescaped key value pairs, or false if not supported
+    static bool ScanAndUnescape(JsonScanner& scanner, const string& data, KeyValues& res);
+};
+
+bool JsonScannerUnittest::ScanAndUnescape(JsonScanner& scanner, const string& data, KeyValues& res) {
+    res.clear();
+    vector<JsonScanner::Field> fields;
+    if (!scanner.Scan(data, fields)) {
+        return false;
+    }
+    for (const auto& field : fields) {
+        string key = field.mKey.to_string(), value = field.mValue.to_string();
+        size_t size = 0;
+        if (field.mKeyEscaped) {
+            if (!JsonScanner::Unescape(field.mKey, &key[0], size)) {
+                return false;
+            }
+            key.resize(size);
+        }
+        if (field.mValueEscaped) {
+            if (!JsonScanner::Unescape(field.mValue, &value[0], size)) {
+                return false;
+            }
+            value.resize(size);
+        }
+        res.emplace_back(key, value);
+    }
+    return true;
+}
+
+void JsonScannerUnittest::TestScan() {
+    for (SimdLevel level : kAllLevels) {
+        JsonScanner scanner(level);
+        KeyValues res;
+
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, R"({"a":"b","c":"d"})", res));
+        APSARA_TEST_EQUAL(KeyValues({{"a", "b"}, {"c", "d"}}), res);
+
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, " \t{ \"a\" :\n\"\" , \"\":\"x\" }\r\n", res));
+        APSARA_TEST_EQUAL(KeyValues({{"a", ""}, {"", "x"}}), res);
+
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, "{}", res));
+        APSARA_TEST_TRUE(res.empty());
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, " { } ", res));
+        APSARA_TEST_TRUE(res.empty());
+
+        // literals are kept as they are, except null
+        APSARA_TEST_TRUE(ScanAndUnescape(
+            scanner, R"({"i":0,"n":-123,"big":123456789012345678,"t":true,"f": false ,"null":null})", res));
+        KeyValues expected
+            = {{"i", "0"}, {"n", "-123"}, {"big", "123456789012345678"}, {"t", "true"}, {"f", "false"}, {"null", ""}};
+        APSARA_TEST_EQUAL(expected, res);
+
+        // structural chars in strings
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, R"({"{[":"]}:,","k":"v"})", res));
+        APSARA_TEST_EQUAL(KeyValues({{"{[", "]}:,"}, {"k", "v"}}), res);
+
+        // duplicated keys are all kept in order
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, R"({"a":"1","a":"2"})", res));
+        APSARA_TEST_EQUAL(KeyValues({{"a", "1"}, {"a", "2"}}), res);
+
+        // fields refer to the original data
+        string data = R"({"key":"value"})";
+        vector<JsonScanner::Field> fields;
+        APSARA_TEST_TRUE(scanner.Scan(data, fields));
+        APSARA_TEST_EQUAL(1U, fields.size());
+        APSARA_TEST_EQUAL(data.data() + 2, fields[0].mKey.data());
+        APSARA_TEST_EQUAL(data.data() + 8, fields[0].mValue.data());
+        APSARA_TEST_FALSE(fields[0].mKeyEscaped);
+        APSARA_TEST_FALSE(fields[0].mValueEscaped);
+    }
+}
+
+void JsonScannerUnittest::TestScanUnsupported() {
+    const vector<string> cases = {
+        // malformed
+        "",
+        " ",
+        "{",
+        "}",
+        R"({"a":"b")",
+        R"({"a":"b"}})",
+        R"({"a":"b"} x)",
+        R"({"a":"b",})",
+        R"({,"a":"b"})",
+        R"({"a" "b"})",
+        R"({"a"::"b"})",
+        R"({"a":"b" "c":"d"})",
+        R"({"a":"b"x,"c":"d"})",
+        R"({a:"b"})",
+        R"({"a":b})",
+        R"({"a":})",
+        R"({"a":"b})",
+        R"({"a":"b\"})",
+        R"({"a":01})",
+        R"({"a":-})",
+        R"({"a":1-2})",
+        R"({"a":tru})",
+        R"({"a":True})",
+        R"({"a":1 2})",
+        R"({"a":"b"}{"c":"d"})",
+        "{\"a\":\"b\tc\"}",
+        "{\"a\":\"b\nc\"}",
+        "{\"a\":\"b\"\v}",
+        // not objects
+        R"(["a","b"])",
+        R"("a")",
+        "1",
+        "null",
+        // supported by json, but left to the full parser
+        R"({"a":{"b":"c"}})",
+        R"({"a":["b"]})",
+        R"({"a":1.5})",
+        R"({"a":1e5})",
+        R"({"a":-0})",
+        R"({"a":1234567890123456789})",
+    };
+    for (SimdLevel level : kAllLevels) {
+        JsonScanner scanner(level);
+        vector<JsonScanner::Field> fields;
+        for (const auto& data : cases) {
+            APSARA_TEST_FALSE_DESC(scanner.Scan(data, fields), data);
+        }
+    }
+}
+
+void JsonScannerUnittest::TestScanEscaped() {
+    for (SimdLevel level : kAllLevels) {
+        JsonScanner scanner(level);
+        KeyValues res;
+
+        APSARA_TEST_TRUE(ScanAndUnescape(scanner, R"({"a\"b":"c\\","d":"\"}\"","e\\\\":"\\\""})", res));
+        APSARA_TEST_EQUAL(KeyValues({{"a\"b", "c\\"}, {"d", "\"}\""}, {"e\\\\", "\\\""}}), res);
+
+        vector<JsonScanner::Field> fields;
+        APSARA_TEST_TRUE(scanner.Scan(R"({"a":"b","c\n":"\u4e2d","e":1})", fields));
+        APSARA_TEST_EQUAL(3U, fields.size());
+        APSARA_TEST_FALSE(fields[0].mKeyEscaped);
+        APSARA_TEST_FALSE(fields[0].mValueEscaped);
+        APSARA_TEST_TRUE(fields[1].mKeyEscaped);
+        APSARA_TEST_TRUE(fields[1].mValueEscaped);
+        APSARA_TEST_FALSE(fields[2].mValueEscaped);
+
+        // escapes across the boundary of 64-byte blocks
+        for (size_t prefix = 50; prefix < 70; ++prefix) {
+            for (size_t backslashes = 1; backslashes <= 4; ++backslashes) {
+                string data = "{\"" + string(prefix, 'k') + "\":\"" + string(backslashes, '\\') + "\",\"x\":\"y\"}";
+                if (backslashes % 2 == 1) {
+                    // the closing quote of the first value is escaped
+                    APSARA_TEST_FALSE(ScanAndUnescape(scanner, data, res));
+                    continue;
+                }
+                APSARA_TEST_TRUE(ScanAndUnescape(scanner, data, res));
+                APSARA_TEST_EQUAL(KeyValues({{string(prefix, 'k'), string(backslashes / 2, '\\')}, {"x", "y"}}), res);
+            }
+        }
+    }
+}
+
+void JsonScannerUnittest::TestUnescape() {
+    const KeyValues cases = {
+        {"", ""},
+        {"abc", "abc"},
+        {R"(\"\\\/\b\f\n\r\t)", "\"\\/\b\f\n\r\t"},
+        {R"(a\u0041b)", "aAb"},
+        {R"(\u00e9\u00E9)", "\xc3\xa9\xc3\xa9"},
+        {R"(\u4e2d\u6587)", "\xe4\xb8\xad\xe6\x96\x87"},
+        {R"(\uffff)", "\xef\xbf\xbf"},
+    };
+    for (const auto& c : cases) {
+        string buffer(c.first.size(), '\0');
+        size_t size = 0;
+        APSARA_TEST_TRUE_DESC(JsonScanner::Unescape(c.first, &buffer[0], size), c.first);
+        APSARA_TEST_EQUAL(c.second, buffer.substr(0, size));
+
+        // in place
+        buffer = c.first;
+        APSARA_TEST_TRUE(JsonScanner::Unescape(buffer, &buffer[0], size));
+        APSARA_TEST_EQUAL(c.second, buffer.substr(0, size));
+    }
+
+    // surrogates and \u0000 are valid json, but left to the full parser
+    for (const string& invalid :
+         {R"(\)", R"(a\x)", R"(\u12)", R"(\u12g4)", R"(\u0000)", R"(\ud83d\ude00)", R"(\udc00)"}) {
+        string buffer(invalid.size(), '\0');
+        size_t size = 0;
+        APSARA_TEST_FALSE_DESC(JsonScanner::Unescape(invalid, &buffer[0], size), invalid);
+    }
+}
+
+void JsonScannerUnittest::TestScanRandom() {
+    // objects made up of strings with lots of quotes and backslashes, and literals, with random blanks, so that all
+    // kinds of chars appear at all positions of blocks
+    static const string kStringChars[] = {"a", "\\\"", "\\\\", "\\n", "\\u4e2d", "{", "}", "[", "]", ":", ",", " "};
+    static const string kStringValues[] = {"a", "\"", "\\", "\n", "\xe4\xb8\xad", "{", "}", "[", "]", ":", ",", " "};
+    static const string kLiterals[] = {"true", "false", "0", "-1", "1234567"};
+    static const string kBlanks[] = {"", "", "", " ", "\t", "\r\n"};
+    mt19937 gen(12345);
+    auto randomString = [&](string& json, string& value) {
+        size_t len = gen() % 20;
+        json = "\"";
+        value.clear();
+        for (size_t i = 0; i < len; ++i) {
+            size_t idx = gen() % 12;
+            json += kStringChars[idx];
+            value += kStringValues[idx];
+        }
+        json += "\"";
+    };
+    for (size_t round = 0; round < 2000; ++round) {
+        string data = kBlanks[gen() % 6] + "{";
+        KeyValues expected;
+        size_t fieldCnt = gen() % 8;
+        for (size_t i = 0; i < fieldCnt; ++i) {
+            string keyJson, key, valueJson, value;
+            randomString(keyJson, key);
+            if (gen() % 4 == 0) {
+                valueJson = value = kLiterals[gen() % 5];
+            } else {
+                randomString(valueJson, value);
+            }
+            data += (i == 0 ? "" : ",") + kBlanks[gen() % 6] + keyJson + kBlanks[gen() % 6] + ":" + kBlanks[gen() % 6]
+                + valueJson + kBlanks[gen() % 6];
+            expected.emplace_back(key, value);
+        }
+        data += "}" + kBlanks[gen() % 6];
+
+        for (SimdLevel level : kAllLevels) {
+            JsonScanner scanner(level);
+            KeyValues res;
+            APSARA_TEST_TRUE_DESC(ScanAndUnescape(scanner, data, res), data);
+            APSARA_TEST_TRUE_DESC(expected == res, data);
+
+            // truncated data is never supported, except for trailing blanks
+            size_t truncatedSize = gen() % data.size();
+            if (data.find_first_not_of(" \t\r\n", truncatedSize) != string::npos) {
+                APSARA_TEST_FALSE_DESC(ScanAndUnescape(scanner, data.substr(0, truncatedSize), res), data);
+            }
+        }
+    }
+}
+
+UNIT_TEST_CASE(JsonScannerUnittest, TestScan)
+UNIT_TEST_CASE(JsonScannerUnittest, TestScanUnsupported)
+UNIT_TEST_CASE(JsonScannerUnittest, TestScanEscaped)
+UNIT_TEST_CASE(JsonScannerUnittest, TestUnescape)
+UNIT_TEST_CASE(JsonScannerUnittest, TestScanRandom)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
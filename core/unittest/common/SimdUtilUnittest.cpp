@@ -0,0 +1,120 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/SimdUtil.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class SimdUtilUnittest : public testing::Test {
+public:
+    void TestFindAllCharPositions();
+    void TestFindAllCharPositionsRandom();
+    void TestFindInBlock();
+};
+
+void SimdUtilUnittest::TestFindAllCharPositions() {
+    for (SimdLevel level : {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        vector<size_t> positions;
+        FindAllCharPositions("", 0, '\n', positions, level);
+        APSARA_TEST_TRUE(positions.empty());
+
+        string data = "line1\nline2\n\nline3";
+        FindAllCharPositions(data.data(), data.size(), '\n', positions, level);
+        APSARA_TEST_EQUAL(vector<size_t>({5, 11, 12}), positions);
+
+        // positions are appended
+        data = string(100, '\n');
+        FindAllCharPositions(data.data(), data.size(), '\n', positions, level);
+        APSARA_TEST_EQUAL(103U, positions.size());
+        for (size_t i = 0; i < 100; ++i) {
+            APSARA_TEST_EQUAL(i, positions[i + 3]);
+        }
+
+        // negative char
+        positions.clear();
+        data = string(70, 'a');
+        data[1] = '\xff';
+        data[69] = '\xff';
+        FindAllCharPositions(data.data(), data.size(), '\xff', positions, level);
+        APSARA_TEST_EQUAL(vector<size_t>({1, 69}), positions);
+    }
+}
+
+void SimdUtilUnittest::TestFindAllCharPositionsRandom() {
+    mt19937 gen(12345);
+    uniform_int_distribution<int> charDist(0, 15);
+    string buffer(4096 + 64, '\0');
+    for (auto& c : buffer) {
+        // '\n' is one of 16 possible chars, so that some blocks have no matches while others have many
+        c = static_cast<char>(charDist(gen) == 0 ? '\n' : 'a' + charDist(gen));
+    }
+    for (size_t offset = 0; offset < 64; offset += 7) {
+        for (size_t size : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 1000, 4096}) {
+            const char* data = buffer.data() + offset;
+            vector<size_t> expected;
+            FindAllCharPositions(data, size, '\n', expected, SimdLevel::NONE);
+            for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+                vector<size_t> positions;
+                FindAllCharPositions(data, size, '\n', positions, level);
+                APSARA_TEST_EQUAL(expected, positions);
+            }
+        }
+    }
+}
+
+void SimdUtilUnittest::TestFindInBlock() {
+    mt19937 gen(12345);
+    const char chars[] = {'"', '\\', ',', '\xff'};
+    for (size_t round = 0; round < 100; ++round) {
+        char block[64];
+        for (auto& c : block) {
+            c = static_cast<char>(round % 2 == 0 ? gen() % 256 : chars[gen() % 4]);
+        }
+        uint64_t expected[4] = {0, 0, 0, 0}, expectedBelow = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            for (size_t k = 0; k < 4; ++k) {
+                if (block[i] == chars[k]) {
+                    expected[k] |= 1ULL << i;
+                }
+            }
+            if (static_cast<unsigned char>(block[i]) < 0x20) {
+                expectedBelow |= 1ULL << i;
+            }
+        }
+        for (SimdLevel level : {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2}) {
+            uint64_t masks[4];
+            FindCharsInBlock(block, chars, 4, masks, level);
+            for (size_t k = 0; k < 4; ++k) {
+                APSARA_TEST_EQUAL(expected[k], masks[k]);
+            }
+            APSARA_TEST_EQUAL(expectedBelow, FindBytesBelowInBlock(block, 0x20, level));
+            APSARA_TEST_EQUAL(0U, FindBytesBelowInBlock(block, 0, level));
+        }
+    }
+}
+
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindAllCharPositions)
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindAllCharPositionsRandom)
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindInBlock)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
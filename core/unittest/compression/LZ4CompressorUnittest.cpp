@@ -22,6 +22,7 @@ namespace logtail {
 class LZ4CompressorUnittest : public ::testing::Test {
 public:
     void TestCompress();
+    void TestCompressToBuffer();
 };
 
 void LZ4CompressorUnittest::TestCompress() {
@@ -36,7 +37,27 @@ void LZ4CompressorUnittest::TestCompress() {
     APSARA_TEST_EQUAL(input, decompressed);
 }
 
+void LZ4CompressorUnittest::TestCompressToBuffer() {
+    LZ4Compressor compressor(CompressType::LZ4);
+    string input = "hello world";
+    // compress a sub string without copying it
+    StringView inputView(input.data(), 5);
+    string buffer(compressor.GetCompressBound(inputView.size()), '\0');
+    string errorMsg;
+    for (size_t i = 0; i < 3; ++i) {
+        // the compression context is reused
+        size_t outputSize = buffer.size();
+        APSARA_TEST_TRUE(compressor.Compress(inputView, &buffer[0], outputSize, errorMsg));
+        APSARA_TEST_TRUE(outputSize <= buffer.size());
+        string decompressed;
+        decompressed.resize(inputView.size());
+        APSARA_TEST_TRUE(compressor.UnCompress(buffer.substr(0, outputSize), decompressed, errorMsg));
+        APSARA_TEST_EQUAL("hello", decompressed);
+    }
+}
+
 UNIT_TEST_CASE(LZ4CompressorUnittest, TestCompress)
+UNIT_TEST_CASE(LZ4CompressorUnittest, TestCompressToBuffer)
 
 } // namespace logtail
 
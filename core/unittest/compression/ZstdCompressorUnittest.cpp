@@ -22,6 +22,7 @@ namespace logtail {
 class ZstdCompressorUnittest : public ::testing::Test {
 public:
     void TestCompress();
+    void TestCompressToBuffer();
 };
 
 void ZstdCompressorUnittest::TestCompress() {
@@ -36,7 +37,27 @@ void ZstdCompressorUnittest::TestCompress() {
     APSARA_TEST_EQUAL(input, decompressed);
 }
 
+void ZstdCompressorUnittest::TestCompressToBuffer() {
+    ZstdCompressor compressor(CompressType::ZSTD);
+    string input = "hello world";
+    // compress a sub string without copying it
+    StringView inputView(input.data(), 5);
+    string buffer(compressor.GetCompressBound(inputView.size()), '\0');
+    string errorMsg;
+    for (size_t i = 0; i < 3; ++i) {
+        // the compression context is reused
+        size_t outputSize = buffer.size();
+        APSARA_TEST_TRUE(compressor.Compress(inputView, &buffer[0], outputSize, errorMsg));
+        APSARA_TEST_TRUE(outputSize <= buffer.size());
+        string decompressed;
+        decompressed.resize(inputView.size());
+        APSARA_TEST_TRUE(compressor.UnCompress(buffer.substr(0, outputSize), decompressed, errorMsg));
+        APSARA_TEST_EQUAL("hello", decompressed);
+    }
+}
+
 UNIT_TEST_CASE(ZstdCompressorUnittest, TestCompress)
+UNIT_TEST_CASE(ZstdCompressorUnittest, TestCompressToBuffer)
 
 } // namespace logtail
 
@@ -0,0 +1,145 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "common/FileSystemUtil.h"
+#include "common/RuntimeUtil.h"
+#include "common/TimeUtil.h"
+#include "event_handler/ReaderWorkerPool.h"
+#include "pipeline/PipelineContext.h"
+#include "reader/LogFileReader.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// Files are appended at a fixed rate by a writer thread, while all files are read round by round like LogInput does,
+// either in the current thread or by reader workers. The read throughput stops growing with the write rate once
+// reading becomes the bottleneck, which is shown by the lag, i.e., bytes written but not read yet.
+static void BM_ReadFiles(size_t workerCount, size_t fileCnt, size_t linesPerSecond, size_t lineSize, int seconds) {
+    string rootDir = GetProcessExecutionDir() + "ReaderWorkerPoolBenchmark";
+    bfs::remove_all(rootDir);
+    bfs::create_directories(rootDir);
+
+    FileReaderOptions readerOpts;
+    readerOpts.mInputType = FileReaderOptions::InputType::InputFile;
+    MultilineOptions multilineOpts;
+    PipelineContext ctx;
+    string line(lineSize - 1, 'a');
+    line.push_back('\n');
+
+    vector<unique_ptr<ofstream>> writers;
+    vector<LogFileReaderPtr> readers;
+    for (size_t i = 0; i < fileCnt; ++i) {
+        string fileName = "test" + ToString(i) + ".log";
+        string filePath = PathJoin(rootDir, fileName);
+        writers.emplace_back(new ofstream(filePath, ios::binary));
+        *writers.back() << line << flush;
+        LogFileReaderPtr reader(new LogFileReader(rootDir,
+                                                  fileName,
+                                                  GetFileDevInode(filePath),
+                                                  make_pair(&readerOpts, &ctx),
+                                                  make_pair(&multilineOpts, &ctx)));
+        reader->InitReader(true, LogFileReader::BACKWARD_TO_BEGINNING);
+        reader->UpdateFilePtr();
+        reader->CheckFileSignatureAndOffset(true);
+        readers.push_back(reader);
+    }
+
+    atomic_bool isWriting{true};
+    atomic<uint64_t> writtenBytes{0};
+    thread writer([&]() {
+        // write every 10ms
+        size_t linesPerRound = max<size_t>(linesPerSecond / 100, 1);
+        while (isWriting) {
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            for (auto& w : writers) {
+                for (size_t j = 0; j < linesPerRound; ++j) {
+                    *w << line;
+                }
+                w->flush();
+            }
+            writtenBytes += linesPerRound * lineSize * writers.size();
+            uint64_t cost = GetCurrentTimeInMicroSeconds() - startTime;
+            if (cost < 10 * 1000) {
+                this_thread::sleep_for(chrono::microseconds(10 * 1000 - cost));
+            }
+        }
+    });
+
+    ReaderWorkerPool* pool = ReaderWorkerPool::GetInstance();
+    pool->Start(workerCount);
+    vector<uint64_t> readBytes(fileCnt, 0);
+    auto readFile = [&readers, &readBytes](size_t idx) {
+        bool hasMoreData = true;
+        while (hasMoreData) {
+            LogBuffer logBuffer;
+            hasMoreData = readers[idx]->ReadLog(logBuffer, nullptr);
+            readBytes[idx] += logBuffer.rawBuffer.size();
+        }
+    };
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    uint64_t endTime = startTime + seconds * 1000 * 1000;
+    size_t rounds = 0;
+    while (GetCurrentTimeInMicroSeconds() < endTime) {
+        for (size_t i = 0; i < fileCnt; ++i) {
+            if (pool->IsEnabled()) {
+                pool->Submit(readers[i].get(), [&readFile, i]() { readFile(i); }, []() {});
+            } else {
+                readFile(i);
+            }
+        }
+        pool->WaitAll([]() {});
+        ++rounds;
+    }
+    uint64_t elapsed = GetCurrentTimeInMicroSeconds() - startTime;
+    isWriting = false;
+    writer.join();
+    pool->Stop();
+
+    uint64_t totalReadBytes = 0;
+    for (auto bytes : readBytes) {
+        totalReadBytes += bytes;
+    }
+    cout << "workers: " << workerCount << "\tfiles: " << fileCnt << "\twrite rate: " << linesPerSecond * lineSize
+         << "B/s per file" << endl;
+    cout << "\tread: " << totalReadBytes * 1000000 / elapsed / 1024 / 1024 << "MB/s\trounds: " << rounds
+         << "\tlag: " << (writtenBytes > totalReadBytes ? writtenBytes - totalReadBytes : 0) / 1024 << "KB" << endl;
+
+    readers.clear();
+    writers.clear();
+    bfs::remove_all(rootDir);
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    for (size_t workerCount : {0, 1, 2, 4, 8}) {
+        BM_ReadFiles(workerCount, 300, 1000, 200, 10);
+    }
+    for (size_t workerCount : {0, 4}) {
+        BM_ReadFiles(workerCount, 300, 10000, 200, 10);
+    }
+    return 0;
+}
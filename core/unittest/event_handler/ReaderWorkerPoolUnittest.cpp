@@ -0,0 +1,152 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "event_handler/ReaderWorkerPool.h"
+#include "pipeline/PipelineContext.h"
+#include "reader/LogFileReader.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ReaderWorkerPoolUnittest : public testing::Test {
+public:
+    void TestSubmitAndWaitAll();
+    void TestReadingOrderOfOneFile();
+    void TestWaiting();
+
+protected:
+    void SetUp() override {
+        mPool = ReaderWorkerPool::GetInstance();
+        mPool->Start(4);
+        for (size_t i = 0; i < 8; ++i) {
+            mReaders.emplace_back(new LogFileReader("/tmp",
+                                                    "test" + ToString(i) + ".log",
+                                                    DevInode(1, i + 1),
+                                                    make_pair(&mReaderOpts, &mCtx),
+                                                    make_pair(&mMultilineOpts, &mCtx)));
+        }
+    }
+
+    void TearDown() override {
+        mPool->Stop();
+        mReaders.clear();
+    }
+
+private:
+    ReaderWorkerPool* mPool = nullptr;
+    FileReaderOptions mReaderOpts;
+    MultilineOptions mMultilineOpts;
+    PipelineContext mCtx;
+    vector<LogFileReaderPtr> mReaders;
+};
+
+void ReaderWorkerPoolUnittest::TestSubmitAndWaitAll() {
+    APSARA_TEST_TRUE(mPool->IsEnabled());
+    APSARA_TEST_FALSE(ReaderWorkerPool::IsWorkerThread());
+
+    vector<int> readRes(mReaders.size(), 0);
+    vector<size_t> callbackOrder;
+    atomic_int workerThreadCnt{0};
+    for (size_t i = 0; i < mReaders.size(); ++i) {
+        mPool->Submit(
+            mReaders[i].get(),
+            [&readRes, &workerThreadCnt, i]() {
+                this_thread::sleep_for(chrono::milliseconds(5));
+                readRes[i] = i + 1;
+                if (ReaderWorkerPool::IsWorkerThread()) {
+                    ++workerThreadCnt;
+                }
+            },
+            [&readRes, &callbackOrder, i]() {
+                // read is finished before callback
+                APSARA_TEST_EQUAL(static_cast<int>(i + 1), readRes[i]);
+                APSARA_TEST_FALSE(ReaderWorkerPool::IsWorkerThread());
+                callbackOrder.push_back(i);
+            });
+        APSARA_TEST_TRUE(mPool->IsReading(mReaders[i].get()));
+    }
+    APSARA_TEST_TRUE(mPool->HasPendingTask());
+
+    mPool->WaitAll([]() {});
+    APSARA_TEST_FALSE(mPool->HasPendingTask());
+    APSARA_TEST_EQUAL(static_cast<int>(mReaders.size()), workerThreadCnt.load());
+    APSARA_TEST_EQUAL(mReaders.size(), callbackOrder.size());
+    for (size_t i = 0; i < mReaders.size(); ++i) {
+        APSARA_TEST_EQUAL(i, callbackOrder[i]);
+        APSARA_TEST_FALSE(mPool->IsReading(mReaders[i].get()));
+    }
+}
+
+void ReaderWorkerPoolUnittest::TestReadingOrderOfOneFile() {
+    // readings of the same file are done by the same worker one by one
+    vector<vector<size_t>> readRes(2);
+    vector<thread::id> threadIds(2);
+    for (size_t i = 0; i < 100; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            mPool->Submit(
+                mReaders[j].get(),
+                [&readRes, &threadIds, i, j]() {
+                    if (i == 0) {
+                        threadIds[j] = this_thread::get_id();
+                    } else {
+                        APSARA_TEST_TRUE(threadIds[j] == this_thread::get_id());
+                    }
+                    readRes[j].push_back(i);
+                },
+                []() {});
+        }
+    }
+    mPool->WaitAll([]() {});
+    for (size_t j = 0; j < 2; ++j) {
+        APSARA_TEST_EQUAL(100U, readRes[j].size());
+        for (size_t i = 0; i < readRes[j].size(); ++i) {
+            APSARA_TEST_EQUAL(i, readRes[j][i]);
+        }
+    }
+}
+
+void ReaderWorkerPoolUnittest::TestWaiting() {
+    atomic_bool isDone{false};
+    int waitingCnt = 0;
+    mPool->Submit(
+        mReaders[0].get(),
+        [&isDone]() {
+            this_thread::sleep_for(chrono::milliseconds(100));
+            isDone = true;
+        },
+        []() {});
+    mPool->WaitAll([&waitingCnt]() { ++waitingCnt; });
+    APSARA_TEST_TRUE(isDone);
+    APSARA_TEST_TRUE(waitingCnt > 0);
+
+    // nothing to wait
+    waitingCnt = 0;
+    mPool->WaitAll([&waitingCnt]() { ++waitingCnt; });
+    APSARA_TEST_EQUAL(0, waitingCnt);
+}
+
+UNIT_TEST_CASE(ReaderWorkerPoolUnittest, TestSubmitAndWaitAll)
+UNIT_TEST_CASE(ReaderWorkerPoolUnittest, TestReadingOrderOfOneFile)
+UNIT_TEST_CASE(ReaderWorkerPoolUnittest, TestWaiting)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,104 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "common/StringTools.h"
+#include "common/TimeUtil.h"
+#include "file_server/FileDiscoveryIndex.h"
+#include "pipeline/PipelineContext.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// Each synthetic config collects the logs of one app, the path of which is like /home/admin/logs/app<i>/*.log. One
+// tenth of the configs are wildcard ones, like /var/log/pods/*/app<i>/*.log, which are indexed by /var/log/pods.
+static void BM_Match(size_t configCnt) {
+    static const size_t kLookupCnt = 100000;
+
+    PipelineContext ctx;
+    vector<unique_ptr<FileDiscoveryOptions>> options;
+    vector<pair<string, FileDiscoveryConfig>> configs;
+    FileDiscoveryIndex index;
+    for (size_t i = 0; i < configCnt; ++i) {
+        Json::Value configJson;
+        if (i % 10 == 0) {
+            configJson["FilePaths"].append("/var/log/pods/*/app" + ToString(i) + "/*.log");
+        } else {
+            configJson["FilePaths"].append("/home/admin/logs/app" + ToString(i) + "/*.log");
+        }
+        options.emplace_back(make_unique<FileDiscoveryOptions>());
+        options.back()->Init(configJson, ctx, "benchmark");
+        configs.emplace_back("config" + ToString(i), make_pair(options.back().get(), &ctx));
+        index.Add(configs.back().first, configs.back().second);
+    }
+
+    vector<pair<string, string>> objects;
+    for (size_t i = 0; i < kLookupCnt; ++i) {
+        size_t app = i * 7 % configCnt;
+        if (app % 10 == 0) {
+            objects.emplace_back("/var/log/pods/pod" + ToString(i % 16) + "/app" + ToString(app), "a.log");
+        } else {
+            objects.emplace_back("/home/admin/logs/app" + ToString(app), "a.log");
+        }
+    }
+
+    size_t linearMatchCnt = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (const auto& object : objects) {
+        for (const auto& config : configs) {
+            if (config.second.first->IsMatch(object.first, object.second)) {
+                ++linearMatchCnt;
+            }
+        }
+    }
+    uint64_t linearElapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+
+    size_t indexMatchCnt = 0;
+    vector<FileDiscoveryConfig> candidates;
+    startTime = GetCurrentTimeInMicroSeconds();
+    for (const auto& object : objects) {
+        candidates.clear();
+        index.FindCandidates(object.first, candidates);
+        for (const auto& config : candidates) {
+            if (config.first->IsMatch(object.first, object.second)) {
+                ++indexMatchCnt;
+            }
+        }
+    }
+    uint64_t indexElapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+
+    cout << "configs: " << configCnt << "\tlinear: " << linearElapsed * 1000 / kLookupCnt << "ns/lookup"
+         << "\tindex: " << indexElapsed * 1000 / kLookupCnt << "ns/lookup"
+         << "\tmatched: " << linearMatchCnt << "/" << indexMatchCnt << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    for (size_t configCnt : {10, 100, 1000, 5000}) {
+        BM_Match(configCnt);
+    }
+    return 0;
+}
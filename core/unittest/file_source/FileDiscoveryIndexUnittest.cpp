@@ -0,0 +1,208 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "file_server/FileDiscoveryIndex.h"
+#include "pipeline/PipelineContext.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FileDiscoveryIndexUnittest : public testing::Test {
+public:
+    void TestFindCandidates();
+    void TestWildcardPath();
+    void TestContainerDiscovery();
+    void TestRemove();
+    void TestConsistentWithLinearScan();
+
+protected:
+    void TearDown() override {
+        mOptions.clear();
+        mNames.clear();
+    }
+
+private:
+    FileDiscoveryConfig CreateConfig(const string& name,
+                                     const string& filePath,
+                                     const Json::Value& extra = Json::Value());
+    vector<string> FindCandidateNames(const FileDiscoveryIndex& index, const string& path);
+
+    PipelineContext mCtx;
+    vector<unique_ptr<FileDiscoveryOptions>> mOptions;
+    map<const FileDiscoveryOptions*, string> mNames;
+};
+
+void FileDiscoveryIndexUnittest::TestFindCandidates() {
+    FileDiscoveryIndex index;
+    index.Add("root", CreateConfig("root", "/*.log"));
+    index.Add("var", CreateConfig("var", "/var/*.log"));
+    index.Add("var_log", CreateConfig("var_log", "/var/log/*.log"));
+    index.Add("var_log_app", CreateConfig("var_log_app", "/var/log/app/*.log"));
+    index.Add("home", CreateConfig("home", "/home/admin/*.log"));
+    APSARA_TEST_EQUAL(5U, index.Size());
+
+    APSARA_TEST_EQUAL(vector<string>({"root", "var", "var_log", "var_log_app"}),
+                      FindCandidateNames(index, "/var/log/app/sub"));
+    APSARA_TEST_EQUAL(vector<string>({"root", "var", "var_log"}), FindCandidateNames(index, "/var/log/app2"));
+    APSARA_TEST_EQUAL(vector<string>({"root", "var", "var_log"}), FindCandidateNames(index, "/var//log/"));
+    APSARA_TEST_EQUAL(vector<string>({"root"}), FindCandidateNames(index, "/home"));
+    APSARA_TEST_EQUAL(vector<string>({"root"}), FindCandidateNames(index, "/"));
+}
+
+void FileDiscoveryIndexUnittest::TestWildcardPath() {
+    FileDiscoveryIndex index;
+    index.Add("wildcard", CreateConfig("wildcard", "/var/log/*/app?/logs/*.log"));
+    index.Add("bracket", CreateConfig("bracket", "/data/[ab]/*/*.log"));
+
+    APSARA_TEST_EQUAL(vector<string>({"wildcard"}), FindCandidateNames(index, "/var/log/pod1/app1/logs"));
+    APSARA_TEST_EQUAL(vector<string>({"wildcard"}), FindCandidateNames(index, "/var/log"));
+    APSARA_TEST_EQUAL(vector<string>(), FindCandidateNames(index, "/var/lib/pod1/app1/logs"));
+    // brackets are wildcards for fnmatch as well
+    APSARA_TEST_EQUAL(vector<string>({"bracket"}), FindCandidateNames(index, "/data/a/x"));
+}
+
+void FileDiscoveryIndexUnittest::TestContainerDiscovery() {
+    FileDiscoveryIndex index;
+    FileDiscoveryConfig config = CreateConfig("container", "/home/admin/logs/*.log");
+    config.first->SetEnableContainerDiscoveryFlag(true);
+    auto containers = make_shared<vector<ContainerInfo>>();
+    ContainerInfo info;
+    info.mRealBaseDir = "/host/upper1/home/admin/logs";
+    containers->push_back(info);
+    info.mRealBaseDir = "/host/upper1/home/admin/logs/sub";
+    containers->push_back(info);
+    config.first->SetContainerInfo(containers);
+    index.Add("container", config);
+
+    // not indexed by the base path
+    APSARA_TEST_EQUAL(vector<string>(), FindCandidateNames(index, "/home/admin/logs"));
+    // nested container dirs
+    APSARA_TEST_EQUAL(vector<string>({"container"}), FindCandidateNames(index, "/host/upper1/home/admin/logs/sub"));
+
+    // container is added
+    info.mRealBaseDir = "/host/upper2/home/admin/logs";
+    containers->push_back(info);
+    APSARA_TEST_EQUAL(vector<string>(), FindCandidateNames(index, "/host/upper2/home/admin/logs"));
+    index.Add("container", config);
+    APSARA_TEST_EQUAL(1U, index.Size());
+    APSARA_TEST_EQUAL(vector<string>({"container"}), FindCandidateNames(index, "/host/upper2/home/admin/logs"));
+
+    // container is removed
+    containers->erase(containers->begin());
+    index.Add("container", config);
+    APSARA_TEST_EQUAL(vector<string>(), FindCandidateNames(index, "/host/upper1/home/admin/logs"));
+    APSARA_TEST_EQUAL(vector<string>({"container"}), FindCandidateNames(index, "/host/upper1/home/admin/logs/sub"));
+}
+
+void FileDiscoveryIndexUnittest::TestRemove() {
+    FileDiscoveryIndex index;
+    index.Add("var_log", CreateConfig("var_log", "/var/log/*.log"));
+    index.Add("var_log_app", CreateConfig("var_log_app", "/var/log/app/*.log"));
+    index.Remove("var_log_app");
+    index.Remove("not_existed");
+    APSARA_TEST_EQUAL(1U, index.Size());
+    APSARA_TEST_EQUAL(vector<string>({"var_log"}), FindCandidateNames(index, "/var/log/app"));
+    // empty nodes are removed
+    APSARA_TEST_EQUAL(0U, index.mRoot.mChildren["var"]->mChildren["log"]->mChildren.size());
+
+    index.Remove("var_log");
+    APSARA_TEST_EQUAL(0U, index.Size());
+    APSARA_TEST_EQUAL(0U, index.mRoot.mChildren.size());
+}
+
+void FileDiscoveryIndexUnittest::TestConsistentWithLinearScan() {
+    vector<pair<string, FileDiscoveryConfig>> configs;
+    Json::Value blacklist;
+    blacklist["ExcludeFiles"].append("skip*.log");
+    blacklist["ExcludeDirs"].append("/var/log/app0/tmp*");
+    configs.emplace_back("app", CreateConfig("app", "/var/log/app0/*.log", blacklist));
+    configs.emplace_back("app_all", CreateConfig("app_all", "/var/log/app0/**/*.log"));
+    configs.emplace_back("app_pattern", CreateConfig("app_pattern", "/var/log/app?/access*.log"));
+    configs.emplace_back("wildcard", CreateConfig("wildcard", "/var/log/*/logs/*.log"));
+    configs.emplace_back("wildcard_all", CreateConfig("wildcard_all", "/var/*/app0/**/*"));
+    configs.emplace_back("root", CreateConfig("root", "/**/*.txt"));
+    FileDiscoveryIndex index;
+    for (const auto& item : configs) {
+        index.Add(item.first, item.second);
+    }
+
+    vector<pair<string, string>> objects = {{"/var/log/app0", "a.log"},
+                                            {"/var/log/app0", "skip1.log"},
+                                            {"/var/log/app0/tmp1", "a.log"},
+                                            {"/var/log/app0/sub/sub", "a.log"},
+                                            {"/var/log/app1", "access.log"},
+                                            {"/var/log/app1/logs", "a.log"},
+                                            {"/var/log/app1/logs", "a.txt"},
+                                            {"/var/log/app0", ""},
+                                            {"/var/log", ""},
+                                            {"/home", "a.txt"}};
+    for (const auto& object : objects) {
+        vector<FileDiscoveryConfig> expected, actual, candidates;
+        for (const auto& item : configs) {
+            if (item.second.first->IsMatch(object.first, object.second)) {
+                expected.push_back(item.second);
+            }
+        }
+        index.FindCandidates(object.first, candidates);
+        for (const auto& config : candidates) {
+            if (config.first->IsMatch(object.first, object.second)) {
+                actual.push_back(config);
+            }
+        }
+        sort(expected.begin(), expected.end());
+        sort(actual.begin(), actual.end());
+        APSARA_TEST_TRUE_DESC(expected == actual, object.first + "/" + object.second);
+    }
+}
+
+FileDiscoveryConfig
+FileDiscoveryIndexUnittest::CreateConfig(const string& name, const string& filePath, const Json::Value& extra) {
+    Json::Value configJson = extra.isNull() ? Json::Value(Json::objectValue) : extra;
+    configJson["FilePaths"].append(Json::Value(filePath));
+    mOptions.emplace_back(make_unique<FileDiscoveryOptions>());
+    APSARA_TEST_TRUE(mOptions.back()->Init(configJson, mCtx, "test"));
+    mNames[mOptions.back().get()] = name;
+    return make_pair(mOptions.back().get(), &mCtx);
+}
+
+vector<string> FileDiscoveryIndexUnittest::FindCandidateNames(const FileDiscoveryIndex& index, const string& path) {
+    vector<FileDiscoveryConfig> candidates;
+    index.FindCandidates(path, candidates);
+    vector<string> names;
+    for (const auto& candidate : candidates) {
+        names.push_back(mNames[candidate.first]);
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
+
+UNIT_TEST_CASE(FileDiscoveryIndexUnittest, TestFindCandidates)
+UNIT_TEST_CASE(FileDiscoveryIndexUnittest, TestWildcardPath)
+UNIT_TEST_CASE(FileDiscoveryIndexUnittest, TestContainerDiscovery)
+UNIT_TEST_CASE(FileDiscoveryIndexUnittest, TestRemove)
+UNIT_TEST_CASE(FileDiscoveryIndexUnittest, TestConsistentWithLinearScan)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
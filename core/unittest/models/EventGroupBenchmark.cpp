@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include "common/Flags.h"
 #include "common/JsonUtil.h"
 #include "common/TimeUtil.h"
 #include "models/LogEvent.h"
@@ -28,12 +29,18 @@ void* __wrap_memcpy(void* dest, const void* src, size_t n) {
 }
 #endif
 
+DECLARE_FLAG_BOOL(enable_event_arena);
+
 namespace logtail {
 
 class EventGroupBenchmark {
 public:
     void TestEraseInLoop();
     void TestWriteIndexInLoop();
+    void TestCopyAndShare(size_t flusherCnt);
+    void TestCreateAndDestroy(bool enableArena);
+    void TestContentOps(size_t contentCnt);
+    void TestTagsAndMetadata(size_t tagCnt);
 };
 
 void EraseInLoop(PipelineEventGroup& logGroup) {
@@ -101,6 +108,153 @@ void EventGroupBenchmark::TestWriteIndexInLoop() {
     printf("%s costs %lums\n", __func__, timeelapsed);
 }
 
+// simulates sending an event group to multiple flushers, where all but the last flusher get a duplicate
+void EventGroupBenchmark::TestCopyAndShare(size_t flusherCnt) {
+    // SetUp
+    std::vector<PipelineEventGroup> eventGroups;
+    for (int i = 0; i < 100; ++i) {
+        eventGroups.emplace_back(std::make_shared<SourceBuffer>());
+    }
+    for (auto& group : eventGroups) {
+        for (int i = 0; i < 1000; ++i) {
+            auto e = group.AddLogEvent();
+            for (int j = 0; j < 10; ++j) {
+                e->SetContent(std::string("key_") + std::to_string(j), std::string(50, 'a'));
+            }
+        }
+    }
+    // Test
+    uint64_t copyTime = 0, shareTime = 0;
+    for (auto& group : eventGroups) {
+        uint64_t starttime = GetCurrentTimeInMicroSeconds();
+        {
+            std::vector<PipelineEventGroup> res;
+            for (size_t i = 1; i < flusherCnt; ++i) {
+                res.emplace_back(group.Copy());
+            }
+        }
+        copyTime += GetCurrentTimeInMicroSeconds() - starttime;
+        starttime = GetCurrentTimeInMicroSeconds();
+        {
+            std::vector<PipelineEventGroup> res;
+            for (size_t i = 1; i < flusherCnt; ++i) {
+                res.emplace_back(group.Share());
+            }
+        }
+        shareTime += GetCurrentTimeInMicroSeconds() - starttime;
+    }
+    printf("%s with %lu flushers: Copy costs %luus, Share costs %luus\n", __func__, flusherCnt, copyTime, shareTime);
+}
+
+// simulates the lifetime of events, which are created by the input, moved to the batch and destroyed after being sent
+void EventGroupBenchmark::TestCreateAndDestroy(bool enableArena) {
+    BOOL_FLAG(enable_event_arena) = enableArena;
+    uint64_t createTime = 0, destroyTime = 0;
+    for (int i = 0; i < 1000; ++i) {
+        uint64_t starttime = GetCurrentTimeInMicroSeconds();
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        for (int j = 0; j < 1000; ++j) {
+            auto e = group.AddLogEvent();
+            e->SetTimestamp(j);
+            e->SetContentNoCopy(StringView("key"), StringView("value"));
+        }
+        EventsContainer batch;
+        batch.reserve(group.GetEvents().size());
+        for (auto& e : group.MutableEvents()) {
+            batch.emplace_back(std::move(e));
+        }
+        createTime += GetCurrentTimeInMicroSeconds() - starttime;
+        starttime = GetCurrentTimeInMicroSeconds();
+        group = PipelineEventGroup(nullptr);
+        batch.clear();
+        destroyTime += GetCurrentTimeInMicroSeconds() - starttime;
+    }
+    printf("%s with arena %d: create costs %luus, destroy costs %luus\n",
+           __func__,
+           enableArena,
+           createTime,
+           destroyTime);
+}
+
+// simulates a parse processor, which replaces the raw content with the parsed ones and reads some of them afterwards
+void EventGroupBenchmark::TestContentOps(size_t contentCnt) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < contentCnt; ++i) {
+        keys.emplace_back("key_" + std::to_string(i));
+    }
+    uint64_t setTime = 0, getTime = 0;
+    size_t hitCnt = 0;
+    for (int i = 0; i < 100; ++i) {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        uint64_t starttime = GetCurrentTimeInMicroSeconds();
+        for (int j = 0; j < 1000; ++j) {
+            auto e = group.AddLogEvent();
+            e->SetContentNoCopy(StringView("content"), StringView("raw"));
+            for (const auto& key : keys) {
+                e->SetContentNoCopy(StringView(key), StringView("value"));
+            }
+            e->DelContent(StringView("content"));
+        }
+        setTime += GetCurrentTimeInMicroSeconds() - starttime;
+        starttime = GetCurrentTimeInMicroSeconds();
+        for (const auto& e : group.GetEvents()) {
+            const auto& logEvent = e.Cast<LogEvent>();
+            for (const auto& key : keys) {
+                hitCnt += logEvent.HasContent(StringView(key));
+            }
+            hitCnt += logEvent.HasContent(StringView("missing"));
+        }
+        getTime += GetCurrentTimeInMicroSeconds() - starttime;
+    }
+    printf("%s with %lu contents: set costs %luus, get costs %luus, hits %lu\n",
+           __func__,
+           contentCnt,
+           setTime,
+           getTime,
+           hitCnt);
+}
+
+// simulates the per group work done by the input, ProcessorTagNative, Batcher and the serializer
+void EventGroupBenchmark::TestTagsAndMetadata(size_t tagCnt) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < tagCnt; ++i) {
+        keys.emplace_back("__tag__:key_" + std::to_string(i));
+    }
+    uint64_t setTime = 0, getTime = 0, hashTime = 0;
+    size_t checksum = 0;
+    for (int i = 0; i < 100000; ++i) {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        uint64_t starttime = GetCurrentTimeInMicroSeconds();
+        group.SetMetadataNoCopy(EventGroupMetaKey::LOG_FILE_PATH, StringView("/var/log/app.log"));
+        group.SetMetadataNoCopy(EventGroupMetaKey::LOG_FILE_PATH_RESOLVED, StringView("/var/log/app.log"));
+        group.SetMetadataNoCopy(EventGroupMetaKey::LOG_FILE_INODE, StringView("123456"));
+        group.SetMetadataNoCopy(EventGroupMetaKey::SOURCE_ID, StringView("source"));
+        for (const auto& key : keys) {
+            group.SetTagNoCopy(StringView(key), StringView("value"));
+        }
+        setTime += GetCurrentTimeInMicroSeconds() - starttime;
+        starttime = GetCurrentTimeInMicroSeconds();
+        for (int j = 0; j < 4; ++j) {
+            checksum += group.GetMetadata(EventGroupMetaKey::LOG_FILE_PATH_RESOLVED).size();
+            checksum += group.HasMetadata(EventGroupMetaKey::HAS_PART_LOG);
+        }
+        for (const auto& tag : group.GetTags()) {
+            checksum += tag.second.size();
+        }
+        getTime += GetCurrentTimeInMicroSeconds() - starttime;
+        starttime = GetCurrentTimeInMicroSeconds();
+        checksum += group.GetTagsHash() & 1;
+        hashTime += GetCurrentTimeInMicroSeconds() - starttime;
+    }
+    printf("%s with %lu tags: set costs %luus, get costs %luus, hash costs %luus, checksum %lu\n",
+           __func__,
+           tagCnt,
+           setTime,
+           getTime,
+           hashTime,
+           checksum);
+}
+
 } // namespace logtail
 
 int main(int argc, char* argv[]) {
@@ -111,5 +265,15 @@ int main(int argc, char* argv[]) {
        TestEraseInLoop costs 453ms
        TestWriteIndexInLoop costs 22ms
      */
+    benchmark.TestCopyAndShare(1);
+    benchmark.TestCopyAndShare(2);
+    benchmark.TestCopyAndShare(3);
+    benchmark.TestCreateAndDestroy(false);
+    benchmark.TestCreateAndDestroy(true);
+    benchmark.TestContentOps(4);
+    benchmark.TestContentOps(12);
+    benchmark.TestContentOps(32);
+    benchmark.TestTagsAndMetadata(2);
+    benchmark.TestTagsAndMetadata(8);
     return 0;
 }
\ No newline at end of file
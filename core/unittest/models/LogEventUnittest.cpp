@@ -27,6 +27,7 @@ public:
     void TestDelContent();
     void TestReadContentOp();
     void TestIterateContent();
+    void TestManyContents();
     void TestMeta();
     void TestSize();
     void TestFromJsonToJson();
@@ -155,6 +156,35 @@ void LogEventUnittest::TestIterateContent() {
     }
 }
 
+void LogEventUnittest::TestManyContents() {
+    // more contents than the threshold, so that contents are indexed
+    for (size_t i = 0; i < 40; ++i) {
+        mLogEvent->SetContent("key" + to_string(i), "value" + to_string(i));
+    }
+    mLogEvent->SetContent(string("key3"), string("new_value3"));
+    for (size_t i = 0; i < 40; i += 2) {
+        mLogEvent->DelContent("key" + to_string(i));
+    }
+    APSARA_TEST_EQUAL(20U, mLogEvent->Size());
+    APSARA_TEST_FALSE(mLogEvent->HasContent("key0"));
+    APSARA_TEST_EQUAL("new_value3", mLogEvent->GetContent("key3").to_string());
+    APSARA_TEST_EQUAL("value39", mLogEvent->FindContent("key39")->second.to_string());
+    // insertion order is kept
+    size_t i = 1;
+    for (const auto& kv : *mLogEvent) {
+        APSARA_TEST_EQUAL("key" + to_string(i), kv.first.to_string());
+        i += 2;
+    }
+    APSARA_TEST_EQUAL(41U, i);
+
+    auto e = mLogEvent->Copy();
+    auto& copy = static_cast<LogEvent&>(*e);
+    copy.SetContent(string("key0"), string("value0"));
+    APSARA_TEST_EQUAL(21U, copy.Size());
+    APSARA_TEST_EQUAL("new_value3", copy.GetContent("key3").to_string());
+    APSARA_TEST_FALSE(mLogEvent->HasContent("key0"));
+}
+
 void LogEventUnittest::TestMeta() {
     mLogEvent->SetPosition(1U, 2U);
     APSARA_TEST_EQUAL(1U, mLogEvent->GetPosition().first);
@@ -207,6 +237,7 @@ UNIT_TEST_CASE(LogEventUnittest, TestSetContent)
 UNIT_TEST_CASE(LogEventUnittest, TestDelContent)
 UNIT_TEST_CASE(LogEventUnittest, TestReadContentOp)
 UNIT_TEST_CASE(LogEventUnittest, TestIterateContent)
+UNIT_TEST_CASE(LogEventUnittest, TestManyContents)
 UNIT_TEST_CASE(LogEventUnittest, TestMeta)
 UNIT_TEST_CASE(LogEventUnittest, TestSize)
 UNIT_TEST_CASE(LogEventUnittest, TestFromJsonToJson)
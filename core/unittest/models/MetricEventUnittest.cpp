@@ -105,7 +105,7 @@ void MetricEventUnittest::TestTag() {
 }
 
 void MetricEventUnittest::TestSize() {
-    size_t basicSize = sizeof(time_t) + sizeof(long) + sizeof(UntypedSingleValue) + sizeof(map<StringView, StringView>);
+    size_t basicSize = sizeof(time_t) + sizeof(long) + sizeof(UntypedSingleValue) + sizeof(decltype(SizedMap::mInner));
     mMetricEvent->SetName("test");
     basicSize += 4;
     
@@ -24,8 +24,11 @@ class PipelineEventGroupUnittest : public ::testing::Test {
 public:
     void TestSwapEvents();
     void TestCopy();
+    void TestShare();
+    void TestEventArena();
     void TestSetMetadata();
     void TestDelMetadata();
+    void TestGetTagsHash();
     void TestFromJsonToJson();
 
 protected:
@@ -57,6 +60,69 @@ void PipelineEventGroupUnittest::TestCopy() {
     APSARA_TEST_EQUAL(3U, res.GetSourceBuffer().use_count());
 }
 
+void PipelineEventGroupUnittest::TestShare() {
+    mEventGroup->AddLogEvent()->SetContent(std::string("key"), std::string("value"));
+    mEventGroup->SetTag(std::string("tag"), std::string("value"));
+    auto res = mEventGroup->Share();
+    APSARA_TEST_EQUAL(1U, res.GetEvents().size());
+    APSARA_TEST_TRUE(res.GetEvents()[0].IsShared());
+    APSARA_TEST_TRUE(mEventGroup->GetEvents()[0].IsShared());
+    APSARA_TEST_EQUAL(&mEventGroup->GetEvents()[0].Cast<LogEvent>(), &res.GetEvents()[0].Cast<LogEvent>());
+    APSARA_TEST_EQUAL("value", res.GetTag("tag").to_string());
+    APSARA_TEST_EQUAL(3U, res.GetSourceBuffer().use_count());
+    {
+        // modification on one group is invisible to the other
+        auto& event = res.MutableEvents()[0].Cast<LogEvent>();
+        APSARA_TEST_EQUAL(&res, event.mPipelineEventGroupPtr);
+        event.SetContent(std::string("key"), std::string("new_value"));
+        APSARA_TEST_FALSE(res.GetEvents()[0].IsShared());
+        APSARA_TEST_TRUE(mEventGroup->GetEvents()[0].IsShared());
+        APSARA_TEST_EQUAL("new_value", res.GetEvents()[0].Cast<LogEvent>().GetContent("key").to_string());
+        APSARA_TEST_EQUAL("value", mEventGroup->GetEvents()[0].Cast<LogEvent>().GetContent("key").to_string());
+    }
+    {
+        // the other owner copies the event as well, since it cannot know whether the event is still read by others
+        const LogEvent* addr = &mEventGroup->GetEvents()[0].Cast<LogEvent>();
+        auto& event = mEventGroup->MutableEvents()[0].Cast<LogEvent>();
+        APSARA_TEST_NOT_EQUAL(addr, &event);
+        APSARA_TEST_FALSE(mEventGroup->GetEvents()[0].IsShared());
+        APSARA_TEST_EQUAL(mEventGroup.get(), event.mPipelineEventGroupPtr);
+        APSARA_TEST_EQUAL("value", event.GetContent("key").to_string());
+    }
+}
+
+void PipelineEventGroupUnittest::TestEventArena() {
+    APSARA_TEST_EQUAL(nullptr, mEventGroup->GetEventArena());
+    mEventGroup->AddLogEvent()->SetContent(std::string("key"), std::string("value"));
+    auto e = mEventGroup->CreateMetricEvent();
+    EventArena* arena = mEventGroup->GetEventArena();
+    APSARA_TEST_NOT_EQUAL(nullptr, arena);
+    {
+        // the arena is moved along with the group
+        PipelineEventGroup group(std::move(*mEventGroup));
+        APSARA_TEST_EQUAL(arena, group.GetEventArena());
+        APSARA_TEST_EQUAL(nullptr, mEventGroup->GetEventArena());
+        mEventGroup.reset(new PipelineEventGroup(std::move(group)));
+    }
+    {
+        // events outlive the group they are allocated from
+        EventsContainer events;
+        mEventGroup->SwapEvents(events);
+        mEventGroup.reset();
+        APSARA_TEST_EQUAL("value", events[0].Cast<LogEvent>().GetContent("key").to_string());
+        APSARA_TEST_EQUAL(0, e->GetTimestamp());
+    }
+    {
+        // copies are not allocated from the arena
+        PipelineEventGroup group(mSourceBuffer);
+        group.AddLogEvent()->SetContent(std::string("key"), std::string("value"));
+        auto res = group.Copy();
+        APSARA_TEST_EQUAL(nullptr, res.GetEventArena());
+        group = std::move(res);
+        APSARA_TEST_EQUAL("value", group.GetEvents()[0].Cast<LogEvent>().GetContent("key").to_string());
+    }
+}
+
 void PipelineEventGroupUnittest::TestSetMetadata() {
     { // string copy, let kv out of scope
         mEventGroup->SetMetadata(EventGroupMetaKey::LOG_FILE_PATH, std::string("value1"));
@@ -96,6 +162,37 @@ void PipelineEventGroupUnittest::TestDelMetadata() {
     APSARA_TEST_FALSE_FATAL(mEventGroup->HasMetadata(EventGroupMetaKey::LOG_FILE_INODE));
 }
 
+void PipelineEventGroupUnittest::TestGetTagsHash() {
+    mEventGroup->SetTag(std::string("key"), std::string("value"));
+    size_t hash = mEventGroup->GetTagsHash();
+    APSARA_TEST_EQUAL(hash, mEventGroup->GetTagsHash());
+    {
+        // tags changed
+        PipelineEventGroup group = mEventGroup->Copy();
+        APSARA_TEST_EQUAL(hash, group.GetTagsHash());
+        group.SetTag(std::string("key"), std::string("value2"));
+        APSARA_TEST_NOT_EQUAL(hash, group.GetTagsHash());
+        group.SetTag(std::string("key"), std::string("value"));
+        APSARA_TEST_EQUAL(hash, group.GetTagsHash());
+        group.DelTag("key");
+        APSARA_TEST_NOT_EQUAL(hash, group.GetTagsHash());
+    }
+    {
+        // source id changed
+        PipelineEventGroup group = mEventGroup->Copy();
+        group.SetMetadata(EventGroupMetaKey::SOURCE_ID, std::string("source"));
+        APSARA_TEST_NOT_EQUAL(hash, group.GetTagsHash());
+        group.DelMetadata(EventGroupMetaKey::SOURCE_ID);
+        APSARA_TEST_EQUAL(hash, group.GetTagsHash());
+    }
+    {
+        // tags modified directly
+        PipelineEventGroup group = mEventGroup->Copy();
+        group.GetSizedTags().Insert("key2", "value2");
+        APSARA_TEST_NOT_EQUAL(hash, group.GetTagsHash());
+    }
+}
+
 void PipelineEventGroupUnittest::TestFromJsonToJson() {
     std::string inJson = R"({
         "events" :
@@ -138,8 +235,11 @@ void PipelineEventGroupUnittest::TestFromJsonToJson() {
 
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestSwapEvents)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestCopy)
+UNIT_TEST_CASE(PipelineEventGroupUnittest, TestShare)
+UNIT_TEST_CASE(PipelineEventGroupUnittest, TestEventArena)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestSetMetadata)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestDelMetadata)
+UNIT_TEST_CASE(PipelineEventGroupUnittest, TestGetTagsHash)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestFromJsonToJson)
 
 } // namespace logtail
@@ -25,6 +25,7 @@ public:
     void TestGet();
     void TestCast();
     void TestCopy();
+    void TestShare();
 
 protected:
     void SetUp() override {
@@ -90,10 +91,43 @@ void PipelineEventPtrUnittest::TestCopy() {
     }
 }
 
+void PipelineEventPtrUnittest::TestShare() {
+    auto logUPtr = mEventGroup->CreateLogEvent();
+    auto addr = logUPtr.get();
+    PipelineEventPtr logEventPtr(std::move(logUPtr));
+    logEventPtr.Cast<LogEvent>().SetContent(std::string("key"), std::string("value"));
+    {
+        auto res = logEventPtr.Share();
+        APSARA_TEST_TRUE(logEventPtr.IsShared());
+        APSARA_TEST_TRUE(res.IsShared());
+        const auto& constRes = res;
+        APSARA_TEST_EQUAL(addr, constRes.Get<LogEvent>());
+        // copy on write
+        res.Cast<LogEvent>().SetContent(std::string("key"), std::string("new_value"));
+        APSARA_TEST_NOT_EQUAL(addr, &res.Cast<LogEvent>());
+        APSARA_TEST_FALSE(res.IsShared());
+        APSARA_TEST_EQUAL("new_value", res.Cast<LogEvent>().GetContent("key").to_string());
+        APSARA_TEST_EQUAL("value", logEventPtr.Cast<LogEvent>().GetContent("key").to_string());
+    }
+    {
+        const auto& constPtr = logEventPtr;
+        auto sharedAddr = constPtr.Get<LogEvent>();
+        auto res = logEventPtr.Share();
+        res.Reset(mEventGroup->CreateLogEvent());
+        // the event is still copied even if the other owner is gone, since owners in other threads may not have
+        // finished reading it
+        APSARA_TEST_TRUE(logEventPtr.IsShared());
+        APSARA_TEST_NOT_EQUAL(sharedAddr, logEventPtr.Get<LogEvent>());
+        APSARA_TEST_FALSE(logEventPtr.IsShared());
+        APSARA_TEST_EQUAL("value", logEventPtr.Cast<LogEvent>().GetContent("key").to_string());
+    }
+}
+
 UNIT_TEST_CASE(PipelineEventPtrUnittest, TestIs)
 UNIT_TEST_CASE(PipelineEventPtrUnittest, TestGet)
 UNIT_TEST_CASE(PipelineEventPtrUnittest, TestCast)
 UNIT_TEST_CASE(PipelineEventPtrUnittest, TestCopy)
+UNIT_TEST_CASE(PipelineEventPtrUnittest, TestShare)
 
 } // namespace logtail
 
@@ -180,7 +180,7 @@ void SpanEventUnittest::TestScopeTag() {
 void SpanEventUnittest::TestSize() {
     size_t basicSize = sizeof(time_t) + sizeof(long) + sizeof(SpanEvent::Kind) + sizeof(uint64_t) + sizeof(uint64_t)
         + sizeof(SpanEvent::StatusCode) + sizeof(vector<SpanEvent::InnerEvent>) + sizeof(vector<SpanEvent::SpanLink>)
-        + sizeof(map<StringView, StringView>) + sizeof(map<StringView, StringView>);
+        + sizeof(decltype(SizedMap::mInner)) + sizeof(decltype(SizedMap::mInner));
 
     mSpanEvent->SetTraceId("test_trace_id");
     mSpanEvent->SetSpanId("test_span_id");
@@ -220,7 +220,7 @@ void SpanEventUnittest::TestSize() {
     }
     {
         SpanEvent::InnerEvent* e = mSpanEvent->AddEvent();
-        size_t newBasicSize = basicSize + sizeof(uint64_t) + sizeof(map<StringView, StringView>);
+        size_t newBasicSize = basicSize + sizeof(uint64_t) + sizeof(decltype(SizedMap::mInner));
 
         e->SetName("test_event");
         newBasicSize += strlen("test_event");
@@ -232,7 +232,7 @@ void SpanEventUnittest::TestSize() {
     }
     {
         SpanEvent::SpanLink* l = mSpanEvent->AddLink();
-        size_t newBasicSize = basicSize + sizeof(map<StringView, StringView>);
+        size_t newBasicSize = basicSize + sizeof(decltype(SizedMap::mInner));
 
         l->SetTraceId("other_trace_id");
         l->SetSpanId("other_span_id");
@@ -446,7 +446,7 @@ void InnerEventUnittest::TestTag() {
 }
 
 void InnerEventUnittest::TestSize() {
-    size_t basicSize = sizeof(uint64_t) + sizeof(map<StringView, StringView>);
+    size_t basicSize = sizeof(uint64_t) + sizeof(decltype(SizedMap::mInner));
 
     mInnerEvent->SetName("test");
     basicSize += strlen("test");
@@ -587,7 +587,7 @@ void SpanLinkUnittest::TestTag() {
 }
 
 void SpanLinkUnittest::TestSize() {
-    size_t basicSize = sizeof(map<StringView, StringView>);
+    size_t basicSize = sizeof(decltype(SizedMap::mInner));
 
     mLink->SetTraceId("test_trace_id");
     mLink->SetSpanId("test_span_id");
@@ -16,6 +16,7 @@
 #include "unittest/UnittestHelper.h"
 #include "observer/interface/helper.h"
 #include "observer/network/protocols/utils.h"
+#include "observer/network/protocols/sketch.h"
 #include "network/protocols/mysql/parser.h"
 
 
@@ -327,6 +328,74 @@ public:
         APSARA_TEST_EQUAL(cache.GetResponsesSize(), 0);
         APSARA_TEST_EQUAL(count, 1);
     }
+
+    void TestLatencySketch() {
+        LatencySketch sketch;
+        APSARA_TEST_TRUE(sketch.IsEmpty());
+        APSARA_TEST_EQUAL(sketch.Quantile(0.5), 0);
+        // 1ms ~ 100ms
+        for (int64_t i = 1; i <= 100; ++i) {
+            sketch.Add(i * 1000000);
+        }
+        APSARA_TEST_EQUAL(sketch.Count(), 100U);
+        std::vector<std::pair<double, int64_t>> expected = {{0.5, 50000000}, {0.9, 90000000}, {0.99, 99000000}};
+        for (const auto& item : expected) {
+            double err = std::abs(double(sketch.Quantile(item.first)) / item.second - 1);
+            APSARA_TEST_TRUE(err <= LatencySketch::kRelativeAccuracy + 0.02);
+        }
+        // out of range
+        sketch.Add(-1);
+        sketch.Add(int64_t(1) << 60);
+        APSARA_TEST_EQUAL(sketch.Count(), 102U);
+        APSARA_TEST_EQUAL(sketch.Quantile(0), LatencySketch::kMinLatencyNs);
+
+        LatencySketch other;
+        for (int64_t i = 1; i <= 100; ++i) {
+            other.Add(i * 1000);
+        }
+        sketch.Merge(other);
+        APSARA_TEST_EQUAL(sketch.Count(), 202U);
+        APSARA_TEST_TRUE(sketch.Quantile(0.25) < 1000000);
+
+        LatencySketch restored;
+        APSARA_TEST_TRUE(restored.Deserialize(sketch.Serialize()));
+        APSARA_TEST_EQUAL(restored.Count(), sketch.Count());
+        APSARA_TEST_EQUAL(restored.Quantile(0.5), sketch.Quantile(0.5));
+        APSARA_TEST_EQUAL(restored.Serialize(), sketch.Serialize());
+        APSARA_TEST_FALSE(restored.Deserialize("0.01,1000;1:1"));
+        APSARA_TEST_FALSE(restored.Deserialize(sketch.Serialize() + ",a"));
+        APSARA_TEST_TRUE(restored.IsEmpty());
+
+        sketch.Clear();
+        APSARA_TEST_TRUE(sketch.IsEmpty());
+        APSARA_TEST_EQUAL(sketch.Quantile(0.99), 0);
+    }
+
+    void TestAggResultLatencyQuantile() {
+        CommonProtocolAggResult result, other;
+        CommonProtocolEventInfo info;
+        for (int64_t i = 1; i <= 100; ++i) {
+            info.LatencyNs = i * 1000000;
+            (i % 2 ? result : other).AddEventInfo(info);
+        }
+        result.Merge(other);
+        sls_logs::Log log;
+        result.ToPB(&log);
+        APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "count", "100"));
+        APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "latency_sketch", result.Latency.Serialize()));
+        for (const auto& key : {"latency_p50_ns", "latency_p90_ns", "latency_p99_ns"}) {
+            bool found = false;
+            for (const auto& content : log.contents()) {
+                if (content.key() == key) {
+                    found = true;
+                    APSARA_TEST_TRUE(std::stoll(content.value()) > 0);
+                }
+            }
+            APSARA_TEST_TRUE(found);
+        }
+        result.Clear();
+        APSARA_TEST_TRUE(result.Latency.IsEmpty());
+    }
 };
 
 
@@ -339,6 +408,8 @@ APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheContinueOneByOneAndRe
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheInsertOldResp, 0);
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheInsertNewReq, 0);
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheTryMatchingReq, 0);
+APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestLatencySketch, 0);
+APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestAggResultLatencyQuantile, 0);
 } // namespace logtail
 
 
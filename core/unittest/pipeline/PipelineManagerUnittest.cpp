@@ -12,17 +12,86 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "batch/TimeoutFlushManager.h"
+#include "common/Lock.h"
 #include "pipeline/Pipeline.h"
 #include "pipeline/PipelineManager.h"
+#include "plugin/instance/FlusherInstance.h"
+#include "plugin/interface/Flusher.h"
+#include "processor/daemon/LogProcess.h"
+#include "queue/ProcessQueueManager.h"
+#include "queue/QueueKeyManager.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
 
 namespace logtail {
 
+class PipelineManagerMock : public PipelineManager {
+public:
+    static PipelineManagerMock* GetInstance() {
+        static PipelineManagerMock instance;
+        return &instance;
+    }
+
+    void ClearEnvironment() {
+        mPipelineNameEntityMap.clear();
+        mPluginCntMap.clear();
+        mBuildCnt = 0;
+    }
+
+    static constexpr uint32_t kBuildTimeMs = 200;
+
+    atomic_uint32_t mBuildCnt{0};
+
+private:
+    shared_ptr<Pipeline> BuildPipeline(Config&& config) override {
+        this_thread::sleep_for(chrono::milliseconds(kBuildTimeMs));
+        ++mBuildCnt;
+        return make_shared<Pipeline>();
+    }
+};
+
+// records whether the item being processed had been done when the pipeline was stopped
+class FlusherStopMock : public Flusher {
+public:
+    static const string sName;
+
+    explicit FlusherStopMock(const atomic_bool& isItemProcessed) : mIsItemProcessed(isItemProcessed) {}
+
+    const string& Name() const override { return sName; }
+    bool Init(const Json::Value& config, Json::Value& optionalGoPipeline) override { return true; }
+    bool Register() override { return true; }
+    bool Unregister(bool isPipelineRemoving) override {
+        mIsStopped = true;
+        mIsItemProcessedWhenStopped = mIsItemProcessed;
+        return true;
+    }
+    void Send(PipelineEventGroup&& g) override {}
+    void Flush(size_t key) override { ++mFlushCnt; }
+    void FlushAll() override {}
+
+    const atomic_bool& mIsItemProcessed;
+    bool mIsStopped = false;
+    bool mIsItemProcessedWhenStopped = false;
+    size_t mFlushCnt = 0;
+};
+
+const string FlusherStopMock::sName = "flusher_stop_mock";
+
 class PipelineManagerUnittest : public testing::Test {
 public:
     void TestPipelineManagement() const;
+    void TestUpdatePipelinesWithoutStall() const;
+    void TestStopPipelineAfterPoppedItemProcessed() const;
+
+protected:
+    void TearDown() override { PipelineManagerMock::GetInstance()->ClearEnvironment(); }
 };
 
 void PipelineManagerUnittest::TestPipelineManagement() const {
@@ -34,7 +103,198 @@ void PipelineManagerUnittest::TestPipelineManagement() const {
     APSARA_TEST_EQUAL(nullptr, PipelineManager::GetInstance()->FindPipelineByName("test3"));
 }
 
+void PipelineManagerUnittest::TestUpdatePipelinesWithoutStall() const {
+    auto manager = PipelineManagerMock::GetInstance();
+    // simulate a process daemon with 2 threads
+    auto process = LogProcess::GetInstance();
+    process->mThreadCount = 2;
+    process->mThreadFlags = new atomic_bool[2];
+    process->mThreadRounds = new atomic_uint64_t[2];
+    for (int i = 0; i < 2; ++i) {
+        process->mThreadFlags[i] = false;
+        process->mThreadRounds[i] = 0;
+    }
+    process->mInitialized = true;
+
+    auto running = make_shared<Pipeline>();
+    auto modified = make_shared<Pipeline>();
+    manager->mPipelineNameEntityMap["running"] = running;
+    manager->mPipelineNameEntityMap["modified"] = modified;
+    QueueKey runningKey = QueueKeyManager::GetInstance()->GetKey("running");
+    QueueKey modifiedKey = QueueKeyManager::GetInstance()->GetKey("modified");
+    ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(runningKey, 0);
+    ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(modifiedKey, 0);
+    ProcessQueueManager::GetInstance()->PushQueue(
+        modifiedKey,
+        unique_ptr<ProcessQueueItem>(new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), 0)));
+
+    // the same steps as LogProcess::ProcessLoop, with the item of the modified pipeline held until released
+    atomic_bool isItemPopped = false, isItemReleased = false, isThreadDone = false;
+    shared_ptr<Pipeline> pipelineWhenItemDone;
+    thread modifiedThread([&]() {
+        ReadLock lock(process->mAccessProcessThreadRWL);
+        process->mThreadFlags[0] = true;
+        unique_ptr<ProcessQueueItem> item;
+        string configName;
+        if (ProcessQueueManager::GetInstance()->PopItem(0, item, configName) && configName == "modified") {
+            isItemPopped = true;
+            while (!isItemReleased) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            pipelineWhenItemDone = manager->FindPipelineByName("modified");
+        }
+        process->mThreadFlags[0] = false;
+        ++process->mThreadRounds[0];
+        isThreadDone = true;
+    });
+    while (!isItemPopped && !isThreadDone) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    APSARA_TEST_TRUE_FATAL(isItemPopped);
+
+    ConfigDiff diff;
+    diff.mModified.emplace_back("modified", make_unique<Json::Value>());
+    thread updateThread([&]() { manager->UpdatePipelines(diff); });
+    // once built, the new pipeline waits for the item of the old one
+    while (manager->mBuildCnt == 0) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    // meanwhile, items of the unchanged pipeline keep being processed
+    const size_t kItemCnt = 10;
+    atomic_size_t processedCnt = 0;
+    thread runningThread([&]() {
+        while (processedCnt < kItemCnt && !isItemReleased) {
+            ReadLock lock(process->mAccessProcessThreadRWL);
+            process->mThreadFlags[1] = true;
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            if (!ProcessQueueManager::GetInstance()->PopItem(1, item, configName)) {
+                process->mThreadFlags[1] = false;
+                ProcessQueueManager::GetInstance()->Wait(10);
+                continue;
+            }
+            if (manager->FindPipelineByName(configName) == running) {
+                ++processedCnt;
+            }
+            process->mThreadFlags[1] = false;
+            ++process->mThreadRounds[1];
+        }
+    });
+    for (size_t i = 0; i < kItemCnt; ++i) {
+        ProcessQueueManager::GetInstance()->PushQueue(
+            runningKey,
+            unique_ptr<ProcessQueueItem>(new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), 0)));
+    }
+    // the deadline only keeps the test from hanging if the unchanged pipeline is blocked
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (processedCnt < kItemCnt && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    size_t processedCntBeforeRelease = processedCnt;
+    auto pipelineBeforeRelease = manager->FindPipelineByName("modified");
+
+    isItemReleased = true;
+    modifiedThread.join();
+    updateThread.join();
+    runningThread.join();
+
+    APSARA_TEST_EQUAL(kItemCnt, processedCntBeforeRelease);
+    // the new pipeline is visible only after the item of the old one has been processed
+    APSARA_TEST_EQUAL(modified, pipelineBeforeRelease);
+    APSARA_TEST_EQUAL(modified, pipelineWhenItemDone);
+    APSARA_TEST_NOT_EQUAL(nullptr, manager->FindPipelineByName("modified"));
+    APSARA_TEST_NOT_EQUAL(modified, manager->FindPipelineByName("modified"));
+    APSARA_TEST_EQUAL(running, manager->FindPipelineByName("running"));
+
+    for (auto key : {runningKey, modifiedKey}) {
+        ProcessQueueManager::GetInstance()->DeleteQueue(key);
+        QueueKeyManager::GetInstance()->RemoveKey(key);
+    }
+    process->mInitialized = false;
+    delete[] process->mThreadFlags;
+    delete[] process->mThreadRounds;
+}
+
+void PipelineManagerUnittest::TestStopPipelineAfterPoppedItemProcessed() const {
+    auto manager = PipelineManagerMock::GetInstance();
+    // simulate a process daemon with 1 thread
+    auto process = LogProcess::GetInstance();
+    process->mThreadCount = 1;
+    process->mThreadFlags = new atomic_bool[1];
+    process->mThreadFlags[0] = false;
+    process->mThreadRounds = new atomic_uint64_t[1];
+    process->mThreadRounds[0] = 0;
+    process->mInitialized = true;
+
+    for (bool isRemoving : {true, false}) {
+        string name = isRemoving ? "removed" : "modified";
+        QueueKey key = QueueKeyManager::GetInstance()->GetKey(name);
+        ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(key, 0);
+        ProcessQueueManager::GetInstance()->PushQueue(
+            key,
+            unique_ptr<ProcessQueueItem>(new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), 0)));
+
+        atomic_bool isItemPopped = false, isItemProcessed = false, isThreadDone = false;
+        auto old = make_shared<Pipeline>();
+        old->GetContext().SetProcessQueueKey(key);
+        auto flusher = new FlusherStopMock(isItemProcessed);
+        old->mFlushers.emplace_back(new FlusherInstance(flusher, "0"));
+        manager->mPipelineNameEntityMap[name] = old;
+        // an expired batch, which should never be flushed once the pipeline is released
+        TimeoutFlushManager::GetInstance()->UpdateRecord(name, 0, 0, 0, flusher);
+
+        // the same steps as LogProcess::ProcessLoop, with processing taking longer than building a pipeline
+        thread processThread([&]() {
+            process->mThreadFlags[0] = true;
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            if (ProcessQueueManager::GetInstance()->PopItem(0, item, configName) && configName == name) {
+                isItemPopped = true;
+                this_thread::sleep_for(chrono::milliseconds(2 * PipelineManagerMock::kBuildTimeMs));
+                isItemProcessed = true;
+            }
+            process->mThreadFlags[0] = false;
+            ++process->mThreadRounds[0];
+            isThreadDone = true;
+        });
+        while (!isItemPopped && !isThreadDone) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        APSARA_TEST_TRUE_FATAL(isItemPopped);
+
+        ConfigDiff diff;
+        if (isRemoving) {
+            diff.mRemoved.emplace_back(name);
+        } else {
+            diff.mModified.emplace_back(name, make_unique<Json::Value>());
+        }
+        manager->UpdatePipelines(diff);
+        processThread.join();
+
+        APSARA_TEST_TRUE(flusher->mIsStopped);
+        APSARA_TEST_TRUE(flusher->mIsItemProcessedWhenStopped);
+        TimeoutFlushManager::GetInstance()->FlushTimeoutBatch();
+        APSARA_TEST_EQUAL(0U, flusher->mFlushCnt);
+        if (isRemoving) {
+            APSARA_TEST_EQUAL(nullptr, manager->FindPipelineByName(name));
+            APSARA_TEST_FALSE(QueueKeyManager::GetInstance()->HasKey(name));
+        } else {
+            APSARA_TEST_NOT_EQUAL(nullptr, manager->FindPipelineByName(name));
+            APSARA_TEST_NOT_EQUAL(old, manager->FindPipelineByName(name));
+            ProcessQueueManager::GetInstance()->DeleteQueue(key);
+            QueueKeyManager::GetInstance()->RemoveKey(key);
+        }
+    }
+
+    process->mInitialized = false;
+    delete[] process->mThreadFlags;
+    delete[] process->mThreadRounds;
+}
+
 UNIT_TEST_CASE(PipelineManagerUnittest, TestPipelineManagement)
+UNIT_TEST_CASE(PipelineManagerUnittest, TestUpdatePipelinesWithoutStall)
+UNIT_TEST_CASE(PipelineManagerUnittest, TestStopPipelineAfterPoppedItemProcessed)
 
 } // namespace logtail
 
@@ -17,9 +17,12 @@
 #include <iostream>
 #include <sstream>
 
+#include "common/LogtailCommonFlags.h"
+#include "common/SimdUtil.h"
 #include "config/Config.h"
 #include "models/LogEvent.h"
 #include "plugin/instance/ProcessorInstance.h"
+#include "processor/ProcessorParseJsonNative.h"
 #include "processor/inner/ProcessorParseContainerLogNative.h"
 #include "unittest/Unittest.h"
 
@@ -40,8 +43,9 @@ std::string formatSize(long long size) {
     return ss.str();
 }
 
-static void BM_DockerJson(int size, int batchSize) {
+static void BM_DockerJson(int size, int batchSize, bool enableScanner) {
     logtail::Logger::Instance().InitGlobalLoggers();
+    BOOL_FLAG(enable_json_scanner) = enableScanner;
 
     PipelineContext mContext;
     mContext.SetConfigName("project##config_0");
@@ -266,6 +270,64 @@ static void BM_ContainerdText(int size, int batchSize) {
     }
 }
 
+// typical json logs of applications, which are flat, with some escaped strings and numbers
+static void BM_Json(int size, int batchSize, bool enableScanner) {
+    BOOL_FLAG(enable_json_scanner) = enableScanner;
+
+    PipelineContext mContext;
+    mContext.SetConfigName("project##config_0");
+
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["KeepingSourceWhenParseFail"] = true;
+    ProcessorParseJsonNative processor;
+    processor.SetContext(mContext);
+    processor.SetMetricsRecordRef(ProcessorParseJsonNative::sName, "1");
+
+    std::vector<std::string> lines = {
+        R"json({"time":"2024-04-07T08:02:40.873971412Z","level":"INFO","logger":"com.example.myproject.BookService","thread":"http-nio-8080-exec-1","traceId":"6a2f1e0c9b7d4e8f","message":"query book finished","bookId":123456,"costMs":15,"success":true})json",
+        R"json({"time":"2024-04-07T08:02:40.873976048Z","level":"ERROR","logger":"com.example.myproject.BookService","thread":"http-nio-8080-exec-2","traceId":"6a2f1e0c9b7d4e90","message":"Exception in thread \"main\" java.lang.NullPointerException\n\tat com.example.myproject.Book.getTitle(Book.java:16)\n\tat com.example.myproject.Author.getBookTitles(Author.java:25)","bookId":123457,"costMs":3,"success":false})json",
+        R"json({"remote_addr":"10.200.98.220","remote_user":"-","time_local":"07/Apr/2024:08:02:40 +0800","request":"GET /api/v1/books?id=123456 HTTP/1.1","status":200,"body_bytes_sent":2368,"http_referer":"-","http_user_agent":"Mozilla/5.0 (Windows NT 10.0; Win64; x64)","request_time":"0.015"})json",
+    };
+    size_t linesSize = 0;
+    Json::Value events;
+    for (int i = 0; i < size; i++) {
+        for (const auto& line : lines) {
+            Json::Value event;
+            event["type"] = 1;
+            event["timestamp"] = 1234567890;
+            event["timestampNanosecond"] = 0;
+            event["contents"]["content"] = line;
+            events.append(event);
+            linesSize += line.size();
+        }
+    }
+    Json::Value root;
+    root["events"] = events;
+    Json::StreamWriterBuilder builder;
+    builder["commentStyle"] = "None";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    std::ostringstream oss;
+    writer->write(root, &oss);
+    std::string inJson = oss.str();
+    std::cout << "log size:\t" << formatSize(linesSize) << std::endl;
+
+    if (processor.Init(config)) {
+        uint64_t durationTime = 0;
+        for (int i = 0; i < batchSize; i++) {
+            auto sourceBuffer = std::make_shared<SourceBuffer>();
+            PipelineEventGroup eventGroup(sourceBuffer);
+            eventGroup.FromJsonString(inJson);
+
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            processor.Process(eventGroup);
+            durationTime += GetCurrentTimeInMicroSeconds() - startTime;
+        }
+        std::cout << "durationTime: " << durationTime << std::endl;
+        std::cout << "process: " << formatSize(linesSize * (uint64_t)batchSize * 1000000 / durationTime) << std::endl;
+    }
+}
+
 int main(int argc, char** argv) {
     logtail::Logger::Instance().InitGlobalLoggers();
 #ifdef NDEBUG
@@ -273,8 +335,15 @@ int main(int argc, char** argv) {
 #else
     std::cout << "debug" << std::endl;
 #endif
-    std::cout << "docker json" << std::endl;
-    BM_DockerJson(512, 100);
+    std::cout << "simd level: " << SimdLevelToString(GetSupportedSimdLevel()) << std::endl;
+    std::cout << "docker json, ParseDockerLog" << std::endl;
+    BM_DockerJson(512, 100, false);
+    std::cout << "docker json, JsonScanner" << std::endl;
+    BM_DockerJson(512, 100, true);
+    std::cout << "json, rapidjson" << std::endl;
+    BM_Json(512, 100, false);
+    std::cout << "json, JsonScanner" << std::endl;
+    BM_Json(512, 100, true);
     std::cout << "containerdText" << std::endl;
     BM_ContainerdText(512, 100);
     return 0;
@@ -0,0 +1,140 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/regex.hpp>
+#include <cstdlib>
+#include <iostream>
+
+#include "common/JsonUtil.h"
+#include "processor/ProcessorFilterNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+static void CreateEvents(PipelineEventGroup& group, size_t eventCnt, size_t valueSize) {
+    for (size_t i = 0; i < eventCnt; ++i) {
+        auto e = group.AddLogEvent();
+        e->SetContent(string("method"), string(i % 2 ? "GET" : "POST"));
+        e->SetContent(string("status"), string(i % 3 ? "200" : "500"));
+        e->SetContent(string("url"), "/api/v1/" + string(valueSize, 'a' + i % 26));
+        e->SetContent(string("content"), "level=INFO " + string(valueSize, 'a' + i % 26));
+    }
+}
+
+// several regexes on the same key, which is how FilterKey + FilterRegex is commonly configured
+static void BM_Rule(size_t valueSize, int batchSize) {
+    const vector<string> exps = {"level=\\w+ .*", ".*a.*", "[^\\n]*"};
+    vector<boost::regex> boostRegs(exps.begin(), exps.end());
+    FilterRegexMatcher matcher;
+    matcher.Init(exps);
+
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    CreateEvents(group, 1000, valueSize);
+    uint64_t boostTime = 0, re2Time = 0;
+    size_t boostCnt = 0, re2Cnt = 0;
+    string exception;
+    for (int i = 0; i < batchSize; ++i) {
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        for (const auto& e : group.GetEvents()) {
+            StringView value = e.Cast<LogEvent>().GetContent("content");
+            bool matched = true;
+            for (const auto& reg : boostRegs) {
+                if (!BoostRegexMatch(value.data(), value.size(), reg, exception)) {
+                    matched = false;
+                    break;
+                }
+            }
+            boostCnt += matched;
+        }
+        boostTime += GetCurrentTimeInMicroSeconds() - startTime;
+        startTime = GetCurrentTimeInMicroSeconds();
+        for (const auto& e : group.GetEvents()) {
+            re2Cnt += matcher.Match(e.Cast<LogEvent>().GetContent("content"), exception);
+        }
+        re2Time += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    cout << "value size: " << valueSize << "\tboost: " << boostTime << "us\tre2 set: " << re2Time << "us" << endl;
+    if (boostCnt != re2Cnt) {
+        cout << "error: " << boostCnt << " vs " << re2Cnt << endl;
+    }
+}
+
+static void BM_Expression(size_t valueSize, int batchSize) {
+    const char* jsonStr = R"({
+        "operator": "and",
+        "operands": [
+            {
+                "operator": "or",
+                "operands": [
+                    {"type": "regex", "key": "method", "exp": "GET"},
+                    {"type": "regex", "key": "status", "exp": "5\\d\\d"}
+                ]
+            },
+            {
+                "operator": "not",
+                "operands": [
+                    {"type": "regex", "key": "url", "exp": "/api/v\\d+/b.*"}
+                ]
+            }
+        ]
+    })";
+    Json::Value root;
+    string errorMsg;
+    ParseJsonTable(jsonStr, root, errorMsg);
+    BaseFilterNodePtr tree = ParseExpressionFromJSON(root);
+    FilterProgram program;
+    program.Compile(tree);
+
+    PipelineContext ctx;
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    CreateEvents(group, 1000, valueSize);
+    uint64_t treeTime = 0, programTime = 0;
+    size_t treeCnt = 0, programCnt = 0;
+    for (int i = 0; i < batchSize; ++i) {
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        for (const auto& e : group.GetEvents()) {
+            treeCnt += tree->Match(e.Cast<LogEvent>(), ctx);
+        }
+        treeTime += GetCurrentTimeInMicroSeconds() - startTime;
+        startTime = GetCurrentTimeInMicroSeconds();
+        for (const auto& e : group.GetEvents()) {
+            programCnt += program.Match(e.Cast<LogEvent>(), ctx);
+        }
+        programTime += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    cout << "value size: " << valueSize << "\tboost tree: " << treeTime << "us\tre2 program: " << programTime << "us"
+         << endl;
+    if (treeCnt != programCnt) {
+        cout << "error: " << treeCnt << " vs " << programCnt << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    cout << "BM_Rule" << endl;
+    BM_Rule(10, 100);
+    BM_Rule(100, 100);
+    BM_Rule(1000, 100);
+    cout << "BM_Expression" << endl;
+    BM_Expression(10, 100);
+    BM_Expression(100, 100);
+    BM_Expression(1000, 100);
+    return 0;
+}
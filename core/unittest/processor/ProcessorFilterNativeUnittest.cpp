@@ -31,6 +31,8 @@ public:
     void TestLogFilterRule();
     void TestBaseFilter();
     void TestFilterNoneUtf8();
+    void TestFilterRegexMatcher();
+    void TestFilterProgram();
 
     PipelineContext mContext;
 };
@@ -40,6 +42,8 @@ UNIT_TEST_CASE(ProcessorFilterNativeUnittest, OnFailedInit)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestLogFilterRule)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestBaseFilter)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestFilterNoneUtf8)
+UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestFilterRegexMatcher)
+UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestFilterProgram)
 
 void ProcessorFilterNativeUnittest::OnSuccessfulInit() {
     unique_ptr<ProcessorFilterNative> processor;
@@ -1035,6 +1039,98 @@ void ProcessorFilterNativeUnittest::TestFilterNoneUtf8() {
     }
 } // end of case
 
+void ProcessorFilterNativeUnittest::TestFilterRegexMatcher() {
+    std::string exception;
+    { // single regex
+        FilterRegexMatcher matcher;
+        APSARA_TEST_TRUE(matcher.Init({"value.*"}));
+        APSARA_TEST_NOT_EQUAL(nullptr, matcher.mRE2);
+        APSARA_TEST_EQUAL(nullptr, matcher.mRE2Set);
+        APSARA_TEST_TRUE(matcher.Match(StringView("value1"), exception));
+        APSARA_TEST_FALSE(matcher.Match(StringView("xvalue1"), exception));
+        // consistent with boost::regex_match
+        APSARA_TEST_TRUE(matcher.Match(StringView("value\nabc"), exception));
+        APSARA_TEST_TRUE(matcher.Match(StringView("value\xff\xfe"), exception));
+    }
+    { // multiple regexes
+        FilterRegexMatcher matcher;
+        APSARA_TEST_TRUE(matcher.Init({"value.*", ".*1", "\\w+"}));
+        APSARA_TEST_EQUAL(nullptr, matcher.mRE2);
+        APSARA_TEST_NOT_EQUAL(nullptr, matcher.mRE2Set);
+        APSARA_TEST_EQUAL(3U, matcher.Size());
+        APSARA_TEST_TRUE(matcher.Match(StringView("value1"), exception));
+        APSARA_TEST_FALSE(matcher.Match(StringView("value2"), exception));
+        APSARA_TEST_FALSE(matcher.Match(StringView("value 1"), exception));
+    }
+    { // regex unsupported by re2
+        FilterRegexMatcher matcher;
+        APSARA_TEST_TRUE(matcher.Init({"(a+)b\\1", "a.*"}));
+        APSARA_TEST_NOT_EQUAL(nullptr, matcher.mRE2);
+        APSARA_TEST_EQUAL(1U, matcher.mBoostRegs.size());
+        APSARA_TEST_TRUE(matcher.Match(StringView("aabaa"), exception));
+        APSARA_TEST_FALSE(matcher.Match(StringView("aaba"), exception));
+    }
+    { // invalid regex
+        FilterRegexMatcher matcher;
+        APSARA_TEST_FALSE(matcher.Init({"[a"}));
+    }
+}
+
+void ProcessorFilterNativeUnittest::TestFilterProgram() {
+    // not (key1 matches "a.*" and (key2 matches "b.*" or key3 matches "c.*"))
+    const char* jsonStr = R"({
+        "operator": "not",
+        "operands": [
+            {
+                "operator": "and",
+                "operands": [
+                    {
+                        "type": "regex",
+                        "key": "key1",
+                        "exp": "a.*"
+                    },
+                    {
+                        "operator": "or",
+                        "operands": [
+                            {
+                                "type": "regex",
+                                "key": "key2",
+                                "exp": "b.*"
+                            },
+                            {
+                                "type": "regex",
+                                "key": "key3",
+                                "exp": "c.*"
+                            }
+                        ]
+                    }
+                ]
+            }
+        ]
+    })";
+    Json::Value rootNode;
+    std::string errorMsg;
+    APSARA_TEST_TRUE_FATAL(ParseJsonTable(jsonStr, rootNode, errorMsg));
+    FilterProgram program;
+    APSARA_TEST_TRUE_FATAL(program.Compile(ParseExpressionFromJSON(rootNode)));
+    APSARA_TEST_EQUAL(6U, program.mInstructions.size());
+    APSARA_TEST_EQUAL(3U, program.mMatchers.size());
+    APSARA_TEST_EQUAL(6U, program.mInstructions[0].mEnd);
+    APSARA_TEST_EQUAL(3U, program.mInstructions[2].mEnd);
+
+    PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+    auto event = eventGroup.AddLogEvent();
+    event->SetContent(std::string("key1"), std::string("a1"));
+    event->SetContent(std::string("key3"), std::string("c1"));
+    APSARA_TEST_FALSE(program.Match(*event, mContext));
+    event->SetContent(std::string("key3"), std::string("d1"));
+    APSARA_TEST_TRUE(program.Match(*event, mContext));
+    event->SetContent(std::string("key2"), std::string("b1"));
+    APSARA_TEST_FALSE(program.Match(*event, mContext));
+    event->SetContent(std::string("key1"), std::string("b1"));
+    APSARA_TEST_TRUE(program.Match(*event, mContext));
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
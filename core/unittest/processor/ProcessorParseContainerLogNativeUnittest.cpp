@@ -52,6 +52,7 @@ public:
     void TestDockerJsonLogLineParser();
     void TestKeepingSourceWhenParseFail();
     void TestParseDockerLog();
+    void TestScanDockerLog();
 
     PipelineContext mContext;
 };
@@ -64,6 +65,7 @@ UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestDockerJsonLogLinePa
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestDockerJsonLogLineParser);
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestKeepingSourceWhenParseFail);
 UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestParseDockerLog);
+UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestScanDockerLog);
 // UNIT_TEST_CASE(ProcessorParseContainerLogNativeUnittest, TestFindAndSearchPerformance);
 
 // 生成一个随机字符串
@@ -2264,6 +2266,44 @@ void ProcessorParseContainerLogNativeUnittest::TestParseDockerLog() {
     }
 }
 
+void ProcessorParseContainerLogNativeUnittest::TestScanDockerLog() {
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    PipelineEventGroup eventGroup(sourceBuffer);
+    LogEvent* sourceEvent = eventGroup.AddLogEvent();
+    // lines accepted by ScanDockerLog, which should be the same as ParseDockerLog
+    const std::vector<std::string> scannedLines = {
+        R"({"log":"Hello, World!\n","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"time":"2024-04-09T02:21:28.744862802Z","stream":"stderr","log":""})",
+        R"({"log":"say \"hi\"\t\\ \u4e2d\u6587\/\n","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":"a","log":"b","time":"2024-04-09T02:21:28.744862802Z"})",
+    };
+    for (const auto& line : scannedLines) {
+        DockerLog scanned, parsed;
+        APSARA_TEST_TRUE_FATAL(ProcessorParseContainerLogNative::ScanDockerLog(*sourceEvent, line, scanned));
+        std::string buffer = line;
+        APSARA_TEST_TRUE_FATAL(ProcessorParseContainerLogNative::ParseDockerLog(&buffer[0], buffer.size(), parsed));
+        APSARA_TEST_EQUAL(parsed.log, scanned.log);
+        APSARA_TEST_EQUAL(parsed.stream, scanned.stream);
+        APSARA_TEST_EQUAL(parsed.time, scanned.time);
+    }
+    // lines left to ParseDockerLog
+    const std::vector<std::string> unscannedLines = {
+        R"({"log": "a","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"( {"log":"a","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":"a","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z","attrs":"x"})",
+        R"({"log":"a","stream":"stdout"})",
+        R"({"log":"a","stream":"std\out","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":"a\x","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":"\ud83d\ude00","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":1,"stream":"stdout","time":"2024-04-09T02:21:28.744862802Z"})",
+        R"({"log":"a","stream":"stdout","time":"2024-04-09T02:21:28.744862802Z")",
+    };
+    for (const auto& line : unscannedLines) {
+        DockerLog scanned;
+        APSARA_TEST_FALSE_DESC(ProcessorParseContainerLogNative::ScanDockerLog(*sourceEvent, line, scanned), line);
+    }
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
\ No newline at end of file
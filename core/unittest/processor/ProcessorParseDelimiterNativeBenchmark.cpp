@@ -0,0 +1,165 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <iostream>
+
+#include "common/SimdUtil.h"
+#include "common/TimeUtil.h"
+#include "parser/DelimiterModeFsmParser.h"
+#include "parser/DelimiterTokenizer.h"
+#include "plugin/instance/ProcessorInstance.h"
+#include "processor/ProcessorParseDelimiterNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// lines of colCnt columns, with every other column quoted and containing a separator and a doubled quote if quoted
+static vector<string> CreateLines(size_t lineCnt, size_t colCnt, bool quoted) {
+    vector<string> lines;
+    lines.reserve(lineCnt);
+    for (size_t i = 0; i < lineCnt; ++i) {
+        string line;
+        for (size_t j = 0; j < colCnt; ++j) {
+            if (j > 0) {
+                line.push_back(',');
+            }
+            if (quoted && j % 2 == 1) {
+                line.append("\"value, \"\"");
+                line.append(to_string(i + j));
+                line.append("\"\"\"");
+            } else {
+                line.append("value_");
+                line.append(to_string(i + j));
+            }
+        }
+        lines.emplace_back(std::move(line));
+    }
+    return lines;
+}
+
+static size_t TotalSize(const vector<string>& lines) {
+    size_t size = 0;
+    for (const auto& line : lines) {
+        size += line.size();
+    }
+    return size;
+}
+
+static void BM_Tokenize(size_t colCnt, bool quoted, int batchSize) {
+    vector<string> lines = CreateLines(1000, colCnt, quoted);
+    size_t totalSize = TotalSize(lines) * batchSize;
+    cout << "columns: " << colCnt << "\tquoted: " << quoted;
+
+    // the state machine used before, which runs per char
+    DelimiterModeFsmParser fsm('"', ',');
+    vector<StringView> columns;
+    size_t expectedCnt = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        expectedCnt = 0;
+        for (const auto& line : lines) {
+            columns.clear();
+            fsm.ParseDelimiterLine(line, 0, line.size(), columns);
+            expectedCnt += columns.size();
+        }
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << "\tfsm: " << totalSize / elapsed << "MB/s";
+
+    vector<size_t> escapedColumns;
+    string unescaped;
+    for (SimdLevel level : {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > GetSupportedSimdLevel()) {
+            continue;
+        }
+        DelimiterTokenizer tokenizer(',', true, '"', level);
+        size_t cnt = 0;
+        startTime = GetCurrentTimeInMicroSeconds();
+        for (int i = 0; i < batchSize; ++i) {
+            cnt = 0;
+            for (const auto& line : lines) {
+                tokenizer.Tokenize(line, columns, escapedColumns);
+                for (size_t idx : escapedColumns) {
+                    unescaped.resize(columns[idx].size());
+                    tokenizer.Unescape(columns[idx], &unescaped[0]);
+                }
+                cnt += columns.size();
+            }
+        }
+        elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+        cout << "\t" << SimdLevelToString(level) << ": " << totalSize / elapsed << "MB/s";
+        if (cnt != expectedCnt) {
+            cout << "\terror: " << cnt << " vs " << expectedCnt;
+        }
+    }
+    cout << endl;
+}
+
+// the whole processor, including event creation
+static void BM_Process(size_t colCnt, bool quoted, int batchSize) {
+    vector<string> lines = CreateLines(1000, colCnt, quoted);
+    PipelineContext ctx;
+    ctx.SetConfigName("project##config_0");
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["Separator"] = ",";
+    config["Quote"] = "\"";
+    config["Keys"] = Json::arrayValue;
+    for (size_t i = 0; i < colCnt; ++i) {
+        config["Keys"].append("key_" + to_string(i));
+    }
+    ProcessorParseDelimiterNative& processor = *(new ProcessorParseDelimiterNative);
+    ProcessorInstance processorInstance(&processor, "1");
+    processorInstance.Init(config, ctx);
+
+    uint64_t elapsed = 0;
+    for (int i = 0; i < batchSize; ++i) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        for (const auto& line : lines) {
+            StringBuffer b = group.GetSourceBuffer()->CopyString(line);
+            auto e = group.AddLogEvent();
+            e->SetContentNoCopy("content", StringView(b.data, b.size));
+        }
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(group);
+        elapsed += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    cout << "columns: " << colCnt << "\tquoted: " << quoted
+         << "\tprocess: " << TotalSize(lines) * batchSize / max<uint64_t>(elapsed, 1) << "MB/s" << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    cout << "supported simd level: " << SimdLevelToString(GetSupportedSimdLevel()) << endl;
+    cout << "BM_Tokenize" << endl;
+    for (bool quoted : {false, true}) {
+        for (size_t colCnt : {4, 16, 64, 256}) {
+            BM_Tokenize(colCnt, quoted, 100);
+        }
+    }
+    cout << "BM_Process" << endl;
+    for (bool quoted : {false, true}) {
+        for (size_t colCnt : {4, 16, 64, 256}) {
+            BM_Process(colCnt, quoted, 20);
+        }
+    }
+    return 0;
+}
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include <random>
 
 #include "common/JsonUtil.h"
 #include "config/Config.h"
 #include "models/LogEvent.h"
+#include "parser/DelimiterModeFsmParser.h"
+#include "parser/DelimiterTokenizer.h"
 #include "plugin/instance/ProcessorInstance.h"
 #include "processor/inner/ProcessorMergeMultilineLogNative.h"
 #include "processor/ProcessorParseDelimiterNative.h"
@@ -45,6 +48,8 @@ public:
     void TestProcessEventDiscardUnmatch();
     void TestAllowingShortenedFields();
     void TestExtend();
+    void TestProcessDoubledQuotes();
+    void TestTokenizerConsistentWithFsm();
     PipelineContext mContext;
 };
 
@@ -60,6 +65,8 @@ UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessEventKeepUnmatc
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessEventDiscardUnmatch);
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestAllowingShortenedFields);
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestExtend);
+UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessDoubledQuotes);
+UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestTokenizerConsistentWithFsm);
 
 void ProcessorParseDelimiterNativeUnittest::TestAllowingShortenedFields() {
     // make config
@@ -2188,6 +2195,114 @@ void ProcessorParseDelimiterNativeUnittest::TestProcessEventDiscardUnmatch() {
     APSARA_TEST_EQUAL_FATAL(uint64_t(count), processor.mProcParseErrorTotal->GetValue());
 }
 
+void ProcessorParseDelimiterNativeUnittest::TestProcessDoubledQuotes() {
+    // make config
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["Separator"] = ",";
+    config["Keys"] = Json::arrayValue;
+    config["Keys"].append("time");
+    config["Keys"].append("message");
+    config["Keys"].append("tags");
+    config["Keys"].append("request_time");
+    // make events
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    PipelineEventGroup eventGroup(sourceBuffer);
+    std::string inJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "content" : "2013-10-31 21:03:49,\"say \"\"hi\"\", bye\",\"\"\"a\"\",\"\"b\"\"\",0.024"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond": 0,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "content" : "2013-10-31 21:03:49,\"say \"hi\"\",\"\",0.024"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond": 0,
+                "type" : 1
+            }
+        ]
+    })";
+    eventGroup.FromJsonString(inJson);
+    // run function
+    ProcessorParseDelimiterNative& processor = *(new ProcessorParseDelimiterNative);
+    std::string pluginId = "testID";
+    ProcessorInstance processorInstance(&processor, pluginId);
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    processor.Process(eventGroup);
+    std::string expectJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "message": "say \"hi\", bye",
+                    "request_time": "0.024",
+                    "tags": "\"a\",\"b\"",
+                    "time": "2013-10-31 21:03:49"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond": 0,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "__raw_log__": "2013-10-31 21:03:49,\"say \"hi\"\",\"\",0.024"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond": 0,
+                "type" : 1
+            }
+        ]
+    })";
+    // judge result
+    std::string outJson = eventGroup.ToJsonString();
+    APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
+}
+
+void ProcessorParseDelimiterNativeUnittest::TestTokenizerConsistentWithFsm() {
+    // lines made up of separators, quotes and data at random, so that every char appears at all positions of blocks,
+    // and most of the lines are invalid
+    static const char kChars[] = {'a', 'a', 'a', ' ', ',', ',', '"', '"'};
+    static const SimdLevel kAllLevels[] = {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2};
+    std::mt19937 gen(12345);
+    for (int i = 0; i < 20000; ++i) {
+        std::string line(gen() % 200, 'a');
+        for (auto& c : line) {
+            c = kChars[gen() % sizeof(kChars)];
+        }
+        for (bool useQuote : {true, false}) {
+            // the quote of the fsm never appears if quotes are disabled
+            DelimiterModeFsmParser fsm(useQuote ? '"' : '\x01', ',');
+            std::vector<std::string> expected;
+            bool expectedRes = fsm.ParseDelimiterLine(line.data(), 0, line.size(), expected);
+            for (SimdLevel level : kAllLevels) {
+                DelimiterTokenizer tokenizer(',', useQuote, '"', level);
+                std::vector<StringView> columns;
+                std::vector<size_t> escapedColumns;
+                APSARA_TEST_EQUAL_DESC(expectedRes, tokenizer.Tokenize(line, columns, escapedColumns), line);
+                std::vector<std::string> res;
+                for (const auto& column : columns) {
+                    res.emplace_back(column.to_string());
+                }
+                for (size_t idx : escapedColumns) {
+                    res[idx].resize(tokenizer.Unescape(columns[idx], &res[idx][0]));
+                }
+                APSARA_TEST_TRUE_DESC(expected == res, line);
+            }
+        }
+    }
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <cstdlib>
 
 #include "common/JsonUtil.h"
+#include "common/LogtailCommonFlags.h"
 #include "config/Config.h"
 #include "models/LogEvent.h"
 #include "plugin/instance/ProcessorInstance.h"
@@ -35,6 +36,7 @@ public:
     void TestProcessJsonContent();
     void TestProcessJsonRaw();
     void TestMultipleLines();
+    void TestScannerConsistentWithRapidjson();
 
     PipelineContext mContext;
 };
@@ -55,6 +57,59 @@ UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestProcessJsonRaw);
 
 UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestMultipleLines);
 
+UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestScannerConsistentWithRapidjson);
+
+void ProcessorParseJsonNativeUnittest::TestScannerConsistentWithRapidjson() {
+    // lines parsed by the scanner, as well as those falling back to rapidjson
+    const std::vector<std::string> lines = {
+        R"({"a":"b","c":1,"d":true,"e":false,"f":null,"g":-123})",
+        R"( { "a" : "b" , "c" : 1 } )",
+        R"({})",
+        R"({"a":"1","a":"2"})",
+        R"({"content":"overwritten","rawLog":"raw"})",
+        R"({"msg":"line1\nline2 \"quoted\" \\ \/ \b\f\r\t \u4e2d\u6587","k\"ey":"v"})",
+        "{\"long\":\"" + std::string(60, 'a') + "\\\"" + std::string(60, 'b') + "\\\\\",\"next\":\"value\"}",
+        R"({"emoji":"\ud83d\ude00"})",
+        R"({"nul":"a\u0000b"})",
+        R"({"nested":{"b":[1,2.5,"c"]},"double":1.50,"exp":1e3,"zero":-0,"big":12345678901234567890})",
+        R"({"a":"b")",
+        R"({"a":"b"} x)",
+        R"({"a":"b",})",
+        R"(["a","b"])",
+        R"("a")",
+        "{\"a\":\"b\tc\"}",
+        R"({"a":"\x"})",
+        "",
+    };
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["KeepingSourceWhenParseFail"] = true;
+    config["KeepingSourceWhenParseSucceed"] = true;
+    config["CopingRawLog"] = true;
+    config["RenamedSourceKey"] = "rawLog";
+
+    std::string outJson[2];
+    for (bool enableScanner : {false, true}) {
+        BOOL_FLAG(enable_json_scanner) = enableScanner;
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        for (const auto& line : lines) {
+            LogEvent* e = eventGroup.AddLogEvent();
+            e->SetContent(std::string("content"), line);
+            e->SetTimestamp(12345678901);
+        }
+        ProcessorParseJsonNative& processor = *(new ProcessorParseJsonNative);
+        ProcessorInstance processorInstance(&processor, "testID");
+        APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+        std::vector<PipelineEventGroup> eventGroupList;
+        eventGroupList.emplace_back(std::move(eventGroup));
+        processorInstance.Process(eventGroupList);
+        outJson[enableScanner] = eventGroupList[0].ToJsonString();
+    }
+    BOOL_FLAG(enable_json_scanner) = true;
+    APSARA_TEST_STREQ_FATAL(outJson[0].c_str(), outJson[1].c_str());
+}
+
 void ProcessorParseJsonNativeUnittest::TestMultipleLines() {
     // error json
     {
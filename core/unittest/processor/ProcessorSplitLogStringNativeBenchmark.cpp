@@ -0,0 +1,131 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <iostream>
+
+#include "common/SimdUtil.h"
+#include "common/TimeUtil.h"
+#include "processor/inner/ProcessorSplitLogStringNative.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// the line by line scanning used before
+static size_t SplitByLoop(StringView log, char splitChar) {
+    size_t cnt = 0;
+    size_t begin = 0;
+    while (begin < log.size()) {
+        size_t end = begin;
+        while (end < log.size() && log[end] != splitChar) {
+            ++end;
+        }
+        ++cnt;
+        begin = end + 1;
+    }
+    return cnt;
+}
+
+static size_t SplitBySimd(StringView log, char splitChar, SimdLevel level) {
+    static vector<size_t> positions;
+    positions.clear();
+    FindAllCharPositions(log.data(), log.size(), splitChar, positions, level);
+    return positions.size() + (positions.empty() ? !log.empty() : positions.back() + 1 < log.size());
+}
+
+static string CreateBuffer(size_t bufferSize, size_t lineSize) {
+    string buffer;
+    buffer.reserve(bufferSize + lineSize);
+    size_t i = 0;
+    while (buffer.size() < bufferSize) {
+        buffer.append(lineSize - 1, 'a' + i++ % 26);
+        buffer.push_back('\n');
+    }
+    return buffer;
+}
+
+static void BM_Scan(size_t lineSize, int batchSize) {
+    string buffer = CreateBuffer(512 * 1024, lineSize);
+    StringView log(buffer.data(), buffer.size());
+    cout << "line size: " << lineSize;
+
+    size_t expectedCnt = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        expectedCnt = SplitByLoop(log, '\n');
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << "\tloop: " << buffer.size() * batchSize / elapsed << "MB/s";
+
+    for (SimdLevel level : {SimdLevel::NONE, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > GetSupportedSimdLevel()) {
+            continue;
+        }
+        size_t cnt = 0;
+        startTime = GetCurrentTimeInMicroSeconds();
+        for (int i = 0; i < batchSize; ++i) {
+            cnt = SplitBySimd(log, '\n', level);
+        }
+        elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+        cout << "\t" << SimdLevelToString(level) << ": " << buffer.size() * batchSize / elapsed << "MB/s";
+        if (cnt != expectedCnt) {
+            cout << "\terror: " << cnt << " vs " << expectedCnt;
+        }
+    }
+    cout << endl;
+}
+
+// the whole processor, including event creation
+static void BM_Process(size_t lineSize, int batchSize) {
+    string buffer = CreateBuffer(512 * 1024, lineSize);
+    PipelineContext ctx;
+    ctx.SetConfigName("project##config_0");
+    ProcessorSplitLogStringNative processor;
+    processor.SetContext(ctx);
+    processor.Init(Json::Value());
+
+    uint64_t elapsed = 0;
+    for (int i = 0; i < batchSize; ++i) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        StringBuffer b = group.GetSourceBuffer()->CopyString(buffer);
+        auto e = group.AddLogEvent();
+        e->SetContentNoCopy(DEFAULT_CONTENT_KEY, StringView(b.data, b.size));
+        e->SetPosition(0, buffer.size());
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(group);
+        elapsed += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    cout << "line size: " << lineSize << "\tprocess: " << buffer.size() * batchSize / max<uint64_t>(elapsed, 1)
+         << "MB/s" << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    cout << "supported simd level: " << SimdLevelToString(GetSupportedSimdLevel()) << endl;
+    cout << "BM_Scan" << endl;
+    for (size_t lineSize : {16, 64, 256, 1024, 4096}) {
+        BM_Scan(lineSize, 1000);
+    }
+    cout << "BM_Process" << endl;
+    for (size_t lineSize : {16, 64, 256, 1024, 4096}) {
+        BM_Process(lineSize, 100);
+    }
+    return 0;
+}
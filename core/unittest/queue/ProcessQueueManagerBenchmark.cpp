@@ -0,0 +1,121 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/TimeUtil.h"
+#include "queue/ProcessQueueManager.h"
+#include "queue/QueueKeyManager.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_lock_free_process_queue);
+DECLARE_FLAG_INT32(process_thread_count);
+
+using namespace std;
+using namespace logtail;
+
+// Producers push items to the queues round robin, while consumers pop items the same way as process threads do and
+// spend some time on each item. The mode can not be switched once the queue manager is created, so run this benchmark
+// twice, with and without the argument "lockfree".
+static void BM_PushAndPop(vector<QueueKey>& keys,
+                          size_t producerCnt,
+                          size_t consumerCnt,
+                          size_t itemCntPerProducer,
+                          size_t workPerItem) {
+    ProcessQueueManager* manager = ProcessQueueManager::GetInstance();
+    INT32_FLAG(process_thread_count) = consumerCnt;
+
+    const size_t totalCnt = producerCnt * itemCntPerProducer;
+    atomic_size_t poppedCnt{0};
+    atomic<uint64_t> checksum{0};
+    atomic_size_t pushFailCnt{0};
+    atomic_size_t waitCnt{0};
+    atomic<uint64_t> endTime{0};
+    vector<thread> threads;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < consumerCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            while (poppedCnt < totalCnt) {
+                if (!manager->PopItem(i, item, configName)) {
+                    ++waitCnt;
+                    manager->Wait(100);
+                    continue;
+                }
+                if (++poppedCnt == totalCnt) {
+                    endTime = GetCurrentTimeInMicroSeconds();
+                }
+                uint64_t sum = item->mInputIndex;
+                for (size_t j = 0; j < workPerItem; ++j) {
+                    sum = sum * 31 + j;
+                }
+                checksum += sum & 1;
+            }
+            // wake up the others
+            manager->Trigger();
+        });
+    }
+    for (size_t i = 0; i < producerCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            for (size_t j = 0; j < itemCntPerProducer; ++j) {
+                QueueKey key = keys[(i + j) % keys.size()];
+                unique_ptr<ProcessQueueItem> item(
+                    new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), j));
+                while (manager->PushQueue(key, std::move(item)) != 0) {
+                    ++pushFailCnt;
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    uint64_t elapsed = max<uint64_t>(endTime - startTime, 1);
+    cout << "producers: " << producerCnt << "\tconsumers: " << consumerCnt << "\tqueues: " << keys.size()
+         << "\tthroughput: " << totalCnt * 1000 / elapsed << "K items/s\tpush failures: " << pushFailCnt
+         << "\twaits: " << waitCnt << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    BOOL_FLAG(enable_lock_free_process_queue) = argc > 1 && string(argv[1]) == "lockfree";
+    cout << "lock free: " << BOOL_FLAG(enable_lock_free_process_queue) << endl;
+
+    vector<QueueKey> keys;
+    for (size_t i = 0; i < 64; ++i) {
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey("config_" + ToString(i)));
+        ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(keys.back(), i % 2);
+    }
+    cout << "BM_PushAndPop without work" << endl;
+    for (size_t threadCnt : {1, 2, 4, 8, 16}) {
+        BM_PushAndPop(keys, 4, threadCnt, 200000, 0);
+    }
+    cout << "BM_PushAndPop with work" << endl;
+    for (size_t threadCnt : {1, 2, 4, 8, 16}) {
+        BM_PushAndPop(keys, 4, threadCnt, 50000, 2000);
+    }
+    return 0;
+}
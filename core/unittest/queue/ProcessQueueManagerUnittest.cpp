@@ -32,12 +32,14 @@ public:
     void TestPopItem();
     void TestIsAllQueueEmpty();
     void OnPipelineUpdate();
+    void TestLockFreeMode();
 
 protected:
     static void SetUpTestCase() { sEventGroup.reset(new PipelineEventGroup(make_shared<SourceBuffer>())); }
     void TearDown() override {
         QueueKeyManager::GetInstance()->Clear();
         sProcessQueueManager->Clear();
+        sProcessQueueManager->mLockFree = false;
         ExactlyOnceQueueManager::GetInstance()->Clear();
     }
 
@@ -314,6 +316,96 @@ void ProcessQueueManagerUnittest::OnPipelineUpdate() {
     APSARA_TEST_TRUE(ExactlyOnceQueueManager::GetInstance()->mProcessQueues[2]->mValidToPop);
 }
 
+void ProcessQueueManagerUnittest::TestLockFreeMode() {
+    sProcessQueueManager->mLockFree = true;
+    unique_ptr<ProcessQueueItem> item;
+    string configName;
+
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    QueueKey key3 = QueueKeyManager::GetInstance()->GetKey("test_config_3");
+    // create queue
+    APSARA_TEST_TRUE(sProcessQueueManager->CreateOrUpdateQueue(key1, 1));
+    APSARA_TEST_TRUE(sProcessQueueManager->CreateOrUpdateQueue(key2, 1));
+    APSARA_TEST_TRUE(sProcessQueueManager->CreateOrUpdateQueue(key3, 1));
+    APSARA_TEST_EQUAL(3U, sProcessQueueManager->GetCnt());
+    APSARA_TEST_EQUAL(0U, sProcessQueueManager->mQueues.size());
+    // update queue with same priority
+    APSARA_TEST_FALSE(sProcessQueueManager->CreateOrUpdateQueue(key1, 1));
+    // update queue with different priority
+    APSARA_TEST_TRUE(sProcessQueueManager->CreateOrUpdateQueue(key3, 0));
+    APSARA_TEST_EQUAL(1U, sProcessQueueManager->mLockFreeSnapshot->mPriorityQueue[0].size());
+    APSARA_TEST_EQUAL(2U, sProcessQueueManager->mLockFreeSnapshot->mPriorityQueue[1].size());
+    APSARA_TEST_EQUAL(3U, sProcessQueueManager->GetCnt());
+
+    // set upstream and downstream
+    vector<SingleLogstoreSenderManager<SenderQueueParam>*> queues;
+    vector<FeedbackInterface*> feedbacks;
+    APSARA_TEST_TRUE(sProcessQueueManager->SetDownStreamQueues(key1, queues));
+    APSARA_TEST_TRUE(sProcessQueueManager->SetFeedbackInterface(key1, feedbacks));
+    APSARA_TEST_FALSE(sProcessQueueManager->SetDownStreamQueues(100, queues));
+    APSARA_TEST_FALSE(sProcessQueueManager->SetFeedbackInterface(100, feedbacks));
+
+    // push
+    APSARA_TEST_TRUE(sProcessQueueManager->IsAllQueueEmpty());
+    APSARA_TEST_TRUE(sProcessQueueManager->IsValidToPush(key1));
+    APSARA_TEST_FALSE(sProcessQueueManager->IsValidToPush(100));
+    for (auto key : {key1, key2, key1, key3}) {
+        APSARA_TEST_EQUAL(0,
+                          sProcessQueueManager->PushQueue(
+                              key, unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+    }
+    APSARA_TEST_EQUAL(2,
+                      sProcessQueueManager->PushQueue(
+                          100, unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+    APSARA_TEST_FALSE(sProcessQueueManager->IsAllQueueEmpty());
+
+    // pop, queues with higher priority first, and queues with the same priority in turn
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_EQUAL("test_config_3", configName);
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+    // invalidate pop
+    sProcessQueueManager->InvalidatePop("test_config_1");
+    APSARA_TEST_FALSE(sProcessQueueManager->PopItem(0, item, configName));
+    sProcessQueueManager->ValidatePop("test_config_1");
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_FALSE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_TRUE(sProcessQueueManager->IsAllQueueEmpty());
+
+    // exactly once queue
+    ExactlyOnceQueueManager::GetInstance()->CreateOrUpdateQueue(5, 0, "test_config_5", vector<RangeCheckpointPtr>(5));
+    sProcessQueueManager->PushQueue(5, unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0)));
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItem(0, item, configName));
+    APSARA_TEST_EQUAL("test_config_5", configName);
+
+    // delete queue
+    weak_ptr<LockFreeProcessQueue> deletedQue = sProcessQueueManager->FindLockFreeQueue(key1);
+    APSARA_TEST_TRUE(sProcessQueueManager->DeleteQueue(key1));
+    // still referenced by the snapshot cached by this thread
+    APSARA_TEST_FALSE(deletedQue.expired());
+    APSARA_TEST_FALSE(sProcessQueueManager->DeleteQueue(key1));
+    APSARA_TEST_EQUAL(2U, sProcessQueueManager->GetCnt());
+    APSARA_TEST_EQUAL(1U, sProcessQueueManager->mLockFreeSnapshot->mPriorityQueue[1].size());
+    APSARA_TEST_EQUAL(2,
+                      sProcessQueueManager->PushQueue(
+                          key1, unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+
+    // wait and trigger
+    sProcessQueueManager->Trigger();
+    uint64_t startTime = GetCurrentTimeInMilliSeconds();
+    sProcessQueueManager->Wait(1000);
+    APSARA_TEST_TRUE(GetCurrentTimeInMilliSeconds() - startTime < 500);
+    // the outdated snapshot is released by an idle thread
+    APSARA_TEST_TRUE(deletedQue.expired());
+    startTime = GetCurrentTimeInMilliSeconds();
+    sProcessQueueManager->Wait(100);
+    APSARA_TEST_TRUE(GetCurrentTimeInMilliSeconds() - startTime >= 90);
+}
+
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestUpdateQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestDeleteQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestSetQueueUpstreamAndDownStream)
@@ -321,6 +413,7 @@ UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPushQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItem)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestIsAllQueueEmpty)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, OnPipelineUpdate)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestLockFreeMode)
 
 } // namespace logtail
 
@@ -12,11 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <unordered_set>
 
 #include "common/FeedbackInterface.h"
 #include "models/PipelineEventGroup.h"
+#include "queue/LockFreeProcessQueue.h"
 #include "queue/ProcessQueue.h"
 #include "unittest/Unittest.h"
 
@@ -33,10 +36,20 @@ private:
     unordered_set<QueueKey> mFeedbackedKeys;
 };
 
+class ConcurrentFeedbackInterfaceMock : public FeedbackInterface {
+public:
+    void Feedback(QueueKey key) override { ++mFeedbackCnt; };
+
+    atomic_int mFeedbackCnt{0};
+};
+
 class ProcessQueueUnittest : public testing::Test {
 public:
     void TestPush();
     void TestPop();
+    void TestLockFreePush();
+    void TestLockFreePop();
+    void TestLockFreeConcurrentPushAndPop();
 
 protected:
     static void SetUpTestCase() { sEventGroup.reset(new PipelineEventGroup(make_shared<SourceBuffer>())); }
@@ -53,6 +66,12 @@ protected:
         mFeedback2.reset(new FeedbackInterfaceMock);
         vector<FeedbackInterface*> feedbacks{mFeedback1.get(), mFeedback2.get()};
         mQueue->SetUpStreamFeedbacks(feedbacks);
+
+        mLockFreeQueue.reset(new LockFreeProcessQueue(sCap, sLowWatermark, sHighWatermark, sKey, "test_config"));
+        queues = {mSenderQueue1.get(), mSenderQueue2.get()};
+        mLockFreeQueue->SetDownStreamQueues(queues);
+        feedbacks = {mFeedback1.get(), mFeedback2.get()};
+        mLockFreeQueue->SetUpStreamFeedbacks(feedbacks);
     }
 
 private:
@@ -63,6 +82,7 @@ private:
     static const size_t sHighWatermark = 4;
 
     unique_ptr<ProcessQueue> mQueue;
+    unique_ptr<LockFreeProcessQueue> mLockFreeQueue;
     unique_ptr<FeedbackInterface> mFeedback1;
     unique_ptr<FeedbackInterface> mFeedback2;
     unique_ptr<SingleLogstoreSenderManager<SenderQueueParam>> mSenderQueue1;
@@ -118,8 +138,116 @@ void ProcessQueueUnittest::TestPop() {
     APSARA_TEST_TRUE(static_cast<FeedbackInterfaceMock*>(mFeedback2.get())->HasFeedback(sKey));
 }
 
+void ProcessQueueUnittest::TestLockFreePush() {
+    // push first
+    for (size_t i = 0; i < sHighWatermark; ++i) {
+        APSARA_TEST_TRUE(
+            mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+    }
+    // now queue size comes to high watermark, push is forbidden
+    APSARA_TEST_FALSE(mLockFreeQueue->IsValidToPush());
+    APSARA_TEST_FALSE(
+        mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+    // still not valid to push when low watermark is reached
+    unique_ptr<ProcessQueueItem> item;
+    mLockFreeQueue->Pop(item);
+    APSARA_TEST_FALSE(
+        mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+    mLockFreeQueue->Pop(item);
+    // now queue size comes to low watermark, push can be resumed
+    APSARA_TEST_TRUE(mLockFreeQueue->IsValidToPush());
+    APSARA_TEST_TRUE(
+        mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0))));
+
+    // capacity is never exceeded even if the state is valid to push
+    for (size_t i = 0; i < sCap; ++i) {
+        mLockFreeQueue->mValidToPush = true;
+        mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0)));
+    }
+    APSARA_TEST_EQUAL(sCap, mLockFreeQueue->mSize.load());
+}
+
+void ProcessQueueUnittest::TestLockFreePop() {
+    unique_ptr<ProcessQueueItem> item;
+    // nothing to pop
+    APSARA_TEST_FALSE(mLockFreeQueue->Pop(item));
+
+    mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0)));
+    // invalidate pop
+    mLockFreeQueue->InvalidatePop();
+    APSARA_TEST_FALSE(mLockFreeQueue->Pop(item));
+    mLockFreeQueue->ValidatePop();
+
+    // downstream queues are not valid to push
+    mSenderQueue1->mValid = false;
+    APSARA_TEST_FALSE(mLockFreeQueue->Pop(item));
+    mSenderQueue1->mValid = true;
+
+    // push to high watermark
+    for (size_t i = 1; i < sHighWatermark; ++i) {
+        mLockFreeQueue->Push(unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0)));
+    }
+    // from high watermark to low wartermark
+    APSARA_TEST_TRUE(mLockFreeQueue->Pop(item));
+    APSARA_TEST_FALSE(static_cast<FeedbackInterfaceMock*>(mFeedback1.get())->HasFeedback(sKey));
+    APSARA_TEST_FALSE(static_cast<FeedbackInterfaceMock*>(mFeedback2.get())->HasFeedback(sKey));
+    APSARA_TEST_TRUE(mLockFreeQueue->Pop(item));
+    APSARA_TEST_TRUE(static_cast<FeedbackInterfaceMock*>(mFeedback1.get())->HasFeedback(sKey));
+    APSARA_TEST_TRUE(static_cast<FeedbackInterfaceMock*>(mFeedback2.get())->HasFeedback(sKey));
+}
+
+void ProcessQueueUnittest::TestLockFreeConcurrentPushAndPop() {
+    const size_t producerCnt = 4, consumerCnt = 4, itemCntPerProducer = 10000;
+    ConcurrentFeedbackInterfaceMock feedback;
+    vector<FeedbackInterface*> feedbacks{&feedback};
+    mLockFreeQueue->SetUpStreamFeedbacks(feedbacks);
+
+    atomic_size_t poppedCnt{0};
+    atomic_size_t maxInputIndex{0};
+    vector<thread> threads;
+    for (size_t i = 0; i < producerCnt; ++i) {
+        threads.emplace_back([this, i, itemCntPerProducer]() {
+            for (size_t j = 0; j < itemCntPerProducer; ++j) {
+                unique_ptr<ProcessQueueItem> item(
+                    new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), i * itemCntPerProducer + j));
+                // wait for feedback like the real producers do
+                while (!mLockFreeQueue->IsValidToPush() || !mLockFreeQueue->Push(std::move(item))) {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < consumerCnt; ++i) {
+        threads.emplace_back([this, &poppedCnt, &maxInputIndex, producerCnt, itemCntPerProducer]() {
+            unique_ptr<ProcessQueueItem> item;
+            while (poppedCnt < producerCnt * itemCntPerProducer) {
+                if (!mLockFreeQueue->Pop(item)) {
+                    this_thread::yield();
+                    continue;
+                }
+                ++poppedCnt;
+                size_t idx = maxInputIndex;
+                while (idx < item->mInputIndex && !maxInputIndex.compare_exchange_weak(idx, item->mInputIndex)) {
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_EQUAL(producerCnt * itemCntPerProducer, poppedCnt.load());
+    APSARA_TEST_EQUAL(producerCnt * itemCntPerProducer - 1, maxInputIndex.load());
+    APSARA_TEST_TRUE(mLockFreeQueue->Empty());
+    // producers never get stuck, so the queue must have been valid to push again with feedback
+    APSARA_TEST_TRUE(mLockFreeQueue->IsValidToPush());
+    APSARA_TEST_TRUE(feedback.mFeedbackCnt > 0);
+}
+
 UNIT_TEST_CASE(ProcessQueueUnittest, TestPush)
 UNIT_TEST_CASE(ProcessQueueUnittest, TestPop)
+UNIT_TEST_CASE(ProcessQueueUnittest, TestLockFreePush)
+UNIT_TEST_CASE(ProcessQueueUnittest, TestLockFreePop)
+UNIT_TEST_CASE(ProcessQueueUnittest, TestLockFreeConcurrentPushAndPop)
 
 } // namespace logtail
 
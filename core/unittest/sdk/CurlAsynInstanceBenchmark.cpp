@@ -0,0 +1,226 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "common/TimeUtil.h"
+#include "sdk/Closure.h"
+#include "sdk/CurlAsynInstance.h"
+#include "sdk/CurlEventLoop.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(sls_client_event_loop_thread_count);
+
+using namespace std;
+using namespace logtail;
+using namespace logtail::sdk;
+
+static atomic_size_t sDoneCnt{0};
+static atomic_size_t sFailCnt{0};
+
+// Minimal keep-alive http server, which replies every request with an empty 200 response.
+class DummyServer {
+public:
+    bool Start() {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (bind(mListenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(mListenFd, 1024) != 0) {
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(mListenFd, (sockaddr*)&addr, &len);
+        mPort = ntohs(addr.sin_port);
+        thread([this]() {
+            while (true) {
+                int fd = accept(mListenFd, nullptr, nullptr);
+                if (fd < 0) {
+                    return;
+                }
+                ++mConnCnt;
+                thread(&DummyServer::Serve, fd).detach();
+            }
+        }).detach();
+        return true;
+    }
+
+    int32_t GetPort() const { return mPort; }
+    size_t GetConnCnt() const { return mConnCnt; }
+
+private:
+    static void Serve(int fd) {
+        static const char kResponse[]
+            = "HTTP/1.1 200 OK\r\nx-log-requestid: benchmark\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+        string buf;
+        char tmp[4096];
+        while (true) {
+            ssize_t n = read(fd, tmp, sizeof(tmp));
+            if (n <= 0) {
+                break;
+            }
+            buf.append(tmp, n);
+            // requests are sent with Content-Length, so the body follows the header immediately
+            while (true) {
+                size_t headerEnd = buf.find("\r\n\r\n");
+                if (headerEnd == string::npos) {
+                    break;
+                }
+                size_t bodyLen = 0;
+                size_t pos = buf.find("Content-Length: ");
+                if (pos != string::npos && pos < headerEnd) {
+                    bodyLen = strtoul(buf.c_str() + pos + 16, nullptr, 10);
+                }
+                if (buf.size() < headerEnd + 4 + bodyLen) {
+                    break;
+                }
+                buf.erase(0, headerEnd + 4 + bodyLen);
+                if (write(fd, kResponse, sizeof(kResponse) - 1) < 0) {
+                    close(fd);
+                    return;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    atomic_size_t mConnCnt{0};
+};
+
+// deleted once the request is done, since neither sender path owns the closure
+class CountingClosure : public LogsClosure {
+public:
+    void OnSuccess(Response* response) override {
+        ++sDoneCnt;
+        delete this;
+    }
+    void OnFail(Response* response, const string& errorCode, const string& errorMessage) override {
+        ++sFailCnt;
+        ++sDoneCnt;
+        delete this;
+    }
+    void Done() override {}
+};
+
+static AsynRequest* CreateRequest(int32_t port, const string& body) {
+    map<string, string> header;
+    header["Content-Type"] = "application/x-protobuf";
+    header["Content-Length"] = ToString(body.size());
+    header["x-log-compresstype"] = "lz4";
+    return new AsynRequest("POST",
+                           "127.0.0.1",
+                           port,
+                           "/logstores/benchmark/shards/lb",
+                           "",
+                           header,
+                           body,
+                           30,
+                           "",
+                           false,
+                           new CountingClosure(),
+                           new PostLogStoreLogsResponse());
+}
+
+static void Wait(size_t expected) {
+    while (sDoneCnt < expected) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
+
+// Requests are sent in batches of concurrency, the same as the sender does when the sender queues are busy.
+template <class Sender>
+static void BM_SendRequests(const string& name,
+                            Sender& sender,
+                            DummyServer& server,
+                            size_t requestCnt,
+                            size_t concurrency,
+                            size_t bodySize) {
+    string body(bodySize, 'a');
+    sDoneCnt = 0;
+    sFailCnt = 0;
+    size_t connCnt = server.GetConnCnt();
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t sent = 0; sent < requestCnt; sent += concurrency) {
+        size_t batch = min(concurrency, requestCnt - sent);
+        for (size_t i = 0; i < batch; ++i) {
+            sender.AddRequest(CreateRequest(server.GetPort(), body));
+        }
+        Wait(sent + batch);
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << name << "\tconcurrency: " << concurrency << "\tbody: " << bodySize
+         << "\tthroughput: " << requestCnt * 1000000 / elapsed << " req/s\tfailures: " << sFailCnt
+         << "\tnew connections: " << server.GetConnCnt() - connCnt << endl;
+}
+
+static void OnRequestDone(CURL* curl, AsynRequest* request, CURLcode res) {
+    long httpCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    if (res == CURLE_OK && httpCode == 200) {
+        request->mCallBack->OnSuccess(request->mResponse);
+    } else {
+        request->mCallBack->OnFail(request->mResponse, "", "");
+    }
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    curl_global_init(CURL_GLOBAL_ALL);
+    DummyServer server;
+    if (!server.Start()) {
+        cout << "failed to start server" << endl;
+        return 1;
+    }
+
+    // the legacy instance can not be stopped, so it is leaked on purpose
+    INT32_FLAG(sls_client_event_loop_thread_count) = 0;
+    CurlAsynInstance* legacy = new CurlAsynInstance();
+    for (size_t concurrency : {16, 128, 512}) {
+        BM_SendRequests("select", *legacy, server, 20000, concurrency, 1024);
+    }
+
+    for (size_t loopCnt : {1, 2, 4}) {
+        CurlEventLoopPool pool(loopCnt, 32, OnRequestDone);
+        if (!pool.Start()) {
+            cout << "failed to start event loops" << endl;
+            return 1;
+        }
+        for (size_t concurrency : {16, 128, 512}) {
+            BM_SendRequests("epoll x" + ToString(loopCnt), pool, server, 20000, concurrency, 1024);
+        }
+        pool.Stop();
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "sdk/Closure.h"
+#include "sdk/CurlAsynInstance.h"
+#include "sdk/CurlEventLoop.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(sls_client_event_loop_thread_count);
+
+using namespace std;
+
+namespace logtail {
+namespace sdk {
+
+    // Keep-alive http server on loopback, which replies every request with an empty 200 response, or never replies
+    // if it is silent.
+    class LocalServer {
+    public:
+        explicit LocalServer(bool silent) : mSilent(silent) {}
+
+        // fds are closed only after all threads exit, so that they are not reused while still being served
+        ~LocalServer() {
+            if (mListenFd >= 0) {
+                shutdown(mListenFd, SHUT_RDWR);
+            }
+            if (mAcceptThread.joinable()) {
+                mAcceptThread.join();
+            }
+            for (int fd : mConnFds) {
+                shutdown(fd, SHUT_RDWR);
+            }
+            for (auto& t : mServeThreads) {
+                t.join();
+            }
+            for (int fd : mConnFds) {
+                close(fd);
+            }
+            if (mListenFd >= 0) {
+                close(mListenFd);
+            }
+        }
+
+        bool Start() {
+            mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0;
+            if (bind(mListenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(mListenFd, 16) != 0) {
+                return false;
+            }
+            socklen_t len = sizeof(addr);
+            getsockname(mListenFd, (sockaddr*)&addr, &len);
+            mPort = ntohs(addr.sin_port);
+            mAcceptThread = thread([this]() {
+                while (true) {
+                    int fd = accept(mListenFd, nullptr, nullptr);
+                    if (fd < 0) {
+                        return;
+                    }
+                    ++mConnCnt;
+                    mConnFds.push_back(fd);
+                    mServeThreads.emplace_back(&LocalServer::Serve, this, fd);
+                }
+            });
+            return true;
+        }
+
+        int32_t GetPort() const { return mPort; }
+        size_t GetConnCnt() const { return mConnCnt; }
+        size_t GetRequestCnt() const { return mRequestCnt; }
+
+    private:
+        void Serve(int fd) {
+            static const char kResponse[]
+                = "HTTP/1.1 200 OK\r\nx-log-requestid: unittest\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+            string buf;
+            char tmp[4096];
+            while (true) {
+                ssize_t n = read(fd, tmp, sizeof(tmp));
+                if (n <= 0) {
+                    break;
+                }
+                buf.append(tmp, n);
+                while (true) {
+                    size_t headerEnd = buf.find("\r\n\r\n");
+                    if (headerEnd == string::npos) {
+                        break;
+                    }
+                    size_t bodyLen = 0;
+                    size_t pos = buf.find("Content-Length: ");
+                    if (pos != string::npos && pos < headerEnd) {
+                        bodyLen = strtoul(buf.c_str() + pos + 16, nullptr, 10);
+                    }
+                    if (buf.size() < headerEnd + 4 + bodyLen) {
+                        break;
+                    }
+                    buf.erase(0, headerEnd + 4 + bodyLen);
+                    ++mRequestCnt;
+                    if (!mSilent && write(fd, kResponse, sizeof(kResponse) - 1) < 0) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        bool mSilent = false;
+        int mListenFd = -1;
+        int32_t mPort = 0;
+        atomic_size_t mConnCnt{0};
+        atomic_size_t mRequestCnt{0};
+        thread mAcceptThread;
+        // accessed by the accept thread only until it is joined
+        vector<int> mConnFds;
+        vector<thread> mServeThreads;
+    };
+
+    struct RequestResult {
+        atomic_bool mDone{false};
+        bool mSuccess = false;
+        string mErrorCode;
+        string mRequestId;
+    };
+
+    class ResultClosure : public LogsClosure {
+    public:
+        explicit ResultClosure(RequestResult* result) : mResult(result) {}
+
+        void OnSuccess(Response* response) override {
+            mResult->mSuccess = true;
+            mResult->mRequestId = response->requestId;
+            mResult->mDone = true;
+            delete this;
+        }
+        void OnFail(Response* response, const string& errorCode, const string& errorMessage) override {
+            mResult->mErrorCode = errorCode;
+            mResult->mDone = true;
+            delete this;
+        }
+        void Done() override {}
+
+    private:
+        RequestResult* mResult;
+    };
+
+    class CurlEventLoopUnittest : public ::testing::Test {
+    public:
+        void TestSendRequest();
+        void TestRequestTimeout();
+        void TestReuseHandle();
+
+    protected:
+        static void SetUpTestCase() { curl_global_init(CURL_GLOBAL_ALL); }
+
+        void SetUp() override { mDefaultLoopCnt = INT32_FLAG(sls_client_event_loop_thread_count); }
+
+        void TearDown() override { INT32_FLAG(sls_client_event_loop_thread_count) = mDefaultLoopCnt; }
+
+        static AsynRequest* CreateRequest(int32_t port, int32_t timeout, RequestResult* result) {
+            string body(1024, 'a');
+            map<string, string> header;
+            header["Content-Type"] = "application/x-protobuf";
+            header["Content-Length"] = ToString(body.size());
+            return new AsynRequest("POST",
+                                   "127.0.0.1",
+                                   port,
+                                   "/logstores/unittest/shards/lb",
+                                   "",
+                                   header,
+                                   body,
+                                   timeout,
+                                   "",
+                                   false,
+                                   new ResultClosure(result),
+                                   new PostLogStoreLogsResponse());
+        }
+
+        static bool WaitForDone(const RequestResult& result, int timeoutSec) {
+            auto deadline = chrono::steady_clock::now() + chrono::seconds(timeoutSec);
+            while (!result.mDone && chrono::steady_clock::now() < deadline) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            return result.mDone;
+        }
+
+    private:
+        int32_t mDefaultLoopCnt = 0;
+    };
+
+    void CurlEventLoopUnittest::TestSendRequest() {
+        LocalServer server(false);
+        APSARA_TEST_TRUE_FATAL(server.Start());
+
+        INT32_FLAG(sls_client_event_loop_thread_count) = 1;
+        CurlAsynInstance instance;
+        RequestResult result;
+        instance.AddRequest(CreateRequest(server.GetPort(), 15, &result));
+        APSARA_TEST_TRUE_FATAL(WaitForDone(result, 10));
+        APSARA_TEST_TRUE(result.mSuccess);
+        APSARA_TEST_EQUAL("unittest", result.mRequestId);
+        APSARA_TEST_EQUAL(1U, server.GetRequestCnt());
+    }
+
+    void CurlEventLoopUnittest::TestRequestTimeout() {
+        LocalServer server(true);
+        APSARA_TEST_TRUE_FATAL(server.Start());
+
+        INT32_FLAG(sls_client_event_loop_thread_count) = 1;
+        CurlAsynInstance instance;
+        RequestResult result;
+        auto startTime = chrono::steady_clock::now();
+        instance.AddRequest(CreateRequest(server.GetPort(), 1, &result));
+        // the request is finished by the timer of the event loop, since the server never replies
+        APSARA_TEST_TRUE_FATAL(WaitForDone(result, 10));
+        APSARA_TEST_FALSE(result.mSuccess);
+        APSARA_TEST_EQUAL(LOGE_REQUEST_TIMEOUT, result.mErrorCode);
+        APSARA_TEST_TRUE(chrono::steady_clock::now() - startTime >= chrono::milliseconds(900));
+        APSARA_TEST_EQUAL(1U, server.GetRequestCnt());
+    }
+
+    void CurlEventLoopUnittest::TestReuseHandle() {
+        LocalServer server(false);
+        APSARA_TEST_TRUE_FATAL(server.Start());
+
+        size_t doneCnt = 0;
+        CurlEventLoop loop(nullptr,
+                           [&doneCnt](CURL* curl, AsynRequest* request, CURLcode res) {
+                               long httpCode = 0;
+                               curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+                               if (res == CURLE_OK && httpCode == 200) {
+                                   request->mCallBack->OnSuccess(request->mResponse);
+                               } else {
+                                   request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_ERROR, "");
+                               }
+                               ++doneCnt;
+                           },
+                           4);
+        APSARA_TEST_TRUE_FATAL(loop.Start());
+        for (int i = 0; i < 3; ++i) {
+            RequestResult result;
+            loop.AddRequest(CreateRequest(server.GetPort(), 15, &result));
+            APSARA_TEST_TRUE_FATAL(WaitForDone(result, 10));
+            APSARA_TEST_TRUE(result.mSuccess);
+        }
+        // the request is released after the callback returns
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+        while (loop.GetRunningRequestCnt() > 0 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        APSARA_TEST_EQUAL(0U, loop.GetRunningRequestCnt());
+        loop.Stop();
+        APSARA_TEST_EQUAL(3U, doneCnt);
+        APSARA_TEST_EQUAL(3U, server.GetRequestCnt());
+        // sequential requests to the same endpoint are sent through the same kept-alive connection
+        APSARA_TEST_EQUAL(1U, server.GetConnCnt());
+    }
+
+    UNIT_TEST_CASE(CurlEventLoopUnittest, TestSendRequest)
+    UNIT_TEST_CASE(CurlEventLoopUnittest, TestRequestTimeout)
+    UNIT_TEST_CASE(CurlEventLoopUnittest, TestReuseHandle)
+
+} // namespace sdk
+} // namespace logtail
+
+UNIT_TEST_MAIN
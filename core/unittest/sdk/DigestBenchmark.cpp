@@ -0,0 +1,119 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "common/TimeUtil.h"
+#include "sdk/Common.h"
+#include "sdk/Digest.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+using namespace logtail::sdk;
+
+static const char* GetBackendName(DigestBackend backend) {
+    return backend == DigestBackend::OPENSSL ? "openssl" : "builtin";
+}
+
+static void BM_MD5(DigestBackend backend, size_t bodySize) {
+    SetDigestBackend(backend);
+    string body(bodySize, 'a');
+    size_t round = max<size_t>(256 * 1024 * 1024 / bodySize, 1);
+    size_t checksum = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < round; ++i) {
+        body[i % bodySize] = static_cast<char>(i);
+        checksum += CalcMD5(body)[0];
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << "md5 " << GetBackendName(backend) << "\tbody: " << bodySize
+         << "\tthroughput: " << round * bodySize / elapsed << " MB/s\t" << checksum % 2 << endl;
+}
+
+// The same as what is done for each PostLogStoreLogs request. Before, content md5 was calculated twice, once for the
+// header and once more for the signature.
+static void BM_SignRequest(DigestBackend backend, bool reuseContentMd5, size_t bodySize) {
+    SetDigestBackend(backend);
+    string body(bodySize, 'a');
+    map<string, string> parameters;
+    size_t round = max<size_t>(256 * 1024 * 1024 / bodySize, 16);
+    size_t checksum = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < round; ++i) {
+        body[i % bodySize] = static_cast<char>(i);
+        map<string, string> header;
+        header[CONTENT_TYPE] = TYPE_LOG_PROTOBUF;
+        header[X_LOG_BODYRAWSIZE] = "4096";
+        header[X_LOG_COMPRESSTYPE] = "lz4";
+        header[DATE] = "Thu, 18 Feb 2021 10:11:10 GMT";
+        header[X_LOG_APIVERSION] = LOG_API_VERSION;
+        header[X_LOG_SIGNATUREMETHOD] = HMAC_SHA1;
+        string contentMd5 = CalcMD5(body);
+        if (reuseContentMd5) {
+            header[CONTENT_MD5] = contentMd5;
+        }
+        checksum += GetUrlSignature(HTTP_POST, "/logstores/test/shards/lb", header, parameters, body, "key")[0];
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << "sign " << GetBackendName(backend) << (reuseContentMd5 ? ", md5 once" : ", md5 twice")
+         << "\tbody: " << bodySize << "\tthroughput: " << round * 1000000 / elapsed << " req/s\t" << checksum % 2
+         << endl;
+}
+
+static void BM_Base64(bool useStream) {
+    // the same size as a signature
+    string data(20, 'a');
+    size_t round = 1000000;
+    size_t checksum = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < round; ++i) {
+        data[i % data.size()] = static_cast<char>(i);
+        if (useStream) {
+            istringstream iss(data);
+            ostringstream oss;
+            Base64Encoding(iss, oss);
+            checksum += oss.str()[0];
+        } else {
+            checksum += Base64Enconde(data)[0];
+        }
+    }
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << "base64 " << (useStream ? "stream" : "direct") << "\tthroughput: " << round * 1000000 / elapsed
+         << " op/s\t" << checksum % 2 << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    cout << "default digest backend: " << GetBackendName(GetDigestBackend()) << endl;
+    for (size_t bodySize : {1024, 64 * 1024, 1024 * 1024, 3 * 1024 * 1024}) {
+        BM_MD5(DigestBackend::BUILTIN, bodySize);
+        BM_MD5(DigestBackend::OPENSSL, bodySize);
+    }
+    for (size_t bodySize : {1024, 64 * 1024, 1024 * 1024, 3 * 1024 * 1024}) {
+        BM_SignRequest(DigestBackend::BUILTIN, false, bodySize);
+        BM_SignRequest(DigestBackend::OPENSSL, true, bodySize);
+    }
+    BM_Base64(true);
+    BM_Base64(false);
+    return 0;
+}
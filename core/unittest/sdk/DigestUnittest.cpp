@@ -0,0 +1,155 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+
+#include "sdk/Common.h"
+#include "sdk/Digest.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+namespace sdk {
+
+    class DigestUnittest : public ::testing::Test {
+    public:
+        void TestMD5();
+        void TestHmacSHA1();
+        void TestBackendConsistency();
+        void TestBase64Encode();
+        void TestUrlSignature();
+
+    protected:
+        void TearDown() override { SetDigestBackend(mDefaultBackend); }
+
+        DigestBackend mDefaultBackend = GetDigestBackend();
+    };
+
+    static string ToHexString(const uint8_t* digest, size_t size) {
+        static const char* table = "0123456789abcdef";
+        string res;
+        for (size_t i = 0; i < size; ++i) {
+            res += table[digest[i] >> 4];
+            res += table[digest[i] & 0x0F];
+        }
+        return res;
+    }
+
+    static string RandomString(size_t size) {
+        static mt19937 gen(0);
+        string res(size, '\0');
+        for (auto& c : res) {
+            c = static_cast<char>(gen());
+        }
+        return res;
+    }
+
+    void DigestUnittest::TestMD5() {
+        for (auto backend : {DigestBackend::BUILTIN, DigestBackend::OPENSSL}) {
+            SetDigestBackend(backend);
+            // test suite from RFC 1321
+            APSARA_TEST_EQUAL("D41D8CD98F00B204E9800998ECF8427E", CalcMD5(""));
+            APSARA_TEST_EQUAL("900150983CD24FB0D6963F7D28E17F72", CalcMD5("abc"));
+            APSARA_TEST_EQUAL("57EDF4A22BE3C955AC49DA2E2107B67A",
+                              CalcMD5("1234567890123456789012345678901234567890"
+                                      "1234567890123456789012345678901234567890"));
+        }
+    }
+
+    void DigestUnittest::TestHmacSHA1() {
+        for (auto backend : {DigestBackend::BUILTIN, DigestBackend::OPENSSL}) {
+            SetDigestBackend(backend);
+            // test cases from RFC 2202
+            string res = CalcSHA1("what do ya want for nothing?", "Jefe");
+            APSARA_TEST_EQUAL("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+                              ToHexString(reinterpret_cast<const uint8_t*>(res.data()), res.size()));
+            // key longer than block size
+            res = CalcSHA1("Test Using Larger Than Block-Size Key - Hash Key First", string(80, '\xaa'));
+            APSARA_TEST_EQUAL("aa4ae5e15272d00e95705637ce8a3b55ed402112",
+                              ToHexString(reinterpret_cast<const uint8_t*>(res.data()), res.size()));
+        }
+    }
+
+    void DigestUnittest::TestBackendConsistency() {
+        for (size_t size : {1, 55, 56, 63, 64, 65, 1000, 1024 * 1024 + 7}) {
+            string data = RandomString(size);
+            string key = RandomString(size % 100);
+            SetDigestBackend(DigestBackend::BUILTIN);
+            string md5 = CalcMD5(data);
+            string sha1 = CalcSHA1(data, key);
+            SetDigestBackend(DigestBackend::OPENSSL);
+            APSARA_TEST_EQUAL(md5, CalcMD5(data));
+            APSARA_TEST_EQUAL(sha1, CalcSHA1(data, key));
+        }
+    }
+
+    void DigestUnittest::TestBase64Encode() {
+        // test vectors from RFC 4648
+        APSARA_TEST_EQUAL("", Base64Enconde(""));
+        APSARA_TEST_EQUAL("Zg==", Base64Enconde("f"));
+        APSARA_TEST_EQUAL("Zm8=", Base64Enconde("fo"));
+        APSARA_TEST_EQUAL("Zm9v", Base64Enconde("foo"));
+        APSARA_TEST_EQUAL("Zm9vYg==", Base64Enconde("foob"));
+        APSARA_TEST_EQUAL("Zm9vYmE=", Base64Enconde("fooba"));
+        APSARA_TEST_EQUAL("Zm9vYmFy", Base64Enconde("foobar"));
+        // the same as the stream version
+        for (size_t size = 0; size < 100; ++size) {
+            string data = RandomString(size);
+            istringstream iss(data);
+            ostringstream oss;
+            Base64Encoding(iss, oss);
+            APSARA_TEST_EQUAL(oss.str(), Base64Enconde(data));
+        }
+        // appended to the output
+        string res = "prefix";
+        Base64Encode("foobar", 6, res);
+        APSARA_TEST_EQUAL("prefixZm9vYmFy", res);
+    }
+
+    void DigestUnittest::TestUrlSignature() {
+        string body = RandomString(1000);
+        map<string, string> parameters;
+        parameters["key"] = "hash";
+        map<string, string> header;
+        header[CONTENT_TYPE] = TYPE_LOG_PROTOBUF;
+        header[DATE] = "Thu, 18 Feb 2021 10:11:10 GMT";
+        header[X_LOG_APIVERSION] = LOG_API_VERSION;
+        header[X_LOG_SIGNATUREMETHOD] = HMAC_SHA1;
+        header[X_LOG_BODYRAWSIZE] = "2000";
+        header[X_ACS_SECURITY_TOKEN] = "token";
+        string signature = GetUrlSignature(HTTP_POST, "/logstores/test/shards/route", header, parameters, body, "key");
+
+        // content md5 set by the caller is used
+        header[CONTENT_MD5] = CalcMD5(body);
+        APSARA_TEST_EQUAL(signature,
+                          GetUrlSignature(HTTP_POST, "/logstores/test/shards/route", header, parameters, body, "key"));
+
+        // old header prefix is converted, and the order of headers is kept
+        header.erase(X_LOG_BODYRAWSIZE);
+        header["x-sls-bodyrawsize"] = "2000";
+        APSARA_TEST_EQUAL(signature,
+                          GetUrlSignature(HTTP_POST, "/logstores/test/shards/route", header, parameters, body, "key"));
+    }
+
+    UNIT_TEST_CASE(DigestUnittest, TestMD5)
+    UNIT_TEST_CASE(DigestUnittest, TestHmacSHA1)
+    UNIT_TEST_CASE(DigestUnittest, TestBackendConsistency)
+    UNIT_TEST_CASE(DigestUnittest, TestBase64Encode)
+    UNIT_TEST_CASE(DigestUnittest, TestUrlSignature)
+
+} // namespace sdk
+} // namespace logtail
+
+UNIT_TEST_MAIN
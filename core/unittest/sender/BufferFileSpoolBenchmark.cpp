@@ -0,0 +1,204 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "common/FileSystemUtil.h"
+#include "common/RuntimeUtil.h"
+#include "common/StringTools.h"
+#include "common/TimeUtil.h"
+#include "sender/BufferFileSpool.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// same layout as the meta of buffer file records
+struct RecordMeta {
+    int32_t mLogDataSize;
+    int32_t mEncryptionSize;
+    int32_t mEncodedInfoSize;
+    int32_t mTimeStamp;
+    int32_t mHandled;
+    int32_t mRetryTime;
+};
+
+static const string kHeader(1024, 'h');
+static const string kInfo(64, 'i');
+
+static RecordMeta CreateMeta(size_t dataSize) {
+    RecordMeta meta;
+    meta.mLogDataSize = dataSize;
+    meta.mEncryptionSize = dataSize;
+    meta.mEncodedInfoSize = kInfo.size();
+    meta.mTimeStamp = time(NULL);
+    meta.mHandled = 0;
+    meta.mRetryTime = 0;
+    return meta;
+}
+
+static void PrintResult(const string& name, size_t recordCnt, size_t dataSize, uint64_t startTime) {
+    uint64_t elapsed = max<uint64_t>(GetCurrentTimeInMicroSeconds() - startTime, 1);
+    cout << name << "\trecords: " << recordCnt << "\tsize: " << dataSize
+         << "\tthroughput: " << recordCnt * 1000000 / elapsed << " records/s, "
+         << recordCnt * (sizeof(RecordMeta) + kInfo.size() + dataSize) / elapsed << " MB/s" << endl;
+}
+
+// the way records were written before: the file is opened and closed for each record
+static void BM_SpillLegacy(const string& fileName, size_t recordCnt, size_t dataSize) {
+    remove(fileName.c_str());
+    string data(dataSize, 'd');
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < recordCnt; ++i) {
+        FILE* fout = FileAppendOpen(fileName.c_str(), "ab");
+        if (ftell(fout) == 0) {
+            fwrite(kHeader.data(), 1, kHeader.size(), fout);
+        }
+        RecordMeta meta = CreateMeta(dataSize);
+        size_t size = sizeof(meta) + kInfo.size() + dataSize;
+        char* buffer = new char[size];
+        memcpy(buffer, &meta, sizeof(meta));
+        memcpy(buffer + sizeof(meta), kInfo.data(), kInfo.size());
+        memcpy(buffer + sizeof(meta) + kInfo.size(), data.data(), dataSize);
+        fwrite(buffer, 1, size, fout);
+        delete[] buffer;
+        fclose(fout);
+    }
+    PrintResult("spill legacy", recordCnt, dataSize, startTime);
+}
+
+static void BM_SpillSpool(
+    const string& fileName, size_t recordCnt, size_t dataSize, size_t commitSize, bool sync, bool preallocate) {
+    remove(fileName.c_str());
+    string data(dataSize, 'd');
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    BufferFileWriter writer;
+    writer.Open(fileName, kHeader, preallocate ? recordCnt * (sizeof(RecordMeta) + kInfo.size() + dataSize) : 0);
+    for (size_t i = 0; i < recordCnt; ++i) {
+        RecordMeta meta = CreateMeta(dataSize);
+        writer.Append(&meta, sizeof(meta));
+        writer.Append(kInfo.data(), kInfo.size());
+        writer.Append(data.data(), dataSize);
+        if (writer.GetPendingSize() >= commitSize) {
+            writer.Commit(sync);
+        }
+    }
+    writer.Commit(sync);
+    writer.Close();
+    PrintResult("spill spool, commit size: " + ToString(commitSize) + ", sync: " + ToString(sync)
+                    + ", preallocate: " + ToString(preallocate),
+                recordCnt,
+                dataSize,
+                startTime);
+}
+
+// the way records were read before: the file is reopened for each record, and meta is always written back
+static void BM_ReplayLegacy(const string& fileName, size_t dataSize) {
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    int64_t pos = kHeader.size();
+    size_t readCnt = 0;
+    while (true) {
+        FILE* fin = FileReadOnlyOpen(fileName.c_str(), "rb");
+        fseek(fin, 0, SEEK_END);
+        if (ftell(fin) == pos) {
+            fclose(fin);
+            break;
+        }
+        fseek(fin, pos, SEEK_SET);
+        RecordMeta meta;
+        if (fread(&meta, 1, sizeof(meta), fin) != sizeof(meta)) {
+            fclose(fin);
+            break;
+        }
+        char* buffer = new char[meta.mEncodedInfoSize + 1];
+        fread(buffer, 1, meta.mEncodedInfoSize, fin);
+        delete[] buffer;
+        buffer = new char[meta.mEncryptionSize + 1];
+        fread(buffer, 1, meta.mEncryptionSize, fin);
+        delete[] buffer;
+        fclose(fin);
+        ++readCnt;
+
+        meta.mHandled = 1;
+#if defined(__linux__)
+        int fd = open(fileName.c_str(), O_WRONLY);
+        lseek(fd, pos, SEEK_SET);
+        if (write(fd, &meta, sizeof(meta)) < 0) {
+            cout << "write back meta failed" << endl;
+        }
+        close(fd);
+#endif
+        pos += sizeof(meta) + meta.mEncodedInfoSize + meta.mEncryptionSize;
+    }
+    PrintResult("replay legacy", readCnt, dataSize, startTime);
+}
+
+static void BM_ReplaySpool(const string& fileName, size_t dataSize) {
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    BufferFileReader reader;
+    reader.Open(fileName);
+    int64_t pos = kHeader.size();
+    size_t readCnt = 0;
+    string info;
+    string encryption;
+    while (pos < reader.GetFileSize()) {
+        RecordMeta meta;
+        if (reader.Read(pos, &meta, sizeof(meta)) != sizeof(meta)) {
+            break;
+        }
+        info.resize(meta.mEncodedInfoSize);
+        reader.Read(pos + sizeof(meta), &info[0], meta.mEncodedInfoSize);
+        encryption.resize(meta.mEncryptionSize);
+        reader.Read(pos + sizeof(meta) + meta.mEncodedInfoSize, &encryption[0], meta.mEncryptionSize);
+        ++readCnt;
+
+        meta.mHandled = 1;
+        reader.Write(pos, &meta, sizeof(meta));
+        pos += sizeof(meta) + meta.mEncodedInfoSize + meta.mEncryptionSize;
+    }
+    reader.Close();
+    PrintResult("replay spool", readCnt, dataSize, startTime);
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    string fileName = GetProcessExecutionDir() + "logtail_buffer_file_benchmark";
+    for (size_t dataSize : {512, 4096, 65536}) {
+        size_t recordCnt = 64 * 1024 * 1024 / dataSize;
+        BM_SpillLegacy(fileName, recordCnt, dataSize);
+        BM_ReplayLegacy(fileName, dataSize);
+        // commit size 0 means each record is committed once appended
+        for (size_t commitSize : {0, 256 * 1024, 4 * 1024 * 1024}) {
+            BM_SpillSpool(fileName, recordCnt, dataSize, commitSize, false, false);
+        }
+        BM_SpillSpool(fileName, recordCnt, dataSize, 4 * 1024 * 1024, false, true);
+        BM_SpillSpool(fileName, recordCnt, dataSize, 4 * 1024 * 1024, true, true);
+        BM_ReplaySpool(fileName, dataSize);
+        cout << endl;
+    }
+    remove(fileName.c_str());
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/FileSystemUtil.h"
+#include "common/RuntimeUtil.h"
+#include "sender/BufferFileSpool.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class BufferFileSpoolUnittest : public ::testing::Test {
+public:
+    void TestWriteAndCommit();
+    void TestReopen();
+    void TestPreallocate();
+    void TestRead();
+    void TestWriteBack();
+
+protected:
+    void SetUp() override {
+        mTestDir = (bfs::path(GetProcessExecutionDir()) / "BufferFileSpoolUnittest").string();
+        bfs::remove_all(mTestDir);
+        bfs::create_directories(mTestDir);
+        mFileName = (bfs::path(mTestDir) / "logtail_buffer_file_1").string();
+    }
+
+    void TearDown() override { bfs::remove_all(mTestDir); }
+
+    string ReadAll() {
+        string content;
+        ReadFileContent(mFileName, content, 1024 * 1024);
+        return content;
+    }
+
+    string mTestDir;
+    string mFileName;
+};
+
+void BufferFileSpoolUnittest::TestWriteAndCommit() {
+    BufferFileWriter writer;
+    APSARA_TEST_TRUE(writer.Open(mFileName, "header", 0));
+    APSARA_TEST_TRUE(writer.IsOpen());
+    APSARA_TEST_EQUAL(mFileName, writer.GetFileName());
+    // header is written on open
+    APSARA_TEST_EQUAL("header", ReadAll());
+    APSARA_TEST_EQUAL(6, writer.GetSize());
+
+    writer.Append("record1", 7);
+    writer.Append("record2", 7);
+    APSARA_TEST_EQUAL(14U, writer.GetPendingSize());
+    APSARA_TEST_EQUAL(20, writer.GetSize());
+    // nothing is written before commit
+    APSARA_TEST_EQUAL("header", ReadAll());
+
+    APSARA_TEST_TRUE(writer.Commit(true));
+    APSARA_TEST_EQUAL(0U, writer.GetPendingSize());
+    APSARA_TEST_EQUAL(20, writer.GetSize());
+    APSARA_TEST_EQUAL("headerrecord1record2", ReadAll());
+    // empty commit
+    APSARA_TEST_TRUE(writer.Commit(false));
+
+    // uncommitted records are discarded on close
+    writer.Append("record3", 7);
+    writer.Close();
+    APSARA_TEST_FALSE(writer.IsOpen());
+    APSARA_TEST_EQUAL("", writer.GetFileName());
+    APSARA_TEST_EQUAL("headerrecord1record2", ReadAll());
+}
+
+void BufferFileSpoolUnittest::TestReopen() {
+    BufferFileWriter writer;
+    APSARA_TEST_TRUE(writer.Open(mFileName, "header", 0));
+    writer.Append("record1", 7);
+    APSARA_TEST_TRUE(writer.Commit(false));
+    writer.Close();
+
+    // header is not written again for an existing file
+    APSARA_TEST_TRUE(writer.Open(mFileName, "header", 0));
+    APSARA_TEST_EQUAL(13, writer.GetSize());
+    writer.Append("record2", 7);
+    APSARA_TEST_TRUE(writer.Commit(false));
+    APSARA_TEST_EQUAL("headerrecord1record2", ReadAll());
+
+    // open another file
+    string anotherFileName = mFileName + "_2";
+    APSARA_TEST_TRUE(writer.Open(anotherFileName, "header", 0));
+    APSARA_TEST_EQUAL(anotherFileName, writer.GetFileName());
+    APSARA_TEST_EQUAL(6, writer.GetSize());
+
+    // open failure
+    APSARA_TEST_FALSE(writer.Open((bfs::path(mTestDir) / "not_exist" / "file").string(), "header", 0));
+    APSARA_TEST_FALSE(writer.IsOpen());
+}
+
+void BufferFileSpoolUnittest::TestPreallocate() {
+    BufferFileWriter writer;
+    APSARA_TEST_TRUE(writer.Open(mFileName, "header", 1024 * 1024));
+    writer.Append("record1", 7);
+    APSARA_TEST_TRUE(writer.Commit(false));
+    // file size is not changed by preallocation, since readers take it as the end of records
+    APSARA_TEST_EQUAL(13, bfs::file_size(mFileName));
+    writer.Close();
+    APSARA_TEST_EQUAL(13, bfs::file_size(mFileName));
+    APSARA_TEST_EQUAL("headerrecord1", ReadAll());
+}
+
+void BufferFileSpoolUnittest::TestRead() {
+    OverwriteFile(mFileName, "headerrecord1record2");
+    BufferFileReader reader;
+    APSARA_TEST_FALSE(reader.Open(mFileName + "_not_exist"));
+    APSARA_TEST_TRUE(reader.Open(mFileName));
+    APSARA_TEST_EQUAL(mFileName, reader.GetFileName());
+    APSARA_TEST_EQUAL(20, reader.GetFileSize());
+
+    char buf[16] = {0};
+    // sequential read
+    APSARA_TEST_EQUAL(7U, reader.Read(6, buf, 7));
+    APSARA_TEST_EQUAL("record1", string(buf, 7));
+    APSARA_TEST_EQUAL(7U, reader.Read(13, buf, 7));
+    APSARA_TEST_EQUAL("record2", string(buf, 7));
+    // read backward
+    APSARA_TEST_EQUAL(6U, reader.Read(0, buf, 6));
+    APSARA_TEST_EQUAL("header", string(buf, 6));
+    // skip and read beyond the end
+    APSARA_TEST_EQUAL(3U, reader.Read(17, buf, 7));
+    APSARA_TEST_EQUAL("rd2", string(buf, 3));
+    APSARA_TEST_EQUAL(0U, reader.Read(20, buf, 7));
+}
+
+void BufferFileSpoolUnittest::TestWriteBack() {
+    OverwriteFile(mFileName, "headerrecord1record2");
+    {
+        BufferFileReader reader;
+        APSARA_TEST_TRUE(reader.Open(mFileName));
+        char buf[16] = {0};
+        APSARA_TEST_EQUAL(7U, reader.Read(6, buf, 7));
+        APSARA_TEST_TRUE(reader.Write(6, "RECORD1", 7));
+        APSARA_TEST_EQUAL(7U, reader.Read(13, buf, 7));
+        APSARA_TEST_EQUAL("record2", string(buf, 7));
+        APSARA_TEST_TRUE(reader.Write(13, "RECORD2", 7));
+        // written back in place, the file is not truncated
+        APSARA_TEST_EQUAL("headerRECORD1RECORD2", ReadAll());
+    }
+    APSARA_TEST_EQUAL("headerRECORD1RECORD2", ReadAll());
+}
+
+UNIT_TEST_CASE(BufferFileSpoolUnittest, TestWriteAndCommit)
+UNIT_TEST_CASE(BufferFileSpoolUnittest, TestReopen)
+UNIT_TEST_CASE(BufferFileSpoolUnittest, TestPreallocate)
+UNIT_TEST_CASE(BufferFileSpoolUnittest, TestRead)
+UNIT_TEST_CASE(BufferFileSpoolUnittest, TestWriteBack)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
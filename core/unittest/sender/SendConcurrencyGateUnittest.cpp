@@ -0,0 +1,65 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <thread>
+
+#include "common/TimeUtil.h"
+#include "sender/SendConcurrencyGate.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class SendConcurrencyGateUnittest : public ::testing::Test {
+public:
+    void TestWaitForSlot();
+    void TestWakeUp();
+};
+
+void SendConcurrencyGateUnittest::TestWaitForSlot() {
+    SendConcurrencyGate gate;
+    APSARA_TEST_TRUE(gate.WaitForSlot(2, 0));
+    gate.Add();
+    APSARA_TEST_TRUE(gate.WaitForSlot(2, 0));
+    gate.Add();
+    APSARA_TEST_EQUAL(2, gate.Get());
+    APSARA_TEST_FALSE(gate.WaitForSlot(2, 10));
+    gate.Sub();
+    APSARA_TEST_TRUE(gate.WaitForSlot(2, 0));
+    gate.Set(0);
+    APSARA_TEST_EQUAL(0, gate.Get());
+}
+
+void SendConcurrencyGateUnittest::TestWakeUp() {
+    SendConcurrencyGate gate;
+    gate.Add();
+    thread t([&]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        gate.Sub();
+    });
+    uint64_t startTime = GetCurrentTimeInMilliSeconds();
+    APSARA_TEST_TRUE(gate.WaitForSlot(1, 10000));
+    // woken up by Sub instead of timeout
+    APSARA_TEST_TRUE(GetCurrentTimeInMilliSeconds() - startTime < 5000);
+    t.join();
+}
+
+UNIT_TEST_CASE(SendConcurrencyGateUnittest, TestWaitForSlot)
+UNIT_TEST_CASE(SendConcurrencyGateUnittest, TestWakeUp)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,249 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/TimeUtil.h"
+#include "sender/SendConcurrencyGate.h"
+#include "sender/TokenBucket.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// Mock endpoint which finishes each request after a fixed latency, and records the time from the log group being
+// generated to the request being done.
+class MockEndpoint {
+public:
+    MockEndpoint(SendConcurrencyGate& gate, int64_t latencyUs) : mGate(gate), mLatency(latencyUs) {
+        mThread = thread([this]() { Run(); });
+    }
+
+    ~MockEndpoint() {
+        {
+            lock_guard<mutex> lock(mMux);
+            mStop = true;
+        }
+        mCond.notify_one();
+        mThread.join();
+    }
+
+    void Send(int64_t generateTime) {
+        {
+            lock_guard<mutex> lock(mMux);
+            mRequests.emplace(GetCurrentTimeInMicroSeconds() + mLatency, generateTime);
+        }
+        mCond.notify_one();
+    }
+
+    vector<int64_t> GetLatencies() {
+        lock_guard<mutex> lock(mMux);
+        return mLatencies;
+    }
+
+private:
+    void Run() {
+        unique_lock<mutex> lock(mMux);
+        while (!mStop) {
+            if (mRequests.empty()) {
+                mCond.wait(lock);
+                continue;
+            }
+            int64_t curTime = GetCurrentTimeInMicroSeconds();
+            auto iter = mRequests.begin();
+            if (iter->first > curTime) {
+                mCond.wait_for(lock, chrono::microseconds(iter->first - curTime));
+                continue;
+            }
+            mLatencies.push_back(curTime - iter->second);
+            mRequests.erase(iter);
+            lock.unlock();
+            mGate.Sub();
+            lock.lock();
+        }
+    }
+
+    SendConcurrencyGate& mGate;
+    const int64_t mLatency;
+    mutex mMux;
+    condition_variable mCond;
+    multimap<int64_t, int64_t> mRequests;
+    vector<int64_t> mLatencies;
+    bool mStop = false;
+    thread mThread;
+};
+
+// the same as the sender thread did before: random sleep, polling the concurrency and one second flow control window
+struct PollingStrategy {
+    void Smooth(size_t batchSize) {
+        int64_t sleepMicroseconds = 0;
+        if (batchSize < 10) {
+            sleepMicroseconds = (rand() % 40) * 10000;
+        } else if (batchSize < 20) {
+            sleepMicroseconds = (rand() % 30) * 10000;
+        } else if (batchSize < 30) {
+            sleepMicroseconds = (rand() % 20) * 10000;
+        } else if (batchSize < 40) {
+            sleepMicroseconds = (rand() % 10) * 10000;
+        }
+        if (sleepMicroseconds > 0) {
+            usleep(sleepMicroseconds);
+        }
+    }
+
+    void FlowControl(int32_t dataSize, int32_t bps) {
+        int64_t curTime = GetCurrentTimeInMicroSeconds();
+        if (curTime - mLastTime >= 1000 * 1000) {
+            mLastTime = curTime;
+            mLastByte = dataSize;
+        } else if (mLastByte > bps) {
+            usleep(1000 * 1000 - (curTime - mLastTime));
+            mLastTime = GetCurrentTimeInMicroSeconds();
+            mLastByte = dataSize;
+        } else {
+            mLastByte += dataSize;
+        }
+    }
+
+    void WaitForSlot(SendConcurrencyGate& gate, int32_t limit) {
+        while (gate.Get() >= limit) {
+            usleep(10 * 1000);
+        }
+    }
+
+    int64_t mLastTime = 0;
+    int64_t mLastByte = 0;
+};
+
+struct GateStrategy {
+    void Smooth(size_t batchSize) {}
+
+    void FlowControl(int32_t dataSize, int32_t bps) {
+        if (mBucket.GetRate() != bps) {
+            mBucket.SetRate(bps, bps / 10);
+        }
+        int64_t waitTime = mBucket.Consume(dataSize, GetCurrentTimeInMicroSeconds());
+        if (waitTime > 0) {
+            usleep(waitTime);
+        }
+    }
+
+    void WaitForSlot(SendConcurrencyGate& gate, int32_t limit) {
+        while (!gate.WaitForSlot(limit, 100)) {
+        }
+    }
+
+    TokenBucket mBucket;
+};
+
+static void PrintPercentiles(const string& name, vector<int64_t> latencies, int64_t elapsedUs) {
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[min(latencies.size() - 1, size_t(latencies.size() * p))]; };
+    cout << name << "\trequests: " << latencies.size() << "\tthroughput: " << latencies.size() * 1000000 / elapsedUs
+         << "/s\tp50: " << percentile(0.5) / 1000 << "ms\tp90: " << percentile(0.9) / 1000
+         << "ms\tp99: " << percentile(0.99) / 1000 << "ms\tmax: " << latencies.back() / 1000 << "ms" << endl;
+}
+
+// Log groups of groupSize bytes are generated at groupsPerSec, and sent by a single sender thread the same way as
+// Sender::DaemonSender does.
+template <class Strategy>
+static void BM_SendLatency(const string& name,
+                           int32_t groupsPerSec,
+                           int32_t groupSize,
+                           int32_t bps,
+                           int32_t concurrency,
+                           int64_t endpointLatencyUs,
+                           int32_t durationSec) {
+    SendConcurrencyGate gate;
+    MockEndpoint endpoint(gate, endpointLatencyUs);
+    Strategy strategy;
+
+    mutex mux;
+    condition_variable cond;
+    deque<int64_t> queue;
+    atomic_bool stop{false};
+    int64_t startTime = GetCurrentTimeInMicroSeconds();
+    thread producer([&]() {
+        int64_t interval = 1000000 / groupsPerSec;
+        for (int64_t i = 0; i < int64_t(groupsPerSec) * durationSec; ++i) {
+            int64_t next = startTime + i * interval;
+            int64_t curTime = GetCurrentTimeInMicroSeconds();
+            if (next > curTime) {
+                usleep(next - curTime);
+            }
+            {
+                lock_guard<mutex> lock(mux);
+                queue.push_back(GetCurrentTimeInMicroSeconds());
+            }
+            cond.notify_one();
+        }
+        stop = true;
+        cond.notify_one();
+    });
+
+    while (true) {
+        deque<int64_t> batch;
+        {
+            unique_lock<mutex> lock(mux);
+            cond.wait_for(lock, chrono::seconds(1), [&]() { return !queue.empty() || stop; });
+            batch.swap(queue);
+        }
+        if (batch.empty() && stop) {
+            break;
+        }
+        strategy.Smooth(batch.size());
+        for (int64_t generateTime : batch) {
+            strategy.FlowControl(groupSize, bps);
+            strategy.WaitForSlot(gate, concurrency);
+            gate.Add();
+            endpoint.Send(generateTime);
+        }
+    }
+    producer.join();
+    while (gate.Get() > 0) {
+        gate.WaitForSlot(1, 100);
+    }
+    PrintPercentiles(name, endpoint.GetLatencies(), GetCurrentTimeInMicroSeconds() - startTime);
+}
+
+int main(int argc, char** argv) {
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    cout << "low load: 20 groups/s, no flow control" << endl;
+    BM_SendLatency<PollingStrategy>("polling", 20, 64 * 1024, 1 << 30, 20, 20000, 10);
+    BM_SendLatency<GateStrategy>("gate", 20, 64 * 1024, 1 << 30, 20, 20000, 10);
+    cout << "concurrency bound: 1000 groups/s, concurrency 10, endpoint latency 5ms" << endl;
+    BM_SendLatency<PollingStrategy>("polling", 1000, 64 * 1024, 1 << 30, 10, 5000, 10);
+    BM_SendLatency<GateStrategy>("gate", 1000, 64 * 1024, 1 << 30, 10, 5000, 10);
+    cout << "flow control bound: 200 groups/s of 64KB, 10MB/s" << endl;
+    BM_SendLatency<PollingStrategy>("polling", 200, 64 * 1024, 10 * 1024 * 1024, 20, 20000, 10);
+    BM_SendLatency<GateStrategy>("gate", 200, 64 * 1024, 10 * 1024 * 1024, 20, 20000, 10);
+    return 0;
+}
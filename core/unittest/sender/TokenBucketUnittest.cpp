@@ -0,0 +1,73 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sender/TokenBucket.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class TokenBucketUnittest : public ::testing::Test {
+public:
+    void TestConsume();
+    void TestRefill();
+    void TestSetRate();
+};
+
+void TokenBucketUnittest::TestConsume() {
+    TokenBucket bucket;
+    // no limit
+    APSARA_TEST_EQUAL(0, bucket.Consume(1000, 1000000));
+
+    bucket.SetRate(1000, 1000);
+    APSARA_TEST_EQUAL(0, bucket.Consume(600, 1000000));
+    APSARA_TEST_EQUAL(0, bucket.Consume(400, 1000000));
+    // 500 tokens in debt, which takes 0.5 second to refill
+    APSARA_TEST_EQUAL(500000, bucket.Consume(500, 1000000));
+}
+
+void TokenBucketUnittest::TestRefill() {
+    TokenBucket bucket;
+    bucket.SetRate(1000, 1000);
+    APSARA_TEST_EQUAL(0, bucket.Consume(1000, 1000000));
+    // 100 tokens refilled after 0.1 second
+    APSARA_TEST_EQUAL(0, bucket.Consume(100, 1100000));
+    APSARA_TEST_EQUAL(100000, bucket.Consume(100, 1100000));
+    // no more than burst after idle for a long time
+    APSARA_TEST_EQUAL(0, bucket.Consume(900, 100000000));
+    APSARA_TEST_EQUAL(500000, bucket.Consume(600, 100000000));
+    // clock jumped back
+    APSARA_TEST_EQUAL(1000000, bucket.Consume(500, 1000000));
+}
+
+void TokenBucketUnittest::TestSetRate() {
+    TokenBucket bucket;
+    bucket.SetRate(1000, 1000);
+    APSARA_TEST_EQUAL(1000, bucket.GetRate());
+    APSARA_TEST_EQUAL(0, bucket.Consume(200, 1000000));
+    // tokens are capped by the new burst
+    bucket.SetRate(2000, 100);
+    APSARA_TEST_EQUAL(2000, bucket.GetRate());
+    APSARA_TEST_EQUAL(0, bucket.Consume(100, 1000000));
+    APSARA_TEST_EQUAL(50000, bucket.Consume(100, 1000000));
+}
+
+UNIT_TEST_CASE(TokenBucketUnittest, TestConsume)
+UNIT_TEST_CASE(TokenBucketUnittest, TestRefill)
+UNIT_TEST_CASE(TokenBucketUnittest, TestSetRate)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,135 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/StringTools.h"
+#include "common/TimeUtil.h"
+#include "log_pb/sls_logs.pb.h"
+#include "serializer/FlatLogGroupWriter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// Round trip of a log group from the native pipeline to the Go plugin system: the native side serializes the group,
+// and the Go side copies the buffer and walks every key and value. With protobuf, the Go side has to decode the buffer
+// field by field, which is simulated by ParseFromString here, while the flat layout is read in place.
+struct Field {
+    StringView mKey;
+    StringView mValue;
+};
+
+static uint32_t ReadUint32(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+static size_t ReadFlat(const string& buf) {
+    const char* base = buf.data();
+    uint32_t logCnt = ReadUint32(base + 4), contentCnt = ReadUint32(base + 8);
+    const char* p = base + FlatLogGroupWriter::kHeaderSize + logCnt * FlatLogGroupWriter::kLogSize;
+    vector<Field> fields(contentCnt);
+    size_t total = 0;
+    for (auto& field : fields) {
+        field.mKey = StringView(base + ReadUint32(p), ReadUint32(p + 4));
+        field.mValue = StringView(base + ReadUint32(p + 8), ReadUint32(p + 12));
+        total += field.mKey.size() + field.mValue.size();
+        p += FlatLogGroupWriter::kFieldSize;
+    }
+    return total;
+}
+
+static size_t ReadProtobuf(const string& buf) {
+    sls_logs::LogGroup logGroup;
+    logGroup.ParseFromString(buf);
+    size_t total = 0;
+    for (const auto& log : logGroup.logs()) {
+        for (const auto& content : log.contents()) {
+            total += content.key().size() + content.value().size();
+        }
+    }
+    return total;
+}
+
+static void BM_RoundTrip(size_t contentCnt, size_t valueSize, int batchSize) {
+    static const size_t kEventCnt = 1000;
+
+    vector<string> keys, values;
+    size_t stringsSize = 5;
+    for (size_t j = 0; j < contentCnt; ++j) {
+        keys.emplace_back("key_" + ToString(j));
+        values.emplace_back(valueSize, 'a' + j % 26);
+        stringsSize += (keys.back().size() + valueSize) * kEventCnt;
+    }
+
+    uint64_t flatTime = 0, protobufTime = 0;
+    size_t flatSize = 0, protobufSize = 0, checksum = 0;
+    for (int i = 0; i < batchSize; ++i) {
+        {
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            FlatLogGroupWriter writer;
+            writer.Prepare(kEventCnt, kEventCnt * contentCnt, 0, stringsSize);
+            for (size_t k = 0; k < kEventCnt; ++k) {
+                writer.AddLog(1234567890, 123456789, true);
+                for (size_t j = 0; j < contentCnt; ++j) {
+                    writer.AddLogContent(keys[j], values[j]);
+                }
+            }
+            writer.SetTopic("topic");
+            string copied = writer.GetResult();
+            checksum += ReadFlat(copied);
+            flatTime += GetCurrentTimeInMicroSeconds() - startTime;
+            flatSize += copied.size();
+        }
+        {
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            sls_logs::LogGroup logGroup;
+            for (size_t k = 0; k < kEventCnt; ++k) {
+                auto log = logGroup.add_logs();
+                log->set_time(1234567890);
+                log->set_time_ns(123456789);
+                for (size_t j = 0; j < contentCnt; ++j) {
+                    auto content = log->add_contents();
+                    content->set_key(keys[j]);
+                    content->set_value(values[j]);
+                }
+            }
+            logGroup.set_topic("topic");
+            string res = logGroup.SerializeAsString();
+            checksum += ReadProtobuf(res);
+            protobufTime += GetCurrentTimeInMicroSeconds() - startTime;
+            protobufSize += res.size();
+        }
+    }
+    cout << "contents per event: " << contentCnt << "\tvalue size: " << valueSize
+         << "\tavg flat size: " << flatSize / batchSize << "\tavg protobuf size: " << protobufSize / batchSize
+         << "\tchecksum: " << checksum << endl;
+    cout << "\tflat: " << flatTime << "us\tprotobuf: " << protobufTime << "us" << endl;
+}
+
+int main(int argc, char** argv) {
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    BM_RoundTrip(5, 10, 100);
+    BM_RoundTrip(10, 50, 100);
+    BM_RoundTrip(20, 200, 100);
+    return 0;
+}
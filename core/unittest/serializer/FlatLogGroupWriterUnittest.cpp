@@ -0,0 +1,102 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "serializer/FlatLogGroupWriter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FlatLogGroupWriterUnittest : public ::testing::Test {
+public:
+    void TestWrite();
+    void TestWriteEmpty();
+
+private:
+    static uint32_t ReadUint32(const string& buf, size_t pos);
+    static string ReadString(const string& buf, size_t pos);
+};
+
+uint32_t FlatLogGroupWriterUnittest::ReadUint32(const string& buf, size_t pos) {
+    const auto* p = reinterpret_cast<const unsigned char*>(buf.data() + pos);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+string FlatLogGroupWriterUnittest::ReadString(const string& buf, size_t pos) {
+    return buf.substr(ReadUint32(buf, pos), ReadUint32(buf, pos + 4));
+}
+
+void FlatLogGroupWriterUnittest::TestWrite() {
+    // log 0: 2 contents with time ns, log 1: no content, log 2: 1 content with empty value
+    FlatLogGroupWriter writer;
+    writer.Prepare(3, 3, 1, 39);
+    writer.AddLog(1700000000, 123, true);
+    writer.AddLogContent("key1", "value1");
+    writer.AddLogContent("key2", "value2");
+    writer.AddLog(1700000001, 0, false);
+    writer.AddLog(1700000002, 0, false);
+    writer.AddLogContent("key3", "");
+    writer.SetTopic("topic");
+    writer.AddLogTag("__path__", "/a");
+
+    const string& res = writer.GetResult();
+    APSARA_TEST_EQUAL(FlatLogGroupWriter::GetSize(3, 3, 1, 39), res.size());
+    APSARA_TEST_EQUAL(FlatLogGroupWriter::kMagic, ReadUint32(res, 0));
+    APSARA_TEST_EQUAL(3U, ReadUint32(res, 4));
+    APSARA_TEST_EQUAL(3U, ReadUint32(res, 8));
+    APSARA_TEST_EQUAL(1U, ReadUint32(res, 12));
+    APSARA_TEST_EQUAL("topic", ReadString(res, 16));
+
+    size_t pos = FlatLogGroupWriter::kHeaderSize;
+    uint32_t expectedTimes[] = {1700000000, 1700000001, 1700000002};
+    uint32_t expectedEnds[] = {2, 2, 3};
+    for (size_t i = 0; i < 3; ++i, pos += FlatLogGroupWriter::kLogSize) {
+        APSARA_TEST_EQUAL(expectedTimes[i], ReadUint32(res, pos));
+        APSARA_TEST_EQUAL(i == 0 ? 123U : 0U, ReadUint32(res, pos + 4));
+        APSARA_TEST_EQUAL(i == 0 ? 1U : 0U, ReadUint32(res, pos + 8));
+        APSARA_TEST_EQUAL(expectedEnds[i], ReadUint32(res, pos + 12));
+    }
+
+    APSARA_TEST_EQUAL("key1", ReadString(res, pos));
+    APSARA_TEST_EQUAL("value1", ReadString(res, pos + 8));
+    pos += FlatLogGroupWriter::kFieldSize;
+    APSARA_TEST_EQUAL("key2", ReadString(res, pos));
+    APSARA_TEST_EQUAL("value2", ReadString(res, pos + 8));
+    pos += FlatLogGroupWriter::kFieldSize;
+    APSARA_TEST_EQUAL("key3", ReadString(res, pos));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, pos + 12));
+    pos += FlatLogGroupWriter::kFieldSize;
+    APSARA_TEST_EQUAL("__path__", ReadString(res, pos));
+    APSARA_TEST_EQUAL("/a", ReadString(res, pos + 8));
+}
+
+void FlatLogGroupWriterUnittest::TestWriteEmpty() {
+    FlatLogGroupWriter writer;
+    writer.Prepare(0, 0, 0, 0);
+    const string& res = writer.GetResult();
+    APSARA_TEST_EQUAL(FlatLogGroupWriter::kHeaderSize, res.size());
+    APSARA_TEST_EQUAL(FlatLogGroupWriter::kMagic, ReadUint32(res, 0));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, 4));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, 20));
+}
+
+UNIT_TEST_CASE(FlatLogGroupWriterUnittest, TestWrite)
+UNIT_TEST_CASE(FlatLogGroupWriterUnittest, TestWriteEmpty)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
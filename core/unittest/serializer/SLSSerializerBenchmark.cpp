@@ -0,0 +1,126 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <iostream>
+
+#include "common/TimeUtil.h"
+#include "flusher/FlusherSLS.h"
+#include "serializer/SLSSerializer.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// the serialization path before LogGroupWriter is introduced, kept here for comparison
+static bool SerializeByProtobuf(const FlusherSLS* flusher, BatchedEvents&& group, string& res) {
+    sls_logs::LogGroup logGroup;
+    for (const auto& e : group.mEvents) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        auto log = logGroup.add_logs();
+        for (const auto& kv : logEvent) {
+            auto contPtr = log->add_contents();
+            contPtr->set_key(kv.first.to_string());
+            contPtr->set_value(kv.second.to_string());
+        }
+        log->set_time(logEvent.GetTimestamp());
+        if (flusher->GetContext().GetGlobalConfig().mEnableTimestampNanosecond
+            && logEvent.GetTimestampNanosecond()) {
+            log->set_time_ns(logEvent.GetTimestampNanosecond().value());
+        }
+    }
+    for (const auto& tag : group.mTags.mInner) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            logGroup.set_topic(tag.second.to_string());
+        } else if (tag.first == LOG_RESERVED_KEY_SOURCE) {
+            logGroup.set_source(tag.second.to_string());
+        } else if (tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
+            logGroup.set_machineuuid(tag.second.to_string());
+        } else {
+            auto logTag = logGroup.add_logtags();
+            logTag->set_key(tag.first.to_string());
+            logTag->set_value(tag.second.to_string());
+        }
+    }
+    logGroup.set_category(flusher->mLogstore);
+    res = logGroup.SerializeAsString();
+    return true;
+}
+
+static BatchedEvents CreateBatchedEvents(size_t eventCnt, size_t contentCnt, size_t valueSize) {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    group.SetTag(LOG_RESERVED_KEY_SOURCE, "172.16.0.1");
+    group.SetTag(LOG_RESERVED_KEY_MACHINE_UUID, "machine_uuid");
+    group.SetTag(string("__path__"), string("/var/log/containers/app.log"));
+    group.SetTag(string("__hostname__"), string("hostname"));
+    for (size_t i = 0; i < eventCnt; ++i) {
+        LogEvent* e = group.AddLogEvent();
+        for (size_t j = 0; j < contentCnt; ++j) {
+            e->SetContent("key_" + ToString(j), string(valueSize, 'a' + j % 26));
+        }
+        e->SetTimestamp(1234567890, 123456789);
+    }
+    return BatchedEvents(std::move(group.MutableEvents()),
+                         std::move(group.GetSizedTags()),
+                         std::move(group.GetSourceBuffer()),
+                         StringView(),
+                         RangeCheckpointPtr());
+}
+
+static void BM_Serialize(FlusherSLS* flusher, size_t contentCnt, size_t valueSize, int batchSize) {
+    SLSEventGroupSerializer serializer(flusher);
+    uint64_t writerTime = 0, protobufTime = 0;
+    size_t totalSize = 0;
+    for (int i = 0; i < batchSize; ++i) {
+        string res, errorMsg;
+        {
+            BatchedEvents batch = CreateBatchedEvents(1000, contentCnt, valueSize);
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            serializer.Serialize(std::move(batch), res, errorMsg);
+            writerTime += GetCurrentTimeInMicroSeconds() - startTime;
+            totalSize += res.size();
+        }
+        {
+            BatchedEvents batch = CreateBatchedEvents(1000, contentCnt, valueSize);
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            SerializeByProtobuf(flusher, std::move(batch), res);
+            protobufTime += GetCurrentTimeInMicroSeconds() - startTime;
+        }
+    }
+    cout << "contents per event: " << contentCnt << "\tvalue size: " << valueSize
+         << "\tavg group size: " << totalSize / batchSize << endl;
+    cout << "\tLogGroupWriter: " << writerTime << "us\tprotobuf: " << protobufTime << "us" << endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    cout << "release" << endl;
+#else
+    cout << "debug" << endl;
+#endif
+    PipelineContext ctx;
+    ctx.SetConfigName("test_config");
+    const_cast<GlobalConfig&>(ctx.GetGlobalConfig()).mEnableTimestampNanosecond = true;
+    FlusherSLS flusher;
+    flusher.SetContext(ctx);
+    flusher.SetMetricsRecordRef(FlusherSLS::sName, "1");
+    flusher.mLogstore = "logstore";
+
+    BM_Serialize(&flusher, 5, 10, 100);
+    BM_Serialize(&flusher, 10, 50, 100);
+    BM_Serialize(&flusher, 20, 200, 100);
+    return 0;
+}
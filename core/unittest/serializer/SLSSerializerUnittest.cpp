@@ -26,6 +26,7 @@ class SLSSerializerUnittest : public ::testing::Test {
 public:
     void TestSerializeEventGroup();
     void TestSerializeEventGroupList();
+    void TestSerializeEventGroupIdenticalToProtobuf();
 
 protected:
     static void SetUpTestCase() { sFlusher = make_unique<FlusherSLS>(); }
@@ -115,6 +116,62 @@ void SLSSerializerUnittest::TestSerializeEventGroupList() {
     APSARA_TEST_EQUAL(sls_logs::SlsCompressType::SLS_CMP_NONE, logPackageList.packages(0).compress_type());
 }
 
+void SLSSerializerUnittest::TestSerializeEventGroupIdenticalToProtobuf() {
+    const_cast<GlobalConfig&>(mCtx.GetGlobalConfig()).mEnableTimestampNanosecond = true;
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "");
+    group.SetTag(LOG_RESERVED_KEY_MACHINE_UUID, "machine_uuid");
+    group.SetTag(string("tag_key"), string(200, 't'));
+    group.SetTag(string("a_tag_key"), string("tag_value"));
+    for (size_t i = 0; i < 10; ++i) {
+        LogEvent* e = group.AddLogEvent();
+        e->SetContent(string("key"), string(i * 50, 'v'));
+        e->SetContent(string("empty_value"), string());
+        e->SetContent(string(300, 'k'), string("value"));
+        if (i % 2 == 0) {
+            e->SetTimestamp(1234567890 + i, i * 1000);
+        } else {
+            e->SetTimestamp(i);
+        }
+    }
+    group.AddLogEvent()->SetTimestamp(0);
+
+    sls_logs::LogGroup expected;
+    for (const auto& e : group.GetEvents()) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        auto log = expected.add_logs();
+        for (const auto& kv : logEvent) {
+            auto contPtr = log->add_contents();
+            contPtr->set_key(kv.first.to_string());
+            contPtr->set_value(kv.second.to_string());
+        }
+        log->set_time(logEvent.GetTimestamp());
+        if (logEvent.GetTimestampNanosecond()) {
+            log->set_time_ns(logEvent.GetTimestampNanosecond().value());
+        }
+    }
+    expected.set_category("logstore");
+    expected.set_topic("");
+    expected.set_machineuuid("machine_uuid");
+    auto logTag = expected.add_logtags();
+    logTag->set_key("a_tag_key");
+    logTag->set_value("tag_value");
+    logTag = expected.add_logtags();
+    logTag->set_key("tag_key");
+    logTag->set_value(string(200, 't'));
+
+    BatchedEvents batch(std::move(group.MutableEvents()),
+                        std::move(group.GetSizedTags()),
+                        std::move(group.GetSourceBuffer()),
+                        StringView(),
+                        RangeCheckpointPtr());
+    SLSEventGroupSerializer serializer(sFlusher.get());
+    string res, errorMsg;
+    APSARA_TEST_TRUE(serializer.Serialize(std::move(batch), res, errorMsg));
+    APSARA_TEST_EQUAL(expected.SerializeAsString(), res);
+    const_cast<GlobalConfig&>(mCtx.GetGlobalConfig()).mEnableTimestampNanosecond = false;
+}
+
 BatchedEvents SLSSerializerUnittest::CreateBatchedEvents(bool enableNanosecond) {
     PipelineEventGroup group(make_shared<SourceBuffer>());
     group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
@@ -141,6 +198,7 @@ BatchedEvents SLSSerializerUnittest::CreateBatchedEvents(bool enableNanosecond)
 
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroup)
 UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroupList)
+UNIT_TEST_CASE(SLSSerializerUnittest, TestSerializeEventGroupIdenticalToProtobuf)
 
 } // namespace logtail
 
@@ -0,0 +1,126 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package protocol
+
+import (
+	"encoding/binary"
+	"errors"
+	"unsafe"
+)
+
+// Flat log group is the format in which log groups are handed over from the native pipeline, see
+// core/serializer/FlatLogGroupWriter.h for the layout. All integers are uint32 in little endian.
+const (
+	flatLogGroupMagic      = 0x31474C46 // "FLG1"
+	flatLogGroupHeaderSize = 24
+	flatLogGroupLogSize    = 16
+	flatLogGroupFieldSize  = 16
+)
+
+var errInvalidFlatLogGroup = errors.New("invalid flat log group")
+
+// DecodeFlatLogGroup decodes the flat log group in data. Keys and values of the result refer to data directly instead
+// of being copied, so data must be owned by the caller and never be modified afterwards. Logs, contents, tags and
+// nanosecond times are allocated in batches.
+func DecodeFlatLogGroup(data []byte) (*LogGroup, error) {
+	if len(data) < flatLogGroupHeaderSize || binary.LittleEndian.Uint32(data) != flatLogGroupMagic {
+		return nil, errInvalidFlatLogGroup
+	}
+	logCnt := uint64(binary.LittleEndian.Uint32(data[4:]))
+	contentCnt := uint64(binary.LittleEndian.Uint32(data[8:]))
+	tagCnt := uint64(binary.LittleEndian.Uint32(data[12:]))
+	if flatLogGroupHeaderSize+logCnt*flatLogGroupLogSize+(contentCnt+tagCnt)*flatLogGroupFieldSize > uint64(len(data)) {
+		return nil, errInvalidFlatLogGroup
+	}
+
+	logGroup := &LogGroup{}
+	var ok bool
+	if logGroup.Topic, ok = flatString(data, data[16:]); !ok {
+		return nil, errInvalidFlatLogGroup
+	}
+
+	logs := make([]Log, logCnt)
+	timeNs := make([]uint32, logCnt)
+	contents := make([]Log_Content, contentCnt)
+	logGroup.Logs = make([]*Log, logCnt)
+	contentPtrs := make([]*Log_Content, contentCnt)
+	logPos := flatLogGroupHeaderSize
+	contentPos := flatLogGroupHeaderSize + int(logCnt)*flatLogGroupLogSize
+	contentBegin := uint64(0)
+	for i := range logs {
+		entry := data[logPos : logPos+flatLogGroupLogSize]
+		logPos += flatLogGroupLogSize
+		log := &logs[i]
+		log.Time = binary.LittleEndian.Uint32(entry)
+		if binary.LittleEndian.Uint32(entry[8:]) != 0 {
+			timeNs[i] = binary.LittleEndian.Uint32(entry[4:])
+			log.TimeNs = &timeNs[i]
+		}
+		contentEnd := uint64(binary.LittleEndian.Uint32(entry[12:]))
+		if contentEnd < contentBegin || contentEnd > contentCnt {
+			return nil, errInvalidFlatLogGroup
+		}
+		for j := contentBegin; j < contentEnd; j++ {
+			field := data[contentPos : contentPos+flatLogGroupFieldSize]
+			contentPos += flatLogGroupFieldSize
+			content := &contents[j]
+			if content.Key, ok = flatString(data, field); !ok {
+				return nil, errInvalidFlatLogGroup
+			}
+			if content.Value, ok = flatString(data, field[8:]); !ok {
+				return nil, errInvalidFlatLogGroup
+			}
+			contentPtrs[j] = content
+		}
+		log.Contents = contentPtrs[contentBegin:contentEnd:contentEnd]
+		contentBegin = contentEnd
+		logGroup.Logs[i] = log
+	}
+	if contentBegin != contentCnt {
+		return nil, errInvalidFlatLogGroup
+	}
+
+	if tagCnt > 0 {
+		tags := make([]LogTag, tagCnt)
+		logGroup.LogTags = make([]*LogTag, tagCnt)
+		for i := range tags {
+			field := data[contentPos : contentPos+flatLogGroupFieldSize]
+			contentPos += flatLogGroupFieldSize
+			tag := &tags[i]
+			if tag.Key, ok = flatString(data, field); !ok {
+				return nil, errInvalidFlatLogGroup
+			}
+			if tag.Value, ok = flatString(data, field[8:]); !ok {
+				return nil, errInvalidFlatLogGroup
+			}
+			logGroup.LogTags[i] = tag
+		}
+	}
+	return logGroup, nil
+}
+
+// flatString returns the string located by the offset and size at the beginning of field, referring to data.
+func flatString(data []byte, field []byte) (string, bool) {
+	offset := uint64(binary.LittleEndian.Uint32(field))
+	size := uint64(binary.LittleEndian.Uint32(field[4:]))
+	if offset+size > uint64(len(data)) {
+		return "", false
+	}
+	if size == 0 {
+		return "", true
+	}
+	b := data[offset : offset+size]
+	return *(*string)(unsafe.Pointer(&b)), true //nolint:gosec
+}
@@ -0,0 +1,160 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package protocol
+
+import (
+	"encoding/binary"
+	"strconv"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+// encodeFlatLogGroup follows FlatLogGroupWriter in core.
+func encodeFlatLogGroup(logGroup *LogGroup) []byte {
+	contentCnt, stringsSize := 0, len(logGroup.Topic)
+	for _, log := range logGroup.Logs {
+		contentCnt += len(log.Contents)
+		for _, content := range log.Contents {
+			stringsSize += len(content.Key) + len(content.Value)
+		}
+	}
+	for _, tag := range logGroup.LogTags {
+		stringsSize += len(tag.Key) + len(tag.Value)
+	}
+	fieldsSize := len(logGroup.Logs)*flatLogGroupLogSize + (contentCnt+len(logGroup.LogTags))*flatLogGroupFieldSize
+	data := make([]byte, flatLogGroupHeaderSize+fieldsSize+stringsSize)
+	pos, strPos := flatLogGroupHeaderSize, flatLogGroupHeaderSize+fieldsSize
+	putUint32 := func(p int, v int) {
+		binary.LittleEndian.PutUint32(data[p:], uint32(v))
+	}
+	putString := func(p int, s string) {
+		putUint32(p, strPos)
+		putUint32(p+4, len(s))
+		strPos += copy(data[strPos:], s)
+	}
+	putUint32(0, flatLogGroupMagic)
+	putUint32(4, len(logGroup.Logs))
+	putUint32(8, contentCnt)
+	putUint32(12, len(logGroup.LogTags))
+	putString(16, logGroup.Topic)
+	contentPos, contentEnd := pos+len(logGroup.Logs)*flatLogGroupLogSize, 0
+	for _, log := range logGroup.Logs {
+		putUint32(pos, int(log.Time))
+		if log.TimeNs != nil {
+			putUint32(pos+4, int(*log.TimeNs))
+			putUint32(pos+8, 1)
+		}
+		contentEnd += len(log.Contents)
+		putUint32(pos+12, contentEnd)
+		pos += flatLogGroupLogSize
+		for _, content := range log.Contents {
+			putString(contentPos, content.Key)
+			putString(contentPos+8, content.Value)
+			contentPos += flatLogGroupFieldSize
+		}
+	}
+	for _, tag := range logGroup.LogTags {
+		putString(contentPos, tag.Key)
+		putString(contentPos+8, tag.Value)
+		contentPos += flatLogGroupFieldSize
+	}
+	return data
+}
+
+func newFlatLogGroupTestData(logCnt int) *LogGroup {
+	timeNs := uint32(123456789)
+	logGroup := &LogGroup{
+		Topic:   "topic",
+		LogTags: []*LogTag{{Key: "__hostname__", Value: "host"}, {Key: "__path__", Value: "/var/log/app.log"}},
+	}
+	for i := 0; i < logCnt; i++ {
+		log := &Log{Time: uint32(1700000000 + i)}
+		if i%2 == 0 {
+			log.TimeNs = &timeNs
+		}
+		for j := 0; j < i%4; j++ {
+			log.Contents = append(log.Contents, &Log_Content{Key: "key" + strconv.Itoa(j), Value: "value" + strconv.Itoa(i)})
+		}
+		logGroup.Logs = append(logGroup.Logs, log)
+	}
+	return logGroup
+}
+
+func TestDecodeFlatLogGroup(t *testing.T) {
+	expected := newFlatLogGroupTestData(10)
+	logGroup, err := DecodeFlatLogGroup(encodeFlatLogGroup(expected))
+	require.NoError(t, err)
+	assert.Equal(t, expected.Topic, logGroup.Topic)
+	assert.Equal(t, expected.LogTags, logGroup.LogTags)
+	require.Equal(t, len(expected.Logs), len(logGroup.Logs))
+	for i, log := range logGroup.Logs {
+		assert.Equal(t, expected.Logs[i].Time, log.Time)
+		assert.Equal(t, expected.Logs[i].TimeNs, log.TimeNs)
+		assert.Equal(t, len(expected.Logs[i].Contents), len(log.Contents))
+		for j, content := range log.Contents {
+			assert.Equal(t, *expected.Logs[i].Contents[j], *content)
+		}
+	}
+
+	logGroup, err = DecodeFlatLogGroup(encodeFlatLogGroup(&LogGroup{}))
+	require.NoError(t, err)
+	assert.Empty(t, logGroup.Logs)
+	assert.Empty(t, logGroup.LogTags)
+}
+
+func TestDecodeFlatLogGroupInvalid(t *testing.T) {
+	data := encodeFlatLogGroup(newFlatLogGroupTestData(10))
+
+	_, err := DecodeFlatLogGroup(data[:flatLogGroupHeaderSize-1])
+	assert.Error(t, err)
+
+	_, err = DecodeFlatLogGroup(data[:len(data)-1])
+	assert.Error(t, err)
+
+	badMagic := append([]byte{}, data...)
+	badMagic[0] = 0
+	_, err = DecodeFlatLogGroup(badMagic)
+	assert.Error(t, err)
+
+	badContentEnd := append([]byte{}, data...)
+	binary.LittleEndian.PutUint32(badContentEnd[flatLogGroupHeaderSize+12:], 1000)
+	_, err = DecodeFlatLogGroup(badContentEnd)
+	assert.Error(t, err)
+}
+
+func BenchmarkDecodeFlatLogGroup(b *testing.B) {
+	data := encodeFlatLogGroup(newFlatLogGroupTestData(1024))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		copied := make([]byte, len(data))
+		copy(copied, data)
+		if _, err := DecodeFlatLogGroup(copied); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
+func BenchmarkUnmarshalLogGroup(b *testing.B) {
+	data, _ := newFlatLogGroupTestData(1024).Marshal()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		logGroup := &LogGroup{}
+		if err := logGroup.Unmarshal(data); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -173,6 +173,16 @@ func ProcessLogGroup(configName string, logBytes []byte, packID string) int {
 	return config.ProcessLogGroup(logBytes, util.StringDeepCopy(packID))
 }
 
+//export ProcessFlatLogGroup
+func ProcessFlatLogGroup(configName string, logBytes []byte, packID string) int {
+	config, exists := pluginmanager.LogtailConfig[configName]
+	if !exists {
+		logger.Debug(context.Background(), "config not found", configName)
+		return -1
+	}
+	return config.ProcessFlatLogGroup(logBytes, util.StringDeepCopy(packID))
+}
+
 //export HoldOn
 func HoldOn(exitFlag int) {
 	logger.Info(context.Background(), "Hold on", "start", "flag", exitFlag)
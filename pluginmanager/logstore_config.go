@@ -340,6 +340,25 @@ func (lc *LogstoreConfig) ProcessLogGroup(logByte []byte, packID string) int {
 	return 0
 }
 
+// ProcessFlatLogGroup is the counterpart of ProcessLogGroup for log groups passed by core in flat layout. logByte
+// refers to memory owned by core, so it is copied once as a whole and all keys and values of the decoded log group
+// refer to the copy, which is kept alive by the log group itself.
+func (lc *LogstoreConfig) ProcessFlatLogGroup(logByte []byte, packID string) int {
+	data := make([]byte, len(logByte))
+	copy(data, logByte)
+	logGroup, err := protocol.DecodeFlatLogGroup(data)
+	if err != nil {
+		logger.Error(lc.Context.GetRuntimeContext(), "WRONG_PROTOBUF_ALARM",
+			"cannot process flat log group passed by core, err", err)
+		return -1
+	}
+	lc.PluginRunner.ReceiveLogGroup(pipeline.LogGroupWithContext{
+		LogGroup: logGroup,
+		Context:  map[string]interface{}{ctxKeySource: packID}},
+	)
+	return 0
+}
+
 func hasDockerStdoutInput(plugins map[string]interface{}) bool {
 	inputs, exists := plugins["inputs"]
 	if !exists {